@@ -0,0 +1,134 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+#define RATES 4
+
+/**
+ * Largest distance between a live and a baked bone at the sample times themselves, where baked
+ * playback must give back what was sampled
+ */
+static float maxSampleDifference(spBakedAnimation *baked, spSkeleton *live, spSkeleton *skeleton) {
+    float maxDifference = 0.0f;
+    for (int i = 0; i < baked->samplesCount; ++i) {
+        float time = fminf(i / baked->sampleRate, baked->animation->duration);
+        spSkeleton_setToSetupPose(live);
+        spAnimation_apply(baked->animation, live, time, time, 0, NULL, NULL, 1, SP_MIX_POSE_SETUP,
+                          SP_MIX_DIRECTION_IN);
+        spSkeleton_updateWorldTransform(live);
+        spBakedAnimation_apply(baked, skeleton, time, 0);
+        for (int j = 0; j < live->bonesCount; ++j) {
+            const spBone *e = live->bones[j], *a = skeleton->bones[j];
+            float differences[] = {e->a - a->a, e->b - a->b, e->c - a->c, e->d - a->d,
+                                   e->worldX - a->worldX, e->worldY - a->worldY};
+            for (size_t k = 0; k < sizeof(differences) / sizeof(differences[0]); ++k) {
+                maxDifference = fmaxf(maxDifference, fabsf(differences[k]));
+            }
+        }
+        for (int j = 0; j < live->slotsCount; ++j) {
+            if (live->slots[j]->attachment != skeleton->slots[j]->attachment ||
+                live->drawOrder[j]->data != skeleton->drawOrder[j]->data) {
+                return INFINITY;
+            }
+        }
+    }
+    return maxDifference;
+}
+
+/**
+ * Live evaluation, an animation state applied and world transforms updated every frame, against
+ * baked playback at several sample rates
+ */
+static bool runBake(spSkeletonData *skeletonData, const char *animationName, int frames) {
+    const float rates[RATES] = {15, 30, 60, 120};
+    spAnimation *animation = spSkeletonData_findAnimation(skeletonData, animationName);
+    if (!animation) {
+        fprintf(stderr, "Animation %s not found\n", animationName);
+        return false;
+    }
+    spSkeleton *skeleton = spSkeleton_create(skeletonData);
+    spSkeleton *live = spSkeleton_create(skeletonData);
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    spAnimationState *state = spAnimationState_create(stateData);
+    spAnimationState_setAnimation(state, 0, animation, 1);
+    spSkeleton_setToSetupPose(live);
+
+    StageTimer timer;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    long long liveNanos = 0;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        timer.start();
+        spAnimationState_update(state, deltaTime);
+        spAnimationState_apply(state, live);
+        spSkeleton_updateWorldTransform(live);
+        long long elapsed = timer.elapsedNanos();
+        // The first 10% of the frames only warm up caches
+        if (frame >= 0) liveNanos += elapsed;
+    }
+    printf("%s: %d bones, %d slots, %.2f s, %d frames\n", animationName, skeleton->bonesCount,
+           skeleton->slotsCount, animation->duration, frames);
+    printf("  %-10s %8.1f ns/frame\n", "live", (double) liveNanos / frames);
+
+    bool ok = true;
+    float lastError = INFINITY;
+    for (int i = 0; i < RATES; ++i) {
+        timer.start();
+        spBakedAnimation *baked = spBakedAnimation_create(skeleton, animation, rates[i]);
+        long long bakeNanos = timer.elapsedNanos();
+
+        long long bakedNanos = 0;
+        for (int frame = -frames / 10; frame < frames; ++frame) {
+            timer.start();
+            spBakedAnimation_apply(baked, skeleton, frame * deltaTime, 1);
+            long long elapsed = timer.elapsedNanos();
+            if (frame >= 0) bakedNanos += elapsed;
+        }
+
+        float colorError;
+        float error = spBakedAnimation_measureError(baked, skeleton, 3, &colorError);
+        float sampleDifference = maxSampleDifference(baked, live, skeleton);
+        printf("  %3.0f Hz     %8.1f ns/frame, speedup %5.2fx, baked in %.2f ms, %7.0f bytes/s, "
+               "max error %.3f units, %.4f color, at samples %g\n", rates[i],
+               (double) bakedNanos / frames, (double) liveNanos / bakedNanos, bakeNanos / 1e6,
+               spBakedAnimation_getBytesPerSecond(baked), error, colorError, sampleDifference);
+        // Exact at the samples, and closer to live evaluation the more samples there are
+        ok = ok && sampleDifference == 0.0f && error <= lastError;
+        lastError = error;
+        spBakedAnimation_dispose(baked);
+    }
+    printf("  baked matches live: %s\n", ok ? "yes" : "NO");
+
+    spAnimationState_dispose(state);
+    spAnimationStateData_dispose(stateData);
+    spSkeleton_dispose(live);
+    spSkeleton_dispose(skeleton);
+    return ok;
+}
+
+/**
+ * Usage: bake-bench [frames] [animation]
+ */
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 3000;
+    const char *animationName = argc > 2 ? argv[2] : "walk";
+    if (frames <= 0) frames = 3000;
+
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return 1;
+    }
+    string skeletonPath = getRaptorDir() + "raptor.skel";
+    spSkeletonData *skeletonData = readSkeletonData(atlas, skeletonPath.c_str(), true);
+    bool ok = skeletonData != NULL;
+    if (ok) {
+        ok = runBake(skeletonData, animationName, frames);
+        spSkeletonData_dispose(skeletonData);
+    }
+    spAtlas_dispose(atlas);
+    return ok ? 0 : 1;
+}
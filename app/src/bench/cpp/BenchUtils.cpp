@@ -0,0 +1,85 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+
+static long fixedClockFrame = 0;
+
+/*
+ * Spine callbacks: the benchmarks never touch GL so pages get no texture
+ */
+void _spAtlasPage_createTexture(spAtlasPage *self, const char *path) {
+    self->width = 0;
+    self->height = 0;
+}
+
+void _spAtlasPage_disposeTexture(spAtlasPage *self) {
+
+}
+
+char *_spUtil_readFile(const char *path, int *length) {
+    return _spReadFile(path, length);
+}
+
+long getFixedClockTimeInMilli() {
+    return (fixedClockFrame++) * FIXED_FRAME_MILLIS;
+}
+
+void resetFixedClock() {
+    fixedClockFrame = 0;
+}
+
+std::string getRaptorDir() {
+    return std::string(STICKER_BENCH_RES_DIR) + "/raptor/";
+}
+
+spSkeletonData *readSkeletonData(spAtlas *atlas, const char *path, bool binary) {
+    spSkeletonData *skeletonData;
+    if (binary) {
+        spSkeletonBinary *reader = spSkeletonBinary_create(atlas);
+        skeletonData = spSkeletonBinary_readSkeletonDataFile(reader, path);
+        if (!skeletonData) fprintf(stderr, "Read %s: FAILED (%s)\n", path, reader->error);
+        spSkeletonBinary_dispose(reader);
+    } else {
+        spSkeletonJson *reader = spSkeletonJson_create(atlas);
+        skeletonData = spSkeletonJson_readSkeletonDataFile(reader, path);
+        if (!skeletonData) fprintf(stderr, "Read %s: FAILED (%s)\n", path, reader->error);
+        spSkeletonJson_dispose(reader);
+    }
+    return skeletonData;
+}
+
+void printStage(const char *stage, double nanosPerFrame) {
+    printf("  %-40s %12.1f ns/frame\n", stage, nanosPerFrame);
+}
+
+spBoneData *addBone(spSkeletonData *skeletonData, const char *name, spBoneData *parent,
+                    float x, float rotation, float length) {
+    spBoneData *boneData = spBoneData_create(skeletonData->bonesCount, name, parent);
+    boneData->x = x;
+    boneData->rotation = rotation;
+    boneData->length = length;
+    skeletonData->bones[skeletonData->bonesCount++] = boneData;
+    return boneData;
+}
+
+void swingBones(spSkeleton *skeleton, float time, float reach) {
+    for (int i = 1; i < skeleton->bonesCount; ++i) {
+        spBone *bone = skeleton->bones[i];
+        spBoneData *data = bone->data;
+        bone->rotation = data->rotation + 20 * sinf(time * 3 + i * 0.7f);
+        bone->x = data->x + reach * cosf(time * 2 + i);
+    }
+}
+
+float maxWorldDifference(const spSkeleton *expected, const spSkeleton *actual) {
+    float maxDifference = 0.0f;
+    for (int i = 0; i < expected->bonesCount; ++i) {
+        const spBone *e = expected->bones[i], *a = actual->bones[i];
+        float differences[] = {e->a - a->a, e->b - a->b, e->c - a->c, e->d - a->d,
+                               e->worldX - a->worldX, e->worldY - a->worldY};
+        for (size_t j = 0; j < sizeof(differences) / sizeof(differences[0]); ++j) {
+            maxDifference = fmaxf(maxDifference, fabsf(differences[j]));
+        }
+    }
+    return maxDifference;
+}
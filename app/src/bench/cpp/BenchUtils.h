@@ -0,0 +1,78 @@
+#ifndef HELLO_SPINE_BENCHUTILS_H
+#define HELLO_SPINE_BENCHUTILS_H
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <chrono>
+#include <string>
+
+#define FIXED_FRAME_MILLIS 16
+
+/**
+ * Monotonic nanosecond stopwatch used to time a single stage
+ */
+class StageTimer {
+
+private:
+    std::chrono::steady_clock::time_point mStart;
+
+public:
+    void start() {
+        mStart = std::chrono::steady_clock::now();
+    }
+
+    long long elapsedNanos() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - mStart).count();
+    }
+};
+
+/**
+ * Fixed clock injected instead of getCurrentSystemTimeInMilli: every call advances one frame
+ * of FIXED_FRAME_MILLIS so that all runs step the animation through the same times
+ */
+extern long getFixedClockTimeInMilli();
+
+extern void resetFixedClock();
+
+/**
+ * Directory of the bundled raptor sample
+ */
+extern std::string getRaptorDir();
+
+/**
+ * Load skeleton data either from raptor.json or raptor.skel
+ *
+ * @param atlas atlas the attachments are resolved from
+ * @param path skeleton file path
+ * @param binary true to read a .skel file, false to read a .json file
+ * @return skeleton data or NULL on failure
+ */
+extern spSkeletonData *readSkeletonData(spAtlas *atlas, const char *path, bool binary);
+
+extern void printStage(const char *stage, double nanosPerFrame);
+
+/**
+ * Append a bone to a synthetic skeleton data whose bones array is already allocated
+ *
+ * @param parent parent bone, NULL for the root
+ * @param x local x, along the parent
+ * @param rotation local rotation in degrees
+ * @param length bone length
+ */
+extern spBoneData *addBone(spSkeletonData *skeletonData, const char *name, spBoneData *parent,
+                           float x, float rotation, float length);
+
+/**
+ * Same local pose on every skeleton of a data: every bone but the root swings with its own phase
+ *
+ * @param reach amplitude of the local x swing
+ */
+extern void swingBones(spSkeleton *skeleton, float time, float reach);
+
+/**
+ * Largest difference between the world transforms of two skeletons of the same data
+ */
+extern float maxWorldDifference(const spSkeleton *expected, const spSkeleton *actual);
+
+#endif
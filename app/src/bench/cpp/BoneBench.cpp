@@ -0,0 +1,386 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+#define SWEEP_COUNT 1000000
+
+/**
+ * Worst errors of one sincos implementation against double precision
+ */
+struct SinCosError {
+    double maxValueError;   // Largest absolute error of sine or cosine
+    double maxAngleDegrees; // Largest error of atan2(sine, cosine) against the angle, in degrees
+};
+
+static void addSample(SinCosError *error, float degrees, float sine, float cosine) {
+    double radians = degrees * (M_PI / 180.0);
+    error->maxValueError = fmax(error->maxValueError, fabs(sine - sin(radians)));
+    error->maxValueError = fmax(error->maxValueError, fabs(cosine - cos(radians)));
+    double angle = atan2((double) sine, (double) cosine) - atan2(sin(radians), cos(radians));
+    if (angle > M_PI) angle -= 2 * M_PI;
+    else if (angle < -M_PI) angle += 2 * M_PI;
+    error->maxAngleDegrees = fmax(error->maxAngleDegrees, fabs(angle) * (180.0 / M_PI));
+}
+
+static void printSinCos(const char *name, const SinCosError &error, double nanosPerAngle) {
+    printf("  %-28s %5.2f ns/angle, max |error| %.3g, max angle error %.3g degrees\n", name,
+           nanosPerAngle, error.maxValueError, error.maxAngleDegrees);
+}
+
+/**
+ * Evenly spaced angles in [-range, range] degrees
+ */
+static vector<float> createAngles(float range, int count) {
+    vector<float> angles;
+    for (int i = 0; i < count; ++i) {
+        angles.push_back(-range + 2 * range * i / count);
+    }
+    return angles;
+}
+
+/**
+ * Accuracy and raw speed of libm, the scalar polynomial and the array polynomial
+ */
+static void runSinCos(float range) {
+    vector<float> angles = createAngles(range, SWEEP_COUNT);
+    int count = (int) angles.size();
+    vector<float> sines((size_t) count), cosines((size_t) count);
+    SinCosError libmError = {0, 0}, fastError = {0, 0}, arrayError = {0, 0};
+    StageTimer timer;
+
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        sines[i] = SIN_DEG(angles[i]);
+        cosines[i] = COS_DEG(angles[i]);
+    }
+    long long libmNanos = timer.elapsedNanos();
+    for (int i = 0; i < count; ++i) addSample(&libmError, angles[i], sines[i], cosines[i]);
+
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        _spMath_fastSinCosDeg(angles[i], &sines[i], &cosines[i]);
+    }
+    long long fastNanos = timer.elapsedNanos();
+    for (int i = 0; i < count; ++i) addSample(&fastError, angles[i], sines[i], cosines[i]);
+
+    timer.start();
+    _spMath_fastSinCosDegArray(&angles[0], &sines[0], &cosines[0], count);
+    long long arrayNanos = timer.elapsedNanos();
+    for (int i = 0; i < count; ++i) addSample(&arrayError, angles[i], sines[i], cosines[i]);
+
+    printf("sincos of %d angles in [-%g, %g] degrees\n", count, range, range);
+    printSinCos("libm sinf/cosf", libmError, (double) libmNanos / count);
+    printSinCos("_spMath_fastSinCosDeg", fastError, (double) fastNanos / count);
+    printSinCos("_spMath_fastSinCosDegArray", arrayError, (double) arrayNanos / count);
+}
+
+/**
+ * Bones per second of spSkeleton_updateWorldTransform on the raptor walk, with libm and with
+ * fast math
+ */
+static bool runBones(spSkeletonData *skeletonData, int frames) {
+    spSkeleton *reference = spSkeleton_create(skeletonData);
+    spSkeleton *skeletons[2];
+    const char *names[] = {"libm", "fast math"};
+    long long nanos[2] = {0, 0};
+    float differences[2] = {0, 0};
+    for (int i = 0; i < 2; ++i) {
+        skeletons[i] = spSkeleton_create(skeletonData);
+    }
+
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    spAnimationState *state = spAnimationState_create(stateData);
+    if (!spAnimationState_setAnimationByName(state, 0, "walk", 1)) {
+        fprintf(stderr, "Animation walk not found\n");
+        return false;
+    }
+
+    StageTimer timer;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        spAnimationState_update(state, deltaTime);
+        spAnimationState_apply(state, reference);
+        spBone_setFastMath(0);
+        spSkeleton_updateWorldTransform(reference);
+
+        for (int i = 0; i < 2; ++i) {
+            spAnimationState_apply(state, skeletons[i]);
+            spBone_setFastMath(i);
+            timer.start();
+            spSkeleton_updateWorldTransform(skeletons[i]);
+            long long elapsed = timer.elapsedNanos();
+
+            // The first 10% of the frames only warm up caches
+            if (frame < 0) continue;
+            nanos[i] += elapsed;
+            differences[i] = fmaxf(differences[i], maxWorldDifference(reference, skeletons[i]));
+        }
+    }
+    spBone_setFastMath(0);
+
+    printf("raptor walk: %d bones, %d frames\n", reference->bonesCount, frames);
+    for (int i = 0; i < 2; ++i) {
+        double bonesPerSecond = (double) reference->bonesCount * frames / (nanos[i] / 1e9);
+        printf("  %-24s %7.1f ns/frame, %6.2f M bones/s, max world difference %g\n", names[i],
+               (double) nanos[i] / frames, bonesPerSecond / 1e6, differences[i]);
+    }
+
+    spAnimationState_dispose(state);
+    spAnimationStateData_dispose(stateData);
+    for (int i = 0; i < 2; ++i) {
+        spSkeleton_dispose(skeletons[i]);
+    }
+    spSkeleton_dispose(reference);
+    return true;
+}
+
+/**
+ * Full against incremental spSkeleton_updateWorldTransform on a partially animated raptor
+ *
+ * @param animationName looping animation, NULL to hold the setup pose
+ */
+static bool runIncremental(spSkeletonData *skeletonData, const char *animationName, int frames) {
+    spSkeleton *full = spSkeleton_create(skeletonData);
+    spSkeleton *incremental = spSkeleton_create(skeletonData);
+    spSkeleton_setIncrementalUpdate(incremental, 1);
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    spAnimationState *state = spAnimationState_create(stateData);
+    bool ok = !animationName || spAnimationState_setAnimationByName(state, 0, animationName, 1);
+    if (!ok) fprintf(stderr, "Animation %s not found\n", animationName);
+
+    StageTimer timer;
+    long long fullNanos = 0, incrementalNanos = 0;
+    long long updatedBones = 0;
+    float difference = 0.0f;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    for (int frame = -frames / 10; ok && frame < frames; ++frame) {
+        spAnimationState_update(state, deltaTime);
+        spAnimationState_apply(state, full);
+        spAnimationState_apply(state, incremental);
+
+        timer.start();
+        spSkeleton_updateWorldTransform(full);
+        long long fullFrame = timer.elapsedNanos();
+
+        timer.start();
+        spSkeleton_updateWorldTransform(incremental);
+        long long incrementalFrame = timer.elapsedNanos();
+
+        // The first 10% of the frames only warm up caches
+        if (frame < 0) continue;
+        fullNanos += fullFrame;
+        incrementalNanos += incrementalFrame;
+        updatedBones += spSkeleton_getUpdatedBonesCount(incremental);
+        difference = fmaxf(difference, maxWorldDifference(full, incremental));
+    }
+
+    if (ok) {
+        printf("%s: %.1f of %d bone updates/frame, full %.1f ns/frame, incremental %.1f ns/frame, "
+               "max world difference %g\n", animationName ? animationName : "setup pose held",
+               (double) updatedBones / frames, full->bonesCount, (double) fullNanos / frames,
+               (double) incrementalNanos / frames, difference);
+    }
+
+    spAnimationState_dispose(state);
+    spAnimationStateData_dispose(stateData);
+    spSkeleton_dispose(incremental);
+    spSkeleton_dispose(full);
+    return ok && difference == 0.0f;
+}
+
+static int sAllocations = 0;
+static size_t sAllocatedBytes = 0;
+
+static void *countingMalloc(size_t size) {
+    ++sAllocations;
+    sAllocatedBytes += size;
+    return malloc(size);
+}
+
+/**
+ * Allocations, bytes and time of spSkeleton_create and spSkeleton_dispose, as when stickers are
+ * created and destroyed while scrolling
+ */
+static void runInstances(spSkeletonData *skeletonData, int count) {
+    vector<spSkeleton *> skeletons((size_t) count);
+    StageTimer timer;
+
+    _spSetMalloc(countingMalloc);
+    sAllocations = 0;
+    sAllocatedBytes = 0;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        skeletons[i] = spSkeleton_create(skeletonData);
+    }
+    long long createNanos = timer.elapsedNanos();
+    _spSetMalloc(malloc);
+
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        spSkeleton_dispose(skeletons[i]);
+    }
+    long long disposeNanos = timer.elapsedNanos();
+
+    printf("%d raptor instances: %.1f allocations and %.0f bytes per instance, create %.1f us, "
+           "dispose %.1f us\n", count, (double) sAllocations / count,
+           (double) sAllocatedBytes / count, createNanos / 1e3 / count,
+           disposeNanos / 1e3 / count);
+}
+
+/**
+ * A crowd of raptors walking out of phase, one spSkeleton each against spSkeletonInstances of
+ * one spSkeletonTemplate
+ */
+static bool runCrowd(spSkeletonData *skeletonData, int count, int frames) {
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    spSkeletonTemplate *skeletonTemplate = spSkeletonTemplate_create(skeletonData);
+    vector<spSkeleton *> skeletons((size_t) count);
+    vector<spSkeletonInstance *> instances((size_t) count);
+    vector<spAnimationState *> skeletonStates((size_t) count), instanceStates((size_t) count);
+
+    _spSetMalloc(countingMalloc);
+    sAllocatedBytes = 0;
+    for (int i = 0; i < count; ++i) {
+        skeletons[i] = spSkeleton_create(skeletonData);
+    }
+    size_t skeletonBytes = sAllocatedBytes;
+    _spSetMalloc(malloc);
+
+    for (int i = 0; i < count; ++i) {
+        instances[i] = spSkeletonInstance_create(skeletonTemplate);
+        skeletonStates[i] = spAnimationState_create(stateData);
+        instanceStates[i] = spAnimationState_create(stateData);
+        spAnimationState_setAnimationByName(skeletonStates[i], 0, "walk", 1)->trackTime = 0.05f * i;
+        spAnimationState_setAnimationByName(instanceStates[i], 0, "walk", 1)->trackTime = 0.05f * i;
+    }
+
+    StageTimer timer;
+    long long skeletonNanos = 0, instanceNanos = 0;
+    float difference = 0.0f;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            spAnimationState_update(skeletonStates[i], deltaTime);
+            spAnimationState_apply(skeletonStates[i], skeletons[i]);
+            spSkeleton_updateWorldTransform(skeletons[i]);
+        }
+        long long skeletonFrame = timer.elapsedNanos();
+
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            spSkeleton *skeleton = spSkeletonInstance_load(instances[i]);
+            spAnimationState_update(instanceStates[i], deltaTime);
+            spAnimationState_apply(instanceStates[i], skeleton);
+            spSkeleton_updateWorldTransform(skeleton);
+            spSkeletonInstance_store(instances[i]);
+        }
+        long long instanceFrame = timer.elapsedNanos();
+
+        // The first 10% of the frames only warm up caches
+        if (frame < 0) continue;
+        skeletonNanos += skeletonFrame;
+        instanceNanos += instanceFrame;
+        if (frame % 10 == 0) {
+            for (int i = 0; i < count; ++i) {
+                difference = fmaxf(difference, maxWorldDifference(skeletons[i],
+                                                                  spSkeletonInstance_load(instances[i])));
+            }
+        }
+    }
+
+    // Deform vertices are allocated while animating, on both sides
+    int instanceBytes = 0;
+    for (int i = 0; i < count; ++i) {
+        instanceBytes += spSkeletonInstance_getByteCount(instances[i]);
+        for (int j = 0; j < skeletons[i]->slotsCount; ++j) {
+            skeletonBytes += sizeof(float) * skeletons[i]->slots[j]->attachmentVerticesCapacity;
+        }
+    }
+    printf("crowd of %d raptors walking: spSkeleton %.0f bytes and %.1f us/frame each, "
+           "spSkeletonInstance %.0f bytes and %.1f us/frame each, max world difference %g\n",
+           count, (double) skeletonBytes / count, skeletonNanos / 1e3 / frames / count,
+           (double) instanceBytes / count, instanceNanos / 1e3 / frames / count, difference);
+
+    for (int i = 0; i < count; ++i) {
+        spAnimationState_dispose(instanceStates[i]);
+        spAnimationState_dispose(skeletonStates[i]);
+        spSkeletonInstance_dispose(instances[i]);
+        spSkeleton_dispose(skeletons[i]);
+    }
+    spSkeletonTemplate_dispose(skeletonTemplate);
+    spAnimationStateData_dispose(stateData);
+    return difference == 0.0f;
+}
+
+/**
+ * Two spSkeletonInstances of a template with incremental update on, posed in turn: the template
+ * bones may match its last update while their world transforms are of the other instance
+ */
+static bool runSharedIncremental(spSkeletonData *skeletonData) {
+    spAnimation *walk = spSkeletonData_findAnimation(skeletonData, "walk");
+    spSkeletonTemplate *skeletonTemplate = spSkeletonTemplate_create(skeletonData);
+    spSkeletonInstance *first = spSkeletonInstance_create(skeletonTemplate);
+    spSkeletonInstance *second = spSkeletonInstance_create(skeletonTemplate);
+    spSkeleton *fresh = spSkeleton_create(skeletonData);
+    spSkeleton_setIncrementalUpdate(skeletonTemplate->skeleton, 1);
+
+    const float times[] = {0.1f, 0.5f, 0.5f};
+    spSkeletonInstance *const order[] = {second, first, second};
+    for (int i = 0; i < 3; ++i) {
+        spSkeleton *skeleton = spSkeletonInstance_load(order[i]);
+        spAnimation_apply(walk, skeleton, times[i], times[i], 1, NULL, NULL, 1, SP_MIX_POSE_SETUP,
+                          SP_MIX_DIRECTION_IN);
+        spSkeleton_updateWorldTransform(skeleton);
+        spSkeletonInstance_store(order[i]);
+    }
+    spAnimation_apply(walk, fresh, 0.5f, 0.5f, 1, NULL, NULL, 1, SP_MIX_POSE_SETUP,
+                      SP_MIX_DIRECTION_IN);
+    spSkeleton_updateWorldTransform(fresh);
+    float difference = maxWorldDifference(fresh, spSkeletonInstance_load(second));
+    printf("instances of an incremental template, walk at 0.1 then 0.5: max world difference %g\n",
+           difference);
+
+    spSkeleton_dispose(fresh);
+    spSkeletonInstance_dispose(second);
+    spSkeletonInstance_dispose(first);
+    spSkeletonTemplate_dispose(skeletonTemplate);
+    return difference == 0.0f;
+}
+
+/**
+ * Usage: bone-bench [frames]
+ */
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 5000;
+    if (frames <= 0) frames = 5000;
+
+    runSinCos(720.0f);
+    runSinCos(1e5f);
+
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return 1;
+    }
+    string skeletonPath = getRaptorDir() + "raptor.skel";
+    spSkeletonData *skeletonData = readSkeletonData(atlas, skeletonPath.c_str(), true);
+    bool ok = skeletonData && runBones(skeletonData, frames);
+    if (ok) {
+        ok = runIncremental(skeletonData, NULL, frames);
+        ok = runIncremental(skeletonData, "gun-grab", frames) && ok;
+        ok = runIncremental(skeletonData, "walk", frames) && ok;
+        runInstances(skeletonData, 1000);
+        ok = runCrowd(skeletonData, 50, frames / 10) && ok;
+        ok = runSharedIncremental(skeletonData) && ok;
+    }
+
+    if (skeletonData) spSkeletonData_dispose(skeletonData);
+    spAtlas_dispose(atlas);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,288 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#define SWEEP_COUNT 1000000
+#define VARIANTS 4
+
+/**
+ * Largest world difference fast math may add on top of the batched solver: positions of the
+ * synthetic rig and the raptor are a few hundred units, angles are off by about 1e-7 radians
+ */
+#define FAST_MATH_TOLERANCE 1e-3f
+
+/**
+ * IK heavy synthetic rig: legs of a thigh, a shin and a foot around a body. The thigh and the shin
+ * reach for one target with a two bone IK, the foot aims at another with a one bone IK and a pad
+ * follows the foot with an absolute world transform constraint. Every fourth thigh is scaled non
+ * uniformly, which the batched solver leaves to the scalar one.
+ */
+static spSkeletonData *createLegsSkeletonData(int legs) {
+    spSkeletonData *skeletonData = spSkeletonData_create();
+    skeletonData->bones = MALLOC(spBoneData *, 2 + legs * 6);
+    skeletonData->ikConstraints = MALLOC(spIkConstraintData *, legs * 2);
+    skeletonData->transformConstraints = MALLOC(spTransformConstraintData *, legs);
+
+    spBoneData *root = addBone(skeletonData, "root", NULL, 0, 0, 30);
+    spBoneData *body = addBone(skeletonData, "body", root, 0, 90, 30);
+    char name[32];
+    for (int leg = 0; leg < legs; ++leg) {
+        float angle = 360.0f * leg / legs;
+        snprintf(name, sizeof(name), "thigh%d", leg);
+        spBoneData *thigh = addBone(skeletonData, name, body, 20, angle, 30);
+        if (leg % 4 == 3) thigh->scaleY = 0.8f;
+        snprintf(name, sizeof(name), "shin%d", leg);
+        spBoneData *shin = addBone(skeletonData, name, thigh, 30, 30, 30);
+        snprintf(name, sizeof(name), "foot%d", leg);
+        spBoneData *foot = addBone(skeletonData, name, shin, 30, -30, 30);
+        snprintf(name, sizeof(name), "target%d", leg);
+        spBoneData *target = addBone(skeletonData, name, body, 60, angle + 10, 30);
+        snprintf(name, sizeof(name), "aim%d", leg);
+        spBoneData *aim = addBone(skeletonData, name, body, 90, angle, 30);
+        snprintf(name, sizeof(name), "pad%d", leg);
+        spBoneData *pad = addBone(skeletonData, name, body, 10, angle, 30);
+
+        snprintf(name, sizeof(name), "leg%d", leg);
+        spIkConstraintData *ik = spIkConstraintData_create(name);
+        ik->order = leg * 3;
+        ik->bonesCount = 2;
+        ik->bones = MALLOC(spBoneData *, 2);
+        ik->bones[0] = thigh;
+        ik->bones[1] = shin;
+        ik->target = target;
+        ik->bendDirection = leg % 2 ? -1 : 1;
+        skeletonData->ikConstraints[skeletonData->ikConstraintsCount++] = ik;
+
+        snprintf(name, sizeof(name), "foot%d", leg);
+        ik = spIkConstraintData_create(name);
+        ik->order = leg * 3 + 1;
+        ik->bonesCount = 1;
+        ik->bones = MALLOC(spBoneData *, 1);
+        ik->bones[0] = foot;
+        ik->target = aim;
+        ik->mix = 0.75f;
+        skeletonData->ikConstraints[skeletonData->ikConstraintsCount++] = ik;
+
+        snprintf(name, sizeof(name), "pad%d", leg);
+        spTransformConstraintData *transform = spTransformConstraintData_create(name);
+        transform->order = leg * 3 + 2;
+        transform->bonesCount = 1;
+        CONST_CAST(spBoneData **, transform->bones) = MALLOC(spBoneData *, 1);
+        transform->bones[0] = pad;
+        transform->target = foot;
+        transform->offsetRotation = 15;
+        transform->rotateMix = 0.5f;
+        transform->translateMix = 0.5f;
+        transform->scaleMix = 0.3f;
+        transform->shearMix = 0.2f;
+        skeletonData->transformConstraints[skeletonData->transformConstraintsCount++] = transform;
+    }
+    return skeletonData;
+}
+
+/**
+ * Accuracy and speed of the fast atan2 and acos arrays against double precision
+ */
+static void runMath() {
+    vector<float> y(SWEEP_COUNT), x(SWEEP_COUNT), cosines(SWEEP_COUNT), angles(SWEEP_COUNT);
+    for (int i = 0; i < SWEEP_COUNT; ++i) {
+        double angle = -M_PI + 2 * M_PI * i / SWEEP_COUNT;
+        float radius = 0.001f + 1000.0f * (i % 97) / 97;
+        y[i] = (float) (radius * sin(angle));
+        x[i] = (float) (radius * cos(angle));
+        cosines[i] = -1.0f + 2.0f * i / (SWEEP_COUNT - 1);
+    }
+    StageTimer timer;
+    printf("atan2 and acos of %d values\n", SWEEP_COUNT);
+    for (int fastMath = 0; fastMath <= 1; ++fastMath) {
+        spBone_setFastMath(fastMath);
+        double atan2Error = 0, acosError = 0;
+        timer.start();
+        _spMath_atan2Array(&y[0], &x[0], &angles[0], SWEEP_COUNT);
+        long long atan2Nanos = timer.elapsedNanos();
+        for (int i = 0; i < SWEEP_COUNT; ++i) {
+            atan2Error = fmax(atan2Error, fabs(angles[i] - atan2((double) y[i], (double) x[i])));
+        }
+        timer.start();
+        _spMath_acosArray(&cosines[0], &angles[0], SWEEP_COUNT);
+        long long acosNanos = timer.elapsedNanos();
+        for (int i = 0; i < SWEEP_COUNT; ++i) {
+            acosError = fmax(acosError, fabs(angles[i] - acos((double) cosines[i])));
+        }
+        printf("  %-10s atan2 %5.2f ns, max error %.3g rad; acos %5.2f ns, max error %.3g rad\n",
+               fastMath ? "fast math" : "libm", (double) atan2Nanos / SWEEP_COUNT, atan2Error,
+               (double) acosNanos / SWEEP_COUNT, acosError);
+    }
+    spBone_setFastMath(0);
+}
+
+/**
+ * Runs the scalar and the batched solvers side by side, with libm and with fast math, and checks
+ * them against the scalar solver of the same math. With libm the batched world transforms must be
+ * bit-identical, with fast math they may differ by FAST_MATH_TOLERANCE.
+ *
+ * @param state animation applied to every skeleton, NULL to use swingBones()
+ */
+static bool runSolvers(const char *name, spSkeletonData *skeletonData, spAnimationState *state,
+                       int frames) {
+    const char *names[VARIANTS] = {"scalar, libm", "batched, libm", "scalar, fast math",
+                                   "batched, fast math"};
+    spSkeleton *skeletons[VARIANTS];
+    long long nanos[VARIANTS] = {0, 0, 0, 0};
+    float differences[VARIANTS] = {0, 0, 0, 0};
+    for (int i = 0; i < VARIANTS; ++i) {
+        skeletons[i] = spSkeleton_create(skeletonData);
+        spSkeleton_setBatchedConstraints(skeletons[i], i % 2);
+    }
+
+    StageTimer timer;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        if (state) spAnimationState_update(state, deltaTime);
+        for (int i = 0; i < VARIANTS; ++i) {
+            if (state)
+                spAnimationState_apply(state, skeletons[i]);
+            else
+                swingBones(skeletons[i], frame * deltaTime, 15);
+            spBone_setFastMath(i >= 2);
+            timer.start();
+            spSkeleton_updateWorldTransform(skeletons[i]);
+            long long elapsed = timer.elapsedNanos();
+
+            // The first 10% of the frames only warm up caches
+            if (frame < 0) continue;
+            nanos[i] += elapsed;
+            if (i % 2) {
+                differences[i] = fmaxf(differences[i],
+                                       maxWorldDifference(skeletons[i - 1], skeletons[i]));
+            }
+        }
+    }
+    spBone_setFastMath(0);
+
+    printf("%s: %d bones, %d IK and %d transform constraints in %d batches, %d frames\n", name,
+           skeletons[0]->bonesCount, skeletons[0]->ikConstraintsCount,
+           skeletons[0]->transformConstraintsCount,
+           spSkeleton_getConstraintBatchesCount(skeletons[1]), frames);
+    for (int i = 0; i < VARIANTS; ++i) {
+        printf("  %-20s %8.1f ns/frame", names[i], (double) nanos[i] / frames);
+        if (i % 2) {
+            printf(", speedup %.2fx, max difference to scalar %g",
+                   (double) nanos[i - 1] / nanos[i], differences[i]);
+        }
+        printf("\n");
+    }
+    bool ok = differences[1] == 0.0f && differences[3] <= FAST_MATH_TOLERANCE;
+    printf("  batched matches scalar: %s\n", ok ? "yes" : "NO");
+
+    for (int i = 0; i < VARIANTS; ++i) {
+        spSkeleton_dispose(skeletons[i]);
+    }
+    return ok;
+}
+
+/**
+ * Largest world difference over a few frames of the animation, posed from the setup pose
+ */
+static float poseDifference(spAnimation *animation, spSkeleton *expected, spSkeleton *actual) {
+    float difference = 0;
+    for (int frame = 0; frame < 3; ++frame) {
+        float time = frame * FIXED_FRAME_MILLIS / 1000.0f;
+        spSkeleton *skeletons[2] = {expected, actual};
+        for (int i = 0; i < 2; ++i) {
+            spSkeleton_setToSetupPose(skeletons[i]);
+            spAnimation_apply(animation, skeletons[i], time, time, 1, NULL, NULL, 1,
+                              SP_MIX_POSE_SETUP, SP_MIX_DIRECTION_IN);
+            spSkeleton_updateWorldTransform(skeletons[i]);
+        }
+        difference = fmaxf(difference, maxWorldDifference(expected, actual));
+    }
+    return difference;
+}
+
+/**
+ * Retargets an IK constraint of a skeleton and rebuilds its update cache, which must not reuse
+ * the cache kept for the old target, then targets it back, which may. Each is compared with a
+ * skeleton created with that target in its data.
+ */
+static bool runRetarget(spSkeletonData *skeletonData) {
+    spAnimation *walk = spSkeletonData_findAnimation(skeletonData, "walk");
+    spIkConstraintData *ikData = spSkeletonData_findIkConstraint(skeletonData, "front-arm-goal");
+    spBoneData *tongue = spSkeletonData_findBone(skeletonData, "tongue3");
+    if (!walk || !ikData || !tongue) {
+        fprintf(stderr, "Animation walk, IK constraint front-arm-goal or bone tongue3 not found\n");
+        return false;
+    }
+    spSkeleton *skeleton = spSkeleton_create(skeletonData);
+    spSkeleton *original = spSkeleton_create(skeletonData);
+    spBoneData *target = ikData->target;
+    ikData->target = tongue;
+    spSkeleton *retargeted = spSkeleton_create(skeletonData);
+    ikData->target = target;
+
+    spIkConstraint *ik = spSkeleton_findIkConstraint(skeleton, "front-arm-goal");
+    ik->target = spSkeleton_findBone(skeleton, "tongue3");
+    spSkeleton_updateCache(skeleton);
+    float retargetDifference = poseDifference(walk, retargeted, skeleton);
+    ik->target = spSkeleton_findBone(skeleton, target->name);
+    spSkeleton_updateCache(skeleton);
+    float restoreDifference = poseDifference(walk, original, skeleton);
+
+    bool ok = retargetDifference == 0.0f && restoreDifference == 0.0f;
+    printf("raptor front-arm-goal retargeted to tongue3 and back: max difference %g and %g, "
+           "update cache rebuilt: %s\n", retargetDifference, restoreDifference, ok ? "yes" : "NO");
+    spSkeleton_dispose(retargeted);
+    spSkeleton_dispose(original);
+    spSkeleton_dispose(skeleton);
+    return ok;
+}
+
+static bool runRaptor(int frames) {
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return false;
+    }
+    string skeletonPath = getRaptorDir() + "raptor.skel";
+    spSkeletonData *skeletonData = readSkeletonData(atlas, skeletonPath.c_str(), true);
+    bool ok = skeletonData != NULL;
+    if (ok) {
+        spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+        spAnimationState *state = spAnimationState_create(stateData);
+        ok = spAnimationState_setAnimationByName(state, 0, "walk", 1) != NULL;
+        if (ok) {
+            ok = runSolvers("raptor walk", skeletonData, state, frames);
+            ok = runRetarget(skeletonData) && ok;
+        } else {
+            fprintf(stderr, "Animation walk not found\n");
+        }
+        spAnimationState_dispose(state);
+        spAnimationStateData_dispose(stateData);
+        spSkeletonData_dispose(skeletonData);
+    }
+    spAtlas_dispose(atlas);
+    return ok;
+}
+
+/**
+ * Usage: constraint-bench [legs] [frames]
+ */
+int main(int argc, char **argv) {
+    int legs = argc > 1 ? atoi(argv[1]) : 64;
+    int frames = argc > 2 ? atoi(argv[2]) : 2000;
+    if (legs <= 0) legs = 64;
+    if (frames <= 0) frames = 2000;
+
+    runMath();
+    spSkeletonData *skeletonData = createLegsSkeletonData(legs);
+    bool ok = runSolvers("legs", skeletonData, NULL, frames);
+    spSkeletonData_dispose(skeletonData);
+    ok = runRaptor(frames) && ok;
+    return ok ? 0 : 1;
+}
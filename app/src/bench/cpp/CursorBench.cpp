@@ -0,0 +1,280 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+#define BONES 16
+#define SLOTS 4
+#define MIX_DURATION 0.2f
+
+/**
+ * Which animation state a run drives: cursors as shipped, no cursors at all, or cursors that are
+ * reset before every apply so each lookup counts the steps of a full binary search
+ */
+enum CursorMode {
+    CURSORS, NO_CURSORS, SEARCH_ALWAYS, MODES
+};
+
+/**
+ * Cursor counters of the track entries of one animation state, summed when they are disposed
+ */
+struct CursorTotals {
+    long long lookups;
+    long long searches;
+    long long searchSteps;
+    long long events;
+};
+
+static void countCursors(spAnimationState *state, spEventType type, spTrackEntry *entry,
+                         spEvent *event) {
+    CursorTotals *totals = (CursorTotals *) state->rendererObject;
+    if (type == SP_ANIMATION_EVENT) {
+        totals->events++;
+        return;
+    }
+    if (type != SP_ANIMATION_DISPOSE) return;
+    for (int i = 0; i < entry->animation->timelinesCount; ++i) {
+        totals->lookups += entry->timelineCursors[i].lookups;
+        totals->searches += entry->timelineCursors[i].searches;
+        totals->searchSteps += entry->timelineCursors[i].searchSteps;
+    }
+}
+
+static void resetCursors(spTrackEntry *entry) {
+    for (; entry; entry = entry->mixingFrom) {
+        for (int i = 0; i < entry->animation->timelinesCount; ++i) {
+            entry->timelineCursors[i].frame = 0;
+        }
+    }
+}
+
+/**
+ * Keys evenly spaced 1/30 s apart with a Bezier curve on every other key, like baked motion
+ */
+static void setCurves(spCurveTimeline *timeline, int keys) {
+    for (int i = 0; i < keys - 1; i += 2) {
+        spCurveTimeline_setCurve(timeline, i, 0.25f, 0, 0.75f, 1);
+    }
+}
+
+static spAnimation *createKeyedAnimation(spSkeletonData *skeletonData, const char *name, int keys,
+                                         float phase) {
+    int timelinesCount = BONES * 4 + SLOTS * 2 + 1;
+    spAnimation *animation = spAnimation_create(name, timelinesCount);
+    float frameTime = 1 / 30.0f;
+    animation->duration = (keys - 1) * frameTime;
+    int t = 0;
+    for (int bone = 0; bone < BONES; ++bone) {
+        spRotateTimeline *rotate = spRotateTimeline_create(keys);
+        spTranslateTimeline *translate = spTranslateTimeline_create(keys);
+        spScaleTimeline *scale = spScaleTimeline_create(keys);
+        spShearTimeline *shear = spShearTimeline_create(keys);
+        rotate->boneIndex = translate->boneIndex = scale->boneIndex = shear->boneIndex = bone + 1;
+        for (int i = 0; i < keys; ++i) {
+            float time = i * frameTime, angle = phase + bone * 0.4f + i * 0.3f;
+            spRotateTimeline_setFrame(rotate, i, time, 170 * sinf(angle));
+            spTranslateTimeline_setFrame(translate, i, time, 10 * cosf(angle), 10 * sinf(angle));
+            spTranslateTimeline_setFrame(scale, i, time, 1 + 0.2f * sinf(angle), 1);
+            spTranslateTimeline_setFrame(shear, i, time, 5 * sinf(angle), 0);
+        }
+        setCurves(SUPER(rotate), keys);
+        setCurves(SUPER(translate), keys);
+        animation->timelines[t++] = SUPER(SUPER(rotate));
+        animation->timelines[t++] = SUPER(SUPER(translate));
+        animation->timelines[t++] = SUPER(SUPER(scale));
+        animation->timelines[t++] = SUPER(SUPER(shear));
+    }
+    for (int slot = 0; slot < SLOTS; ++slot) {
+        spColorTimeline *color = spColorTimeline_create(keys);
+        spAttachmentTimeline *attachment = spAttachmentTimeline_create(keys);
+        color->slotIndex = attachment->slotIndex = slot;
+        for (int i = 0; i < keys; ++i) {
+            float time = i * frameTime, angle = phase + slot + i * 0.2f;
+            spColorTimeline_setFrame(color, i, time, 0.5f + 0.5f * sinf(angle), 1, 1, 1);
+            spAttachmentTimeline_setFrame(attachment, i, time, (i + slot) % 3 ? "a" : "b");
+        }
+        animation->timelines[t++] = SUPER(SUPER(color));
+        animation->timelines[t++] = SUPER(attachment);
+    }
+    // An event every fourth key
+    int eventsCount = (keys + 3) / 4;
+    spEventTimeline *events = spEventTimeline_create(eventsCount);
+    for (int i = 0; i < eventsCount; ++i) {
+        spEventTimeline_setFrame(events, i, spEvent_create(i * 4 * frameTime, skeletonData->events[0]));
+    }
+    animation->timelines[t++] = SUPER(events);
+    return animation;
+}
+
+/**
+ * BONES bones under the root and SLOTS slots with two region attachments each, driven by two
+ * animations of keys keys on every bone and slot timeline
+ */
+static spSkeletonData *createKeyedSkeletonData(int keys) {
+    spSkeletonData *skeletonData = spSkeletonData_create();
+    char name[32];
+    skeletonData->bones = MALLOC(spBoneData *, BONES + 1);
+    skeletonData->bones[skeletonData->bonesCount++] = spBoneData_create(0, "root", NULL);
+    for (int i = 0; i < BONES; ++i) {
+        snprintf(name, sizeof(name), "bone%d", i);
+        spBoneData *bone = spBoneData_create(i + 1, name, skeletonData->bones[0]);
+        bone->x = i * 10.0f;
+        skeletonData->bones[skeletonData->bonesCount++] = bone;
+    }
+
+    skeletonData->slots = MALLOC(spSlotData *, SLOTS);
+    skeletonData->skinsCount = 1;
+    skeletonData->skins = MALLOC(spSkin *, 1);
+    skeletonData->skins[0] = skeletonData->defaultSkin = spSkin_create("default");
+    for (int i = 0; i < SLOTS; ++i) {
+        snprintf(name, sizeof(name), "slot%d", i);
+        skeletonData->slots[i] = spSlotData_create(i, name, skeletonData->bones[1 + i]);
+        spSlotData_setAttachmentName(skeletonData->slots[i], "a");
+        spSkin_addAttachment(skeletonData->defaultSkin, i, "a", SUPER(spRegionAttachment_create("a")));
+        spSkin_addAttachment(skeletonData->defaultSkin, i, "b", SUPER(spRegionAttachment_create("b")));
+    }
+    skeletonData->slotsCount = SLOTS;
+
+    skeletonData->eventsCount = 1;
+    skeletonData->events = MALLOC(spEventData *, 1);
+    skeletonData->events[0] = spEventData_create("step");
+
+    skeletonData->animationsCount = 2;
+    skeletonData->animations = MALLOC(spAnimation *, 2);
+    skeletonData->animations[0] = createKeyedAnimation(skeletonData, "sway", keys, 0);
+    skeletonData->animations[1] = createKeyedAnimation(skeletonData, "wave", keys, 1);
+    return skeletonData;
+}
+
+static bool samePose(const spSkeleton *expected, const spSkeleton *actual) {
+    for (int i = 0; i < expected->bonesCount; ++i) {
+        const spBone *e = expected->bones[i], *a = actual->bones[i];
+        if (e->x != a->x || e->y != a->y || e->rotation != a->rotation || e->scaleX != a->scaleX ||
+            e->scaleY != a->scaleY || e->shearX != a->shearX || e->shearY != a->shearY) {
+            return false;
+        }
+    }
+    for (int i = 0; i < expected->slotsCount; ++i) {
+        const spSlot *e = expected->slots[i], *a = actual->slots[i];
+        if (e->attachment != a->attachment || memcmp(&e->color, &a->color, sizeof(e->color))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Plays the animations with a crossfade every few seconds and a jump now and then, the same on
+ * every mode. Times applying with and without cursors, counts the binary search steps the cursors
+ * saved and checks every mode poses the skeleton the same.
+ */
+static bool runCursors(const char *name, spSkeletonData *skeletonData, const char *first,
+                       const char *second, int frames) {
+    const char *names[MODES] = {"cursors", "no cursors", "search always"};
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    stateData->defaultMix = MIX_DURATION;
+    spAnimationState *states[MODES];
+    spSkeleton *skeletons[MODES];
+    CursorTotals totals[MODES];
+    long long nanos[MODES] = {0, 0, 0};
+    memset(totals, 0, sizeof(totals));
+    for (int i = 0; i < MODES; ++i) {
+        states[i] = spAnimationState_create(stateData);
+        states[i]->listener = countCursors;
+        states[i]->rendererObject = &totals[i];
+        spAnimationState_setTimelineCursors(states[i], i != NO_CURSORS);
+        spAnimationState_setAnimationByName(states[i], 0, first, 1);
+        skeletons[i] = spSkeleton_create(skeletonData);
+        spSkeleton_setToSetupPose(skeletons[i]);
+    }
+
+    StageTimer timer;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    bool same = true;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        int step = frame + frames / 10;
+        for (int i = 0; i < MODES; ++i) {
+            if (step % 150 == 149) {
+                spAnimationState_setAnimationByName(states[i], 0, step % 300 == 149 ? second : first, 1);
+            } else if (step % 400 == 399) {
+                // Jump a second ahead. Seeking back would fire the events up to the end of the loop,
+                // more than the state holds for one apply.
+                spAnimationState_getCurrent(states[i], 0)->trackTime += 1;
+            }
+            spAnimationState_update(states[i], deltaTime);
+            if (i == SEARCH_ALWAYS) resetCursors(spAnimationState_getCurrent(states[i], 0));
+            timer.start();
+            spAnimationState_apply(states[i], skeletons[i]);
+            long long elapsed = timer.elapsedNanos();
+
+            // The first 10% of the frames only warm up caches
+            if (frame >= 0) nanos[i] += elapsed;
+        }
+        for (int i = 1; i < MODES; ++i) {
+            same = samePose(skeletons[0], skeletons[i]) && same;
+        }
+    }
+
+    for (int i = 0; i < MODES; ++i) {
+        // Disposing the state disposes the remaining track entries, which adds up their cursors
+        spAnimationState_dispose(states[i]);
+        spSkeleton_dispose(skeletons[i]);
+    }
+    spAnimationStateData_dispose(stateData);
+
+    same = same && totals[NO_CURSORS].events == totals[CURSORS].events &&
+           totals[SEARCH_ALWAYS].events == totals[CURSORS].events;
+    printf("%s: %d frames\n", name, frames);
+    for (int i = 0; i < MODES; ++i) {
+        printf("  %-14s %8.1f ns/frame", names[i], (double) nanos[i] / frames);
+        if (i != NO_CURSORS) {
+            printf(", %lld lookups, %lld searches, %lld search steps", totals[i].lookups,
+                   totals[i].searches, totals[i].searchSteps);
+        }
+        printf("\n");
+    }
+    long long saved = totals[SEARCH_ALWAYS].searchSteps - totals[CURSORS].searchSteps;
+    printf("  search steps saved %lld (%.1f%%), speedup %.2fx, same pose and events: %s\n", saved,
+           totals[SEARCH_ALWAYS].searchSteps ? 100.0 * saved / totals[SEARCH_ALWAYS].searchSteps : 0.0,
+           (double) nanos[NO_CURSORS] / nanos[CURSORS], same ? "yes" : "NO");
+    return same;
+}
+
+static bool runRaptor(int frames) {
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return false;
+    }
+    string skeletonPath = getRaptorDir() + "raptor.skel";
+    spSkeletonData *skeletonData = readSkeletonData(atlas, skeletonPath.c_str(), true);
+    bool ok = skeletonData != NULL;
+    if (ok) {
+        ok = runCursors("raptor walk and roar", skeletonData, "walk", "roar", frames);
+        spSkeletonData_dispose(skeletonData);
+    }
+    spAtlas_dispose(atlas);
+    return ok;
+}
+
+/**
+ * Usage: cursor-bench [keys] [frames]
+ */
+int main(int argc, char **argv) {
+    int keys = argc > 1 ? atoi(argv[1]) : 600;
+    int frames = argc > 2 ? atoi(argv[2]) : 3000;
+    if (keys < 2) keys = 600;
+    if (frames <= 0) frames = 3000;
+
+    spSkeletonData *skeletonData = createKeyedSkeletonData(keys);
+    char name[64];
+    snprintf(name, sizeof(name), "%d bones and %d slots, %d keys per timeline", BONES, SLOTS, keys);
+    bool ok = runCursors(name, skeletonData, "sway", "wave", frames);
+    spSkeletonData_dispose(skeletonData);
+    ok = runRaptor(frames) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#define REFERENCE_SIZE 19
+#define PROBES 257
+
+/**
+ * The curve layout the runtime had before: a type and 9 forward differenced points for every
+ * frame, linear or not, and a scan for the first point at or past the percent
+ */
+struct ReferenceCurve {
+    float curves[REFERENCE_SIZE];
+};
+
+static void referenceSetCurve(ReferenceCurve *curve, float cx1, float cy1, float cx2, float cy2) {
+    float tmpx = (-cx1 * 2 + cx2) * 0.03f, tmpy = (-cy1 * 2 + cy2) * 0.03f;
+    float dddfx = ((cx1 - cx2) * 3 + 1) * 0.006f, dddfy = ((cy1 - cy2) * 3 + 1) * 0.006f;
+    float ddfx = tmpx * 2 + dddfx, ddfy = tmpy * 2 + dddfy;
+    float dfx = cx1 * 0.3f + tmpx + dddfx * 0.16666667f;
+    float dfy = cy1 * 0.3f + tmpy + dddfy * 0.16666667f;
+    float x = dfx, y = dfy;
+    curve->curves[0] = 2; // Bezier
+    for (int i = 1; i < REFERENCE_SIZE; i += 2) {
+        curve->curves[i] = x;
+        curve->curves[i + 1] = y;
+        dfx += ddfx;
+        dfy += ddfy;
+        ddfx += dddfx;
+        ddfy += dddfy;
+        x += dfx;
+        y += dfy;
+    }
+}
+
+static float referenceCurvePercent(const ReferenceCurve *curve, float percent) {
+    const float *curves = curve->curves;
+    percent = fminf(fmaxf(percent, 0), 1);
+    float x = 0;
+    int i = 1;
+    for (; i < REFERENCE_SIZE - 1; i += 2) {
+        x = curves[i];
+        if (x >= percent) {
+            float prevX = i == 1 ? 0 : curves[i - 2], prevY = i == 1 ? 0 : curves[i - 1];
+            return prevY + (curves[i + 1] - prevY) * (percent - prevX) / (x - prevX);
+        }
+    }
+    float y = curves[i - 1];
+    return y + (1 - y) * (percent - x) / (1 - x);
+}
+
+/**
+ * The Bezier curve itself at x, solving x(t) by bisection
+ */
+static float exactCurvePercent(const float *handles, float x) {
+    double low = 0, high = 1, t = 0.5;
+    for (int i = 0; i < 60; ++i) {
+        t = (low + high) / 2;
+        double u = 1 - t;
+        double curveX = 3 * u * u * t * handles[0] + 3 * u * t * t * handles[2] + t * t * t;
+        if (curveX < x) low = t;
+        else high = t;
+    }
+    double u = 1 - t;
+    return (float) (3 * u * u * t * handles[1] + 3 * u * t * t * handles[3] + t * t * t);
+}
+
+/**
+ * Bytes of the curves of a timeline, as stored now and with the previous layout
+ */
+static void countCurveBytes(const spCurveTimeline *timeline, size_t *bytes,
+                            size_t *referenceBytes) {
+    *bytes += timeline->curvesCount * sizeof(int) +
+              timeline->bezierCurvesCapacity * 18 * sizeof(float);
+    *referenceBytes += timeline->curvesCount * REFERENCE_SIZE * sizeof(float);
+}
+
+/**
+ * Curve storage of every curve timeline of a skeleton data
+ */
+static bool reportSkeletonData(const char *name, spSkeletonData *skeletonData) {
+    size_t bytes = 0, referenceBytes = 0;
+    int counts[3] = {0, 0, 0}; // Linear, stepped, Bezier
+    for (int i = 0; i < skeletonData->animationsCount; ++i) {
+        spAnimation *animation = skeletonData->animations[i];
+        for (int j = 0; j < animation->timelinesCount; ++j) {
+            spTimeline *timeline = animation->timelines[j];
+            if (timeline->type == SP_TIMELINE_ATTACHMENT || timeline->type == SP_TIMELINE_EVENT ||
+                timeline->type == SP_TIMELINE_DRAWORDER) {
+                continue;
+            }
+            spCurveTimeline *curveTimeline = (spCurveTimeline *) timeline;
+            countCurveBytes(curveTimeline, &bytes, &referenceBytes);
+            for (int k = 0; k < curveTimeline->curvesCount; ++k) {
+                int curve = curveTimeline->curves[k];
+                counts[curve > 0 ? 2 : -curve]++;
+            }
+        }
+    }
+    printf("%s: %d linear, %d stepped, %d Bezier frames, curves %zu bytes, previously %zu "
+           "bytes (%.1f%%)\n", name, counts[0], counts[1], counts[2], bytes, referenceBytes,
+           referenceBytes ? 100.0 * bytes / referenceBytes : 0.0);
+    return bytes <= referenceBytes;
+}
+
+/**
+ * Random Bezier curves evaluated through a timeline and through the previous layout: same
+ * results, fewer nanoseconds
+ */
+static bool runEvaluation(int curves, int evaluations) {
+    spRotateTimeline *timeline = spRotateTimeline_create(curves + 1);
+    vector<ReferenceCurve> references((size_t) curves);
+    vector<float> handles((size_t) curves * 4);
+    srand(1);
+    for (int i = 0; i < curves; ++i) {
+        float *h = &handles[i * 4];
+        h[0] = rand() / (float) RAND_MAX;
+        h[1] = rand() / (float) RAND_MAX * 1.4f - 0.2f; // Some overshoot
+        h[2] = rand() / (float) RAND_MAX;
+        h[3] = rand() / (float) RAND_MAX * 1.4f - 0.2f;
+        spCurveTimeline_setCurve(SUPER(timeline), i, h[0], h[1], h[2], h[3]);
+        referenceSetCurve(&references[i], h[0], h[1], h[2], h[3]);
+    }
+
+    // Accuracy: against the previous evaluation bit for bit, against the curve itself
+    bool same = true;
+    float maxError = 0, referenceMaxError = 0;
+    for (int i = 0; i < curves; ++i) {
+        for (int k = 0; k < PROBES; ++k) {
+            float percent = k / (float) (PROBES - 1);
+            float value = spCurveTimeline_getCurvePercent(SUPER(timeline), i, percent);
+            float reference = referenceCurvePercent(&references[i], percent);
+            float exact = exactCurvePercent(&handles[i * 4], percent);
+            same = same && memcmp(&value, &reference, sizeof(value)) == 0;
+            maxError = fmaxf(maxError, fabsf(value - exact));
+            referenceMaxError = fmaxf(referenceMaxError, fabsf(reference - exact));
+        }
+    }
+
+    // Speed: percents moving forward a little every frame, as when playing, and random ones
+    vector<float> percents((size_t) evaluations);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < evaluations; ++i) {
+            percents[i] = pass == 0 ? fmodf(i / 60.0f / 0.4f, 1) : rand() / (float) RAND_MAX;
+        }
+        StageTimer timer;
+        float sum = 0, referenceSum = 0;
+        timer.start();
+        for (int i = 0; i < evaluations; ++i) {
+            referenceSum += referenceCurvePercent(&references[(i >> 4) % curves], percents[i]);
+        }
+        long long referenceNanos = timer.elapsedNanos();
+        timer.start();
+        for (int i = 0; i < evaluations; ++i) {
+            sum += spCurveTimeline_getCurvePercent(SUPER(timeline), (i >> 4) % curves, percents[i]);
+        }
+        long long nanos = timer.elapsedNanos();
+        printf("  %-8s percents: previous %6.2f ns, now %6.2f ns, speedup %5.2fx\n",
+               pass == 0 ? "playing" : "random", (double) referenceNanos / evaluations,
+               (double) nanos / evaluations, (double) referenceNanos / nanos);
+        same = same && sum == referenceSum;
+    }
+    printf("  max error against the curve %.5f, previously %.5f, same results: %s\n", maxError,
+           referenceMaxError, same ? "yes" : "NO");
+
+    size_t bytes = 0, referenceBytes = 0;
+    countCurveBytes(SUPER(timeline), &bytes, &referenceBytes);
+    printf("  %d Bezier frames: %zu bytes, previously %zu bytes\n", curves, bytes, referenceBytes);
+
+    spTimeline_dispose(SUPER(SUPER(timeline)));
+    return same && bytes <= referenceBytes;
+}
+
+/**
+ * Usage: curve-bench [curves] [evaluations]
+ */
+/**
+ * A frame switched between Bezier, linear and stepped again and again, as an editor might: the
+ * Bezier points must land in the buffer and the last setting must win
+ */
+static bool runResets() {
+    spRotateTimeline *timeline = spRotateTimeline_create(2);
+    spCurveTimeline *curve = SUPER(timeline);
+    ReferenceCurve reference;
+    bool same = true;
+    for (int i = 0; i < 16; ++i) {
+        float cy = 0.1f * (i % 10);
+        spCurveTimeline_setCurve(curve, 0, 0.25f, cy, 0.75f, 1 - cy);
+        if (i % 2) spCurveTimeline_setLinear(curve, 0);
+        else spCurveTimeline_setStepped(curve, 0);
+        spCurveTimeline_setCurve(curve, 0, 0.25f, cy, 0.75f, 1 - cy);
+        referenceSetCurve(&reference, 0.25f, cy, 0.75f, 1 - cy);
+        for (int k = 0; k < PROBES; ++k) {
+            float percent = k / (float) (PROBES - 1);
+            if (spCurveTimeline_getCurvePercent(curve, 0, percent) !=
+                referenceCurvePercent(&reference, percent)) {
+                same = false;
+            }
+        }
+    }
+    spCurveTimeline_setLinear(curve, 0);
+    same = same && spCurveTimeline_getCurvePercent(curve, 0, 0.3f) == 0.3f;
+    printf("Bezier, linear and stepped set over one frame 16 times: %d Bezier slots, same "
+           "curves: %s\n", curve->bezierCurvesCount, same ? "yes" : "NO");
+    spTimeline_dispose(SUPER(curve));
+    return same;
+}
+
+int main(int argc, char **argv) {
+    int curves = argc > 1 ? atoi(argv[1]) : 1024;
+    int evaluations = argc > 2 ? atoi(argv[2]) : 4000000;
+    if (curves <= 0) curves = 1024;
+    if (evaluations <= 0) evaluations = 4000000;
+
+    printf("%d random Bezier curves, %d evaluations\n", curves, evaluations);
+    bool ok = runEvaluation(curves, evaluations);
+    ok = runResets() && ok;
+
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return 1;
+    }
+    const char *files[] = {"raptor.skel", "raptor.json"};
+    for (int i = 0; i < 2; ++i) {
+        string skeletonPath = getRaptorDir() + files[i];
+        spSkeletonData *skeletonData = readSkeletonData(atlas, skeletonPath.c_str(), i == 0);
+        if (!skeletonData) {
+            ok = false;
+            continue;
+        }
+        ok = reportSkeletonData(files[i], skeletonData) && ok;
+        spSkeletonData_dispose(skeletonData);
+    }
+    spAtlas_dispose(atlas);
+    printf("curves match the previous layout: %s\n", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+#include "BenchUtils.h"
+#include <RenderCommands.h>
+#include <VertexFlipbook.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#define CONFIGS 4
+
+/**
+ * Caller-owned render command buffers, grown the same way Sticker::reserveRenderCommands does
+ */
+struct RenderCommandStorage {
+    vector<PackedVertex> vertices;
+    vector<uint16_t> indices;
+    vector<RenderCommand> commands;
+    RenderCommandList<PackedVertex> list;
+
+    RenderCommandStorage() {
+        reserve(2048, 4096, 16);
+    }
+
+    void reserve(int vertexCapacity, int indexCapacity, int commandCapacity) {
+        vertices.resize((size_t) vertexCapacity);
+        indices.resize((size_t) indexCapacity);
+        commands.resize((size_t) commandCapacity);
+        list.vertices = &vertices[0];
+        list.indices = &indices[0];
+        list.indexCapacity = indexCapacity;
+        list.vertexCapacity = vertexCapacity;
+        list.commands = &commands[0];
+        list.commandCapacity = commandCapacity;
+    }
+
+    void build(RenderCommandBuilder<PackedVertex> *builder, const spSkeleton *skeleton) {
+        builder->build(skeleton, &list);
+        while (list.overflow) {
+            reserve(list.vertexCapacity * 2, list.indexCapacity * 2, list.commandCapacity * 2);
+            builder->build(skeleton, &list);
+        }
+    }
+
+    void play(const VertexFlipbook *flipbook, float time, bool interpolate) {
+        flipbook->play(time, interpolate, &list);
+        while (list.overflow) {
+            reserve(list.vertexCapacity * 2, list.indexCapacity * 2, list.commandCapacity * 2);
+            flipbook->play(time, interpolate, &list);
+        }
+    }
+};
+
+struct FlipbookConfig {
+    float frameRate;
+    bool quantized;
+};
+
+/**
+ * Compare two command lists. Commands, indices and texture coordinates must match exactly,
+ * colors too when checkColors is set.
+ *
+ * @param positionError largest position difference, raised to it
+ * @return false if the lists do not draw the same attachments
+ */
+static bool compareLists(const RenderCommandList<PackedVertex> *expected,
+                         const RenderCommandList<PackedVertex> *actual, bool checkColors,
+                         float *positionError) {
+    if (expected->vertexCount != actual->vertexCount ||
+        expected->indexCount != actual->indexCount ||
+        expected->commandCount != actual->commandCount) {
+        return false;
+    }
+    for (int i = 0; i < expected->commandCount; ++i) {
+        const RenderCommand *e = expected->commands + i, *a = actual->commands + i;
+        if (e->vertexStart != a->vertexStart || e->vertexCount != a->vertexCount ||
+            e->indexStart != a->indexStart || e->indexCount != a->indexCount ||
+            e->page != a->page || e->blendMode != a->blendMode) {
+            return false;
+        }
+    }
+    size_t indexBytes = expected->indexCount * sizeof(uint16_t);
+    if (memcmp(expected->indices, actual->indices, indexBytes) != 0) return false;
+    for (int i = 0; i < expected->vertexCount; ++i) {
+        const PackedVertex *e = expected->vertices + i, *a = actual->vertices + i;
+        if (e->u != a->u || e->v != a->v) return false;
+        if (checkColors && (e->r != a->r || e->g != a->g || e->b != a->b || e->a != a->a)) {
+            return false;
+        }
+        *positionError = fmaxf(*positionError, fmaxf(fabsf(e->x - a->x), fabsf(e->y - a->y)));
+    }
+    return true;
+}
+
+/**
+ * Build the live render commands of the animation at a time, posed from the setup pose
+ */
+static void buildLive(spSkeleton *skeleton, spAnimation *animation,
+                      RenderCommandBuilder<PackedVertex> *builder, RenderCommandStorage *storage,
+                      float time) {
+    spSkeleton_setToSetupPose(skeleton);
+    spAnimation_apply(animation, skeleton, time, time, 1, NULL, NULL, 1.0f, SP_MIX_POSE_SETUP,
+                      SP_MIX_DIRECTION_IN);
+    spSkeleton_updateWorldTransform(skeleton);
+    storage->build(builder, skeleton);
+}
+
+/**
+ * Live evaluation, an animation state applied, world transforms updated and render commands
+ * built every frame, against flipbooks of float and int16 frames
+ */
+static bool runFlipbook(spSkeletonData *skeletonData, const char *animationName, int frames) {
+    const FlipbookConfig configs[CONFIGS] = {{30, false}, {30, true}, {60, false}, {60, true}};
+    spAnimation *animation = spSkeletonData_findAnimation(skeletonData, animationName);
+    if (!animation) {
+        fprintf(stderr, "Animation %s not found\n", animationName);
+        return false;
+    }
+    spSkeleton *skeleton = spSkeleton_create(skeletonData);
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    spAnimationState *state = spAnimationState_create(stateData);
+    spAnimationState_setAnimation(state, 0, animation, 1);
+    spSkeleton_setToSetupPose(skeleton);
+    RenderCommandBuilder<PackedVertex> builder;
+    RenderCommandStorage live, played;
+
+    StageTimer timer;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    long long liveNanos = 0;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        timer.start();
+        spAnimationState_update(state, deltaTime);
+        spAnimationState_apply(state, skeleton);
+        spSkeleton_updateWorldTransform(skeleton);
+        live.build(&builder, skeleton);
+        long long elapsed = timer.elapsedNanos();
+        // The first 10% of the frames only warm up caches
+        if (frame >= 0) liveNanos += elapsed;
+    }
+    printf("%s: %d vertices, %d commands, %.2f s, %d frames\n", animationName,
+           live.list.vertexCount, live.list.commandCount, animation->duration, frames);
+    printf("  %-12s %8.1f ns/frame\n", "live", (double) liveNanos / frames);
+
+    bool ok = true;
+    for (int i = 0; i < CONFIGS; ++i) {
+        const FlipbookConfig &config = configs[i];
+        VertexFlipbook flipbook;
+        timer.start();
+        flipbook.bake(skeleton, animation, &builder, config.frameRate, DEFAULT_FLIPBOOK_BUDGET,
+                      config.quantized);
+        long long bakeNanos = timer.elapsedNanos();
+        if (!flipbook.isBaked()) {
+            printf("  %3.0f fps %s: over the default budget\n", config.frameRate,
+                   config.quantized ? "int16" : "float");
+            ok = false;
+            continue;
+        }
+
+        long long playNanos = 0;
+        for (int frame = -frames / 10; frame < frames; ++frame) {
+            timer.start();
+            played.play(&flipbook, frame * deltaTime, true);
+            long long elapsed = timer.elapsedNanos();
+            if (frame >= 0) playNanos += elapsed;
+        }
+
+        // At the frame times the flipbook gives back what was built, then halfway between them
+        float frameError = 0.0f, middleError = 0.0f;
+        int snapped = 0;
+        bool exact = true;
+        for (int frame = 0; frame < flipbook.getFrameCount(); ++frame) {
+            float time = frame / config.frameRate;
+            buildLive(skeleton, animation, &builder, &live, time);
+            played.play(&flipbook, time, true);
+            exact = exact && compareLists(&live.list, &played.list, true, &frameError);
+
+            time = fminf((frame + 0.5f) / config.frameRate, animation->duration);
+            buildLive(skeleton, animation, &builder, &live, time);
+            played.play(&flipbook, time, true);
+            if (!compareLists(&live.list, &played.list, false, &middleError)) snapped++;
+        }
+        float quantizationError = flipbook.getQuantizationError();
+        printf("  %3.0f fps %s %8.1f ns/frame, speedup %5.2fx, baked in %.2f ms, %d topologies, "
+               "%8zu bytes, %7.0f bytes/s, error %.4f units at frames (%.4f allowed), %.3f "
+               "between, %d snapped\n", config.frameRate, config.quantized ? "int16" : "float",
+               (double) playNanos / frames, (double) liveNanos / playNanos, bakeNanos / 1e6,
+               flipbook.getTopologyCount(), flipbook.getByteCount(), flipbook.getBytesPerSecond(),
+               frameError, quantizationError, middleError, snapped);
+        // Float frames are exact, int16 frames within half a quantization step plus float rounding
+        ok = ok && exact && frameError <= quantizationError * 1.01f + 1e-4f;
+
+        // One byte short of what the frames need: the bake gives up and keeps nothing
+        VertexFlipbook small;
+        bool fits = small.bake(skeleton, animation, &builder, config.frameRate,
+                               flipbook.getByteCount() - 1, config.quantized);
+        ok = ok && !fits && !small.isBaked() && small.getByteCount() == 0;
+    }
+    printf("  flipbook matches live: %s\n", ok ? "yes" : "NO");
+
+    spAnimationState_dispose(state);
+    spAnimationStateData_dispose(stateData);
+    spSkeleton_dispose(skeleton);
+    return ok;
+}
+
+/**
+ * Usage: flipbook-bench [frames] [animation]
+ */
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 3000;
+    const char *animationName = argc > 2 ? argv[2] : "walk";
+    if (frames <= 0) frames = 3000;
+
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return 1;
+    }
+    string skeletonPath = getRaptorDir() + "raptor.skel";
+    spSkeletonData *skeletonData = readSkeletonData(atlas, skeletonPath.c_str(), true);
+    bool ok = skeletonData != NULL;
+    if (ok) {
+        ok = runFlipbook(skeletonData, animationName, frames);
+        spSkeletonData_dispose(skeletonData);
+    }
+    spAtlas_dispose(atlas);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,302 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+
+using namespace std;
+
+#define STEP_TIMES 256
+#define MIX_DURATION 0.25f
+#define BAKED_DURATION 4.0f
+#define BAKED_RATE 30.0f
+
+/**
+ * Timelines keeping a frames array of time and values per key, the ones that get compacted
+ */
+static bool isKeyframeTimeline(const spTimeline *timeline) {
+    return timeline->type != SP_TIMELINE_ATTACHMENT && timeline->type != SP_TIMELINE_EVENT &&
+           timeline->type != SP_TIMELINE_DRAWORDER && timeline->type != SP_TIMELINE_DEFORM;
+}
+
+/**
+ * Keyframe bytes of an animation, the interleaved floats or the compact keyframes. Key times
+ * shared by compact keyframes count once.
+ */
+static size_t countKeyframeBytes(const spAnimation *animation) {
+    set<const float *> times;
+    size_t bytes = 0;
+    for (int i = 0; i < animation->timelinesCount; ++i) {
+        if (!isKeyframeTimeline(animation->timelines[i])) continue;
+        const spBaseTimeline *timeline = (const spBaseTimeline *) animation->timelines[i];
+        const spCompactKeyframes *keyframes = timeline->keyframes;
+        if (!keyframes) {
+            bytes += timeline->framesCount * sizeof(float);
+            continue;
+        }
+        size_t values = (size_t) keyframes->keysCount * keyframes->valuesCount;
+        bytes += sizeof(spCompactKeyframes);
+        if (times.insert(keyframes->times).second) {
+            bytes += sizeof(int) + keyframes->keysCount * sizeof(float); // Reference count
+        }
+        if (keyframes->colors) {
+            bytes += values * sizeof(unsigned char);
+        } else {
+            bytes += keyframes->valuesCount * 2 * sizeof(float) + values * sizeof(unsigned short);
+        }
+    }
+    return bytes;
+}
+
+static size_t countKeyframeBytes(const spSkeletonData *skeletonData) {
+    size_t bytes = 0;
+    for (int i = 0; i < skeletonData->animationsCount; ++i) {
+        bytes += countKeyframeBytes(skeletonData->animations[i]);
+    }
+    return bytes;
+}
+
+/**
+ * Rotation, translation and scale of every bone keyed BAKED_RATE times a second, like motion
+ * baked on export
+ */
+static spAnimation *createBakedAnimation(const spSkeletonData *skeletonData) {
+    int keys = (int) (BAKED_DURATION * BAKED_RATE) + 1;
+    spAnimation *animation = spAnimation_create("baked", skeletonData->bonesCount * 3);
+    animation->duration = BAKED_DURATION;
+    for (int i = 0; i < skeletonData->bonesCount; ++i) {
+        spRotateTimeline *rotate = spRotateTimeline_create(keys);
+        spTranslateTimeline *translate = spTranslateTimeline_create(keys);
+        spScaleTimeline *scale = spScaleTimeline_create(keys);
+        rotate->boneIndex = translate->boneIndex = scale->boneIndex = i;
+        for (int k = 0; k < keys; ++k) {
+            float time = k / BAKED_RATE;
+            float phase = 2 * (float) M_PI * time / BAKED_DURATION + i;
+            spRotateTimeline_setFrame(rotate, k, time, 30 * sinf(phase));
+            spTranslateTimeline_setFrame(translate, k, time, 10 * sinf(phase),
+                                         5 * cosf(phase));
+            spScaleTimeline_setFrame(scale, k, time, 1 + 0.1f * sinf(phase), 1);
+        }
+        animation->timelines[i * 3] = (spTimeline *) rotate;
+        animation->timelines[i * 3 + 1] = (spTimeline *) translate;
+        animation->timelines[i * 3 + 2] = (spTimeline *) scale;
+    }
+    return animation;
+}
+
+static spSkeletonData *readCompactSkeletonData(spAtlas *atlas, const char *path, bool binary) {
+    spSkeletonData *skeletonData;
+    if (binary) {
+        spSkeletonBinary *reader = spSkeletonBinary_create(atlas);
+        reader->compactKeyframes = 1;
+        skeletonData = spSkeletonBinary_readSkeletonDataFile(reader, path);
+        spSkeletonBinary_dispose(reader);
+    } else {
+        spSkeletonJson *reader = spSkeletonJson_create(atlas);
+        reader->compactKeyframes = 1;
+        skeletonData = spSkeletonJson_readSkeletonDataFile(reader, path);
+        spSkeletonJson_dispose(reader);
+    }
+    if (!skeletonData) fprintf(stderr, "Read %s compacted: FAILED\n", path);
+    return skeletonData;
+}
+
+/**
+ * Largest world transform difference between two posed skeletons, and whether the slots show
+ * the same colors and attachments
+ */
+static bool comparePoses(const spSkeleton *expected, const spSkeleton *actual, float *error) {
+    for (int i = 0; i < expected->bonesCount; ++i) {
+        const spBone *e = expected->bones[i], *a = actual->bones[i];
+        float differences[] = {e->a - a->a, e->b - a->b, e->c - a->c, e->d - a->d,
+                               e->worldX - a->worldX, e->worldY - a->worldY};
+        for (int k = 0; k < 6; ++k) *error = fmaxf(*error, fabsf(differences[k]));
+    }
+    for (int i = 0; i < expected->slotsCount; ++i) {
+        const spSlot *e = expected->drawOrder[i], *a = actual->drawOrder[i];
+        if (e->data->index != a->data->index) return false;
+        // Attachments of two skeleton datas, the same when their names match
+        if ((e->attachment == NULL) != (a->attachment == NULL)) return false;
+        if (e->attachment && strcmp(e->attachment->name, a->attachment->name) != 0) return false;
+        if (memcmp(&e->color, &a->color, sizeof(spColor)) != 0) return false;
+        if ((e->darkColor == NULL) != (a->darkColor == NULL)) return false;
+        if (e->darkColor && memcmp(e->darkColor, a->darkColor, sizeof(spColor)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * An animation posed at 120 times from the setup pose
+ */
+static bool comparePoses(spSkeleton *expected, spSkeleton *actual, spAnimation *e,
+                         spAnimation *a, float *error) {
+    bool same = true;
+    for (int k = 0; k <= 120; ++k) {
+        float time = e->duration * k / 120;
+        spSkeleton_setToSetupPose(expected);
+        spSkeleton_setToSetupPose(actual);
+        spAnimation_apply(e, expected, time, time, 1, NULL, NULL, 1, SP_MIX_POSE_SETUP,
+                          SP_MIX_DIRECTION_IN);
+        spAnimation_apply(a, actual, time, time, 1, NULL, NULL, 1, SP_MIX_POSE_SETUP,
+                          SP_MIX_DIRECTION_IN);
+        spSkeleton_updateWorldTransform(expected);
+        spSkeleton_updateWorldTransform(actual);
+        same = comparePoses(expected, actual, error) && same;
+    }
+    return same;
+}
+
+/**
+ * Every animation posed at 120 times from the setup pose, then crossfaded from the previous one
+ * through an animation state so the rotation mixing reads compact keys too
+ */
+static bool compareAnimations(spSkeletonData *full, spSkeletonData *compact, float *error) {
+    spSkeleton *expected = spSkeleton_create(full);
+    spSkeleton *actual = spSkeleton_create(compact);
+    bool same = true;
+    for (int i = 0; i < full->animationsCount; ++i) {
+        spAnimation *e = full->animations[i], *a = compact->animations[i];
+        same = comparePoses(expected, actual, e, a, error) && same;
+
+        float times[STEP_TIMES], compactTimes[STEP_TIMES];
+        int count = _spAnimation_getStepTimes(e, times, STEP_TIMES);
+        int compactCount = _spAnimation_getStepTimes(a, compactTimes, STEP_TIMES);
+        same = same && count == compactCount &&
+               memcmp(times, compactTimes, MIN(count, STEP_TIMES) * sizeof(float)) == 0;
+    }
+
+    spAnimationStateData *expectedData = spAnimationStateData_create(full);
+    spAnimationStateData *actualData = spAnimationStateData_create(compact);
+    expectedData->defaultMix = actualData->defaultMix = MIX_DURATION;
+    spAnimationState *expectedState = spAnimationState_create(expectedData);
+    spAnimationState *actualState = spAnimationState_create(actualData);
+    spSkeleton_setToSetupPose(expected);
+    spSkeleton_setToSetupPose(actual);
+    for (int i = 0; i < full->animationsCount; ++i) {
+        spAnimationState_setAnimation(expectedState, 0, full->animations[i], 1);
+        spAnimationState_setAnimation(actualState, 0, compact->animations[i], 1);
+        for (int k = 0; k < 60; ++k) {
+            spAnimationState_update(expectedState, FIXED_FRAME_MILLIS / 1000.0f);
+            spAnimationState_update(actualState, FIXED_FRAME_MILLIS / 1000.0f);
+            spAnimationState_apply(expectedState, expected);
+            spAnimationState_apply(actualState, actual);
+            spSkeleton_updateWorldTransform(expected);
+            spSkeleton_updateWorldTransform(actual);
+            same = comparePoses(expected, actual, error) && same;
+        }
+    }
+    spAnimationState_dispose(expectedState);
+    spAnimationState_dispose(actualState);
+    spAnimationStateData_dispose(expectedData);
+    spAnimationStateData_dispose(actualData);
+    spSkeleton_dispose(expected);
+    spSkeleton_dispose(actual);
+    return same;
+}
+
+/**
+ * Animation state applied every frame, without updating world transforms
+ */
+static long long timeApply(spSkeletonData *skeletonData, spAnimation *animation, int frames) {
+    if (!animation) return 0;
+    spSkeleton *skeleton = spSkeleton_create(skeletonData);
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    spAnimationState *state = spAnimationState_create(stateData);
+    spAnimationState_setAnimation(state, 0, animation, 1);
+    StageTimer timer;
+    long long nanos = 0;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        spAnimationState_update(state, FIXED_FRAME_MILLIS / 1000.0f);
+        timer.start();
+        spAnimationState_apply(state, skeleton);
+        long long elapsed = timer.elapsedNanos();
+        // The first 10% of the frames only warm up caches
+        if (frame >= 0) nanos += elapsed;
+    }
+    spAnimationState_dispose(state);
+    spAnimationStateData_dispose(stateData);
+    spSkeleton_dispose(skeleton);
+    return nanos;
+}
+
+/**
+ * Dense baked keys, where the 16 bit values pay off most, compacted through
+ * spAnimation_compactKeyframes on the raptor bones
+ */
+static bool runBaked(spSkeletonData *skeletonData, int frames) {
+    spAnimation *full = createBakedAnimation(skeletonData);
+    spAnimation *compact = createBakedAnimation(skeletonData);
+    spAnimation_compactKeyframes(compact);
+    size_t bytes = countKeyframeBytes(full), compactBytes = countKeyframeBytes(compact);
+
+    spSkeleton *expected = spSkeleton_create(skeletonData);
+    spSkeleton *actual = spSkeleton_create(skeletonData);
+    float error = 0;
+    bool same = comparePoses(expected, actual, full, compact, &error);
+    spSkeleton_dispose(expected);
+    spSkeleton_dispose(actual);
+    long long nanos = timeApply(skeletonData, full, frames);
+    long long compactNanos = timeApply(skeletonData, compact, frames);
+
+    printf("baked, %d bones keyed %.0f times a second: keyframes %zu bytes, compacted %zu "
+           "bytes (%.1f%%)\n", skeletonData->bonesCount, BAKED_RATE, bytes, compactBytes,
+           100.0 * compactBytes / bytes);
+    printf("  apply %8.1f ns/frame, compacted %8.1f ns/frame, max world transform error %.5f\n",
+           (double) nanos / frames, (double) compactNanos / frames, error);
+    spAnimation_dispose(full);
+    spAnimation_dispose(compact);
+    return same && compactBytes * 2 < bytes && error < 0.05f;
+}
+
+/**
+ * Usage: keyframe-bench [frames] [animation]
+ */
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 20000;
+    const char *animationName = argc > 2 ? argv[2] : "walk";
+    if (frames <= 0) frames = 20000;
+
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return 1;
+    }
+    bool ok = true;
+    const char *files[] = {"raptor.skel", "raptor.json"};
+    for (int i = 0; i < 2; ++i) {
+        string skeletonPath = getRaptorDir() + files[i];
+        spSkeletonData *full = readSkeletonData(atlas, skeletonPath.c_str(), i == 0);
+        spSkeletonData *compact = readCompactSkeletonData(atlas, skeletonPath.c_str(), i == 0);
+        if (!full || !compact) {
+            if (full) spSkeletonData_dispose(full);
+            if (compact) spSkeletonData_dispose(compact);
+            ok = false;
+            continue;
+        }
+        size_t bytes = countKeyframeBytes(full), compactBytes = countKeyframeBytes(compact);
+        float error = 0;
+        bool same = compareAnimations(full, compact, &error);
+        long long nanos = timeApply(full, spSkeletonData_findAnimation(full, animationName),
+                                    frames);
+        long long compactNanos = timeApply(
+                compact, spSkeletonData_findAnimation(compact, animationName), frames);
+        printf("%s: keyframes %zu bytes, compacted %zu bytes (%.1f%%)\n", files[i], bytes,
+               compactBytes, bytes ? 100.0 * compactBytes / bytes : 0.0);
+        printf("  %s apply %8.1f ns/frame, compacted %8.1f ns/frame\n", animationName,
+               (double) nanos / frames, (double) compactNanos / frames);
+        printf("  max world transform error %.5f, same colors, attachments and steps: %s\n",
+               error, same ? "yes" : "NO");
+        // Bone rotations and translations quantized to 1/65535 of their range
+        ok = ok && same && compactBytes < bytes && error < 0.05f;
+        if (i == 0) ok = runBaked(full, frames) && ok;
+        spSkeletonData_dispose(compact);
+        spSkeletonData_dispose(full);
+    }
+    spAtlas_dispose(atlas);
+    printf("compacted keyframes match: %s\n", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+#include "BenchUtils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define LOADS 3
+#define MISS_PERCENT 10
+
+/**
+ * Atlas of names 16x16 regions named region0, region1...
+ */
+static string createAtlasText(int names) {
+    string text = "names.png\nsize: 4096,4096\nformat: RGBA8888\nfilter: Linear,Linear\nrepeat: none\n";
+    char region[160];
+    for (int i = 0; i < names; ++i) {
+        snprintf(region, sizeof(region),
+                 "region%d\n  rotate: false\n  xy: %d, %d\n  size: 16, 16\n  orig: 16, 16\n"
+                 "  offset: 0, 0\n  index: -1\n", i, i % 256 * 16, i / 256 * 16);
+        text += region;
+    }
+    return text;
+}
+
+static bool writeFile(const string &path, const string &text) {
+    FILE *file = fopen(path.c_str(), "wb");
+    bool ok = file && fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (file) ok = fclose(file) == 0 && ok;
+    if (!ok) fprintf(stderr, "Write %s: FAILED\n", path.c_str());
+    return ok;
+}
+
+/**
+ * Skeleton of names bones in a binary tree, one slot with a region attachment per bone, names / 4
+ * events and names / 16 animations. The animations share the bones and slots out between them,
+ * so the loader looks up every bone and slot name once more per timeline.
+ */
+static string createSkeletonJson(int names) {
+    int events = names / 4 > 0 ? names / 4 : 1;
+    int animations = names / 16 > 0 ? names / 16 : 1;
+    string json = "{\"skeleton\":{\"hash\":\"name-bench\",\"spine\":\"3.6.53\"},\"bones\":[{\"name\":\"root\"}";
+    char item[256];
+    for (int i = 0; i < names; ++i) {
+        if (i == 0) {
+            snprintf(item, sizeof(item), ",{\"name\":\"bone0\",\"parent\":\"root\",\"length\":10}");
+        } else {
+            snprintf(item, sizeof(item), ",{\"name\":\"bone%d\",\"parent\":\"bone%d\",\"length\":10,"
+                                         "\"rotation\":%d}", i, (i - 1) / 2, i % 90);
+        }
+        json += item;
+    }
+    json += "],\"slots\":[";
+    for (int i = 0; i < names; ++i) {
+        snprintf(item, sizeof(item), "%s{\"name\":\"slot%d\",\"bone\":\"bone%d\",\"attachment\":\"region%d\"}",
+                 i ? "," : "", i, i, i);
+        json += item;
+    }
+    json += "],\"skins\":{\"default\":{";
+    for (int i = 0; i < names; ++i) {
+        snprintf(item, sizeof(item), "%s\"slot%d\":{\"region%d\":{\"width\":16,\"height\":16}}",
+                 i ? "," : "", i, i);
+        json += item;
+    }
+    json += "}},\"events\":{";
+    for (int i = 0; i < events; ++i) {
+        snprintf(item, sizeof(item), "%s\"event%d\":{\"int\":%d}", i ? "," : "", i, i);
+        json += item;
+    }
+    json += "},\"animations\":{";
+    for (int a = 0; a < animations; ++a) {
+        snprintf(item, sizeof(item), "%s\"animation%d\":{\"bones\":{", a ? "," : "", a);
+        json += item;
+        for (int i = a, first = 1; i < names; i += animations, first = 0) {
+            snprintf(item, sizeof(item), "%s\"bone%d\":{\"rotate\":[{\"time\":0,\"angle\":0},"
+                                         "{\"time\":1,\"angle\":30}]}", first ? "" : ",", i);
+            json += item;
+        }
+        json += "},\"slots\":{";
+        for (int i = a, first = 1; i < names; i += animations, first = 0) {
+            snprintf(item, sizeof(item), "%s\"slot%d\":{\"attachment\":[{\"time\":0,\"name\":\"region%d\"},"
+                                         "{\"time\":0.5,\"name\":null}]}", first ? "" : ",", i, i);
+            json += item;
+        }
+        snprintf(item, sizeof(item), "},\"events\":[{\"time\":0.5,\"name\":\"event%d\"}]}", a % events);
+        json += item;
+    }
+    json += "}}";
+    return json;
+}
+
+/*
+ * The linear scans the hashed lookups replaced, to time them and to check the hashed results
+ */
+
+static int linearBoneIndex(const spSkeletonData *data, const char *name) {
+    for (int i = 0; i < data->bonesCount; ++i) {
+        if (strcmp(data->bones[i]->name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static int linearSlotIndex(const spSkeletonData *data, const char *name) {
+    for (int i = 0; i < data->slotsCount; ++i) {
+        if (strcmp(data->slots[i]->name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static spAnimation *linearAnimation(const spSkeletonData *data, const char *name) {
+    for (int i = 0; i < data->animationsCount; ++i) {
+        if (strcmp(data->animations[i]->name, name) == 0) return data->animations[i];
+    }
+    return NULL;
+}
+
+static spEventData *linearEvent(const spSkeletonData *data, const char *name) {
+    for (int i = 0; i < data->eventsCount; ++i) {
+        if (strcmp(data->events[i]->name, name) == 0) return data->events[i];
+    }
+    return NULL;
+}
+
+static spAtlasRegion *linearRegion(const spAtlas *atlas, const char *name) {
+    for (spAtlasRegion *region = atlas->regions; region; region = region->next) {
+        if (strcmp(region->name, name) == 0) return region;
+    }
+    return NULL;
+}
+
+static spAttachment *linearAttachment(const spSkin *skin, int slotIndex, const char *name) {
+    for (const _Entry *entry = SUB_CAST(_spSkin, skin)->entries; entry; entry = entry->next) {
+        if (entry->slotIndex == slotIndex && strcmp(entry->name, name) == 0) return entry->attachment;
+    }
+    return NULL;
+}
+
+/**
+ * Lookup names: prefix followed by a random index below count, or a missing name for
+ * MISS_PERCENT of them
+ */
+static vector<string> createQueries(const char *prefix, int count, int lookups) {
+    vector<string> queries(lookups);
+    char name[64];
+    for (int i = 0; i < lookups; ++i) {
+        if (rand() % 100 < MISS_PERCENT) {
+            snprintf(name, sizeof(name), "missing%d", i);
+        } else {
+            snprintf(name, sizeof(name), "%s%d", prefix, rand() % count);
+        }
+        queries[i] = name;
+    }
+    return queries;
+}
+
+static unsigned long long checksum(const void *found) {
+    return (size_t) found;
+}
+
+/**
+ * Runs lookup for every query index
+ *
+ * @param sum sum of the lookup results, to compare the hashed lookups with the linear scans;
+ * unsigned so that summing pointers wraps around instead of overflowing
+ * @return nanoseconds per lookup
+ */
+template<typename Lookup>
+static double timeLookups(int lookups, Lookup lookup, unsigned long long *sum) {
+    StageTimer timer;
+    *sum = 0;
+    timer.start();
+    for (int i = 0; i < lookups; ++i) {
+        *sum += lookup(i);
+    }
+    return (double) timer.elapsedNanos() / lookups;
+}
+
+template<typename Hashed, typename Linear>
+static bool compareLookups(const char *name, int lookups, Hashed hashed, Linear linear) {
+    unsigned long long hashedSum, linearSum;
+    double hashedNanos = timeLookups(lookups, hashed, &hashedSum);
+    double linearNanos = timeLookups(lookups, linear, &linearSum);
+    printf("  %-34s hashed %8.1f ns, linear %10.1f ns, speedup %7.1fx%s\n", name, hashedNanos,
+           linearNanos, linearNanos / hashedNanos, hashedSum == linearSum ? "" : ", RESULTS DIFFER");
+    return hashedSum == linearSum;
+}
+
+/**
+ * Times each name based API against its linear scan over the same queries. The results must match.
+ */
+static bool runLookups(spAtlas *atlas, spSkeletonData *data, int lookups) {
+    spSkeleton *skeleton = spSkeleton_create(data);
+    spAnimationStateData *stateData = spAnimationStateData_create(data);
+    spSkin *skin = data->defaultSkin;
+    vector<string> bones = createQueries("bone", data->bonesCount - 1, lookups);
+    vector<string> slots = createQueries("slot", data->slotsCount, lookups);
+    vector<string> animations = createQueries("animation", data->animationsCount, lookups);
+    vector<string> events = createQueries("event", data->eventsCount, lookups);
+    vector<string> regions = createQueries("region", data->slotsCount, lookups);
+    // Each slot has the region of its own index in the skin, so this pairing finds most attachments
+    vector<string> attachments(lookups);
+    for (int i = 0; i < lookups; ++i) {
+        attachments[i] = slots[i].compare(0, 4, "slot") ? regions[i] : "region" + slots[i].substr(4);
+    }
+
+    printf("%d lookups, %d%% of them missing\n", lookups, MISS_PERCENT);
+    bool ok = compareLookups("spSkeletonData_findBoneIndex", lookups, [&](int i) {
+        return (unsigned long long) spSkeletonData_findBoneIndex(data, bones[i].c_str());
+    }, [&](int i) {
+        return (unsigned long long) linearBoneIndex(data, bones[i].c_str());
+    });
+    ok = compareLookups("spSkeleton_findBone", lookups, [&](int i) {
+        return checksum(spSkeleton_findBone(skeleton, bones[i].c_str()));
+    }, [&](int i) {
+        int index = linearBoneIndex(data, bones[i].c_str());
+        return checksum(index == -1 ? NULL : skeleton->bones[index]);
+    }) && ok;
+    ok = compareLookups("spSkeletonData_findSlotIndex", lookups, [&](int i) {
+        return (unsigned long long) spSkeletonData_findSlotIndex(data, slots[i].c_str());
+    }, [&](int i) {
+        return (unsigned long long) linearSlotIndex(data, slots[i].c_str());
+    }) && ok;
+    ok = compareLookups("spSkeletonData_findAnimation", lookups, [&](int i) {
+        return checksum(spSkeletonData_findAnimation(data, animations[i].c_str()));
+    }, [&](int i) {
+        return checksum(linearAnimation(data, animations[i].c_str()));
+    }) && ok;
+    ok = compareLookups("spSkeletonData_findEvent", lookups, [&](int i) {
+        return checksum(spSkeletonData_findEvent(data, events[i].c_str()));
+    }, [&](int i) {
+        return checksum(linearEvent(data, events[i].c_str()));
+    }) && ok;
+    ok = compareLookups("spAtlas_findRegion", lookups, [&](int i) {
+        return checksum(spAtlas_findRegion(atlas, regions[i].c_str()));
+    }, [&](int i) {
+        return checksum(linearRegion(atlas, regions[i].c_str()));
+    }) && ok;
+    ok = compareLookups("spSkeleton_setAttachment", lookups, [&](int i) {
+        int found = spSkeleton_setAttachment(skeleton, slots[i].c_str(), attachments[i].c_str());
+        return (unsigned long long) found;
+    }, [&](int i) {
+        int index = linearSlotIndex(data, slots[i].c_str());
+        spAttachment *attachment = index == -1 ? NULL : linearAttachment(skin, index, attachments[i].c_str());
+        if (attachment) spSlot_setAttachment(skeleton->slots[index], attachment);
+        return (unsigned long long) (attachment != NULL);
+    }) && ok;
+
+    // Mixes have no linear counterpart left, the durations are checked instead
+    StageTimer timer;
+    timer.start();
+    for (int i = 0; i < lookups; ++i) {
+        spAnimationStateData_setMixByName(stateData, animations[i].c_str(),
+                                          animations[lookups - 1 - i].c_str(), 0.2f);
+    }
+    printf("  %-34s hashed %8.1f ns\n", "spAnimationStateData_setMixByName",
+           (double) timer.elapsedNanos() / lookups);
+    for (int i = 0; i < lookups; ++i) {
+        spAnimation *from = linearAnimation(data, animations[i].c_str());
+        spAnimation *to = linearAnimation(data, animations[lookups - 1 - i].c_str());
+        if (from && to && spAnimationStateData_getMix(stateData, from, to) != 0.2f) ok = false;
+    }
+
+    printf("  hashed lookups match the linear scans: %s\n", ok ? "yes" : "NO");
+    spAnimationStateData_dispose(stateData);
+    spSkeleton_dispose(skeleton);
+    return ok;
+}
+
+/**
+ * Usage: name-bench [names] [lookups]
+ */
+int main(int argc, char **argv) {
+    int names = argc > 1 ? atoi(argv[1]) : 4000;
+    int lookups = argc > 2 ? atoi(argv[2]) : 100000;
+    if (names <= 0) names = 4000;
+    if (lookups <= 0) lookups = 100000;
+    srand(1);
+
+    // Loaded from files like the app does, which also times reading them
+    const char *tmpDir = getenv("TMPDIR");
+    string dir = string(tmpDir && *tmpDir ? tmpDir : "/tmp") + "/";
+    string atlasPath = dir + "name-bench.atlas", skeletonPath = dir + "name-bench.json";
+    string json = createSkeletonJson(names);
+    if (!writeFile(atlasPath, createAtlasText(names)) || !writeFile(skeletonPath, json)) return 1;
+
+    spAtlas *atlas = NULL;
+    spSkeletonData *skeletonData = NULL;
+    StageTimer timer;
+    long long atlasNanos = 0, skeletonNanos = 0;
+    for (int i = 0; i < LOADS && (i == 0 || skeletonData); ++i) {
+        if (skeletonData) spSkeletonData_dispose(skeletonData);
+        if (atlas) spAtlas_dispose(atlas);
+        timer.start();
+        atlas = spAtlas_createFromFile(atlasPath.c_str(), NULL);
+        atlasNanos += timer.elapsedNanos();
+        timer.start();
+        skeletonData = atlas ? readSkeletonData(atlas, skeletonPath.c_str(), false) : NULL;
+        skeletonNanos += timer.elapsedNanos();
+    }
+    remove(atlasPath.c_str());
+    remove(skeletonPath.c_str());
+    if (!skeletonData) {
+        if (atlas) spAtlas_dispose(atlas);
+        return 1;
+    }
+    printf("%d bones, %d slots and attachments, %d regions, %d events, %d animations (%zu KB of JSON)\n",
+           skeletonData->bonesCount, skeletonData->slotsCount, names, skeletonData->eventsCount,
+           skeletonData->animationsCount, json.size() / 1024);
+    printf("  %-34s %10.3f ms\n", "atlas load", atlasNanos / 1e6 / LOADS);
+    printf("  %-34s %10.3f ms\n", "skeleton load", skeletonNanos / 1e6 / LOADS);
+
+    bool ok = runLookups(atlas, skeletonData, lookups);
+    spSkeletonData_dispose(skeletonData);
+    spAtlas_dispose(atlas);
+    return ok ? 0 : 1;
+}
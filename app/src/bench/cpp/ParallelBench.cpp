@@ -0,0 +1,140 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#define LIMB_LENGTH 8
+#define MAX_THREADS 8
+
+/**
+ * Wide synthetic rig: a root and a body bone carrying independent limbs of LIMB_LENGTH bones,
+ * each ending in a two bone IK towards its own target. A transform constraint ties the first two
+ * limbs together so the groups are not all the same size.
+ */
+static spSkeletonData *createWideSkeletonData(int limbs) {
+    spSkeletonData *skeletonData = spSkeletonData_create();
+    skeletonData->bones = MALLOC(spBoneData *, 2 + limbs * (LIMB_LENGTH + 1));
+    skeletonData->ikConstraints = MALLOC(spIkConstraintData *, limbs);
+    skeletonData->transformConstraints = MALLOC(spTransformConstraintData *, 1);
+
+    spBoneData *root = addBone(skeletonData, "root", NULL, 0, 0, 10);
+    spBoneData *body = addBone(skeletonData, "body", root, 0, 90, 10);
+    char name[32];
+    for (int limb = 0; limb < limbs; ++limb) {
+        spBoneData *parent = body;
+        for (int i = 0; i < LIMB_LENGTH; ++i) {
+            snprintf(name, sizeof(name), "limb%d-%d", limb, i);
+            parent = addBone(skeletonData, name, parent, i ? 10 : 0,
+                             i ? 5 : 360.0f * limb / limbs, 10);
+        }
+        snprintf(name, sizeof(name), "target%d", limb);
+        spBoneData *target = addBone(skeletonData, name, body, 60, 360.0f * limb / limbs, 10);
+
+        snprintf(name, sizeof(name), "ik%d", limb);
+        spIkConstraintData *ik = spIkConstraintData_create(name);
+        ik->order = limb;
+        ik->bonesCount = 2;
+        ik->bones = MALLOC(spBoneData *, 2);
+        ik->bones[0] = skeletonData->bones[parent->index - 1];
+        ik->bones[1] = parent;
+        ik->target = target;
+        skeletonData->ikConstraints[skeletonData->ikConstraintsCount++] = ik;
+    }
+
+    if (limbs > 1) {
+        spTransformConstraintData *transform = spTransformConstraintData_create("tie");
+        transform->order = limbs;
+        transform->bonesCount = 1;
+        CONST_CAST(spBoneData **, transform->bones) = MALLOC(spBoneData *, 1);
+        transform->bones[0] = skeletonData->bones[2 + (LIMB_LENGTH + 1) + 2];
+        transform->target = skeletonData->bones[2 + 3];
+        transform->rotateMix = 0.5f;
+        transform->translateMix = 0.25f;
+        skeletonData->transformConstraints[skeletonData->transformConstraintsCount++] = transform;
+    }
+    return skeletonData;
+}
+
+static bool sameWorld(const spSkeleton *expected, const spSkeleton *actual) {
+    for (int i = 0; i < expected->bonesCount; ++i) {
+        const spBone *e = expected->bones[i], *a = actual->bones[i];
+        float ev[] = {e->a, e->b, e->c, e->d, e->worldX, e->worldY};
+        float av[] = {a->a, a->b, a->c, a->d, a->worldX, a->worldY};
+        if (memcmp(ev, av, sizeof(ev)) != 0) return false;
+    }
+    return true;
+}
+
+/**
+ * Serial spSkeleton_updateWorldTransform against the update graph on 1 to MAX_THREADS threads
+ */
+static bool runScaling(int limbs, int frames) {
+    spSkeletonData *skeletonData = createWideSkeletonData(limbs);
+    spSkeleton *serial = spSkeleton_create(skeletonData);
+    spSkeleton *parallel = spSkeleton_create(skeletonData);
+    StageTimer timer;
+    long long serialNanos = 0;
+    bool identical = true, exclusive = true;
+
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        swingBones(serial, frame * 0.016f, 2);
+        timer.start();
+        spSkeleton_updateWorldTransform(serial);
+        long long elapsed = timer.elapsedNanos();
+        if (frame >= 0) serialNanos += elapsed;
+    }
+    printf("wide skeleton: %d bones, %d IK constraints, %d frames, %u hardware threads\n",
+           serial->bonesCount, serial->ikConstraintsCount, frames,
+           std::thread::hardware_concurrency());
+    printf("  %-12s %9.1f ns/frame\n", "serial", (double) serialNanos / frames);
+
+    for (int threads = 1; threads <= MAX_THREADS; ++threads) {
+        spThreadPool *pool = spThreadPool_create(threads);
+        spSkeleton_setThreadPool(parallel, pool);
+        // The other update modes would silently replace the pool
+        exclusive = exclusive && !spSkeleton_setBatchedConstraints(parallel, 1) &&
+                    !spSkeleton_setIncrementalUpdate(parallel, 1);
+        long long nanos = 0;
+        for (int frame = -frames / 10; frame < frames; ++frame) {
+            float time = frame * 0.016f;
+            swingBones(parallel, time, 2);
+            timer.start();
+            spSkeleton_updateWorldTransform(parallel);
+            long long elapsed = timer.elapsedNanos();
+
+            // The first 10% of the frames only warm up caches and threads
+            if (frame < 0) continue;
+            nanos += elapsed;
+            swingBones(serial, time, 2);
+            spSkeleton_updateWorldTransform(serial);
+            identical = identical && sameWorld(serial, parallel);
+        }
+        char name[16];
+        snprintf(name, sizeof(name), "%d thread%s", threads, threads > 1 ? "s" : "");
+        printf("  %-12s %9.1f ns/frame, %d groups, speedup %.2fx\n", name, (double) nanos / frames,
+               spSkeleton_getUpdateGroupsCount(parallel), (double) serialNanos / nanos);
+        spSkeleton_setThreadPool(parallel, NULL);
+        spThreadPool_dispose(pool);
+    }
+    printf("  bit-identical to serial: %s\n", identical ? "yes" : "NO");
+    printf("  batched constraints and incremental update refused with a pool: %s\n",
+           exclusive ? "yes" : "NO");
+
+    spSkeleton_dispose(parallel);
+    spSkeleton_dispose(serial);
+    spSkeletonData_dispose(skeletonData);
+    return identical && exclusive;
+}
+
+/**
+ * Usage: parallel-bench [limbs] [frames]
+ */
+int main(int argc, char **argv) {
+    int limbs = argc > 1 ? atoi(argv[1]) : 64;
+    int frames = argc > 2 ? atoi(argv[2]) : 2000;
+    if (limbs <= 0) limbs = 64;
+    if (frames <= 0) frames = 2000;
+    return runScaling(limbs, frames) ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include "BenchUtils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SCENARIOS 3
+
+/**
+ * One path constraint case: how the bones follow the path and whether the path itself moves
+ */
+struct PathScenario {
+    const char *name;
+    spRotateMode rotateMode;
+    float offsetRotation;
+    bool movingPath;
+};
+
+/**
+ * Open, constant speed path of curves wavy Bezier curves attached to its own bone
+ */
+static spPathAttachment *createWavyPath(int curves) {
+    spPathAttachment *path = spPathAttachment_create("path");
+    spVertexAttachment *vertices = SUPER(path);
+    int points = curves + 1;
+    vertices->worldVerticesLength = vertices->verticesCount = points * 6;
+    vertices->vertices = MALLOC(float, vertices->verticesCount);
+    for (int i = 0; i < points; ++i) {
+        float x = i * 100.0f, y = i % 2 ? 40.0f : -40.0f;
+        float *point = vertices->vertices + i * 6;
+        // In handle, point, out handle
+        point[0] = x - 30;
+        point[1] = y;
+        point[2] = x;
+        point[3] = y;
+        point[4] = x + 30;
+        point[5] = y;
+    }
+    path->lengthsLength = points;
+    path->lengths = MALLOC(float, points);
+    for (int i = 0; i < points; ++i) path->lengths[i] = (i + 1) * 110.0f;
+    path->closed = 0;
+    path->constantSpeed = 1;
+    return path;
+}
+
+/**
+ * A tail of bones bones spaced along a path of curves curves
+ */
+static spSkeletonData *createTailSkeletonData(const PathScenario &scenario, int bones, int curves) {
+    spSkeletonData *skeletonData = spSkeletonData_create();
+    skeletonData->bones = MALLOC(spBoneData *, 2 + bones);
+    spBoneData *root = addBone(skeletonData, "root", NULL, 0, 0, 20);
+    spBoneData *pathBone = addBone(skeletonData, "path", root, 0, 0, 20);
+    spBoneData *parent = root;
+    char name[32];
+    for (int i = 0; i < bones; ++i) {
+        snprintf(name, sizeof(name), "tail%d", i);
+        parent = addBone(skeletonData, name, parent, i ? 20 : 0, 0, 20);
+    }
+
+    skeletonData->slotsCount = 1;
+    skeletonData->slots = MALLOC(spSlotData *, 1);
+    skeletonData->slots[0] = spSlotData_create(0, "path", pathBone);
+    spSlotData_setAttachmentName(skeletonData->slots[0], "path");
+    skeletonData->skinsCount = 1;
+    skeletonData->skins = MALLOC(spSkin *, 1);
+    skeletonData->skins[0] = skeletonData->defaultSkin = spSkin_create("default");
+    spSkin_addAttachment(skeletonData->defaultSkin, 0, "path", SUPER(SUPER(createWavyPath(curves))));
+
+    spPathConstraintData *constraint = spPathConstraintData_create("tail");
+    constraint->bonesCount = bones;
+    CONST_CAST(spBoneData **, constraint->bones) = MALLOC(spBoneData *, bones);
+    for (int i = 0; i < bones; ++i) constraint->bones[i] = skeletonData->bones[2 + i];
+    constraint->target = skeletonData->slots[0];
+    constraint->positionMode = SP_POSITION_MODE_PERCENT;
+    constraint->spacingMode = SP_SPACING_MODE_LENGTH;
+    constraint->rotateMode = scenario.rotateMode;
+    constraint->offsetRotation = scenario.offsetRotation;
+    constraint->rotateMix = 1;
+    constraint->translateMix = 1;
+    skeletonData->pathConstraintsCount = 1;
+    skeletonData->pathConstraints = MALLOC(spPathConstraintData *, 1);
+    skeletonData->pathConstraints[0] = constraint;
+    return skeletonData;
+}
+
+/**
+ * The tail slides along the path, which also swings around its bone for a moving path
+ */
+static void pose(spSkeleton *skeleton, const PathScenario &scenario, float time) {
+    skeleton->pathConstraints[0]->position = 0.3f * (1 + sinf(time));
+    if (scenario.movingPath) skeleton->bones[1]->rotation = 10 * sinf(time * 2);
+}
+
+/**
+ * Times the path constraint with its arc-length cache against a skeleton whose cache is dropped
+ * before every update, like the evaluation without the cache. Both must give the same bones.
+ */
+static bool runScenario(const PathScenario &scenario, int bones, int curves, int frames) {
+    spSkeletonData *skeletonData = createTailSkeletonData(scenario, bones, curves);
+    spSkeleton *cached = spSkeleton_create(skeletonData);
+    spSkeleton *cold = spSkeleton_create(skeletonData);
+    spSkeleton_setToSetupPose(cached);
+    spSkeleton_setToSetupPose(cold);
+    StageTimer timer;
+    long long cachedNanos = 0, coldNanos = 0;
+    float difference = 0;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        pose(cached, scenario, frame * deltaTime);
+        timer.start();
+        spSkeleton_updateWorldTransform(cached);
+        long long cachedElapsed = timer.elapsedNanos();
+
+        pose(cold, scenario, frame * deltaTime);
+        cold->pathConstraints[0]->cachedPath = NULL;
+        timer.start();
+        spSkeleton_updateWorldTransform(cold);
+        long long coldElapsed = timer.elapsedNanos();
+
+        // The first 10% of the frames only warm up caches
+        if (frame < 0) continue;
+        cachedNanos += cachedElapsed;
+        coldNanos += coldElapsed;
+        difference = fmaxf(difference, maxWorldDifference(cold, cached));
+    }
+    printf("  %-28s cold %8.1f ns/frame, cached %8.1f ns/frame, max world difference %g\n",
+           scenario.name, (double) coldNanos / frames, (double) cachedNanos / frames, difference);
+    spSkeleton_dispose(cold);
+    spSkeleton_dispose(cached);
+    spSkeletonData_dispose(skeletonData);
+    return difference == 0.0f;
+}
+
+/**
+ * Usage: path-bench [bones] [curves] [frames]
+ */
+int main(int argc, char **argv) {
+    int bones = argc > 1 ? atoi(argv[1]) : 32;
+    int curves = argc > 2 ? atoi(argv[2]) : 16;
+    int frames = argc > 3 ? atoi(argv[3]) : 5000;
+    if (bones <= 0) bones = 32;
+    if (curves <= 0) curves = 16;
+    if (frames <= 0) frames = 5000;
+
+    const PathScenario scenarios[SCENARIOS] = {
+            {"tail, chain", SP_ROTATE_MODE_CHAIN, 0, false},
+            {"ribbon, tangent", SP_ROTATE_MODE_TANGENT, 0, false},
+            {"moving ribbon, chain scale", SP_ROTATE_MODE_CHAIN_SCALE, 90, true},
+    };
+    printf("path of %d curves driving %d bones, %d frames\n", curves, bones, frames);
+    bool ok = true;
+    for (int i = 0; i < SCENARIOS; ++i) {
+        ok = runScenario(scenarios[i], bones, curves, frames) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+#include "BenchUtils.h"
+#include <StickerScene.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Print the counters of one resource cache
+ */
+static void printCacheStats(const char *name, ResourceCache *cache) {
+    ResourceCacheStats stats = cache->getStats();
+    printf("  %s cache: %d hits, %d misses, %d live resources, %zu live bytes, "
+           "%zu loaded bytes\n", name, stats.hits, stats.misses, stats.liveResources,
+           stats.liveBytes, stats.loadedBytes);
+}
+
+/**
+ * CPU time of updating a scene and building its render commands, per frame
+ */
+static double timeScene(StickerScene *scene, int frames) {
+    StageTimer timer;
+    long long nanos = 0;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        timer.start();
+        scene->update(deltaTime);
+        scene->buildRenderCommands();
+        long long frameNanos = timer.elapsedNanos();
+
+        // The first 10% of the frames only warm up caches
+        if (frame >= 0) nanos += frameNanos;
+    }
+    return (double) nanos / frames;
+}
+
+/**
+ * Two transformed raptors built from flipbooks against the same scene built live, at a time
+ * the flipbooks have a frame for. The live raptors are refused a flipbook over budget first.
+ *
+ * @return largest position difference, negative if the commands or indices differ
+ */
+static float compareFlipbookScene(const string &atlasPath, const string &skeletonPath) {
+    ResourceCache cache;
+    StickerScene live(&cache), baked(&cache);
+    for (int i = 0; i < 2; ++i) {
+        int liveId = live.addSticker(atlasPath.c_str(), skeletonPath.c_str(), "walk");
+        int bakedId = baked.addSticker(atlasPath.c_str(), skeletonPath.c_str(), "walk");
+        live.setStickerTransform(liveId, i * 300.0f, 50.0f, 30.0f, 0.5f);
+        baked.setStickerTransform(bakedId, i * 300.0f, 50.0f, 30.0f, 0.5f);
+        if (live.setStickerFlipbookPlayback(liveId, 30.0f, 1, false)) return -1.0f;
+        if (!baked.setStickerFlipbookPlayback(bakedId, 30.0f, DEFAULT_FLIPBOOK_BUDGET, false)) {
+            return -1.0f;
+        }
+    }
+    live.update(0.0f);
+    baked.update(0.0f);
+    const RenderCommandList<PackedVertex> *expected = live.buildRenderCommands();
+    const RenderCommandList<PackedVertex> *actual = baked.buildRenderCommands();
+
+    if (expected->commandCount != actual->commandCount ||
+        expected->vertexCount != actual->vertexCount ||
+        expected->indexCount != actual->indexCount) {
+        return -1.0f;
+    }
+    for (int i = 0; i < expected->commandCount; ++i) {
+        const RenderCommand &e = expected->commands[i], &a = actual->commands[i];
+        if (e.vertexStart != a.vertexStart || e.vertexCount != a.vertexCount ||
+            e.indexStart != a.indexStart || e.indexCount != a.indexCount || e.page != a.page) {
+            return -1.0f;
+        }
+    }
+    for (int i = 0; i < expected->indexCount; ++i) {
+        if (expected->indices[i] != actual->indices[i]) return -1.0f;
+    }
+    float difference = 0.0f;
+    for (int i = 0; i < expected->vertexCount; ++i) {
+        difference = fmaxf(difference, fabsf(expected->vertices[i].x - actual->vertices[i].x));
+        difference = fmaxf(difference, fabsf(expected->vertices[i].y - actual->vertices[i].y));
+    }
+    return difference;
+}
+
+/**
+ * Scene of N raptors against N independent single-sticker pipelines: load cost, draw calls
+ * and CPU time per frame. The pipelines are loaded once with a cache each and once more
+ * through one shared cache, where opening the same sticker again only creates a skeleton.
+ */
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 20;
+    int frames = argc > 2 ? atoi(argv[2]) : 1000;
+    if (count <= 0) count = 20;
+    if (frames <= 0) frames = 1000;
+
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    string skeletonPath = getRaptorDir() + "raptor.skel";
+    StageTimer timer;
+
+    // One scene, every sticker shares the atlas and the skeleton data
+    timer.start();
+    ResourceCache sceneCache;
+    StickerScene scene(&sceneCache);
+    vector<int> ids;
+    for (int i = 0; i < count; ++i) {
+        int id = scene.addSticker(atlasPath.c_str(), skeletonPath.c_str(), "walk");
+        if (id == 0) {
+            fprintf(stderr, "Load %s: FAILED\n", skeletonPath.c_str());
+            return 1;
+        }
+        scene.setStickerTransform(id, (i % 5) * 400.0f, (i / 5) * 400.0f, 0.0f, 0.25f);
+        ids.push_back(id);
+    }
+    long long sceneLoadNanos = timer.elapsedNanos();
+
+    // Independent pipelines, each with its own cache, atlas and skeleton data
+    timer.start();
+    vector<ResourceCache *> pipelineCaches;
+    vector<StickerScene *> pipelines;
+    for (int i = 0; i < count; ++i) {
+        ResourceCache *cache = new ResourceCache();
+        StickerScene *pipeline = new StickerScene(cache);
+        pipeline->addSticker(atlasPath.c_str(), skeletonPath.c_str(), "walk");
+        pipelineCaches.push_back(cache);
+        pipelines.push_back(pipeline);
+    }
+    long long pipelinesLoadNanos = timer.elapsedNanos();
+
+    // Pipelines again, this time every one of them opens the sticker through one cache
+    ResourceCache sharedCache;
+    timer.start();
+    vector<StickerScene *> sharedPipelines;
+    for (int i = 0; i < count; ++i) {
+        StickerScene *pipeline = new StickerScene(&sharedCache);
+        pipeline->addSticker(atlasPath.c_str(), skeletonPath.c_str(), "walk");
+        sharedPipelines.push_back(pipeline);
+    }
+    long long sharedLoadNanos = timer.elapsedNanos();
+
+    long long sceneNanos = 0, pipelinesNanos = 0;
+    size_t sceneCommands = 0, pipelinesCommands = 0;
+    float deltaTime = FIXED_FRAME_MILLIS / 1000.0f;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        timer.start();
+        scene.update(deltaTime);
+        int commandCount = scene.buildRenderCommands()->commandCount;
+        long long sceneFrame = timer.elapsedNanos();
+
+        timer.start();
+        int pipelineCommandCount = 0;
+        for (int i = 0; i < count; ++i) {
+            pipelines[i]->update(deltaTime);
+            pipelineCommandCount += pipelines[i]->buildRenderCommands()->commandCount;
+        }
+        long long pipelinesFrame = timer.elapsedNanos();
+
+        // The first 10% of the frames only warm up caches
+        if (frame < 0) continue;
+        sceneNanos += sceneFrame;
+        pipelinesNanos += pipelinesFrame;
+        sceneCommands += commandCount;
+        pipelinesCommands += pipelineCommandCount;
+    }
+
+    printf("%d raptors, %d frames of %d ms\n", count, frames, FIXED_FRAME_MILLIS);
+    printf("  scene:     %d skeleton data, load %.3f ms, %.1f draw calls/frame\n",
+           scene.getAssetCount(), sceneLoadNanos / 1e6, (double) sceneCommands / frames);
+    printf("  pipelines: %d skeleton data, load %.3f ms, %.1f draw calls/frame\n", count,
+           pipelinesLoadNanos / 1e6, (double) pipelinesCommands / frames);
+    printf("  shared:    %d pipelines on one cache, load %.3f ms\n", count,
+           sharedLoadNanos / 1e6);
+    printStage("scene update + build", (double) sceneNanos / frames);
+    printStage("pipelines update + build", (double) pipelinesNanos / frames);
+
+    // The same scene playing baked samples instead of the animation state
+    for (size_t i = 0; i < ids.size(); ++i) {
+        scene.setStickerBakedPlayback(ids[i], 30.0f);
+    }
+    printStage("scene update + build, baked at 30 Hz", timeScene(&scene, frames));
+
+    // And from flipbooks, no skeleton is posed or built
+    for (size_t i = 0; i < ids.size(); ++i) {
+        scene.setStickerFlipbookPlayback(ids[i], 30.0f, DEFAULT_FLIPBOOK_BUDGET, false);
+    }
+    printStage("scene update + build, flipbook at 30 Hz", timeScene(&scene, frames));
+    printCacheStats("scene", &sceneCache);
+    printCacheStats("first pipeline", pipelineCaches[0]);
+    printCacheStats("shared", &sharedCache);
+
+    for (size_t i = 0; i < sharedPipelines.size(); ++i) {
+        delete sharedPipelines[i];
+    }
+    for (size_t i = 0; i < pipelines.size(); ++i) {
+        delete pipelines[i];
+        delete pipelineCaches[i];
+    }
+
+    float flipbookDifference = compareFlipbookScene(atlasPath, skeletonPath);
+    printf("  flipbook scene matches live scene: %s, max position difference %g\n",
+           flipbookDifference >= 0.0f && flipbookDifference < 1e-3f ? "yes" : "no",
+           flipbookDifference);
+    if (flipbookDifference < 0.0f || flipbookDifference >= 1e-3f) return 1;
+
+    // Every pipeline released its references, nothing may be left alive
+    ResourceCacheStats stats = sharedCache.getStats();
+    if (stats.liveResources != 0 || stats.liveBytes != 0) {
+        fprintf(stderr, "Shared cache still holds %d resources\n", stats.liveResources);
+        return 1;
+    }
+    return 0;
+}
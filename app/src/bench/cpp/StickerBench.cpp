@@ -0,0 +1,172 @@
+#include "BenchUtils.h"
+#include <RenderCommands.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Caller-owned render command buffers, grown the same way Sticker::reserveRenderCommands does
+ */
+template<typename Vertex>
+struct RenderCommandStorage {
+    vector<Vertex> vertices;
+    vector<uint16_t> indices;
+    vector<RenderCommand> commands;
+    RenderCommandList<Vertex> list;
+
+    RenderCommandStorage() {
+        reserve(2048, 4096, 16);
+    }
+
+    void reserve(int vertexCapacity, int indexCapacity, int commandCapacity) {
+        vertices.resize((size_t) vertexCapacity);
+        indices.resize((size_t) indexCapacity);
+        commands.resize((size_t) commandCapacity);
+        list.vertices = &vertices[0];
+        list.indices = &indices[0];
+        list.indexCapacity = indexCapacity;
+        list.vertexCapacity = vertexCapacity;
+        list.commands = &commands[0];
+        list.commandCapacity = commandCapacity;
+    }
+
+    void build(RenderCommandBuilder<Vertex> *builder, const spSkeleton *skeleton) {
+        builder->build(skeleton, &list);
+        while (list.overflow) {
+            reserve(list.vertexCapacity * 2, list.indexCapacity * 2, list.commandCapacity * 2);
+            builder->build(skeleton, &list);
+        }
+    }
+};
+
+/**
+ * Load one skeleton file and step it through a fixed number of frames, timing every stage
+ *
+ * @param atlas shared atlas
+ * @param fileName raptor.json or raptor.skel
+ * @param animationName looping animation to play
+ * @param frames number of timed frames
+ */
+static bool runStages(spAtlas *atlas, const char *fileName, const char *animationName,
+                      int frames) {
+    string path = getRaptorDir() + fileName;
+    bool binary = strstr(fileName, ".skel") != NULL;
+
+    StageTimer timer;
+    timer.start();
+    spSkeletonData *skeletonData = readSkeletonData(atlas, path.c_str(), binary);
+    long long loadNanos = timer.elapsedNanos();
+    if (!skeletonData) return false;
+
+    spSkeleton *skeleton = spSkeleton_create(skeletonData);
+    spAnimationStateData *stateData = spAnimationStateData_create(skeletonData);
+    stateData->defaultMix = 0.5f;
+    spAnimationState *state = spAnimationState_create(stateData);
+    if (!spAnimationState_setAnimationByName(state, 0, animationName, 1)) {
+        fprintf(stderr, "Animation %s not found in %s\n", animationName, fileName);
+        spAnimationState_dispose(state);
+        spAnimationStateData_dispose(stateData);
+        spSkeleton_dispose(skeleton);
+        spSkeletonData_dispose(skeletonData);
+        return false;
+    }
+    spSkeleton_updateWorldTransform(skeleton);
+
+    RenderCommandBuilder<PackedVertex> builder;
+    RenderCommandStorage<PackedVertex> storage;
+    RenderCommandBuilder<FloatVertex> floatBuilder;
+    RenderCommandStorage<FloatVertex> floatStorage;
+    long long updateNanos = 0, applyNanos = 0, worldNanos = 0, vertexNanos = 0;
+    long long floatVertexNanos = 0;
+    size_t vertexCount = 0, indexCount = 0, commandCount = 0;
+
+    resetFixedClock();
+    long lastTime = 0;
+    for (int frame = -frames / 10; frame < frames; ++frame) {
+        // Same delta computation as Sticker::calculateDeltaTime with the fixed clock
+        long currentTime = getFixedClockTimeInMilli();
+        float deltaTime = (lastTime == 0L ? 0L : currentTime - lastTime) / 1000.0f;
+        lastTime = currentTime;
+
+        timer.start();
+        spAnimationState_update(state, deltaTime);
+        long long update = timer.elapsedNanos();
+
+        timer.start();
+        spAnimationState_apply(state, skeleton);
+        long long apply = timer.elapsedNanos();
+
+        timer.start();
+        spSkeleton_updateWorldTransform(skeleton);
+        long long world = timer.elapsedNanos();
+
+        timer.start();
+        storage.build(&builder, skeleton);
+        long long vertex = timer.elapsedNanos();
+
+        // Same pose into the 32 byte float layout, for comparison only
+        timer.start();
+        floatStorage.build(&floatBuilder, skeleton);
+        long long floatVertex = timer.elapsedNanos();
+
+        // The first 10% of the frames only warm up caches
+        if (frame < 0) continue;
+        updateNanos += update;
+        applyNanos += apply;
+        worldNanos += world;
+        vertexNanos += vertex;
+        floatVertexNanos += floatVertex;
+        vertexCount += storage.list.vertexCount;
+        indexCount += storage.list.indexCount;
+        commandCount += storage.list.commandCount;
+    }
+
+    printf("%s / %s: %d bones, %d slots, %d frames of %d ms, load %.3f ms, "
+           "%.1f vertices, %.1f indices and %.1f commands/frame\n",
+           fileName, animationName, skeleton->bonesCount, skeleton->slotsCount, frames,
+           FIXED_FRAME_MILLIS, loadNanos / 1e6, (double) vertexCount / frames,
+           (double) indexCount / frames, (double) commandCount / frames);
+    printStage("spAnimationState_update", (double) updateNanos / frames);
+    printStage("spAnimationState_apply", (double) applyNanos / frames);
+    printStage("spSkeleton_updateWorldTransform", (double) worldNanos / frames);
+    printStage("region/mesh vertex assembly (commands)", (double) vertexNanos / frames);
+    printStage("total", (double) (updateNanos + applyNanos + worldNanos + vertexNanos) / frames);
+    double indexBytes = (double) indexCount * sizeof(uint16_t) / frames;
+    printf("  upload: %.0f bytes/frame packed (%d B/vertex), %.0f bytes/frame float "
+           "(%d B/vertex), both plus %.0f index bytes\n",
+           (double) vertexCount * sizeof(PackedVertex) / frames, (int) sizeof(PackedVertex),
+           (double) vertexCount * sizeof(FloatVertex) / frames, (int) sizeof(FloatVertex),
+           indexBytes);
+    printStage("float layout vertex assembly", (double) floatVertexNanos / frames);
+
+    spAnimationState_dispose(state);
+    spAnimationStateData_dispose(stateData);
+    spSkeleton_dispose(skeleton);
+    spSkeletonData_dispose(skeletonData);
+    return true;
+}
+
+/**
+ * Usage: sticker-bench [frames] [animation]
+ */
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 5000;
+    const char *animationName = argc > 2 ? argv[2] : "walk";
+    if (frames <= 0) frames = 5000;
+
+    string atlasPath = getRaptorDir() + "raptor.atlas";
+    spAtlas *atlas = spAtlas_createFromFile(atlasPath.c_str(), 0);
+    if (!atlas) {
+        fprintf(stderr, "Read atlas file %s: FAILED\n", atlasPath.c_str());
+        return 1;
+    }
+
+    bool ok = runStages(atlas, "raptor.json", animationName, frames);
+    ok = runStages(atlas, "raptor.skel", animationName, frames) && ok;
+
+    spAtlas_dispose(atlas);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+#ifndef HELLO_SPINE_COMMANDRENDERER_H
+#define HELLO_SPINE_COMMANDRENDERER_H
+
+#include <GLES2/gl2.h>
+#include <glm/glm.hpp>
+#include <spine/spine.h>
+#include <RenderCommands.h>
+#include <utils/StreamingBuffer.h>
+
+#define STREAM_VERTEX_CAPACITY (256 * 1024)
+#define STREAM_INDEX_CAPACITY (64 * 1024)
+
+/**
+ * OpenGL side of the sticker pipeline: one shader program and the streaming buffers, shared by
+ * everything that draws through it. Page textures come from the atlas callbacks, which share
+ * them through the ResourceCache that created the atlas.
+ */
+class CommandRenderer {
+
+private:
+    GLuint mProgram;
+    StreamingBuffer mVertexStream;
+    StreamingBuffer mIndexStream;
+    GLintptr mVertexOffset;
+    GLintptr mIndexOffset;
+
+    GLuint mPositionHandle;
+    GLuint mColorHandle;
+    GLuint mMvpMatrixHandle;
+    GLuint mTexCoordsHandle;
+    GLuint mTexSampler2DHandle;
+    GLuint mTintHandle;
+
+    glm::mat4 mMvpMatrix;
+    bool mMvpValid;
+    spColor mTint;
+    bool mTintValid;
+    bool mPremultipliedAlpha;
+
+    virtual void bindBufferData(const RenderCommandList<PackedVertex> *list);
+
+    virtual void passDataToOpenGl(const glm::mat4 &mvpMatrix);
+
+    virtual void setVertexAttribPointers(int baseVertex);
+
+    virtual void updateBlendMode(int newMode);
+
+    virtual void updatePremultipliedBlendMode(int newMode);
+
+    virtual void updateTint(const spColor &tint);
+
+public:
+    CommandRenderer();
+
+    virtual ~CommandRenderer();
+
+    virtual bool init();
+
+    virtual void dispose();
+
+    virtual void setPremultipliedAlpha(bool premultipliedAlpha);
+
+    virtual bool isPremultipliedAlpha();
+
+    virtual void render(const RenderCommandList<PackedVertex> *list, const glm::mat4 &mvpMatrix);
+};
+
+#endif
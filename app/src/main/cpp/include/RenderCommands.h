@@ -0,0 +1,108 @@
+#ifndef HELLO_SPINE_RENDERCOMMANDS_H
+#define HELLO_SPINE_RENDERCOMMANDS_H
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <stdint.h>
+
+#define MAX_WORLD_VERTEX_COUNT 8000
+#define MAX_COMMAND_VERTEX_COUNT 65536 // 16-bit indices
+
+/**
+ * Interleaved 16 byte vertex: float position, normalized uint16 UVs, RGBA8 color
+ */
+struct PackedVertex {
+    float x, y;
+    uint16_t u, v;
+    uint8_t r, g, b, a;
+};
+
+/**
+ * Interleaved 32 byte vertex with float attributes, kept for comparison and for GPUs that
+ * dislike normalized integer attributes
+ */
+struct FloatVertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+};
+
+/**
+ * One indexed draw call sharing texture page, blend mode and tint. With premultiplied alpha
+ * additive slots are drawn under SP_BLEND_MODE_NORMAL and the tint is premultiplied.
+ * Indices are relative to vertexStart so a command never addresses more than 65536 vertices.
+ */
+struct RenderCommand {
+    int vertexStart;
+    int vertexCount;
+    int indexStart;
+    int indexCount;
+    spAtlasPage *page;
+    spBlendMode blendMode;
+    spColor tint;
+};
+
+/**
+ * Caller-owned output of RenderCommandBuilder::build.
+ * Every attachment vertex is written once and triangles come from the index list; colors
+ * hold slot * attachment color, the skeleton color travels as the per-command tint.
+ */
+template<typename Vertex>
+struct RenderCommandList {
+    Vertex *vertices;
+    int vertexCapacity;
+
+    uint16_t *indices;
+    int indexCapacity;
+
+    RenderCommand *commands;
+    int commandCapacity;
+
+    int vertexCount;
+    int indexCount;
+    int commandCount;
+    bool overflow;     // Some attachments did not fit, grow the buffers and build again
+};
+
+/**
+ * Turns a posed skeleton into a flat list of render commands, without touching OpenGL.
+ * Instantiated for PackedVertex and FloatVertex in RenderCommands.cpp.
+ */
+template<typename Vertex>
+class RenderCommandBuilder {
+
+private:
+    float *mWorldVertices;
+    bool mPremultipliedAlpha;
+    const float *mTransform;
+
+    virtual spBlendMode getBatchBlendMode(const spSlot *slot);
+
+    virtual bool beginCommand(RenderCommandList<Vertex> *list, const spSkeleton *skeleton,
+                              spAtlasPage *page, spBlendMode blendMode, int vertexCount,
+                              int indexCount);
+
+    virtual void transformWorldVertices(int worldVerticesLength);
+
+    virtual void addRegionAttachment(RenderCommandList<Vertex> *list,
+                                     spRegionAttachment *region, spSlot *slot);
+
+    virtual void addMeshAttachment(RenderCommandList<Vertex> *list, spMeshAttachment *mesh,
+                                   spSlot *slot);
+
+public:
+    RenderCommandBuilder();
+
+    virtual ~RenderCommandBuilder();
+
+    virtual void setPremultipliedAlpha(bool premultipliedAlpha);
+
+    virtual void build(const spSkeleton *skeleton, RenderCommandList<Vertex> *list);
+
+    virtual void begin(RenderCommandList<Vertex> *list);
+
+    virtual void append(const spSkeleton *skeleton, RenderCommandList<Vertex> *list,
+                        const float *transform);
+};
+
+#endif
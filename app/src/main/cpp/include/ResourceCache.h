@@ -0,0 +1,100 @@
+#ifndef HELLO_SPINE_RESOURCECACHE_H
+#define HELLO_SPINE_RESOURCECACHE_H
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <stddef.h>
+#include <map>
+#include <string>
+
+enum ResourceType {
+    RESOURCE_ATLAS,
+    RESOURCE_SKELETON_DATA,
+    RESOURCE_TEXTURE
+};
+
+/**
+ * Texture handle kept by the cache, the GL side creates and deletes the texture itself
+ */
+struct CachedTexture {
+    unsigned int handle;
+    int width;
+    int height;
+};
+
+struct ResourceCacheStats {
+    int hits;
+    int misses;
+    int liveResources;
+    size_t liveBytes;   // File bytes of atlases and skeletons plus decoded texture bytes
+    size_t loadedBytes; // Same, summed over every load since the last resetCounters()
+};
+
+struct ResourceEntry {
+    ResourceType type;
+    std::string key;
+    void *resource;
+    int refCount;
+    size_t bytes;
+    ResourceEntry *dependency; // Atlas a skeleton data was read with, released with it
+};
+
+/**
+ * Reference-counted atlases, skeleton data and textures keyed by file path. Every acquire
+ * must be paired with a release, the resource is freed when its last user releases it.
+ * Atlases are created with the cache as renderer object, so the page texture callbacks can
+ * share textures through acquireTexture/addTexture. Not thread safe: use it from the GL thread.
+ */
+class ResourceCache {
+
+private:
+    std::map<std::string, ResourceEntry *> mEntriesByKey;
+    std::map<const void *, ResourceEntry *> mEntriesByResource;
+    bool mPremultipliedAlpha;
+    bool mCompactKeyframes;
+    ResourceCacheStats mStats;
+
+    virtual ResourceEntry *findEntry(const std::string &key);
+
+    virtual ResourceEntry *addEntry(ResourceType type, const std::string &key, void *resource,
+                                    size_t bytes, ResourceEntry *dependency);
+
+    virtual bool releaseEntry(const void *resource);
+
+    virtual void disposeEntry(ResourceEntry *entry);
+
+public:
+    ResourceCache();
+
+    virtual ~ResourceCache();
+
+    virtual void setPremultipliedAlpha(bool premultipliedAlpha);
+
+    virtual bool isPremultipliedAlpha();
+
+    virtual void setCompactKeyframes(bool compactKeyframes);
+
+    virtual bool isCompactKeyframes();
+
+    virtual spAtlas *acquireAtlas(const char *path);
+
+    virtual void releaseAtlas(spAtlas *atlas);
+
+    virtual spSkeletonData *acquireSkeletonData(const char *path, spAtlas *atlas);
+
+    virtual void releaseSkeletonData(spSkeletonData *skeletonData);
+
+    virtual const CachedTexture *acquireTexture(const char *path);
+
+    virtual const CachedTexture *addTexture(const char *path, const CachedTexture &texture);
+
+    virtual unsigned int releaseTexture(const CachedTexture *texture);
+
+    virtual ResourceCacheStats getStats();
+
+    virtual void resetCounters();
+};
+
+extern ResourceCache *getSharedResourceCache();
+
+#endif
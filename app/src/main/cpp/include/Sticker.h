@@ -6,16 +6,17 @@
 #include <glm/glm.hpp>
 #include <spine/spine.h>
 #include <spine/extension.h>
+#include <RenderCommands.h>
+#include <CommandRenderer.h>
+#include <VertexFlipbook.h>
 #include <vector>
 
 using namespace std;
 using namespace glm;
 
-#define VB_COUNT 3
-#define VB_POSITION 0
-#define VB_COLORS 1
-#define VB_TEX_COORDS 2
-#define MAX_VERTEX_COUNT 8000
+#define INITIAL_VERTEX_CAPACITY 2048
+#define INITIAL_INDEX_CAPACITY 4096
+#define INITIAL_COMMAND_CAPACITY 16
 
 class Sticker {
 
@@ -25,63 +26,63 @@ private:
     spSkeleton *mSkeleton;
     spAnimationStateData *mAnimationStateData;
     spAnimationState *mAnimationState;
+    spBakedAnimation *mBakedAnimation;
+    float mBakedTime;
+    VertexFlipbook mFlipbook;
+    float mFlipbookTime;
 
     char *mAtlasPath;
     char *mJsonPath;
-    char *mImagePath;
     char *mDefaultAnimation;
 
     EGLContext mEglContext;
-    vector<float> mVertexData;
-    vector<float> mColors;
-    vector<float> mTexCoords;
-    GLuint mCountPerVertex;
-    GLuint mCountPerColor;
-    GLuint mCountPerTexCoord;
-
-    GLuint mProgram;
-    GLuint mVB[VB_COUNT];
-
-    GLuint mPositionHandle;
-    GLuint mColorHandle;
-    GLuint mMvpMatrixHandle;
-    GLuint mTexDataHandle;
-    GLuint mTexCoordsHandle;
-    GLuint mTexSampler2DHandle;
+    vector<PackedVertex> mVertices;
+    vector<uint16_t> mIndices;
+    vector<RenderCommand> mCommands;
+    RenderCommandList<PackedVertex> mCommandList;
+    RenderCommandBuilder<PackedVertex> mCommandBuilder;
+
+    CommandRenderer mRenderer;
 
     mat4 mModelMatrix;
     mat4 mViewMatrix;
     mat4 mProjectionMatrix;
     mat4 mMvpMatrix;
+    bool mMvpDirty;
     vec3 mTrans;
     float mAngle;
 
-    float *mWorldVertices;
+    long (*mClock)();
     long mLastAnimationTime;
-    int mCurrentBlendMode = -1;
 
-    virtual void initOpenGL(const char *texturePath);
+    virtual void initOpenGL();
 
     virtual void initSpine();
 
-    virtual void bindBufferData();
-
-    virtual void passDataToOpenGl();
+    virtual void reserveRenderCommands(int vertexCapacity, int indexCapacity,
+                                       int commandCapacity);
 
 public:
     Sticker(const char *atlasPath,
             const char *jsonPath,
-            const char *imagePath,
             const char *defaultAnimation);
 
     ~Sticker();
 
     virtual void init();
 
+    virtual void setPremultipliedAlpha(bool premultipliedAlpha);
+
     virtual void setAngleAndTranslation(float angle, glm::vec3 trans);
 
     virtual void resize(int width, int height);
 
+    virtual void setClock(long (*clock)());
+
+    virtual void setBakedPlayback(float sampleRate);
+
+    virtual bool setFlipbookPlayback(float frameRate, size_t budget, bool quantized);
+
     virtual void calculateMvpMatrix();
 
     virtual long calculateDeltaTime();
@@ -92,13 +93,7 @@ public:
 
     virtual void updateVertexAndTexCoordsData();
 
-    virtual void updateBlendMode(int newMode);
-
-    virtual void updateVertexAndTexCoordsData_fromRegionAttachment(spRegionAttachment *attachment,
-                                                                   spSlot *slot);
-
-    virtual void updateVertexAndTexCoordsData_fromMeshAttachment(spMeshAttachment *attachment,
-                                                                 spSlot *slot);
+    virtual void buildRenderCommands();
 
     virtual void clearGLData();
 
@@ -0,0 +1,101 @@
+#ifndef HELLO_SPINE_STICKERSCENE_H
+#define HELLO_SPINE_STICKERSCENE_H
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <RenderCommands.h>
+#include <ResourceCache.h>
+#include <VertexFlipbook.h>
+#include <vector>
+
+#define SCENE_INITIAL_VERTEX_CAPACITY 8192
+#define SCENE_INITIAL_INDEX_CAPACITY 16384
+#define SCENE_INITIAL_COMMAND_CAPACITY 32
+
+/**
+ * Immutable data of one sticker pack, shared by every instance of the scene showing it.
+ * Atlas and skeleton data are references held on the ResourceCache.
+ */
+struct StickerAsset {
+    char *atlasPath;
+    char *skeletonPath;
+    spAtlas *atlas;
+    spSkeletonData *skeletonData;
+    spAnimationStateData *animationStateData;
+    int instanceCount;
+};
+
+/**
+ * One sticker on screen: its own pose and animation state over a shared asset
+ */
+struct StickerInstance {
+    int id;
+    StickerAsset *asset;
+    spSkeleton *skeleton; // Not an spSkeletonInstance, which is slower per frame
+    spAnimationState *animationState;
+    float transform[6]; // a, b, c, d, tx, ty, see RenderCommandBuilder::append
+    spBakedAnimation *bakedAnimation; // NULL to apply the animation state
+    VertexFlipbook *flipbook; // NULL to build the commands from the skeleton
+    float playbackTime; // Seconds into the baked animation or the flipbook
+};
+
+/**
+ * Many stickers drawn as one command list. Instances are drawn in the order they were added,
+ * consecutive attachments sharing page, blend mode and tint join one command even across
+ * stickers, with the per-instance transform applied on the CPU.
+ * No OpenGL here: page textures are made by the atlas callbacks of the GL side.
+ */
+class StickerScene {
+
+private:
+    ResourceCache *mCache;
+    std::vector<StickerAsset *> mAssets;
+    std::vector<StickerInstance *> mInstances;
+    int mNextId;
+
+    std::vector<PackedVertex> mVertices;
+    std::vector<uint16_t> mIndices;
+    std::vector<RenderCommand> mCommands;
+    RenderCommandList<PackedVertex> mCommandList;
+    RenderCommandBuilder<PackedVertex> mCommandBuilder;
+
+    virtual StickerAsset *acquireAsset(const char *atlasPath, const char *skeletonPath);
+
+    virtual void releaseAsset(StickerAsset *asset);
+
+    virtual StickerInstance *findInstance(int id);
+
+    virtual void reserveRenderCommands(int vertexCapacity, int indexCapacity,
+                                       int commandCapacity);
+
+public:
+    StickerScene(ResourceCache *cache);
+
+    virtual ~StickerScene();
+
+    virtual void setPremultipliedAlpha(bool premultipliedAlpha);
+
+    virtual int addSticker(const char *atlasPath, const char *skeletonPath,
+                           const char *animationName);
+
+    virtual bool removeSticker(int id);
+
+    virtual void clear();
+
+    virtual bool setStickerTransform(int id, float x, float y, float angle, float scale);
+
+    virtual bool setStickerBakedPlayback(int id, float sampleRate);
+
+    virtual bool setStickerFlipbookPlayback(int id, float frameRate, size_t budget,
+                                            bool quantized);
+
+    virtual int getStickerCount();
+
+    virtual int getAssetCount();
+
+    virtual void update(float deltaTime);
+
+    virtual const RenderCommandList<PackedVertex> *buildRenderCommands();
+};
+
+#endif
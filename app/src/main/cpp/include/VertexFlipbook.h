@@ -0,0 +1,86 @@
+#ifndef HELLO_SPINE_VERTEXFLIPBOOK_H
+#define HELLO_SPINE_VERTEXFLIPBOOK_H
+
+#include <RenderCommands.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define DEFAULT_FLIPBOOK_BUDGET (4 * 1024 * 1024)
+
+/**
+ * Commands, indices and texture coordinates shared by every frame that shows the same
+ * attachments in the same draw order
+ */
+struct FlipbookTopology {
+    std::vector<RenderCommand> commands;
+    std::vector<uint16_t> indices;
+    std::vector<uint16_t> uvs; // u, v per vertex
+};
+
+struct FlipbookFrame {
+    int topology;
+    size_t vertexStart; // First vertex of the frame in the position and color streams
+};
+
+/**
+ * The render command stream of a looping animation baked frame by frame, so playback only
+ * copies or blends two frames and needs no skeleton, animation state or constraint solving.
+ * Positions are stored as floats or quantized to int16 against the bounds of the whole
+ * animation, colors as RGBA8. Baking gives up once the frames outgrow the memory budget and
+ * the caller keeps evaluating the skeleton live.
+ */
+class VertexFlipbook {
+
+private:
+    float mFrameRate;
+    float mDuration;
+    bool mQuantized;
+    float mOrigin[2];       // Dequantized position = origin + (q + 32768) * scale
+    float mScale[2];
+    std::vector<FlipbookTopology> mTopologies;
+    std::vector<FlipbookFrame> mFrames;
+    std::vector<float> mPositions;
+    std::vector<int16_t> mQuantizedPositions;
+    std::vector<uint32_t> mColors;
+    size_t mByteCount;
+    int mMaxVertexCount;
+    int mMaxIndexCount;
+    int mMaxCommandCount;
+
+    virtual int findTopology(const RenderCommandList<PackedVertex> *list);
+
+    virtual void quantizePositions();
+
+public:
+    VertexFlipbook();
+
+    virtual ~VertexFlipbook();
+
+    virtual bool bake(spSkeleton *skeleton, spAnimation *animation,
+                      RenderCommandBuilder<PackedVertex> *builder, float frameRate,
+                      size_t budget, bool quantized);
+
+    virtual void clear();
+
+    virtual bool isBaked() const;
+
+    virtual int getFrameCount() const;
+
+    virtual int getTopologyCount() const;
+
+    virtual size_t getByteCount() const;
+
+    virtual float getBytesPerSecond() const;
+
+    virtual float getQuantizationError() const;
+
+    virtual void getMaxCounts(int *vertexCount, int *indexCount, int *commandCount) const;
+
+    virtual void play(float time, bool interpolate, RenderCommandList<PackedVertex> *list) const;
+
+    virtual void append(float time, bool interpolate, RenderCommandList<PackedVertex> *list,
+                        const float *transform) const;
+};
+
+#endif
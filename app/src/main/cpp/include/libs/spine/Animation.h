@@ -70,6 +70,16 @@ typedef enum {
 	SP_MIX_DIRECTION_OUT
 } spMixDirection;
 
+/* Where one timeline was last applied for one playback, usually a track entry. The frame found last and the one after it
+ * are checked before searching the frames, so playback moving forward needs no binary search. A zeroed cursor is reset.
+ * The counters tell how many frame lookups there were, how many of them still searched and the steps of those searches. */
+typedef struct spTimelineCursor {
+	int frame;
+	int lookups;
+	int searches;
+	int searchSteps;
+} spTimelineCursor;
+
 SP_API spAnimation* spAnimation_create (const char* name, int timelinesCount);
 SP_API void spAnimation_dispose (spAnimation* self);
 
@@ -78,12 +88,26 @@ SP_API void spAnimation_dispose (spAnimation* self);
  * @param events Any triggered events are added. May be null.*/
 SP_API void spAnimation_apply (const spAnimation* self, struct spSkeleton* skeleton, float lastTime, float time, int loop,
 		spEvent** events, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction);
+/** Same as spAnimation_apply with one cursor per timeline, which the results do not depend on. cursors may be null. */
+SP_API void spAnimation_applyWithCursors (const spAnimation* self, struct spSkeleton* skeleton, float lastTime, float time,
+		int loop, spEvent** events, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursors);
+/** Moves the keyframes of the rotate, translate, scale, shear, color, two color and constraint timelines to
+ * spCompactKeyframes, except for timelines they would not make smaller. Poses are the same to the quantization step of each
+ * value; colors are exact. The frames of compacted timelines are freed, so setFrame must not be called on them afterwards.
+ * This trades apply time for memory: every apply decodes the two keys around the time, which makes applying an animation
+ * about 2x slower with every bone keyed 30 times a second (a third of the memory) and about 2% slower for the raptor walk
+ * (1.5% less memory). */
+SP_API void spAnimation_compactKeyframes (spAnimation* self);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spAnimation Animation;
+typedef spTimelineCursor TimelineCursor;
 #define Animation_create(...) spAnimation_create(__VA_ARGS__)
 #define Animation_dispose(...) spAnimation_dispose(__VA_ARGS__)
 #define Animation_apply(...) spAnimation_apply(__VA_ARGS__)
+#define Animation_applyWithCursors(...) spAnimation_applyWithCursors(__VA_ARGS__)
+#define Animation_compactKeyframes(...) spAnimation_compactKeyframes(__VA_ARGS__)
 #endif
 
 /**/
@@ -121,6 +145,9 @@ struct spTimeline {
 SP_API void spTimeline_dispose (spTimeline* self);
 SP_API void spTimeline_apply (const spTimeline* self, struct spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction);
+/* @param cursor May be null. */
+SP_API void spTimeline_applyWithCursor (const spTimeline* self, struct spSkeleton* skeleton, float lastTime, float time,
+		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor);
 SP_API int spTimeline_getPropertyId (const spTimeline* self);
 
 #ifdef SPINE_SHORT_NAMES
@@ -134,18 +161,28 @@ typedef spTimeline Timeline;
 #define TIMELINE_DRAWORDER SP_TIMELINE_DRAWORDER
 #define Timeline_dispose(...) spTimeline_dispose(__VA_ARGS__)
 #define Timeline_apply(...) spTimeline_apply(__VA_ARGS__)
+#define Timeline_applyWithCursor(...) spTimeline_applyWithCursor(__VA_ARGS__)
 #endif
 
 /**/
 
+/* Linear frames cost one int. Only Bezier frames keep points, packed in bezierCurves in the order they were set. */
 typedef struct spCurveTimeline {
 	spTimeline super;
-	float* curves; /* type, x, y, ... */
+	int curvesCount;
+	int* curves; /* Per frame: 0 linear, -1 stepped, n > 0 for Bezier curve n - 1. */
+	float* bezierCurves; /* x, y of the 9 points between 0,0 and 1,1 of each Bezier curve. */
+	int bezierCurvesCount;
+	int bezierCurvesCapacity;
 
 #ifdef __cplusplus
 	spCurveTimeline() :
 		super(),
-		curves(0) {
+		curvesCount(0),
+		curves(0),
+		bezierCurves(0),
+		bezierCurvesCount(0),
+		bezierCurvesCapacity(0) {
 	}
 #endif
 } spCurveTimeline;
@@ -169,18 +206,36 @@ typedef spCurveTimeline CurveTimeline;
 
 /**/
 
+/* Keyframes of a timeline with the spBaseTimeline layout after spAnimation_compactKeyframes. The times are a dense array, so
+ * searches touch no values, shared by the timelines of the animation keyed at the same times. This header is followed by
+ * offset and scale of each value of a key over the timeline, then per key the values as 16 bit steps,
+ * value = offset + steps * scale. Values that are all integers use steps of 1 and stay exact. Color timelines store 8 bit
+ * channels instead, without offsets and scales. */
+typedef struct spCompactKeyframes {
+	int keysCount;
+	int valuesCount; /* Per key, the entries of the timeline without the time. */
+	int /*boolean*/ colors;
+	float* times;
+} spCompactKeyframes;
+
+#ifdef SPINE_SHORT_NAMES
+typedef spCompactKeyframes CompactKeyframes;
+#endif
+
 typedef struct spBaseTimeline {
 	spCurveTimeline super;
 	int const framesCount;
 	float* const frames; /* time, angle, ... for rotate. time, x, y, ... for translate and scale. */
 	int boneIndex;
+	spCompactKeyframes* keyframes; /* Replaces frames once compacted, else 0. */
 
 #ifdef __cplusplus
 	spBaseTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		boneIndex(0) {
+		boneIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spBaseTimeline;
@@ -256,13 +311,15 @@ typedef struct spColorTimeline {
 	int const framesCount;
 	float* const frames; /* time, r, g, b, a, ... */
 	int slotIndex;
+	spCompactKeyframes* keyframes;
 
 #ifdef __cplusplus
 	spColorTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		slotIndex(0) {
+		slotIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spColorTimeline;
@@ -286,13 +343,15 @@ typedef struct spTwoColorTimeline {
 	int const framesCount;
 	float* const frames; /* time, r, g, b, a, ... */
 	int slotIndex;
+	spCompactKeyframes* keyframes;
 
 #ifdef __cplusplus
 	spTwoColorTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		slotIndex(0) {
+		slotIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spTwoColorTimeline;
@@ -438,13 +497,15 @@ typedef struct spIkConstraintTimeline {
 	int const framesCount;
 	float* const frames; /* time, mix, bendDirection, ... */
 	int ikConstraintIndex;
+	spCompactKeyframes* keyframes;
 
 #ifdef __cplusplus
 	spIkConstraintTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		ikConstraintIndex(0) {
+		ikConstraintIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spIkConstraintTimeline;
@@ -468,13 +529,15 @@ typedef struct spTransformConstraintTimeline {
 	int const framesCount;
 	float* const frames; /* time, rotate mix, translate mix, scale mix, shear mix, ... */
 	int transformConstraintIndex;
+	spCompactKeyframes* keyframes;
 
 #ifdef __cplusplus
 	spTransformConstraintTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		transformConstraintIndex(0) {
+		transformConstraintIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spTransformConstraintTimeline;
@@ -498,13 +561,15 @@ typedef struct spPathConstraintPositionTimeline {
 	int const framesCount;
 	float* const frames; /* time, rotate mix, translate mix, scale mix, shear mix, ... */
 	int pathConstraintIndex;
+	spCompactKeyframes* keyframes;
 
 #ifdef __cplusplus
 	spPathConstraintPositionTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		pathConstraintIndex(0) {
+		pathConstraintIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spPathConstraintPositionTimeline;
@@ -528,13 +593,15 @@ typedef struct spPathConstraintSpacingTimeline {
 	int const framesCount;
 	float* const frames; /* time, rotate mix, translate mix, scale mix, shear mix, ... */
 	int pathConstraintIndex;
+	spCompactKeyframes* keyframes;
 
 #ifdef __cplusplus
 	spPathConstraintSpacingTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		pathConstraintIndex(0) {
+		pathConstraintIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spPathConstraintSpacingTimeline;
@@ -558,13 +625,15 @@ typedef struct spPathConstraintMixTimeline {
 	int const framesCount;
 	float* const frames; /* time, rotate mix, translate mix, scale mix, shear mix, ... */
 	int pathConstraintIndex;
+	spCompactKeyframes* keyframes;
 
 #ifdef __cplusplus
 	spPathConstraintMixTimeline() :
 		super(),
 		framesCount(0),
 		frames(0),
-		pathConstraintIndex(0) {
+		pathConstraintIndex(0),
+		keyframes(0) {
 	}
 #endif
 } spPathConstraintMixTimeline;
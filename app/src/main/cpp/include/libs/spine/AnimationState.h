@@ -67,6 +67,7 @@ struct spTrackEntry {
 	spTrackEntryArray* timelineDipMix;
 	float* timelinesRotation;
 	int timelinesRotationCount;
+	spTimelineCursor* timelineCursors; /* One per timeline of the animation. */
 	void* rendererObject;
 	void* userData;
 
@@ -84,7 +85,8 @@ struct spTrackEntry {
 		timelineData(0),
 		timelineDipMix(0),
 		timelinesRotation(0),
-		timelinesRotationCount(0) {
+		timelinesRotationCount(0),
+		timelineCursors(0) {
 	}
 #endif
 };
@@ -147,6 +149,10 @@ SP_API void spAnimationState_clearListenerNotifications(spAnimationState* self);
 
 SP_API float spTrackEntry_getAnimationTime (spTrackEntry* entry);
 
+/** Whether timelines start looking for the frame at the time where each track entry last found it, enabled by default. The
+ * pose is the same either way. */
+SP_API void spAnimationState_setTimelineCursors (spAnimationState* self, int /*boolean*/ enabled);
+
 /** Use this to dispose static memory before your app exits to appease your memory leak detector*/
 SP_API void spAnimationState_disposeStatics ();
 
@@ -176,6 +182,7 @@ typedef spAnimationState AnimationState;
 #define AnimationState_setEmptyAnimations(...) spAnimatinState_setEmptyAnimations(__VA_ARGS__)
 #define AnimationState_getCurrent(...) spAnimationState_getCurrent(__VA_ARGS__)
 #define AnimationState_clearListenerNotifications(...) spAnimatinState_clearListenerNotifications(__VA_ARGS__)
+#define AnimationState_setTimelineCursors(...) spAnimationState_setTimelineCursors(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
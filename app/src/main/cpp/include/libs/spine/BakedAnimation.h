@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_BAKEDANIMATION_H_
+#define SPINE_BAKEDANIMATION_H_
+
+#include <spine/dll.h>
+#include <spine/Animation.h>
+#include <spine/Skeleton.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An animation sampled at a fixed rate from the setup pose, after constraints: bone world transforms, slot colors,
+ * attachments and draw order. spBakedAnimation_apply interpolates the world transforms and colors of the two samples around
+ * the time and takes attachments and draw order from the earlier one, so spAnimationState_apply and
+ * spSkeleton_updateWorldTransform are not needed. Where the pose jumps, at a key after a stepped key or an attachment or draw
+ * order key, two more samples are kept around the jump so it happens on time. Deform timelines are still applied live and
+ * events are not fired. The skeleton must use the skin and flip it was baked with, its x and y may change. */
+typedef struct spBakedAnimation {
+	spAnimation* const animation;
+	const float sampleRate; /* Samples per second. */
+	const int samplesCount;
+	const int bonesCount, slotsCount;
+
+#ifdef __cplusplus
+	spBakedAnimation() :
+		animation(0),
+		sampleRate(0),
+		samplesCount(0),
+		bonesCount(0), slotsCount(0) {
+	}
+#endif
+} spBakedAnimation;
+
+/* Poses the skeleton with the animation once per sample and leaves it in the setup pose, world transforms updated.
+ * @param sampleRate Samples per second, the last sample is at the animation duration. */
+SP_API spBakedAnimation* spBakedAnimation_create (spSkeleton* skeleton, spAnimation* animation, float sampleRate);
+SP_API void spBakedAnimation_dispose (spBakedAnimation* self);
+
+/* Sets the world transforms, slot colors, attachments and draw order of the skeleton at the time, then applies the deform
+ * timelines. Bones need spBone_updateAppliedTransform before their applied values are read. */
+SP_API void spBakedAnimation_apply (const spBakedAnimation* self, spSkeleton* skeleton, float time, int /*bool*/ loop);
+
+/* Bytes owned by the baked animation. */
+SP_API int spBakedAnimation_getByteCount (const spBakedAnimation* self);
+/* Bytes per second of animation, the byte count for an animation without duration. */
+SP_API float spBakedAnimation_getBytesPerSecond (const spBakedAnimation* self);
+
+/* Compares the baked pose with the animation applied to the setup pose at probesPerSample times between every two samples.
+ * Returns the largest distance in skeleton units between the live and the baked origin or tip of a bone, bones shorter than
+ * one unit measured at one unit. The skeleton is left in the setup pose.
+ * @param colorError May be 0, else set to the largest difference of a slot color channel. */
+SP_API float spBakedAnimation_measureError (const spBakedAnimation* self, spSkeleton* skeleton, int probesPerSample,
+		float* colorError);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spBakedAnimation BakedAnimation;
+#define BakedAnimation_create(...) spBakedAnimation_create(__VA_ARGS__)
+#define BakedAnimation_dispose(...) spBakedAnimation_dispose(__VA_ARGS__)
+#define BakedAnimation_apply(...) spBakedAnimation_apply(__VA_ARGS__)
+#define BakedAnimation_getByteCount(...) spBakedAnimation_getByteCount(__VA_ARGS__)
+#define BakedAnimation_getBytesPerSecond(...) spBakedAnimation_getBytesPerSecond(__VA_ARGS__)
+#define BakedAnimation_measureError(...) spBakedAnimation_measureError(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_BAKEDANIMATION_H_ */
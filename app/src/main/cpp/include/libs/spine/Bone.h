@@ -77,6 +77,11 @@ struct spBone {
 SP_API void spBone_setYDown (int/*bool*/yDown);
 SP_API int/*bool*/spBone_isYDown ();
 
+/* Uses a polynomial sincos instead of libm for bone and constraint rotations, see _spMath_fastSinCosDeg for its error.
+ * Off by default. */
+SP_API void spBone_setFastMath (int/*bool*/fastMath);
+SP_API int/*bool*/spBone_isFastMath ();
+
 /* @param parent May be 0. */
 SP_API spBone* spBone_create (spBoneData* data, struct spSkeleton* skeleton, spBone* parent);
 SP_API void spBone_dispose (spBone* self);
@@ -103,6 +108,8 @@ SP_API void spBone_rotateWorld (spBone* self, float degrees);
 typedef spBone Bone;
 #define Bone_setYDown(...) spBone_setYDown(__VA_ARGS__)
 #define Bone_isYDown() spBone_isYDown()
+#define Bone_setFastMath(...) spBone_setFastMath(__VA_ARGS__)
+#define Bone_isFastMath() spBone_isFastMath()
 #define Bone_create(...) spBone_create(__VA_ARGS__)
 #define Bone_dispose(...) spBone_dispose(__VA_ARGS__)
 #define Bone_setToSetupPose(...) spBone_setToSetupPose(__VA_ARGS__)
@@ -65,7 +65,19 @@ typedef struct spPathConstraint {
 	int lengthsCount;
 	float* lengths;
 
-	float segments[10];
+	/* Arc lengths of the ten segments of each curve of a constant speed path, computed when a curve is first used. */
+	float* segments;
+
+	/* Scratch of the vectorized bone placement, 8 floats per bone. */
+	float* placement;
+
+	/* The arrays above are carved from one block that only grows. */
+	int arenaCapacity;
+	float* arena;
+
+	/* Path and world vertices the curves and segments were computed for. They are recomputed only when these change. */
+	spPathAttachment* cachedPath;
+	float* cachedWorld;
 
 #ifdef __cplusplus
 	spPathConstraint() :
@@ -86,7 +98,13 @@ typedef struct spPathConstraint {
 		curvesCount(0),
 		curves(0),
 		lengthsCount(0),
-		lengths(0) {
+		lengths(0),
+		segments(0),
+		placement(0),
+		arenaCapacity(0),
+		arena(0),
+		cachedPath(0),
+		cachedWorld(0) {
 	}
 #endif
 } spPathConstraint;
@@ -47,6 +47,7 @@ typedef struct spSkeletonBinary {
 	float scale;
 	spAttachmentLoader* attachmentLoader;
 	const char* const error;
+	int /*boolean*/ compactKeyframes; /* Keeps keyframe values as 16 bit, colors as 8 bit. See spAnimation_compactKeyframes. */
 } spSkeletonBinary;
 
 SP_API spSkeletonBinary* spSkeletonBinary_createWithLoader (spAttachmentLoader* attachmentLoader);
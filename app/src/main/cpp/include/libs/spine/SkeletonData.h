@@ -79,6 +79,9 @@ typedef struct spSkeletonData {
 SP_API spSkeletonData* spSkeletonData_create ();
 SP_API void spSkeletonData_dispose (spSkeletonData* self);
 
+/* Finds are hashed. A find first hashes the names of the items appended to the arrays since the previous one, so hand built
+ * skeleton data may be searched from several threads only after _spSkeletonData_indexNames. Items must not be replaced or
+ * renamed in place. */
 SP_API spBoneData* spSkeletonData_findBone (const spSkeletonData* self, const char* boneName);
 SP_API int spSkeletonData_findBoneIndex (const spSkeletonData* self, const char* boneName);
 
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONINSTANCE_H_
+#define SPINE_SKELETONINSTANCE_H_
+
+#include <spine/dll.h>
+#include <spine/Skeleton.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shares one spSkeleton between many copies of the same skeleton. Each copy is an spSkeletonInstance that only keeps the
+ * mutable pose: bone local and world transforms, constraint mixes, slot colors, attachments and deform, draw order, skin,
+ * position and flip. Bone, slot and constraint structs, the update cache and the pointers to the data exist once, in the
+ * template skeleton. Use spSkeletonInstance_load to pose the template skeleton with an instance, then animate, update or
+ * draw it, then spSkeletonInstance_store to keep the changes. Not thread safe: one instance is loaded at a time.
+ * This trades time for memory: load and store copy the whole pose, so a frame of a crowd of instances takes longer than one of
+ * separate skeletons (11.1 against 9.5 us per raptor on a desktop host, for 11 instead of 25 KB). With incremental update on
+ * the template skeleton, the first update after loading another instance is a full one.
+ * Nothing in this app uses it yet: StickerScene holds a few stickers and keeps one spSkeleton each, where the instances would
+ * cost a second load per frame to build the render commands for little memory saved. */
+typedef struct spSkeletonTemplate {
+	spSkeletonData* const data;
+	spSkeleton* const skeleton; /* Settings such as spSkeleton_setBatchedConstraints apply to every instance. */
+
+#ifdef __cplusplus
+	spSkeletonTemplate() :
+		data(0),
+		skeleton(0) {
+	}
+#endif
+} spSkeletonTemplate;
+
+typedef struct spSkeletonInstance spSkeletonInstance;
+
+SP_API spSkeletonTemplate* spSkeletonTemplate_create (spSkeletonData* data);
+/* All instances must be disposed first. */
+SP_API void spSkeletonTemplate_dispose (spSkeletonTemplate* self);
+
+/* The instance starts in the setup pose with world transforms updated. */
+SP_API spSkeletonInstance* spSkeletonInstance_create (spSkeletonTemplate* skeletonTemplate);
+SP_API void spSkeletonInstance_dispose (spSkeletonInstance* self);
+
+SP_API spSkeletonTemplate* spSkeletonInstance_getTemplate (const spSkeletonInstance* self);
+
+/* Copies the pose of the instance into the template skeleton and returns it. Nothing is copied when the instance is already
+ * loaded. */
+SP_API spSkeleton* spSkeletonInstance_load (spSkeletonInstance* self);
+/* Copies the pose of the template skeleton back into the instance, which must be the loaded one. */
+SP_API void spSkeletonInstance_store (spSkeletonInstance* self);
+
+/* Bytes owned by the instance, deform vertices included. */
+SP_API int spSkeletonInstance_getByteCount (const spSkeletonInstance* self);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonTemplate SkeletonTemplate;
+typedef spSkeletonInstance SkeletonInstance;
+#define SkeletonTemplate_create(...) spSkeletonTemplate_create(__VA_ARGS__)
+#define SkeletonTemplate_dispose(...) spSkeletonTemplate_dispose(__VA_ARGS__)
+#define SkeletonInstance_create(...) spSkeletonInstance_create(__VA_ARGS__)
+#define SkeletonInstance_dispose(...) spSkeletonInstance_dispose(__VA_ARGS__)
+#define SkeletonInstance_getTemplate(...) spSkeletonInstance_getTemplate(__VA_ARGS__)
+#define SkeletonInstance_load(...) spSkeletonInstance_load(__VA_ARGS__)
+#define SkeletonInstance_store(...) spSkeletonInstance_store(__VA_ARGS__)
+#define SkeletonInstance_getByteCount(...) spSkeletonInstance_getByteCount(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONINSTANCE_H_ */
@@ -48,6 +48,7 @@ typedef struct spSkeletonJson {
 	float scale;
 	spAttachmentLoader* attachmentLoader;
 	const char* const error;
+	int /*boolean*/ compactKeyframes; /* Keeps keyframe values as 16 bit, colors as 8 bit. See spAnimation_compactKeyframes. */
 } spSkeletonJson;
 
 SP_API spSkeletonJson* spSkeletonJson_createWithLoader (spAttachmentLoader* attachmentLoader);
@@ -57,11 +57,17 @@ struct _Entry {
 	const char* name;
 	spAttachment* attachment;
 	_Entry* next;
+	unsigned int hash;
+	_Entry* nextInBucket;
 };
 
 typedef struct {
 	spSkin super;
 	_Entry* entries;
+	int entriesCount;
+	/* Hash chains of the entries by slot index and name, newest first like entries. bucketsCount is a power of two. */
+	int bucketsCount;
+	_Entry** buckets;
 } _spSkin;
 
 SP_API spSkin* spSkin_create (const char* name);
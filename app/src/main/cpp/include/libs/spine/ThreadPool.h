@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_THREADPOOL_H_
+#define SPINE_THREADPOOL_H_
+
+#include <spine/dll.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fixed set of worker threads with one task deque each. A worker takes tasks from the front of its own deque and steals
+ * from the back of the others once it is empty. A pool can be shared by any number of skeletons updated from one thread. */
+typedef struct spThreadPool spThreadPool;
+
+typedef void (*spThreadPoolTask) (void* context, int index);
+
+/* threadsCount includes the thread calling spThreadPool_run, a pool of 1 thread runs every task on the caller. */
+SP_API spThreadPool* spThreadPool_create (int threadsCount);
+SP_API void spThreadPool_dispose (spThreadPool* self);
+
+SP_API int spThreadPool_getThreadsCount (const spThreadPool* self);
+
+/* Calls task for every index in [0, tasksCount), spread over the threads of the pool in contiguous blocks. Returns once
+ * every task is done. Not reentrant: tasks must not call spThreadPool_run on the same pool. */
+SP_API void spThreadPool_run (spThreadPool* self, int tasksCount, spThreadPoolTask task, void* context);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spThreadPool ThreadPool;
+#define ThreadPool_create(...) spThreadPool_create(__VA_ARGS__)
+#define ThreadPool_dispose(...) spThreadPool_dispose(__VA_ARGS__)
+#define ThreadPool_getThreadsCount(...) spThreadPool_getThreadsCount(__VA_ARGS__)
+#define ThreadPool_run(...) spThreadPool_run(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_THREADPOOL_H_ */
@@ -178,6 +178,40 @@ void _spSetRandom(float (*_random) ());
 
 char* _spReadFile (const char* path, int* length);
 
+/*
+ * Hashed name indexes
+ */
+
+/* Open addressing table from name hashes to indices into an array its owner keeps, behind the find functions of skeleton
+ * data and atlases. Only hashes are stored, the caller compares the names of the candidates, so the table never points at
+ * names that may be freed. Candidates of one hash come back in the order they were added. A zeroed table is empty. */
+typedef struct _spNameTableSlot {
+	unsigned int hash;
+	int index; /* -1 for a free slot. */
+} _spNameTableSlot;
+
+typedef struct _spNameTable {
+	int count;
+	int mask; /* Capacity - 1, the capacity is a power of two. */
+	_spNameTableSlot* slots;
+} _spNameTable;
+
+/* FNV-1a of the name. */
+unsigned int _spNameTable_hash (const char* name);
+void _spNameTable_add (_spNameTable* self, unsigned int hash, int index);
+/* Returns the next index added with the hash, -1 after the last one. cursor must be -1 for the first call. */
+int _spNameTable_next (const _spNameTable* self, unsigned int hash, int* cursor);
+void _spNameTable_clear (_spNameTable* self);
+void _spNameTable_deinit (_spNameTable* self);
+
+/* Hashes the names of all items of the skeleton data. The loaders call it before returning, after which the find functions
+ * only read the data and may run on several threads. */
+void _spSkeletonData_indexNames (spSkeletonData* self);
+/* Constraints of a skeleton are in the order of their data, so these also find the constraints of skeletons. */
+int _spSkeletonData_findIkConstraintIndex (const spSkeletonData* self, const char* constraintName);
+int _spSkeletonData_findTransformConstraintIndex (const spSkeletonData* self, const char* constraintName);
+int _spSkeletonData_findPathConstraintIndex (const spSkeletonData* self, const char* constraintName);
+
 
 /*
  * Math utilities
@@ -189,6 +223,56 @@ float _spMath_interpolate(float (*apply) (float a), float start, float end, floa
 float _spMath_pow2_apply(float a);
 float _spMath_pow2out_apply(float a);
 
+/* Sine and cosine of one angle in one call: _spMath_fastSinCosDeg with spBone_setFastMath on, libm otherwise. */
+void _spMath_sinCosDeg(float degrees, float* sine, float* cosine);
+void _spMath_sinCos(float radians, float* sine, float* cosine);
+
+/* Polynomial sine and cosine: the angle is reduced to [-45, 45] degrees around the nearest quadrant, then evaluated with single
+ * precision minimax polynomials. For |degrees| <= 1e5 the maximum absolute error against double precision is 9.1e-8, or
+ * 5.8e-6 degrees of angle. libm sinf/cosf of degrees * DEG_RAD is off by 5.8e-7 on [-720, 720] and 7.5e-5 at 1e5 degrees. */
+void _spMath_fastSinCosDeg(float degrees, float* sine, float* cosine);
+/* Same for count angles, four at a time with NEON/SSE2 where available. The outputs may alias the input. */
+void _spMath_fastSinCosDegArray(const float* degrees, float* sines, float* cosines, int count);
+
+/* Array forms of the math of the IK and transform constraint solvers: libm with spBone_setFastMath off, so the results equal
+ * ATAN2, ACOS, SIN and COS. With it on, atan2 is a minimax polynomial evaluated four at a time with NEON/SSE2 where available,
+ * max error 2.7e-7 radians against 2.5e-7 for atan2f, acos a polynomial with max error 3e-7 radians, and sine and cosine
+ * come from _spMath_fastSinCosDegArray. The outputs may alias the inputs. */
+void _spMath_atan2Array(const float* y, const float* x, float* angles, int count);
+void _spMath_acosArray(const float* x, float* angles, int count);
+void _spMath_sinCosArray(const float* radians, float* sines, float* cosines, int count);
+
+/**/
+
+typedef struct _spSlot {
+	spSlot super;
+	float attachmentTime;
+} _spSlot;
+
+/* Initialize objects in memory owned by the caller, spSkeleton_create places them all in one block. bones is the storage for
+ * the constrained bones, data->bonesCount pointers. The deinit functions free only what the object allocated itself. */
+void _spBone_init (spBone* self, spBoneData* data, spSkeleton* skeleton, spBone* parent);
+/* @param darkColor May be 0 when data->darkColor is 0. */
+void _spSlot_init (spSlot* self, spSlotData* data, spBone* bone, spColor* darkColor);
+void _spSlot_deinit (spSlot* self);
+void _spIkConstraint_init (spIkConstraint* self, spIkConstraintData* data, const spSkeleton* skeleton, spBone** bones);
+void _spTransformConstraint_init (spTransformConstraint* self, spTransformConstraintData* data, const spSkeleton* skeleton,
+	spBone** bones);
+void _spPathConstraint_init (spPathConstraint* self, spPathConstraintData* data, const spSkeleton* skeleton, spBone** bones);
+void _spPathConstraint_deinit (spPathConstraint* self);
+
+/* Solve count constraints at once, for spSkeleton_setBatchedConstraints. The constraints must share no bone and not write the
+ * target or parent of another one. scratch holds the bytes returned by the getBatchScratchSize functions. Only constraints
+ * not in local or relative mode can be batched with _spTransformConstraint_applyBatch. */
+size_t _spIkConstraint_getBatchScratchSize (int count);
+void _spIkConstraint_applyBatch (spIkConstraint** constraints, int count, void* scratch);
+size_t _spTransformConstraint_getBatchScratchSize (int bonesCount);
+void _spTransformConstraint_applyBatch (spTransformConstraint** constraints, int count, void* scratch);
+
+/* Makes the next incremental spSkeleton_updateWorldTransform a full one. For poses replaced from outside the skeleton, such as
+ * by spSkeletonInstance_load, whose bones may match the last update while their world transforms do not. */
+void _spSkeleton_invalidateIncrementalUpdate (spSkeleton* self);
+
 /**/
 
 typedef union _spEventQueueItem {
@@ -230,6 +314,7 @@ struct _spAnimationState {
 	int propertyIDsCapacity;
 
 	int /*boolean*/ animationsChanged;
+	int /*boolean*/ timelineCursorsDisabled;
 
 #ifdef __cplusplus
 	_spAnimationState() :
@@ -240,7 +325,8 @@ struct _spAnimationState {
 		propertyIDs(0),
 		propertyIDsCount(0),
 		propertyIDsCapacity(0),
-		animationsChanged(0) {
+		animationsChanged(0),
+		timelineCursorsDisabled(0) {
 	}
 #endif
 };
@@ -287,7 +373,7 @@ void _spVertexAttachment_deinit (spVertexAttachment* self);
 void _spTimeline_init (spTimeline* self, spTimelineType type,
 	void (*dispose) (spTimeline* self),
 	void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction),
+		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor),
 	int (*getPropertyId) (const spTimeline* self));
 void _spTimeline_deinit (spTimeline* self);
 
@@ -300,15 +386,32 @@ void _spTimeline_deinit (spTimeline* self);
 
 void _spCurveTimeline_init (spCurveTimeline* self, spTimelineType type, int framesCount,
 	void (*dispose) (spTimeline* self),
-	void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction),
+	void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor),
 	int (*getPropertyId) (const spTimeline* self));
 void _spCurveTimeline_deinit (spCurveTimeline* self);
+int _spCurveTimeline_isStepped (const spCurveTimeline* self, int frameIndex);
 int _spCurveTimeline_binarySearch (float *values, int valuesLength, float target, int step);
+/* _spCurveTimeline_binarySearch that checks the frame of the cursor and the next one first. cursor may be 0. */
+int _spCurveTimeline_search (float *values, int valuesLength, float target, int step, spTimelineCursor* cursor);
+/* Times where the pose jumps: keys after a stepped key, attachment keys and draw order keys. Writes up to capacity times, in
+ * no order and possibly repeated, and returns how many there are. */
+int _spAnimation_getStepTimes (const spAnimation* self, float* times, int capacity);
+#define SP_MAX_TIMELINE_ENTRIES 8 /* TWOCOLOR_ENTRIES */
+
+/* The frames of the timeline, or for compacted keyframes the keys around time decoded into buffer (2 * entries floats).
+ * framesCount is set to the length of the frames and first to the key they start at, to add to curve indices. *cursor
+ * serves the search of the times and is set to 0, the decoded keys need none. */
+float* _spBaseTimeline_getFrames (const struct spBaseTimeline* self, float time, spTimelineCursor** cursor, float* buffer,
+	int* framesCount, int* first);
 
 #ifdef SPINE_SHORT_NAMES
 #define _CurveTimeline_init(...) _spCurveTimeline_init(__VA_ARGS__)
 #define _CurveTimeline_deinit(...) _spCurveTimeline_deinit(__VA_ARGS__)
+#define _CurveTimeline_isStepped(...) _spCurveTimeline_isStepped(__VA_ARGS__)
 #define _CurveTimeline_binarySearch(...) _spCurveTimeline_binarySearch(__VA_ARGS__)
+#define _CurveTimeline_search(...) _spCurveTimeline_search(__VA_ARGS__)
+#define _Animation_getStepTimes(...) _spAnimation_getStepTimes(__VA_ARGS__)
+#define _BaseTimeline_getFrames(...) _spBaseTimeline_getFrames(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
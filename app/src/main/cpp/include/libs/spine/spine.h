@@ -59,5 +59,8 @@
 #include <spine/Event.h>
 #include <spine/EventData.h>
 #include <spine/VertexEffect.h>
+#include <spine/ThreadPool.h>
+#include <spine/SkeletonInstance.h>
+#include <spine/BakedAnimation.h>
 
 #endif /* SPINE_SPINE_H_ */
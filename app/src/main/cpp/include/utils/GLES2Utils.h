@@ -1,9 +1,43 @@
+#ifndef HELLO_SPINE_GLES2UTILS_H
+#define HELLO_SPINE_GLES2UTILS_H
+
 #include <GLES2/gl2.h>
 #include <EGL/egl.h>
+#include <stddef.h>
+
+#define GL_STATE_MAX_TEXTURE_UNITS 8
+#define GL_STATE_MAX_VERTEX_ATTRIBS 16
+
+/**
+ * Number of state calls passed to GL versus filtered by the state cache since the last
+ * resetGLStateCounters()
+ */
+struct GLStateCounters {
+    int issued;
+    int skipped;
+};
 
 extern bool checkGlError(const char *functionName);
 extern GLuint loadShader(GLenum shaderType, const char *src);
-extern GLuint loadTexture(const char* imagePath);
+extern GLuint loadTexture(const char* imagePath, bool premultiplyAlpha = false,
+                          int *outWidth = NULL, int *outHeight = NULL);
 extern GLuint loadTextureColor(GLubyte rgba[]);
 extern GLuint createProgram(const char *vertexShaderCode, const char *fragShaderCode);
 
+extern void resetGLStateCache();
+extern void resetGLStateCounters();
+extern GLStateCounters getGLStateCounters();
+extern void countGLStateCall(bool issued);
+extern void cachedUseProgram(GLuint program);
+extern void cachedBindBuffer(GLenum target, GLuint buffer);
+extern void cachedActiveTexture(GLenum unit);
+extern void cachedBindTexture(GLenum target, GLuint texture);
+extern void cachedEnableVertexAttribArray(GLuint index);
+extern void cachedDisableVertexAttribArray(GLuint index);
+extern void cachedVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                      GLsizei stride, const void *pointer);
+extern void cachedBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha,
+                                    GLenum dstAlpha);
+extern void cachedBlendFunc(GLenum src, GLenum dst);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef HELLO_SPINE_STREAMINGBUFFER_H
+#define HELLO_SPINE_STREAMINGBUFFER_H
+
+#include <GLES2/gl2.h>
+
+#define STREAMING_BUFFER_RING_SIZE 3 // Frames the GPU may still be reading
+#define STREAMING_BUFFER_ALIGNMENT 16
+
+/**
+ * Ring of pre-sized GL_STREAM_DRAW buffers filled with glBufferSubData.
+ * Data is appended behind what was written earlier; when a buffer is full the ring moves on
+ * and orphans the next buffer, so the driver never has to wait for the GPU to finish reading.
+ */
+class StreamingBuffer {
+
+private:
+    GLenum mTarget;
+    GLuint mBuffers[STREAMING_BUFFER_RING_SIZE];
+    GLsizeiptr mCapacity;
+    GLintptr mOffset;
+    int mCurrent;
+
+    virtual void allocate(GLsizeiptr capacity);
+
+public:
+    StreamingBuffer(GLenum target, GLsizeiptr capacity);
+
+    virtual ~StreamingBuffer();
+
+    virtual void create();
+
+    virtual void destroy();
+
+    virtual GLintptr append(const void *data, GLsizeiptr size);
+
+    virtual GLuint getBuffer();
+};
+
+#endif
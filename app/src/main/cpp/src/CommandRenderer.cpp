@@ -0,0 +1,396 @@
+#include <CommandRenderer.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <android/log.h>
+#include <utils/GLES2Utils.h>
+#include <ResourceCache.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LOG_TAG "COMMAND_RENDERER_CPP"
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+using namespace glm;
+
+const char vertexShaderCode[] =
+        "attribute vec2 a_Position;"
+                "uniform mat4 u_MVPMatrix;"
+                "attribute vec2 a_TexCoords;"
+                "varying vec2 v_TexCoords;"
+                "attribute vec4 a_Color;"
+                "varying vec4 v_Color;"
+                "void main() {"
+                "    v_TexCoords = a_TexCoords;"
+                "    v_Color = a_Color;"
+                "    gl_Position = u_MVPMatrix * vec4(a_Position, 0.0f, 1.0f);"
+                "}";
+
+const char fragShaderCode[] =
+        "precision mediump float;"
+                "varying vec4 v_Color;"
+                "varying vec2 v_TexCoords;"
+                "uniform sampler2D u_Texture;"
+                "uniform vec4 u_Tint;"
+                "void main() {"
+                "    gl_FragColor = texture2D(u_Texture, v_TexCoords) * v_Color * u_Tint;"
+                "}";
+
+/**
+ * GL filter of an atlas page filter
+ */
+static GLint getGLFilter(spAtlasFilter filter) {
+    switch (filter) {
+        case SP_ATLAS_NEAREST:
+            return GL_NEAREST;
+        case SP_ATLAS_MIPMAP:
+        case SP_ATLAS_MIPMAP_LINEAR_LINEAR:
+            return GL_LINEAR_MIPMAP_LINEAR;
+        case SP_ATLAS_MIPMAP_NEAREST_NEAREST:
+            return GL_NEAREST_MIPMAP_NEAREST;
+        case SP_ATLAS_MIPMAP_LINEAR_NEAREST:
+            return GL_LINEAR_MIPMAP_NEAREST;
+        case SP_ATLAS_MIPMAP_NEAREST_LINEAR:
+            return GL_NEAREST_MIPMAP_LINEAR;
+        default:
+            return GL_LINEAR;
+    }
+}
+
+/**
+ * GL wrap mode of an atlas page wrap
+ */
+static GLint getGLWrap(spAtlasWrap wrap) {
+    switch (wrap) {
+        case SP_ATLAS_MIRROREDREPEAT:
+            return GL_MIRRORED_REPEAT;
+        case SP_ATLAS_REPEAT:
+            return GL_REPEAT;
+        default:
+            return GL_CLAMP_TO_EDGE;
+    }
+}
+
+/**
+ * Texture of an atlas page, 0 if the attachment has no page
+ */
+static GLuint getPageTexture(const spAtlasPage *page) {
+    const CachedTexture *texture = page ? (const CachedTexture *) page->rendererObject : NULL;
+    return texture ? texture->handle : 0;
+}
+
+/*
+ * Atlases are created by a ResourceCache passed as renderer object. Pages showing the same
+ * image share one texture through it, a page holds a reference in its renderer object.
+ */
+void _spAtlasPage_createTexture(spAtlasPage *self, const char *path) {
+    ResourceCache *cache = (ResourceCache *) self->atlas->rendererObject;
+    if (!cache) return;
+
+    const CachedTexture *texture = cache->acquireTexture(path);
+    if (!texture) {
+        CachedTexture loaded;
+        loaded.width = 0;
+        loaded.height = 0;
+        loaded.handle = loadTexture(path, cache->isPremultipliedAlpha(), &loaded.width,
+                                    &loaded.height);
+        if (loaded.handle == 0) return;
+
+        // loadTexture leaves the texture bound
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getGLFilter(self->minFilter));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, getGLFilter(self->magFilter));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, getGLWrap(self->uWrap));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, getGLWrap(self->vWrap));
+        if (self->minFilter >= SP_ATLAS_MIPMAP) glGenerateMipmap(GL_TEXTURE_2D);
+        checkGlError("glTexParameteri - atlas page texture");
+
+        texture = cache->addTexture(path, loaded);
+        LOGD("Load atlas page %s: %dx%d, texture %u", self->name, loaded.width, loaded.height,
+             loaded.handle);
+    }
+
+    // Atlases without a size line rely on the image size for the region UVs
+    if (self->width == 0 || self->height == 0) {
+        self->width = texture->width;
+        self->height = texture->height;
+    }
+    self->rendererObject = (void *) texture;
+}
+
+void _spAtlasPage_disposeTexture(spAtlasPage *self) {
+    ResourceCache *cache = (ResourceCache *) self->atlas->rendererObject;
+    const CachedTexture *texture = (const CachedTexture *) self->rendererObject;
+    if (!cache || !texture) return;
+
+    GLuint handle = cache->releaseTexture(texture);
+    if (handle != 0) {
+        glDeleteTextures(1, &handle);
+        resetGLStateCache();
+    }
+    self->rendererObject = NULL;
+}
+
+char *_spUtil_readFile(const char *path, int *length) {
+    return _spReadFile(path, length);
+}
+
+CommandRenderer::CommandRenderer()
+        : mVertexStream(GL_ARRAY_BUFFER, STREAM_VERTEX_CAPACITY),
+          mIndexStream(GL_ELEMENT_ARRAY_BUFFER, STREAM_INDEX_CAPACITY) {
+    mProgram = 0;
+    mVertexOffset = 0;
+    mIndexOffset = 0;
+
+    mPositionHandle = 0;
+    mColorHandle = 0;
+    mMvpMatrixHandle = 0;
+    mTexCoordsHandle = 0;
+    mTexSampler2DHandle = 0;
+    mTintHandle = 0;
+
+    mMvpValid = false;
+    mTintValid = false;
+    mPremultipliedAlpha = false;
+}
+
+CommandRenderer::~CommandRenderer() {
+
+}
+
+/**
+ * Create the program and the streaming buffers, the EGL context must be current
+ *
+ * @return false if the program could not be created
+ */
+bool CommandRenderer::init() {
+    // The context may be new, nothing is known about its state
+    resetGLStateCache();
+
+    // Create program only one time
+    if (mProgram == 0) {
+        mProgram = createProgram(vertexShaderCode, fragShaderCode);
+        if (mProgram == 0) return false;
+    }
+
+    // Get handle for variables in GPU
+    mPositionHandle = (GLuint) glGetAttribLocation(mProgram, "a_Position");
+    mColorHandle = (GLuint) glGetAttribLocation(mProgram, "a_Color");
+    mTexCoordsHandle = (GLuint) glGetAttribLocation(mProgram, "a_TexCoords");
+    mMvpMatrixHandle = (GLuint) glGetUniformLocation(mProgram, "u_MVPMatrix");
+    mTexSampler2DHandle = (GLuint) glGetUniformLocation(mProgram, "u_Texture");
+    mTintHandle = (GLuint) glGetUniformLocation(mProgram, "u_Tint");
+
+    // The sampler always reads texture unit 0, it is program state so set it once
+    cachedUseProgram(mProgram);
+    glUniform1i(mTexSampler2DHandle, 0);
+    checkGlError("glUniform1i - pass texture data");
+    mMvpValid = false;
+    mTintValid = false;
+
+    // Generate the streaming vertex and index buffers
+    mVertexStream.create();
+    mIndexStream.create();
+
+    LOGD("Init OpenGL: SUCCESSFUL...................");
+    return true;
+}
+
+/**
+ * Delete the program and the buffers, the EGL context they were created in must be current.
+ * Page textures go away with their atlas.
+ */
+void CommandRenderer::dispose() {
+    mVertexStream.destroy();
+    mIndexStream.destroy();
+    if (mProgram != 0) {
+        glDeleteProgram(mProgram);
+        mProgram = 0;
+    }
+    resetGLStateCache();
+}
+
+/**
+ * Draw with premultiplied alpha: normal and additive slots share one blend function. The
+ * textures must come from a ResourceCache with the same setting.
+ *
+ * @param premultipliedAlpha true to enable
+ */
+void CommandRenderer::setPremultipliedAlpha(bool premultipliedAlpha) {
+    mPremultipliedAlpha = premultipliedAlpha;
+}
+
+bool CommandRenderer::isPremultipliedAlpha() {
+    return mPremultipliedAlpha;
+}
+
+/**
+ * Render a command list: upload it once, then issue one indexed draw call per render command
+ *
+ * @param list commands built with the same premultiplied alpha setting as this renderer
+ * @param mvpMatrix model view projection matrix of the whole list
+ */
+void CommandRenderer::render(const RenderCommandList<PackedVertex> *list,
+                             const mat4 &mvpMatrix) {
+    if (mProgram == 0 || list->vertexCount == 0) return;
+
+    // Bind data to GPU
+    LOGD("Binding buffer data....");
+    bindBufferData(list);
+
+    // Pass data to OpenGL
+    LOGD("Passing data to OpenGL....");
+    passDataToOpenGl(mvpMatrix);
+
+    // Draw
+    int baseVertex = 0;
+    for (int i = 0; i < list->commandCount; ++i) {
+        const RenderCommand &command = list->commands[i];
+        if (command.vertexStart != baseVertex) {
+            baseVertex = command.vertexStart;
+            setVertexAttribPointers(baseVertex);
+        }
+        cachedBindTexture(GL_TEXTURE_2D, getPageTexture(command.page));
+        updateBlendMode(command.blendMode);
+        updateTint(command.tint);
+        glDrawElements(GL_TRIANGLES, command.indexCount, GL_UNSIGNED_SHORT,
+                       (const void *) (mIndexOffset + command.indexStart * sizeof(uint16_t)));
+        checkGlError("glDrawElements");
+    }
+
+    // Attributes stay enabled, the next frame finds them in the state cache
+    GLStateCounters counters = getGLStateCounters();
+    LOGD("GL state calls: %d issued, %d skipped", counters.issued, counters.skipped);
+}
+
+/**
+ * Bind buffer data: append the whole list to the streaming buffers in one upload each
+ */
+void CommandRenderer::bindBufferData(const RenderCommandList<PackedVertex> *list) {
+    mVertexOffset = mVertexStream.append(list->vertices,
+                                         list->vertexCount * sizeof(PackedVertex));
+    mIndexOffset = mIndexStream.append(list->indices, list->indexCount * sizeof(uint16_t));
+}
+
+/**
+ * Pass data to GPU, every call goes through the GL state cache
+ */
+void CommandRenderer::passDataToOpenGl(const mat4 &mvpMatrix) {
+    cachedUseProgram(mProgram);
+
+    // Pass the interleaved vertex data and the indices
+    cachedBindBuffer(GL_ARRAY_BUFFER, mVertexStream.getBuffer());
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexStream.getBuffer());
+    cachedEnableVertexAttribArray(mPositionHandle);
+    cachedEnableVertexAttribArray(mColorHandle);
+    cachedEnableVertexAttribArray(mTexCoordsHandle);
+    setVertexAttribPointers(0);
+
+    // Textures are bound per render command
+    cachedActiveTexture(GL_TEXTURE0);
+
+    // Pass MVP matrix data, only when it changed
+    bool changed = !mMvpValid || memcmp(&mMvpMatrix, &mvpMatrix, sizeof(mat4)) != 0;
+    countGLStateCall(changed);
+    if (changed) {
+        glUniformMatrix4fv(mMvpMatrixHandle, 1, GL_FALSE, value_ptr(mvpMatrix));
+        checkGlError("glUniformMatrix4fv - pass MVP matrix data");
+        mMvpMatrix = mvpMatrix;
+        mMvpValid = true;
+    }
+}
+
+/**
+ * Point the vertex attributes at the given vertex, GLES2 has no base vertex for glDrawElements
+ *
+ * @param baseVertex first vertex addressed by index 0
+ */
+void CommandRenderer::setVertexAttribPointers(int baseVertex) {
+    GLsizei stride = sizeof(PackedVertex);
+    size_t base = (size_t) mVertexOffset + (size_t) baseVertex * stride;
+
+    cachedVertexAttribPointer(mPositionHandle, 2, GL_FLOAT, GL_FALSE, stride,
+                              (const void *) (base + offsetof(PackedVertex, x)));
+    checkGlError("glVertexAttribPointer - pass vertex data");
+
+    cachedVertexAttribPointer(mColorHandle, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                              (const void *) (base + offsetof(PackedVertex, r)));
+    checkGlError("glVertexAttribPointer - pass color data");
+
+    cachedVertexAttribPointer(mTexCoordsHandle, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                              (const void *) (base + offsetof(PackedVertex, u)));
+    checkGlError("glVertexAttribPointer - pass texture coordinates data");
+}
+
+/**
+ * Update new blend mode, the GL state cache drops the call if the blend function is unchanged
+ */
+void CommandRenderer::updateBlendMode(int newMode) {
+    if (mPremultipliedAlpha) {
+        updatePremultipliedBlendMode(newMode);
+        return;
+    }
+
+    switch (newMode) {
+        case SP_BLEND_MODE_ADDITIVE: // Cr = Cs + Cd
+            //glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            cachedBlendFunc(GL_ONE, GL_ONE);
+            break;
+
+        case SP_BLEND_MODE_MULTIPLY: // Cr = Cs * Cd
+            //glBlendFuncSeparate(GL_DST_COLOR, GL_ZERO, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            cachedBlendFunc(GL_DST_COLOR, GL_ZERO);
+            break;
+
+        case SP_BLEND_MODE_SCREEN: // Cr = Cs * (1 - Cd) + Cd
+            //glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_COLOR, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            cachedBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR); // Cr = Cs + (1 - Cs) × Cd
+            break;
+
+        case SP_BLEND_MODE_NORMAL:
+            cachedBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                                    GL_ONE_MINUS_SRC_ALPHA);
+            break;
+
+        default: // Transparency blending
+            cachedBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+    }
+}
+
+/**
+ * Blend functions for premultiplied colors. Additive slots arrive as SP_BLEND_MODE_NORMAL
+ * with alpha 0, which GL_ONE, GL_ONE_MINUS_SRC_ALPHA turns into Cr = Cs + Cd.
+ */
+void CommandRenderer::updatePremultipliedBlendMode(int newMode) {
+    switch (newMode) {
+        case SP_BLEND_MODE_ADDITIVE: // Cr = Cs + Cd
+            cachedBlendFunc(GL_ONE, GL_ONE);
+            break;
+
+        case SP_BLEND_MODE_MULTIPLY: // Cr = Cs * Cd + (1 - As) * Cd
+            cachedBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+
+        case SP_BLEND_MODE_SCREEN: // Cr = Cs + (1 - Cs) * Cd
+            cachedBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+            break;
+
+        default: // Cr = Cs + (1 - As) * Cd
+            cachedBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+    }
+}
+
+/**
+ * Pass the skeleton tint of a render command, skipped when it did not change
+ */
+void CommandRenderer::updateTint(const spColor &tint) {
+    bool changed = !mTintValid || mTint.r != tint.r || mTint.g != tint.g || mTint.b != tint.b ||
+                   mTint.a != tint.a;
+    countGLStateCall(changed);
+    if (!changed) return;
+
+    glUniform4f(mTintHandle, tint.r, tint.g, tint.b, tint.a);
+    mTint = tint;
+    mTintValid = true;
+}
@@ -0,0 +1,335 @@
+#include <RenderCommands.h>
+#include <string.h>
+
+/**
+ * Atlas page of a region or mesh attachment, NULL if it was not loaded from an atlas
+ */
+static spAtlasPage *getAttachmentPage(void *rendererObject) {
+    spAtlasRegion *region = (spAtlasRegion *) rendererObject;
+    return region ? region->page : NULL;
+}
+
+/**
+ * Map [0, 1] to [0, max], clamping values outside the range
+ */
+static inline unsigned int normalizeUnsigned(float value, float max) {
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return (unsigned int) max;
+    return (unsigned int) (value * max + 0.5f);
+}
+
+/**
+ * Per-layout vertex writers. The color is converted once per attachment, the builder then
+ * stores it on every vertex of that attachment.
+ */
+template<typename Vertex>
+struct VertexWriter;
+
+template<>
+struct VertexWriter<PackedVertex> {
+    typedef uint32_t Color;
+
+    static inline Color packColor(float r, float g, float b, float a) {
+        union {
+            uint8_t channels[4];
+            uint32_t packed;
+        } color;
+        color.channels[0] = (uint8_t) normalizeUnsigned(r, 255.0f);
+        color.channels[1] = (uint8_t) normalizeUnsigned(g, 255.0f);
+        color.channels[2] = (uint8_t) normalizeUnsigned(b, 255.0f);
+        color.channels[3] = (uint8_t) normalizeUnsigned(a, 255.0f);
+        return color.packed;
+    }
+
+    static inline void write(PackedVertex *vertex, const float *position, const float *uv,
+                             Color color) {
+        vertex->x = position[0];
+        vertex->y = position[1];
+        // Atlas UVs are always inside [0, 1], no clamping needed
+        vertex->u = (uint16_t) (uv[0] * 65535.0f + 0.5f);
+        vertex->v = (uint16_t) (uv[1] * 65535.0f + 0.5f);
+        memcpy(&vertex->r, &color, sizeof(color));
+    }
+};
+
+template<>
+struct VertexWriter<FloatVertex> {
+    typedef spColor Color;
+
+    static inline Color packColor(float r, float g, float b, float a) {
+        Color color;
+        color.r = r;
+        color.g = g;
+        color.b = b;
+        color.a = a;
+        return color;
+    }
+
+    static inline void write(FloatVertex *vertex, const float *position, const float *uv,
+                             const Color &color) {
+        vertex->x = position[0];
+        vertex->y = position[1];
+        vertex->u = uv[0];
+        vertex->v = uv[1];
+        vertex->r = color.r;
+        vertex->g = color.g;
+        vertex->b = color.b;
+        vertex->a = color.a;
+    }
+};
+
+/**
+ * Slot * attachment color of a vertex. With premultiplied alpha the color channels are scaled
+ * by alpha, and additive slots get alpha 0 so GL_ONE, GL_ONE_MINUS_SRC_ALPHA adds them.
+ */
+static inline void getVertexColor(const spSlot *slot, const spColor &attachmentColor,
+                                  bool premultipliedAlpha, float *rgba) {
+    float a = slot->color.a * attachmentColor.a;
+    float scale = premultipliedAlpha ? a : 1.0f;
+    rgba[0] = slot->color.r * attachmentColor.r * scale;
+    rgba[1] = slot->color.g * attachmentColor.g * scale;
+    rgba[2] = slot->color.b * attachmentColor.b * scale;
+    rgba[3] = premultipliedAlpha && slot->data->blendMode == SP_BLEND_MODE_ADDITIVE ? 0.0f : a;
+}
+
+template<typename Vertex>
+RenderCommandBuilder<Vertex>::RenderCommandBuilder() {
+    mWorldVertices = new float[MAX_WORLD_VERTEX_COUNT];
+    mPremultipliedAlpha = false;
+    mTransform = NULL;
+}
+
+/**
+ * Switch between straight and premultiplied alpha output
+ *
+ * @param premultipliedAlpha true if the textures are premultiplied, vertex colors and tints
+ * are then premultiplied too and additive slots batch with normal ones
+ */
+template<typename Vertex>
+void RenderCommandBuilder<Vertex>::setPremultipliedAlpha(bool premultipliedAlpha) {
+    mPremultipliedAlpha = premultipliedAlpha;
+}
+
+/**
+ * Blend state a slot is drawn with
+ */
+template<typename Vertex>
+spBlendMode RenderCommandBuilder<Vertex>::getBatchBlendMode(const spSlot *slot) {
+    spBlendMode blendMode = slot->data->blendMode;
+    if (mPremultipliedAlpha && blendMode == SP_BLEND_MODE_ADDITIVE) return SP_BLEND_MODE_NORMAL;
+    return blendMode;
+}
+
+template<typename Vertex>
+RenderCommandBuilder<Vertex>::~RenderCommandBuilder() {
+    if (mWorldVertices != NULL) {
+        delete[] mWorldVertices;
+        mWorldVertices = NULL;
+    }
+}
+
+/**
+ * Fill the command list with a single skeleton
+ *
+ * @param skeleton posed skeleton, world transforms must be up to date
+ * @param list caller-owned buffers, counts are reset
+ */
+template<typename Vertex>
+void RenderCommandBuilder<Vertex>::build(const spSkeleton *skeleton,
+                                         RenderCommandList<Vertex> *list) {
+    begin(list);
+    append(skeleton, list, NULL);
+}
+
+/**
+ * Empty the command list before appending skeletons to it
+ *
+ * @param list caller-owned buffers
+ */
+template<typename Vertex>
+void RenderCommandBuilder<Vertex>::begin(RenderCommandList<Vertex> *list) {
+    list->vertexCount = 0;
+    list->indexCount = 0;
+    list->commandCount = 0;
+    list->overflow = false;
+}
+
+/**
+ * Walk the draw order of a skeleton and append it behind what the list already holds.
+ * Attachments sharing page, blend mode and tint with the previous skeleton join its command.
+ *
+ * @param skeleton posed skeleton, world transforms must be up to date
+ * @param list caller-owned buffers
+ * @param transform affine a, b, c, d, tx, ty applied to the world positions
+ * (x' = a * x + c * y + tx, y' = b * x + d * y + ty), NULL for none
+ */
+template<typename Vertex>
+void RenderCommandBuilder<Vertex>::append(const spSkeleton *skeleton,
+                                          RenderCommandList<Vertex> *list,
+                                          const float *transform) {
+    mTransform = transform;
+    for (int i = 0; i < skeleton->slotsCount; ++i) {
+        spSlot *slot = skeleton->drawOrder[i];
+        if (!slot) continue;
+
+        spAttachment *attachment = slot->attachment;
+        if (!attachment) continue;
+
+        switch (attachment->type) {
+            case SP_ATTACHMENT_REGION: {
+                spRegionAttachment *region = (spRegionAttachment *) attachment;
+                if (beginCommand(list, skeleton, getAttachmentPage(region->rendererObject),
+                                 getBatchBlendMode(slot), 4, 6))
+                    addRegionAttachment(list, region, slot);
+                break;
+            }
+
+            case SP_ATTACHMENT_MESH: {
+                spMeshAttachment *mesh = (spMeshAttachment *) attachment;
+                if (mesh->super.worldVerticesLength > MAX_WORLD_VERTEX_COUNT) break;
+                if (beginCommand(list, skeleton, getAttachmentPage(mesh->rendererObject),
+                                 getBatchBlendMode(slot), mesh->super.worldVerticesLength >> 1,
+                                 mesh->trianglesCount))
+                    addMeshAttachment(list, mesh, slot);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Make sure the next vertices land in a command with the given state, starting a new
+ * command when the texture page or the blend mode changes, or when the command would
+ * address more vertices than a 16-bit index can
+ *
+ * @return false if the vertices, indices or the command do not fit in the list
+ */
+template<typename Vertex>
+bool RenderCommandBuilder<Vertex>::beginCommand(RenderCommandList<Vertex> *list,
+                                                const spSkeleton *skeleton, spAtlasPage *page,
+                                                spBlendMode blendMode, int vertexCount,
+                                                int indexCount) {
+    if (list->vertexCount + vertexCount > list->vertexCapacity ||
+        list->indexCount + indexCount > list->indexCapacity) {
+        list->overflow = true;
+        return false;
+    }
+
+    spColor tint = skeleton->color;
+    if (mPremultipliedAlpha) {
+        tint.r *= tint.a;
+        tint.g *= tint.a;
+        tint.b *= tint.a;
+    }
+
+    if (list->commandCount > 0) {
+        RenderCommand *last = &list->commands[list->commandCount - 1];
+        if (last->page == page && last->blendMode == blendMode && last->tint.r == tint.r &&
+            last->tint.g == tint.g && last->tint.b == tint.b && last->tint.a == tint.a &&
+            last->vertexCount + vertexCount <= MAX_COMMAND_VERTEX_COUNT) {
+            last->vertexCount += vertexCount;
+            last->indexCount += indexCount;
+            return true;
+        }
+    }
+
+    if (list->commandCount == list->commandCapacity) {
+        list->overflow = true;
+        return false;
+    }
+
+    RenderCommand *command = &list->commands[list->commandCount++];
+    command->vertexStart = list->vertexCount;
+    command->vertexCount = vertexCount;
+    command->indexStart = list->indexCount;
+    command->indexCount = indexCount;
+    command->page = page;
+    command->blendMode = blendMode;
+    command->tint = tint;
+    return true;
+}
+
+/**
+ * Apply the transform of the skeleton being appended to the first world vertices
+ */
+template<typename Vertex>
+void RenderCommandBuilder<Vertex>::transformWorldVertices(int worldVerticesLength) {
+    if (!mTransform) return;
+
+    const float *t = mTransform;
+    for (int i = 0; i < worldVerticesLength; i += 2) {
+        float x = mWorldVertices[i], y = mWorldVertices[i + 1];
+        mWorldVertices[i] = t[0] * x + t[2] * y + t[4];
+        mWorldVertices[i + 1] = t[1] * x + t[3] * y + t[5];
+    }
+}
+
+/**
+ * Four vertices and two triangles per region
+ */
+template<typename Vertex>
+void RenderCommandBuilder<Vertex>::addRegionAttachment(RenderCommandList<Vertex> *list,
+                                                       spRegionAttachment *region,
+                                                       spSlot *slot) {
+    spRegionAttachment_computeWorldVertices(region, slot->bone, mWorldVertices, 0, 2);
+    transformWorldVertices(8);
+    float rgba[4];
+    getVertexColor(slot, region->color, mPremultipliedAlpha, rgba);
+    typename VertexWriter<Vertex>::Color color = VertexWriter<Vertex>::packColor(
+            rgba[0], rgba[1], rgba[2], rgba[3]);
+
+    Vertex *vertex = list->vertices + list->vertexCount;
+    for (int i = 0; i < 4; i++, vertex++) {
+        VertexWriter<Vertex>::write(vertex, mWorldVertices + (i << 1), region->uvs + (i << 1),
+                                    color);
+    }
+
+    static const uint16_t quadIndices[6] = {0, 1, 2, 3, 0, 2};
+    RenderCommand *command = &list->commands[list->commandCount - 1];
+    uint16_t base = (uint16_t) (list->vertexCount - command->vertexStart);
+    uint16_t *index = list->indices + list->indexCount;
+    for (int i = 0; i < 6; i++) {
+        index[i] = base + quadIndices[i];
+    }
+
+    list->vertexCount += 4;
+    list->indexCount += 6;
+}
+
+/**
+ * Every mesh vertex once, triangles straight from the mesh index list
+ */
+template<typename Vertex>
+void RenderCommandBuilder<Vertex>::addMeshAttachment(RenderCommandList<Vertex> *list,
+                                                     spMeshAttachment *mesh, spSlot *slot) {
+    int worldVerticesLength = mesh->super.worldVerticesLength;
+    spVertexAttachment_computeWorldVertices(SUPER(mesh), slot, 0, worldVerticesLength,
+                                            mWorldVertices, 0, 2);
+    transformWorldVertices(worldVerticesLength);
+    float rgba[4];
+    getVertexColor(slot, mesh->color, mPremultipliedAlpha, rgba);
+    typename VertexWriter<Vertex>::Color color = VertexWriter<Vertex>::packColor(
+            rgba[0], rgba[1], rgba[2], rgba[3]);
+
+    Vertex *vertex = list->vertices + list->vertexCount;
+    for (int i = 0; i < worldVerticesLength; i += 2, vertex++) {
+        VertexWriter<Vertex>::write(vertex, mWorldVertices + i, mesh->uvs + i, color);
+    }
+
+    RenderCommand *command = &list->commands[list->commandCount - 1];
+    uint16_t base = (uint16_t) (list->vertexCount - command->vertexStart);
+    uint16_t *index = list->indices + list->indexCount;
+    for (int i = 0; i < mesh->trianglesCount; i++) {
+        index[i] = base + mesh->triangles[i];
+    }
+
+    list->vertexCount += worldVerticesLength >> 1;
+    list->indexCount += mesh->trianglesCount;
+}
+
+template class RenderCommandBuilder<PackedVertex>;
+
+template class RenderCommandBuilder<FloatVertex>;
@@ -0,0 +1,265 @@
+#include <ResourceCache.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Size of a file in bytes, 0 if it cannot be opened
+ */
+static size_t getFileSize(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size > 0 ? (size_t) size : 0;
+}
+
+/**
+ * Read skeleton data, binary if the file ends with .skel, JSON otherwise
+ *
+ * @param compactKeyframes keep animation keyframes quantized, see spAnimation_compactKeyframes
+ */
+static spSkeletonData *readSkeletonDataFile(spAtlas *atlas, const char *path,
+                                            bool compactKeyframes) {
+    const char *extension = strrchr(path, '.');
+    spSkeletonData *skeletonData;
+    if (extension && strcmp(extension, ".skel") == 0) {
+        spSkeletonBinary *binary = spSkeletonBinary_create(atlas);
+        binary->compactKeyframes = compactKeyframes;
+        skeletonData = spSkeletonBinary_readSkeletonDataFile(binary, path);
+        spSkeletonBinary_dispose(binary);
+    } else {
+        spSkeletonJson *json = spSkeletonJson_create(atlas);
+        json->compactKeyframes = compactKeyframes;
+        skeletonData = spSkeletonJson_readSkeletonDataFile(json, path);
+        spSkeletonJson_dispose(json);
+    }
+    return skeletonData;
+}
+
+ResourceCache::ResourceCache() {
+    mPremultipliedAlpha = false;
+    mCompactKeyframes = false;
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+/**
+ * Resources still acquired are leaked on purpose: their GL context may be gone already
+ */
+ResourceCache::~ResourceCache() {
+    std::map<const void *, ResourceEntry *>::iterator it;
+    for (it = mEntriesByResource.begin(); it != mEntriesByResource.end(); ++it) {
+        if (it->second->type == RESOURCE_TEXTURE) delete (CachedTexture *) it->second->resource;
+        delete it->second;
+    }
+}
+
+/**
+ * Atlases and textures loaded afterwards are premultiplied. Entries are keyed by this setting,
+ * so straight and premultiplied users never share a texture.
+ */
+void ResourceCache::setPremultipliedAlpha(bool premultipliedAlpha) {
+    mPremultipliedAlpha = premultipliedAlpha;
+}
+
+bool ResourceCache::isPremultipliedAlpha() {
+    return mPremultipliedAlpha;
+}
+
+/**
+ * Skeleton data loaded afterwards keeps its animation values as 16 bit steps and its colors as
+ * 8 bit, for many sticker packs held in memory at once. Poses differ from the full precision
+ * ones by a fraction of a quantization step. Entries are keyed by this setting as well.
+ */
+void ResourceCache::setCompactKeyframes(bool compactKeyframes) {
+    mCompactKeyframes = compactKeyframes;
+}
+
+bool ResourceCache::isCompactKeyframes() {
+    return mCompactKeyframes;
+}
+
+/**
+ * Look up a live entry, counting a hit and a reference if found
+ */
+ResourceEntry *ResourceCache::findEntry(const std::string &key) {
+    std::map<std::string, ResourceEntry *>::iterator it = mEntriesByKey.find(key);
+    if (it == mEntriesByKey.end()) return NULL;
+
+    it->second->refCount++;
+    mStats.hits++;
+    return it->second;
+}
+
+/**
+ * Register a freshly loaded resource with one reference
+ */
+ResourceEntry *ResourceCache::addEntry(ResourceType type, const std::string &key,
+                                       void *resource, size_t bytes,
+                                       ResourceEntry *dependency) {
+    ResourceEntry *entry = new ResourceEntry;
+    entry->type = type;
+    entry->key = key;
+    entry->resource = resource;
+    entry->refCount = 1;
+    entry->bytes = bytes;
+    entry->dependency = dependency;
+    mEntriesByKey[key] = entry;
+    mEntriesByResource[resource] = entry;
+
+    mStats.liveResources++;
+    mStats.liveBytes += bytes;
+    mStats.loadedBytes += bytes;
+    return entry;
+}
+
+/**
+ * Drop one reference, disposing the entry with the last one
+ *
+ * @return true if the resource is gone
+ */
+bool ResourceCache::releaseEntry(const void *resource) {
+    std::map<const void *, ResourceEntry *>::iterator it = mEntriesByResource.find(resource);
+    if (it == mEntriesByResource.end()) return false;
+
+    ResourceEntry *entry = it->second;
+    if (--entry->refCount > 0) return false;
+
+    // Unlink first: disposing an atlas releases its page textures through this cache
+    mEntriesByResource.erase(it);
+    mEntriesByKey.erase(entry->key);
+    mStats.liveResources--;
+    mStats.liveBytes -= entry->bytes;
+    disposeEntry(entry);
+    return true;
+}
+
+void ResourceCache::disposeEntry(ResourceEntry *entry) {
+    switch (entry->type) {
+        case RESOURCE_ATLAS:
+            spAtlas_dispose((spAtlas *) entry->resource);
+            break;
+
+        case RESOURCE_SKELETON_DATA:
+            spSkeletonData_dispose((spSkeletonData *) entry->resource);
+            if (entry->dependency) releaseEntry(entry->dependency->resource);
+            break;
+
+        case RESOURCE_TEXTURE:
+            // The GL object was deleted by the caller of releaseTexture
+            delete (CachedTexture *) entry->resource;
+            break;
+    }
+    delete entry;
+}
+
+/**
+ * Shared atlas of a file, loaded on the first acquire
+ *
+ * @param path atlas file
+ * @return atlas or NULL if it cannot be read
+ */
+spAtlas *ResourceCache::acquireAtlas(const char *path) {
+    std::string key = std::string("atlas:") + (mPremultipliedAlpha ? "pma:" : "") + path;
+    ResourceEntry *entry = findEntry(key);
+    if (entry) return (spAtlas *) entry->resource;
+
+    mStats.misses++;
+    spAtlas *atlas = spAtlas_createFromFile(path, this);
+    if (!atlas) return NULL;
+
+    addEntry(RESOURCE_ATLAS, key, atlas, getFileSize(path), NULL);
+    return atlas;
+}
+
+void ResourceCache::releaseAtlas(spAtlas *atlas) {
+    releaseEntry(atlas);
+}
+
+/**
+ * Shared skeleton data of a file read with the given atlas, loaded on the first acquire.
+ * The skeleton data keeps its own reference on the atlas.
+ *
+ * @param path skeleton file, .json or .skel
+ * @param atlas atlas acquired from this cache
+ * @return skeleton data or NULL if it cannot be read
+ */
+spSkeletonData *ResourceCache::acquireSkeletonData(const char *path, spAtlas *atlas) {
+    char atlasKey[32];
+    snprintf(atlasKey, sizeof(atlasKey), "%p:", (void *) atlas);
+    std::string key = std::string("skeleton:") + (mCompactKeyframes ? "compact:" : "") +
+                      atlasKey + path;
+    ResourceEntry *entry = findEntry(key);
+    if (entry) return (spSkeletonData *) entry->resource;
+
+    mStats.misses++;
+    spSkeletonData *skeletonData = readSkeletonDataFile(atlas, path, mCompactKeyframes);
+    if (!skeletonData) return NULL;
+
+    std::map<const void *, ResourceEntry *>::iterator it = mEntriesByResource.find(atlas);
+    ResourceEntry *atlasEntry = it != mEntriesByResource.end() ? it->second : NULL;
+    if (atlasEntry) atlasEntry->refCount++;
+    addEntry(RESOURCE_SKELETON_DATA, key, skeletonData, getFileSize(path), atlasEntry);
+    return skeletonData;
+}
+
+void ResourceCache::releaseSkeletonData(spSkeletonData *skeletonData) {
+    releaseEntry(skeletonData);
+}
+
+/**
+ * Shared texture of an image, for the page texture callbacks
+ *
+ * @param path image file
+ * @return texture with one more reference, NULL on a miss: load it and call addTexture
+ */
+const CachedTexture *ResourceCache::acquireTexture(const char *path) {
+    std::string key = std::string("texture:") + (mPremultipliedAlpha ? "pma:" : "") + path;
+    ResourceEntry *entry = findEntry(key);
+    if (entry) return (const CachedTexture *) entry->resource;
+
+    mStats.misses++;
+    return NULL;
+}
+
+/**
+ * Register a texture loaded after an acquireTexture miss
+ *
+ * @return the cached copy, holding one reference
+ */
+const CachedTexture *ResourceCache::addTexture(const char *path, const CachedTexture &texture) {
+    std::string key = std::string("texture:") + (mPremultipliedAlpha ? "pma:" : "") + path;
+    CachedTexture *cached = new CachedTexture(texture);
+    addEntry(RESOURCE_TEXTURE, key, cached, (size_t) texture.width * texture.height * 4, NULL);
+    return cached;
+}
+
+/**
+ * Drop one reference on a texture
+ *
+ * @return the texture handle if that was the last reference, the caller then deletes the GL
+ * texture, 0 otherwise
+ */
+unsigned int ResourceCache::releaseTexture(const CachedTexture *texture) {
+    unsigned int handle = texture->handle;
+    return releaseEntry(texture) ? handle : 0;
+}
+
+ResourceCacheStats ResourceCache::getStats() {
+    return mStats;
+}
+
+/**
+ * Restart the hit, miss and loaded byte counters, live counts are kept
+ */
+void ResourceCache::resetCounters() {
+    mStats.hits = 0;
+    mStats.misses = 0;
+    mStats.loadedBytes = 0;
+}
+
+ResourceCache *getSharedResourceCache() {
+    static ResourceCache cache;
+    return &cache;
+}
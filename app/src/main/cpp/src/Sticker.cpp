@@ -1,112 +1,87 @@
 #include <Sticker.h>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <android/log.h>
 #include <utils/TimeUtils.h>
 #include <utils/StringUtils.h>
-#include <utils/GLES2Utils.h>
+#include <ResourceCache.h>
+#include <algorithm>
 
 #define LOG_TAG "STICKER_CPP"
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 
-const char vertexShaderCode[] =
-        "attribute vec2 a_Position;"
-                "uniform mat4 u_MVPMatrix;"
-                "attribute vec2 a_TexCoords;"
-                "varying vec2 v_TexCoords;"
-                "attribute vec4 a_Color;"
-                "varying vec4 v_Color;"
-                "void main() {"
-                "    v_TexCoords = a_TexCoords;"
-                "    v_Color = a_Color;"
-                "    gl_Position = u_MVPMatrix * vec4(a_Position, 0.0f, 1.0f);"
-                "}";
-
-const char fragShaderCode[] =
-        "precision mediump float;"
-                "varying vec4 v_Color;"
-                "varying vec2 v_TexCoords;"
-                "uniform sampler2D u_Texture;"
-                "void main() {"
-                "    gl_FragColor = texture2D(u_Texture, v_TexCoords) * v_Color;"
-                "}";
-
-void _spAtlasPage_createTexture(spAtlasPage *self, const char *path) {
-
-}
-
-void _spAtlasPage_disposeTexture(spAtlasPage *self) {
-
-}
-
-char *_spUtil_readFile(const char *path, int *length) {
-    return _spReadFile(path, length);
-}
-
-Sticker::Sticker(const char *atlasPath, const char *jsonPath, const char *imagePath,
-                 const char *defaultAnimation) {
+Sticker::Sticker(const char *atlasPath, const char *jsonPath, const char *defaultAnimation) {
     mEglContext = eglGetCurrentContext();
-    mCountPerVertex = 2; // (x, y)
-    mCountPerTexCoord = 2; // (x, y)
-    mCountPerColor = 4; // RGBA
-
-    mProgram = 0;
-    mPositionHandle = 0;
-    mColorHandle = 0;
-    mMvpMatrixHandle = 0;
-    mTexDataHandle = 0;
-    mTexCoordsHandle = 0;
-    mTexSampler2DHandle = 0;
 
     mAngle = 0.0f;
     mTrans = vec3(0.0f, 0.0f, 0.0f);
+    mMvpDirty = true;
 
     mAtlasPath = getString(atlasPath);
     mJsonPath = getString(jsonPath);
-    mImagePath = getString(imagePath);
     mDefaultAnimation = getString(defaultAnimation);
 
+    mClock = getCurrentSystemTimeInMilli;
     mLastAnimationTime = 0; // Default
-    mWorldVertices = new float[MAX_VERTEX_COUNT];
+    mBakedAnimation = NULL;
+    mBakedTime = 0.0f;
+    mFlipbookTime = 0.0f;
+    reserveRenderCommands(INITIAL_VERTEX_CAPACITY, INITIAL_INDEX_CAPACITY,
+                          INITIAL_COMMAND_CAPACITY);
+}
+
+/**
+ * (Re)allocate the buffers the render commands are built into
+ *
+ * @param vertexCapacity max vertices per frame
+ * @param indexCapacity max indices per frame
+ * @param commandCapacity max draw calls per frame
+ */
+void Sticker::reserveRenderCommands(int vertexCapacity, int indexCapacity, int commandCapacity) {
+    mVertices.resize((size_t) vertexCapacity);
+    mIndices.resize((size_t) indexCapacity);
+    mCommands.resize((size_t) commandCapacity);
+
+    mCommandList.vertices = &mVertices[0];
+    mCommandList.vertexCapacity = vertexCapacity;
+    mCommandList.indices = &mIndices[0];
+    mCommandList.indexCapacity = indexCapacity;
+    mCommandList.commands = &mCommands[0];
+    mCommandList.commandCapacity = commandCapacity;
+    clearGLData();
 }
 
 /**
  * Initialize sticker
  */
 void Sticker::init() {
-    initOpenGL(mImagePath);
+    initOpenGL();
     initSpine();
 }
 
 /**
- * Initialize OpenGL
- * @param texturePath path of the texture image
+ * Draw with premultiplied alpha: textures are premultiplied at load, and normal and additive
+ * slots share one blend function so they batch together. Call before init().
+ *
+ * @param premultipliedAlpha true to enable
  */
-void Sticker::initOpenGL(const char *texturePath) {
-    // Create program only one time
-    if (mProgram == 0) {
-        mProgram = createProgram(vertexShaderCode, fragShaderCode);
-        if (mProgram == 0) return;
-    }
+void Sticker::setPremultipliedAlpha(bool premultipliedAlpha) {
+    mRenderer.setPremultipliedAlpha(premultipliedAlpha);
+    mCommandBuilder.setPremultipliedAlpha(premultipliedAlpha);
+    getSharedResourceCache()->setPremultipliedAlpha(premultipliedAlpha);
+}
 
-    // Get handle for variables in GPU
-    mPositionHandle = (GLuint) glGetAttribLocation(mProgram, "a_Position");
-    mColorHandle = (GLuint) glGetAttribLocation(mProgram, "a_Color");
-    mTexCoordsHandle = (GLuint) glGetAttribLocation(mProgram, "a_TexCoords");
-    mMvpMatrixHandle = (GLuint) glGetUniformLocation(mProgram, "u_MVPMatrix");
-    mTexSampler2DHandle = (GLuint) glGetUniformLocation(mProgram, "u_Texture");
-    mTexDataHandle = loadTexture(texturePath);
+/**
+ * Initialize OpenGL, the textures are created per atlas page by initSpine
+ */
+void Sticker::initOpenGL() {
+    if (!mRenderer.init()) return;
 
     // Set view matrix
     mViewMatrix = lookAt(vec3(0, 0, 3.0f),
                          vec3(0, 0, 0),
                          vec3(0, 1.0f, 0));
-
-    // Generate new vertex buffer
-    glGenBuffers(VB_COUNT, mVB);
-
-    LOGD("Init OpenGL: SUCCESSFUL...................");
+    mMvpDirty = true;
 }
 
 /**
@@ -158,8 +133,9 @@ void animationStateListener(spAnimationState *state, spEventType type, spTrackEn
  * Initialize spine: Skeleton and animation state
  */
 void Sticker::initSpine() {
-    // Read atlas from atlas file
-    mAtlas = spAtlas_createFromFile(mAtlasPath, 0);
+    // Atlas and skeleton data are shared with every other sticker of the same files
+    ResourceCache *cache = getSharedResourceCache();
+    mAtlas = cache->acquireAtlas(mAtlasPath);
     if (!mAtlas) {
         LOGE("Read atlas file: FAILED..........");
         disposeSpineData();
@@ -167,18 +143,12 @@ void Sticker::initSpine() {
     }
     LOGD("Read atlas file: SUCCESSFUL..........");
 
-    // Create a skeleton json object from atlas
-    spSkeletonJson *json = spSkeletonJson_create(mAtlas);
-    // Read skeleton data from json and json path
-    mSkeletonData = spSkeletonJson_readSkeletonDataFile(json, mJsonPath);
+    mSkeletonData = cache->acquireSkeletonData(mJsonPath, mAtlas);
     if (!mSkeletonData) {
         LOGE("Read skeleton data from json file: FAILED................");
-        spSkeletonJson_dispose(json);
         disposeSpineData();
         return;
     }
-    // Dispose json object because we don't need it after loading
-    spSkeletonJson_dispose(json);
     LOGD("Read skeleton data from json file: SUCCESSFUL..........");
 
     // Create a skeleton
@@ -236,6 +206,7 @@ void Sticker::initSpine() {
 void Sticker::setAngleAndTranslation(float angle, vec3 trans) {
     mAngle = angle;
     mTrans = trans;
+    mMvpDirty = true;
 }
 
 /**
@@ -251,6 +222,80 @@ void Sticker::resize(int width, int height) {
     // TODO Calculate position of camera (the left/right/top/bottom planes)
     // Default max size of sticker 1400 x 1400
     mProjectionMatrix = ortho(0.0f, 2164.81f, 0.0f, 2819.37f, 2.0f, 5.0f);
+    mMvpDirty = true;
+}
+
+/**
+ * Replace the time source used to advance the animation
+ *
+ * @param clock returns the current time in milliseconds, e.g. a fixed-step clock for benchmarks
+ */
+void Sticker::setClock(long (*clock)()) {
+    mClock = clock;
+    mLastAnimationTime = 0;
+}
+
+/**
+ * Play the default animation from samples baked at sampleRate instead of applying the animation
+ * state and solving constraints every frame. Call after init().
+ *
+ * @param sampleRate samples per second, 0 to apply the animation state again
+ */
+void Sticker::setBakedPlayback(float sampleRate) {
+    if (mBakedAnimation) {
+        spBakedAnimation_dispose(mBakedAnimation);
+        mBakedAnimation = NULL;
+    }
+    if (!mSkeleton || sampleRate <= 0) return;
+
+    spAnimation *animation = spSkeletonData_findAnimation(mSkeletonData, mDefaultAnimation);
+    if (!animation) {
+        LOGE("Bake animation %s: FAILED..........", mDefaultAnimation);
+        return;
+    }
+    mBakedAnimation = spBakedAnimation_create(mSkeleton, animation, sampleRate);
+    mBakedTime = 0.0f;
+    LOGD("Bake animation %s: %.0f bytes per second", mDefaultAnimation,
+         spBakedAnimation_getBytesPerSecond(mBakedAnimation));
+}
+
+/**
+ * Play the default animation from its baked render commands, no skeleton is posed or built
+ * while the flipbook plays. The animation must loop and show the skeleton as it is now, since
+ * its position and color are baked in. Call after init().
+ *
+ * @param frameRate frames per second, 0 to evaluate the skeleton live again
+ * @param budget max bytes for the frames, e.g. DEFAULT_FLIPBOOK_BUDGET
+ * @param quantized store positions as int16 instead of float
+ * @return false if the frames did not fit the budget, the sticker keeps evaluating live
+ */
+bool Sticker::setFlipbookPlayback(float frameRate, size_t budget, bool quantized) {
+    mFlipbook.clear();
+    if (!mSkeleton || frameRate <= 0) return false;
+
+    spAnimation *animation = spSkeletonData_findAnimation(mSkeletonData, mDefaultAnimation);
+    if (!animation) {
+        LOGE("Bake flipbook %s: FAILED..........", mDefaultAnimation);
+        return false;
+    }
+    if (!mFlipbook.bake(mSkeleton, animation, &mCommandBuilder, frameRate, budget, quantized)) {
+        LOGE("Bake flipbook %s: over budget of %zu bytes, evaluating live", mDefaultAnimation,
+             budget);
+        return false;
+    }
+    mFlipbookTime = 0.0f;
+
+    int vertexCount, indexCount, commandCount;
+    mFlipbook.getMaxCounts(&vertexCount, &indexCount, &commandCount);
+    if (vertexCount > mCommandList.vertexCapacity || indexCount > mCommandList.indexCapacity ||
+        commandCount > mCommandList.commandCapacity) {
+        reserveRenderCommands(std::max(vertexCount, mCommandList.vertexCapacity),
+                              std::max(indexCount, mCommandList.indexCapacity),
+                              std::max(commandCount, mCommandList.commandCapacity));
+    }
+    LOGD("Bake flipbook %s: %d frames, %d topologies, %.0f bytes per second", mDefaultAnimation,
+         mFlipbook.getFrameCount(), mFlipbook.getTopologyCount(), mFlipbook.getBytesPerSecond());
+    return true;
 }
 
 /**
@@ -264,6 +309,22 @@ void Sticker::draw() {
 
     float deltaTime = calculateDeltaTime() * 1.0f / 1000.0f;
 
+    if (mFlipbook.isBaked()) {
+        // Baked render commands, blended between the two closest frames
+        mFlipbookTime += deltaTime;
+        mFlipbook.play(mFlipbookTime, true, &mCommandList);
+        render();
+        return;
+    }
+
+    if (mBakedAnimation) {
+        // Baked world transforms, no animation state or constraints to evaluate
+        mBakedTime += deltaTime;
+        spBakedAnimation_apply(mBakedAnimation, mSkeleton, mBakedTime, 1);
+        updateVertexAndTexCoordsData();
+        return;
+    }
+
     // Update animation state by delta time
     spAnimationState_update(mAnimationState, deltaTime);
     LOGD("Update animation state at %f seconds", deltaTime);
@@ -285,7 +346,7 @@ void Sticker::draw() {
  * Get the delta time from the current time to the last drawn time
  */
 long Sticker::calculateDeltaTime() {
-    long currentTime = getCurrentSystemTimeInMilli();
+    long currentTime = mClock();
     long deltaTime = this->mLastAnimationTime == 0L ? 0L : currentTime - this->mLastAnimationTime;
     mLastAnimationTime = currentTime;
     return deltaTime;
@@ -300,222 +361,43 @@ void Sticker::updateVertexAndTexCoordsData() {
         return;
     }
 
-    // Clear old data
-    clearGLData();
-
-    for (int i = 0; i < mSkeleton->slotsCount; ++i) {
-        spSlot *slot = mSkeleton->drawOrder[i];
-        if (!slot) continue;
-
-
-        spAttachment *attachment = slot->attachment;
-        if (!attachment) continue;
-        LOGD("Processing attachment of SLOT[%d]...", i);
-
-        // Update blend mode if necessary
-        int blendMode = slot->data->blendMode;
-        if (mCurrentBlendMode != blendMode) {
-            updateBlendMode(blendMode);
-            render();
-            clearGLData();
-            LOGD("New blend mode: %d", mCurrentBlendMode);
-        }
-
-        switch (attachment->type) {
-            case SP_ATTACHMENT_REGION:
-                updateVertexAndTexCoordsData_fromRegionAttachment(
-                        (spRegionAttachment *) attachment, slot);
-                break;
-
-            case SP_ATTACHMENT_MESH:
-                updateVertexAndTexCoordsData_fromMeshAttachment(
-                        (spMeshAttachment *) attachment, slot);
-                break;
-
-            default:
-                LOGE("Other attachment: %s", attachment->type);
-                break;
-        }
-    }
-
+    buildRenderCommands();
     render();
 }
 
 /**
- * Update new blend mode
+ * Build the render commands of the current pose, growing the buffers until everything fits
  */
-void Sticker::updateBlendMode(int newMode) {
-    switch (mCurrentBlendMode) {
-        case SP_BLEND_MODE_ADDITIVE: // Cr = Cs + Cd
-            //glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-            glBlendFunc(GL_ONE, GL_ONE);
-            break;
-
-        case SP_BLEND_MODE_MULTIPLY: // Cr = Cs * Cd
-            //glBlendFuncSeparate(GL_DST_COLOR, GL_ZERO, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-            glBlendFunc(GL_DST_COLOR, GL_ZERO);
-            break;
-
-        case SP_BLEND_MODE_SCREEN: // Cr = Cs * (1 - Cd) + Cd
-            //glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_COLOR, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR); // Cr = Cs + (1 - Cs) × Cd
-            break;
-
-        case SP_BLEND_MODE_NORMAL:
-            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
-                                GL_ONE_MINUS_SRC_ALPHA);
-            break;
-
-        default: // Transparency blending
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            break;
+void Sticker::buildRenderCommands() {
+    mCommandBuilder.build(mSkeleton, &mCommandList);
+    while (mCommandList.overflow) {
+        reserveRenderCommands(mCommandList.vertexCapacity * 2, mCommandList.indexCapacity * 2,
+                              mCommandList.commandCapacity * 2);
+        mCommandBuilder.build(mSkeleton, &mCommandList);
     }
-    mCurrentBlendMode = newMode;
+    LOGD("Built %d render commands, %d vertices, %d indices", mCommandList.commandCount,
+         mCommandList.vertexCount, mCommandList.indexCount);
 }
 
 /**
  * Clear old GL data
  */
 void Sticker::clearGLData() {
-    mVertexData.clear();
-    mColors.clear();
-    mTexCoords.clear();
-}
-
-/**
- * Update vextex data and texture coordinate data from region attachment
- */
-void Sticker::updateVertexAndTexCoordsData_fromRegionAttachment(spRegionAttachment *region,
-                                                                spSlot *slot) {
-    spRegionAttachment_computeWorldVertices(region, slot->bone, mWorldVertices, 0, 2);
-    float r = mSkeleton->color.r * slot->color.r * region->color.r;
-    float g = mSkeleton->color.g * slot->color.g * region->color.g;
-    float b = mSkeleton->color.b * slot->color.b * region->color.b;
-    float a = mSkeleton->color.a * slot->color.a * region->color.a;
-
-    unsigned int order[6] = {0, 1, 2, 3, 0, 2};
-    int j;
-    for (int i = 0; i < 6; i++) {
-        mColors.push_back(r);
-        mColors.push_back(g);
-        mColors.push_back(b);
-        mColors.push_back(a);
-
-        j = order[i];
-        mVertexData.push_back(mWorldVertices[j * 2]);
-        mVertexData.push_back(mWorldVertices[j * 2 + 1]);
-        mTexCoords.push_back(region->uvs[j * 2]);
-        mTexCoords.push_back(region->uvs[j * 2 + 1]);
-    }
+    mCommandList.vertexCount = 0;
+    mCommandList.indexCount = 0;
+    mCommandList.commandCount = 0;
+    mCommandList.overflow = false;
 }
 
 /**
- * Update vextex data and texture coordinate data from mesh attachment
- */
-void Sticker::updateVertexAndTexCoordsData_fromMeshAttachment(spMeshAttachment *mesh,
-                                                              spSlot *slot) {
-    if (mesh->super.worldVerticesLength > MAX_VERTEX_COUNT)
-        return;
-
-    spVertexAttachment_computeWorldVertices(SUPER(mesh), slot, 0, mesh->super.worldVerticesLength,
-                                            mWorldVertices, 0, 2);
-    float r = mSkeleton->color.r * slot->color.r * mesh->color.r;
-    float g = mSkeleton->color.g * slot->color.g * mesh->color.g;
-    float b = mSkeleton->color.b * slot->color.b * mesh->color.b;
-    float a = mSkeleton->color.a * slot->color.a * mesh->color.a;
-
-    for (int i = 0; i < mesh->trianglesCount; ++i) {
-        int j = mesh->triangles[i] << 1;
-        mColors.push_back(r);
-        mColors.push_back(g);
-        mColors.push_back(b);
-        mColors.push_back(a);
-
-        mVertexData.push_back(mWorldVertices[j]);
-        mVertexData.push_back(mWorldVertices[j + 1]);
-        mTexCoords.push_back(mesh->uvs[j]);
-        mTexCoords.push_back(mesh->uvs[j + 1]);
-    }
-}
-
-/**
- * Bind buffer data
- */
-void Sticker::bindBufferData() {
-    glBindBuffer(GL_ARRAY_BUFFER, mVB[VB_POSITION]);
-    glBufferData(GL_ARRAY_BUFFER, mVertexData.size() * sizeof(float), &mVertexData[0],
-                 GL_STATIC_DRAW);
-    checkGlError("glBufferData - vertex data");
-
-    glBindBuffer(GL_ARRAY_BUFFER, mVB[VB_COLORS]);
-    glBufferData(GL_ARRAY_BUFFER, mColors.size() * sizeof(float), &mColors[0], GL_STATIC_DRAW);
-    checkGlError("glBufferData - color data");
-
-    glBindBuffer(GL_ARRAY_BUFFER, mVB[VB_TEX_COORDS]);
-    glBufferData(GL_ARRAY_BUFFER, mTexCoords.size() * sizeof(float), &mTexCoords[0],
-                 GL_STATIC_DRAW);
-    checkGlError("glBufferData - texture coordinates data");
-}
-
-/**
- * Pass data to GPU
- */
-void Sticker::passDataToOpenGl() {
-    glUseProgram(mProgram);
-    checkGlError("glUseProgram");
-
-    // Pass vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, mVB[VB_POSITION]);
-    glEnableVertexAttribArray(mPositionHandle);
-    glVertexAttribPointer(mPositionHandle, mCountPerVertex, GL_FLOAT, GL_FALSE,
-                          mCountPerVertex * sizeof(GLfloat), 0);
-    checkGlError("glVertexAttribPointer - pass vertex data");
-
-    // Pass color  data
-    glBindBuffer(GL_ARRAY_BUFFER, mVB[VB_COLORS]);
-    glEnableVertexAttribArray(mColorHandle);
-    glVertexAttribPointer(mColorHandle, mCountPerColor, GL_FLOAT, GL_FALSE,
-                          mCountPerColor * sizeof(float), 0);
-    checkGlError("glVertexAttribPointer - pass color data");
-
-    // Pass texture coordinate data
-    glBindBuffer(GL_ARRAY_BUFFER, mVB[VB_TEX_COORDS]);
-    glEnableVertexAttribArray(mTexCoordsHandle);
-    glVertexAttribPointer(mTexCoordsHandle, mCountPerTexCoord, GL_FLOAT, GL_FALSE,
-                          mCountPerTexCoord * sizeof(GLfloat), 0);
-    checkGlError("glVertexAttribPointer - pass texture coordinates data");
-
-    // Pass texture data
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mTexDataHandle);
-    glUniform1i(mTexSampler2DHandle, 0);
-    checkGlError("glUniform1i - pass texture data");
-
-    // Pass MVP matrix data
-    calculateMvpMatrix();
-    glUniformMatrix4fv(mMvpMatrixHandle, 1, GL_FALSE, value_ptr(mMvpMatrix));
-    checkGlError("glUniformMatrix4fv - pass MVP matrix data");
-}
-
-/**
- * Render sticker
+ * Render sticker through the shared command renderer
  */
 void Sticker::render() {
-    // Bind data to GPU
-    LOGD("Binding buffer data....");
-    bindBufferData();
-
-    // Pass data to OpenGL
-    LOGD("Passing data to OpenGL....");
-    passDataToOpenGl();
-
-    // Draw
-    glDrawArrays(GL_TRIANGLES, 0, (unsigned) this->mVertexData.size() / 2);
-    checkGlError("glDrawArrays");
-
-    glDisableVertexAttribArray(mPositionHandle);
-    glDisableVertexAttribArray(mTexCoordsHandle);
-    glDisableVertexAttribArray(mColorHandle);
+    if (mMvpDirty) {
+        calculateMvpMatrix();
+        mMvpDirty = false;
+    }
+    mRenderer.render(&mCommandList, mMvpMatrix);
 }
 
 /**
@@ -533,25 +415,23 @@ Sticker::~Sticker() {
         return;
 
     LOGD("Clearing EGL data...........");
-    glDeleteBuffers(VB_COUNT, mVB);
-    glDeleteTextures(1, &mTexDataHandle);
-    glDeleteProgram(mProgram);
-    LOGD("Clear EGL data: SUCCESSFUL...........");
-
     clearGLData();
-
-    if (mWorldVertices != NULL) {
-        delete[] mWorldVertices;
-        mWorldVertices = NULL;
-    }
-
     disposeSpineData();
+    mRenderer.dispose();
+    LOGD("Clear EGL data: SUCCESSFUL...........");
 }
 
 /**
  * Dispose spine data
  */
 void Sticker::disposeSpineData() {
+    mFlipbook.clear();
+
+    if (mBakedAnimation) {
+        spBakedAnimation_dispose(mBakedAnimation);
+        LOGD("Dispose baked animation");
+    }
+
     if (mAnimationState) {
         spAnimationState_dispose(mAnimationState);
         LOGD("Dispose animation state");
@@ -568,13 +448,13 @@ void Sticker::disposeSpineData() {
     }
 
     if (mSkeletonData) {
-        spSkeletonData_dispose(mSkeletonData);
-        LOGD("Dispose skeleton data");
+        getSharedResourceCache()->releaseSkeletonData(mSkeletonData);
+        LOGD("Release skeleton data");
     }
 
     if (mAtlas) {
-        spAtlas_dispose(mAtlas);
-        LOGD("Dispose atlas");
+        getSharedResourceCache()->releaseAtlas(mAtlas);
+        LOGD("Release atlas");
     }
 
     mAtlas = NULL;
@@ -582,6 +462,7 @@ void Sticker::disposeSpineData() {
     mSkeleton = NULL;
     mAnimationStateData = NULL;
     mAnimationState = NULL;
+    mBakedAnimation = NULL;
 
     LOGD("Dispose Spine data: SUCCESSFUL...........");
 }
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include <StickerScene.h>
+#include <utils/StringUtils.h>
+#include <math.h>
+#include <string.h>
+
+/**
+ * @param cache where atlases and skeleton data come from, NULL for the shared cache
+ */
+StickerScene::StickerScene(ResourceCache *cache) {
+    mCache = cache ? cache : getSharedResourceCache();
+    mNextId = 1;
+    reserveRenderCommands(SCENE_INITIAL_VERTEX_CAPACITY, SCENE_INITIAL_INDEX_CAPACITY,
+                          SCENE_INITIAL_COMMAND_CAPACITY);
+}
+
+StickerScene::~StickerScene() {
+    clear();
+}
+
+/**
+ * Must match the premultiplied alpha setting of the renderer drawing the scene
+ */
+void StickerScene::setPremultipliedAlpha(bool premultipliedAlpha) {
+    mCommandBuilder.setPremultipliedAlpha(premultipliedAlpha);
+}
+
+/**
+ * (Re)allocate the buffers the render commands are built into
+ */
+void StickerScene::reserveRenderCommands(int vertexCapacity, int indexCapacity,
+                                         int commandCapacity) {
+    mVertices.resize((size_t) vertexCapacity);
+    mIndices.resize((size_t) indexCapacity);
+    mCommands.resize((size_t) commandCapacity);
+
+    mCommandList.vertices = &mVertices[0];
+    mCommandList.vertexCapacity = vertexCapacity;
+    mCommandList.indices = &mIndices[0];
+    mCommandList.indexCapacity = indexCapacity;
+    mCommandList.commands = &mCommands[0];
+    mCommandList.commandCapacity = commandCapacity;
+    mCommandBuilder.begin(&mCommandList);
+}
+
+/**
+ * Find the asset of the given files or create it from cached atlas and skeleton data
+ *
+ * @return the asset with one more instance counted, NULL if loading failed
+ */
+StickerAsset *StickerScene::acquireAsset(const char *atlasPath, const char *skeletonPath) {
+    for (size_t i = 0; i < mAssets.size(); ++i) {
+        StickerAsset *asset = mAssets[i];
+        if (strcmp(asset->atlasPath, atlasPath) == 0 &&
+            strcmp(asset->skeletonPath, skeletonPath) == 0) {
+            asset->instanceCount++;
+            return asset;
+        }
+    }
+
+    spAtlas *atlas = mCache->acquireAtlas(atlasPath);
+    if (!atlas) return NULL;
+
+    spSkeletonData *skeletonData = mCache->acquireSkeletonData(skeletonPath, atlas);
+    if (!skeletonData) {
+        mCache->releaseAtlas(atlas);
+        return NULL;
+    }
+
+    StickerAsset *asset = new StickerAsset;
+    asset->atlasPath = getString(atlasPath);
+    asset->skeletonPath = getString(skeletonPath);
+    asset->atlas = atlas;
+    asset->skeletonData = skeletonData;
+    asset->animationStateData = spAnimationStateData_create(skeletonData);
+    asset->animationStateData->defaultMix = 0.5f;
+    asset->instanceCount = 1;
+    mAssets.push_back(asset);
+    return asset;
+}
+
+/**
+ * Drop one instance of an asset, disposing it with the last one
+ */
+void StickerScene::releaseAsset(StickerAsset *asset) {
+    if (--asset->instanceCount > 0) return;
+
+    for (size_t i = 0; i < mAssets.size(); ++i) {
+        if (mAssets[i] == asset) {
+            mAssets.erase(mAssets.begin() + i);
+            break;
+        }
+    }
+    spAnimationStateData_dispose(asset->animationStateData);
+    mCache->releaseSkeletonData(asset->skeletonData);
+    mCache->releaseAtlas(asset->atlas);
+    delete[] asset->atlasPath;
+    delete[] asset->skeletonPath;
+    delete asset;
+}
+
+StickerInstance *StickerScene::findInstance(int id) {
+    for (size_t i = 0; i < mInstances.size(); ++i) {
+        if (mInstances[i]->id == id) return mInstances[i];
+    }
+    return NULL;
+}
+
+/**
+ * Add a sticker on top of the others, sharing the data of stickers loaded from the same files
+ *
+ * @param atlasPath atlas file
+ * @param skeletonPath skeleton file, .json or .skel
+ * @param animationName animation to loop, may be NULL
+ * @return id of the sticker, 0 if its files could not be loaded
+ */
+int StickerScene::addSticker(const char *atlasPath, const char *skeletonPath,
+                             const char *animationName) {
+    StickerAsset *asset = acquireAsset(atlasPath, skeletonPath);
+    if (!asset) return 0;
+
+    StickerInstance *instance = new StickerInstance;
+    instance->id = mNextId++;
+    instance->asset = asset;
+    instance->skeleton = spSkeleton_create(asset->skeletonData);
+    instance->animationState = spAnimationState_create(asset->animationStateData);
+    instance->bakedAnimation = NULL;
+    instance->flipbook = NULL;
+    instance->playbackTime = 0.0f;
+    if (animationName) {
+        spAnimationState_setAnimationByName(instance->animationState, 0, animationName, 1);
+    }
+    mInstances.push_back(instance);
+    setStickerTransform(instance->id, 0.0f, 0.0f, 0.0f, 1.0f);
+    spSkeleton_updateWorldTransform(instance->skeleton);
+    return instance->id;
+}
+
+/**
+ * Remove a sticker, its asset goes away with the last sticker using it
+ *
+ * @return false if there is no sticker with this id
+ */
+bool StickerScene::removeSticker(int id) {
+    for (size_t i = 0; i < mInstances.size(); ++i) {
+        StickerInstance *instance = mInstances[i];
+        if (instance->id != id) continue;
+
+        mInstances.erase(mInstances.begin() + i);
+        if (instance->bakedAnimation) spBakedAnimation_dispose(instance->bakedAnimation);
+        delete instance->flipbook;
+        spAnimationState_dispose(instance->animationState);
+        spSkeleton_dispose(instance->skeleton);
+        releaseAsset(instance->asset);
+        delete instance;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Remove every sticker
+ */
+void StickerScene::clear() {
+    while (!mInstances.empty()) {
+        removeSticker(mInstances.back()->id);
+    }
+}
+
+/**
+ * Place a sticker in scene coordinates
+ *
+ * @param id sticker id
+ * @param x translation x
+ * @param y translation y
+ * @param angle rotation in degrees
+ * @param scale uniform scale
+ * @return false if there is no sticker with this id
+ */
+bool StickerScene::setStickerTransform(int id, float x, float y, float angle, float scale) {
+    StickerInstance *instance = findInstance(id);
+    if (!instance) return false;
+
+    float radians = angle * DEG_RAD;
+    float cosine = cosf(radians) * scale, sine = sinf(radians) * scale;
+    instance->transform[0] = cosine;
+    instance->transform[1] = sine;
+    instance->transform[2] = -sine;
+    instance->transform[3] = cosine;
+    instance->transform[4] = x;
+    instance->transform[5] = y;
+    return true;
+}
+
+/**
+ * Play the looping animation of a sticker from samples baked at sampleRate instead of applying
+ * its animation state and solving constraints every frame. Playback starts where the animation
+ * state is, which is left as it is until live playback resumes.
+ *
+ * @param id sticker id
+ * @param sampleRate samples per second, 0 to apply the animation state again
+ * @return false if there is no sticker with this id or it plays no animation
+ */
+bool StickerScene::setStickerBakedPlayback(int id, float sampleRate) {
+    StickerInstance *instance = findInstance(id);
+    if (!instance) return false;
+
+    if (instance->bakedAnimation) {
+        spBakedAnimation_dispose(instance->bakedAnimation);
+        instance->bakedAnimation = NULL;
+    }
+    if (sampleRate <= 0) return true;
+
+    spTrackEntry *entry = spAnimationState_getCurrent(instance->animationState, 0);
+    if (!entry) return false;
+    instance->bakedAnimation = spBakedAnimation_create(instance->skeleton, entry->animation,
+                                                       sampleRate);
+    instance->playbackTime = entry->trackTime;
+    return true;
+}
+
+/**
+ * Play the looping animation of a sticker from its baked render commands, its skeleton is
+ * neither posed nor built while the flipbook plays. Skeleton color and premultiplied alpha are
+ * baked in, the sticker transform is not. Playback starts where the animation state is.
+ *
+ * @param id sticker id
+ * @param frameRate frames per second, 0 to build the commands from the skeleton again
+ * @param budget max bytes for the frames, e.g. DEFAULT_FLIPBOOK_BUDGET
+ * @param quantized store positions as int16 instead of float
+ * @return false if there is no sticker with this id, it plays no animation or the frames did
+ * not fit the budget, the sticker keeps being evaluated live
+ */
+bool StickerScene::setStickerFlipbookPlayback(int id, float frameRate, size_t budget,
+                                              bool quantized) {
+    StickerInstance *instance = findInstance(id);
+    if (!instance) return false;
+
+    delete instance->flipbook;
+    instance->flipbook = NULL;
+    if (frameRate <= 0) return true;
+
+    spTrackEntry *entry = spAnimationState_getCurrent(instance->animationState, 0);
+    if (!entry) return false;
+    VertexFlipbook *flipbook = new VertexFlipbook();
+    if (!flipbook->bake(instance->skeleton, entry->animation, &mCommandBuilder, frameRate,
+                        budget, quantized)) {
+        delete flipbook;
+        return false;
+    }
+    instance->flipbook = flipbook;
+    instance->playbackTime = entry->trackTime;
+    return true;
+}
+
+int StickerScene::getStickerCount() {
+    return (int) mInstances.size();
+}
+
+int StickerScene::getAssetCount() {
+    return (int) mAssets.size();
+}
+
+/**
+ * Advance every sticker and pose its skeleton
+ *
+ * @param deltaTime seconds since the last update
+ */
+void StickerScene::update(float deltaTime) {
+    for (size_t i = 0; i < mInstances.size(); ++i) {
+        StickerInstance *instance = mInstances[i];
+        if (instance->flipbook) {
+            // Nothing to pose, the commands come from the flipbook
+            instance->playbackTime += deltaTime;
+            continue;
+        }
+        if (instance->bakedAnimation) {
+            // Baked world transforms, no animation state or constraints to evaluate
+            instance->playbackTime += deltaTime;
+            spBakedAnimation_apply(instance->bakedAnimation, instance->skeleton,
+                                   instance->playbackTime, 1);
+            continue;
+        }
+        spAnimationState_update(instance->animationState, deltaTime);
+        spAnimationState_apply(instance->animationState, instance->skeleton);
+        spSkeleton_updateWorldTransform(instance->skeleton);
+    }
+}
+
+/**
+ * Build one command list for all stickers, growing the buffers until everything fits
+ *
+ * @return the list, valid until the next call
+ */
+const RenderCommandList<PackedVertex> *StickerScene::buildRenderCommands() {
+    do {
+        if (mCommandList.overflow) {
+            reserveRenderCommands(mCommandList.vertexCapacity * 2,
+                                  mCommandList.indexCapacity * 2,
+                                  mCommandList.commandCapacity * 2);
+        }
+        mCommandBuilder.begin(&mCommandList);
+        for (size_t i = 0; i < mInstances.size() && !mCommandList.overflow; ++i) {
+            StickerInstance *instance = mInstances[i];
+            if (instance->flipbook) {
+                instance->flipbook->append(instance->playbackTime, true, &mCommandList,
+                                           instance->transform);
+            } else {
+                mCommandBuilder.append(instance->skeleton, &mCommandList, instance->transform);
+            }
+        }
+    } while (mCommandList.overflow);
+    return &mCommandList;
+}
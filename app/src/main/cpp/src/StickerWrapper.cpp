@@ -1,12 +1,34 @@
 #include <jni.h>
-#include <Sticker.h>
+#include <CommandRenderer.h>
+#include <StickerScene.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <utils/GLES2Utils.h>
+#include <utils/TimeUtils.h>
 
-Sticker *mSticker = NULL;
+CommandRenderer *mRenderer = NULL;
+StickerScene *mScene = NULL;
+glm::mat4 mSceneMvpMatrix;
+long mLastFrameTime = 0;
 const char *atlasPath = "/sdcard/Sticker/HPBD/HPBD.atlas";
 const char *jsonPath = "/sdcard/Sticker/HPBD/HPBD.json";
-const char *imagePath = "/sdcard/Sticker/HPBD/HPBD.png";
 const char *defAnimation = "animation";
 
+/*
+ * Dispose the scene before the renderer: atlases delete their page textures through it
+ */
+static void destroyScene() {
+    if (mScene) {
+        delete mScene;
+        mScene = NULL;
+    }
+
+    if (mRenderer) {
+        mRenderer->dispose();
+        delete mRenderer;
+        mRenderer = NULL;
+    }
+}
+
 /*
  * ----------------------------------------------------------------------------------
  * JNIEXPORT function - START
@@ -17,16 +39,22 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_blueeagle_hellospine_gl_StickerRenderer_initStickerView(JNIEnv *env,
                                                                         jobject instance) {
-    if (mSticker) {
-        delete mSticker;
-        mSticker = NULL;
-    }
+    destroyScene();
 
-    mSticker = new Sticker(atlasPath, jsonPath, imagePath, defAnimation);
-    mSticker->init();
+    mRenderer = new CommandRenderer();
+    mRenderer->setPremultipliedAlpha(true);
+    mRenderer->init();
+
+    // Page textures are loaded premultiplied by the atlas callbacks of the shared cache
+    ResourceCache *cache = getSharedResourceCache();
+    cache->setPremultipliedAlpha(true);
+    mScene = new StickerScene(cache);
+    mScene->setPremultipliedAlpha(true);
+    mScene->addSticker(atlasPath, jsonPath, defAnimation);
+    mLastFrameTime = 0;
 
     // Set blend func
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    cachedBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
 }
 
@@ -36,33 +64,100 @@ Java_com_blueeagle_hellospine_gl_StickerRenderer_onStickerSurfaceChanged(JNIEnv
                                                                                 jobject instance,
                                                                                 jint width,
                                                                                 jint height) {
-    if (mSticker)
-        mSticker->resize(width, height);
+    glViewport(0, 0, width, height);
+
+    // TODO Calculate position of camera (the left/right/top/bottom planes)
+    glm::mat4 projection = glm::ortho(0.0f, 2164.81f, 0.0f, 2819.37f, 2.0f, 5.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 3.0f), glm::vec3(0, 0, 0),
+                                 glm::vec3(0, 1.0f, 0));
+    mSceneMvpMatrix = projection * view;
 }
 
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_blueeagle_hellospine_gl_StickerRenderer_onStickerDrawFrame(JNIEnv *env,
                                                                            jobject instance) {
-    if (mSticker) {
+    if (mScene) {
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        mSticker->draw();
+        resetGLStateCounters();
+
+        long currentTime = getCurrentSystemTimeInMilli();
+        long deltaTime = mLastFrameTime == 0L ? 0L : currentTime - mLastFrameTime;
+        mLastFrameTime = currentTime;
+
+        mScene->update(deltaTime / 1000.0f);
+        mRenderer->render(mScene->buildRenderCommands(), mSceneMvpMatrix);
     }
 }
 
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_blueeagle_hellospine_gl_StickerRenderer_addSticker(JNIEnv *env, jobject instance,
+                                                            jstring atlasPath_,
+                                                            jstring skeletonPath_,
+                                                            jstring animation_) {
+    if (!mScene) return 0;
+
+    const char *atlasPath = env->GetStringUTFChars(atlasPath_, 0);
+    const char *skeletonPath = env->GetStringUTFChars(skeletonPath_, 0);
+    const char *animation = animation_ ? env->GetStringUTFChars(animation_, 0) : NULL;
+
+    jint id = mScene->addSticker(atlasPath, skeletonPath, animation);
+
+    env->ReleaseStringUTFChars(atlasPath_, atlasPath);
+    env->ReleaseStringUTFChars(skeletonPath_, skeletonPath);
+    if (animation) env->ReleaseStringUTFChars(animation_, animation);
+    return id;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_blueeagle_hellospine_gl_StickerRenderer_removeSticker(JNIEnv *env, jobject instance,
+                                                               jint id) {
+    return (jboolean) (mScene && mScene->removeSticker(id));
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_blueeagle_hellospine_gl_StickerRenderer_setStickerTransform(JNIEnv *env,
+                                                                     jobject instance, jint id,
+                                                                     jfloat x, jfloat y,
+                                                                     jfloat angle,
+                                                                     jfloat scale) {
+    return (jboolean) (mScene && mScene->setStickerTransform(id, x, y, angle, scale));
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_blueeagle_hellospine_gl_StickerRenderer_setStickerBakedPlayback(JNIEnv *env,
+                                                                         jobject instance,
+                                                                         jint id,
+                                                                         jfloat sampleRate) {
+    return (jboolean) (mScene && mScene->setStickerBakedPlayback(id, sampleRate));
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_blueeagle_hellospine_gl_StickerRenderer_setStickerFlipbookPlayback(JNIEnv *env,
+                                                                            jobject instance,
+                                                                            jint id,
+                                                                            jfloat frameRate,
+                                                                            jboolean quantized) {
+    return (jboolean) (mScene && mScene->setStickerFlipbookPlayback(id, frameRate,
+                                                                    DEFAULT_FLIPBOOK_BUDGET,
+                                                                    quantized));
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_blueeagle_hellospine_gl_StickerRenderer_destroySticker(JNIEnv *env,
                                                                        jobject instance) {
-    if (mSticker) {
-        delete mSticker;
-        mSticker = NULL;
-    }
+    destroyScene();
 }
 
 /*
  * ----------------------------------------------------------------------------------
  * JNIEXPORT function - END
  * ----------------------------------------------------------------------------------
- */
\ No newline at end of file
+ */
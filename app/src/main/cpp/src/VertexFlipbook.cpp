@@ -0,0 +1,445 @@
+#include <VertexFlipbook.h>
+#include <math.h>
+#include <string.h>
+
+#define BAKE_VERTEX_CAPACITY 1024
+#define BAKE_INDEX_CAPACITY 2048
+#define BAKE_COMMAND_CAPACITY 16
+
+/**
+ * Scratch buffers the frames are built into while baking
+ */
+struct BakeBuffers {
+    std::vector<PackedVertex> vertices;
+    std::vector<uint16_t> indices;
+    std::vector<RenderCommand> commands;
+    RenderCommandList<PackedVertex> list;
+
+    void reserve(int vertexCapacity, int indexCapacity, int commandCapacity) {
+        vertices.resize((size_t) vertexCapacity);
+        indices.resize((size_t) indexCapacity);
+        commands.resize((size_t) commandCapacity);
+        list.vertices = &vertices[0];
+        list.vertexCapacity = vertexCapacity;
+        list.indices = &indices[0];
+        list.indexCapacity = indexCapacity;
+        list.commands = &commands[0];
+        list.commandCapacity = commandCapacity;
+    }
+};
+
+/**
+ * Same page, blend mode and tint, so the two commands can be drawn as one
+ */
+static bool isSameBatch(const RenderCommand &a, const RenderCommand &b) {
+    return a.page == b.page && a.blendMode == b.blendMode && a.tint.r == b.tint.r &&
+           a.tint.g == b.tint.g && a.tint.b == b.tint.b && a.tint.a == b.tint.a;
+}
+
+static bool isSameCommand(const RenderCommand &a, const RenderCommand &b) {
+    return a.vertexStart == b.vertexStart && a.vertexCount == b.vertexCount &&
+           a.indexStart == b.indexStart && a.indexCount == b.indexCount && isSameBatch(a, b);
+}
+
+/**
+ * Blend two RGBA8 colors channel by channel
+ */
+static inline uint32_t lerpColor(uint32_t from, uint32_t to, float alpha) {
+    uint8_t a[4], b[4];
+    memcpy(a, &from, sizeof(from));
+    memcpy(b, &to, sizeof(to));
+    for (int i = 0; i < 4; ++i) {
+        a[i] = (uint8_t) (a[i] + (b[i] - a[i]) * alpha + 0.5f);
+    }
+    uint32_t color;
+    memcpy(&color, a, sizeof(color));
+    return color;
+}
+
+/**
+ * Readers of the two position formats, so the playback loop has no per-vertex format branch
+ */
+struct FloatPositions {
+    const float *positions;
+
+    explicit FloatPositions(const float *positions) : positions(positions) {
+    }
+
+    inline void read(int vertex, float *position) const {
+        position[0] = positions[vertex * 2];
+        position[1] = positions[vertex * 2 + 1];
+    }
+};
+
+struct QuantizedPositions {
+    const int16_t *positions;
+    float origin[2];
+    float scale[2];
+
+    QuantizedPositions(const int16_t *positions, const float *origin, const float *scale)
+            : positions(positions) {
+        // Fold the int16 offset into the origin
+        this->origin[0] = origin[0] + 32768.0f * scale[0];
+        this->origin[1] = origin[1] + 32768.0f * scale[1];
+        this->scale[0] = scale[0];
+        this->scale[1] = scale[1];
+    }
+
+    inline void read(int vertex, float *position) const {
+        position[0] = origin[0] + positions[vertex * 2] * scale[0];
+        position[1] = origin[1] + positions[vertex * 2 + 1] * scale[1];
+    }
+};
+
+/**
+ * Write one frame, or the blend of two frames of the same topology when alpha > 0
+ *
+ * @param transform affine a, b, c, d, tx, ty applied to the positions, NULL for none
+ */
+template<typename Positions>
+static void writeVertices(const Positions &positions, const Positions &nextPositions,
+                          const uint32_t *colors, const uint32_t *nextColors,
+                          const uint16_t *uvs, float alpha, const float *transform,
+                          PackedVertex *vertices, int vertexCount) {
+    for (int i = 0; i < vertexCount; ++i) {
+        PackedVertex *vertex = vertices + i;
+        float position[2];
+        positions.read(i, position);
+        uint32_t color = colors[i];
+        if (alpha > 0.0f) {
+            float nextPosition[2];
+            nextPositions.read(i, nextPosition);
+            position[0] += (nextPosition[0] - position[0]) * alpha;
+            position[1] += (nextPosition[1] - position[1]) * alpha;
+            if (color != nextColors[i]) color = lerpColor(color, nextColors[i], alpha);
+        }
+        if (transform) {
+            float x = position[0], y = position[1];
+            position[0] = transform[0] * x + transform[2] * y + transform[4];
+            position[1] = transform[1] * x + transform[3] * y + transform[5];
+        }
+        vertex->x = position[0];
+        vertex->y = position[1];
+        vertex->u = uvs[i * 2];
+        vertex->v = uvs[i * 2 + 1];
+        memcpy(&vertex->r, &color, sizeof(color));
+    }
+}
+
+VertexFlipbook::VertexFlipbook() {
+    clear();
+}
+
+VertexFlipbook::~VertexFlipbook() {
+}
+
+/**
+ * Drop every frame, the flipbook is empty until the next successful bake()
+ */
+void VertexFlipbook::clear() {
+    mFrameRate = 0.0f;
+    mDuration = 0.0f;
+    mQuantized = false;
+    mOrigin[0] = mOrigin[1] = 0.0f;
+    mScale[0] = mScale[1] = 0.0f;
+    std::vector<FlipbookTopology>().swap(mTopologies);
+    std::vector<FlipbookFrame>().swap(mFrames);
+    std::vector<float>().swap(mPositions);
+    std::vector<int16_t>().swap(mQuantizedPositions);
+    std::vector<uint32_t>().swap(mColors);
+    mByteCount = 0;
+    mMaxVertexCount = 0;
+    mMaxIndexCount = 0;
+    mMaxCommandCount = 0;
+}
+
+/**
+ * Sample a looping animation from the setup pose at every 1 / frameRate and keep the render
+ * commands the builder makes of each pose. The skeleton is left in the setup pose.
+ *
+ * @param skeleton skeleton of the animation, its position and color are baked in
+ * @param builder builder the live path uses, for the same premultiplied alpha handling
+ * @param frameRate frames per second
+ * @param budget max bytes kept for frames and topologies
+ * @param quantized store positions as int16 instead of float
+ * @return false, with the flipbook left empty, if the frames do not fit the budget
+ */
+bool VertexFlipbook::bake(spSkeleton *skeleton, spAnimation *animation,
+                          RenderCommandBuilder<PackedVertex> *builder, float frameRate,
+                          size_t budget, bool quantized) {
+    clear();
+    if (frameRate <= 0.0f) return false;
+
+    // Frames cover [0, duration), the loop wraps back to the first one
+    float frames = animation->duration * frameRate;
+    int frameCount = (int) frames;
+    if (frameCount < frames) frameCount++;
+    if (frameCount < 1) frameCount = 1;
+
+    BakeBuffers buffers;
+    buffers.reserve(BAKE_VERTEX_CAPACITY, BAKE_INDEX_CAPACITY, BAKE_COMMAND_CAPACITY);
+    size_t vertexBytes = (quantized ? 2 * sizeof(int16_t) : 2 * sizeof(float)) + sizeof(uint32_t);
+    bool fits = true;
+    for (int i = 0; i < frameCount && fits; ++i) {
+        float time = i / frameRate;
+        spSkeleton_setToSetupPose(skeleton);
+        spAnimation_apply(animation, skeleton, time, time, 1, NULL, NULL, 1.0f, SP_MIX_POSE_SETUP,
+                          SP_MIX_DIRECTION_IN);
+        spSkeleton_updateWorldTransform(skeleton);
+
+        builder->build(skeleton, &buffers.list);
+        while (buffers.list.overflow) {
+            buffers.reserve(buffers.list.vertexCapacity * 2, buffers.list.indexCapacity * 2,
+                            buffers.list.commandCapacity * 2);
+            builder->build(skeleton, &buffers.list);
+        }
+
+        const RenderCommandList<PackedVertex> *list = &buffers.list;
+        FlipbookFrame frame;
+        frame.topology = findTopology(list);
+        frame.vertexStart = mColors.size();
+        mFrames.push_back(frame);
+        for (int j = 0; j < list->vertexCount; ++j) {
+            const PackedVertex *vertex = list->vertices + j;
+            uint32_t color;
+            memcpy(&color, &vertex->r, sizeof(color));
+            mPositions.push_back(vertex->x);
+            mPositions.push_back(vertex->y);
+            mColors.push_back(color);
+        }
+
+        mByteCount += sizeof(FlipbookFrame) + list->vertexCount * vertexBytes;
+        if (list->vertexCount > mMaxVertexCount) mMaxVertexCount = list->vertexCount;
+        if (list->indexCount > mMaxIndexCount) mMaxIndexCount = list->indexCount;
+        if (list->commandCount > mMaxCommandCount) mMaxCommandCount = list->commandCount;
+        fits = mByteCount <= budget;
+    }
+
+    spSkeleton_setToSetupPose(skeleton);
+    spSkeleton_updateWorldTransform(skeleton);
+    if (!fits) {
+        clear();
+        return false;
+    }
+
+    mFrameRate = frameRate;
+    mDuration = animation->duration;
+    mQuantized = quantized;
+    if (quantized) quantizePositions();
+    return true;
+}
+
+/**
+ * Index of the topology the built frame uses, added when no earlier frame had it
+ */
+int VertexFlipbook::findTopology(const RenderCommandList<PackedVertex> *list) {
+    // Consecutive frames mostly share their topology, so look from the newest one back
+    for (int i = (int) mTopologies.size() - 1; i >= 0; --i) {
+        const FlipbookTopology &topology = mTopologies[i];
+        if ((int) topology.commands.size() != list->commandCount ||
+            (int) topology.indices.size() != list->indexCount ||
+            (int) topology.uvs.size() != list->vertexCount * 2) {
+            continue;
+        }
+        bool same = true;
+        for (int j = 0; j < list->commandCount && same; ++j) {
+            same = isSameCommand(topology.commands[j], list->commands[j]);
+        }
+        for (int j = 0; j < list->vertexCount && same; ++j) {
+            same = topology.uvs[j * 2] == list->vertices[j].u &&
+                   topology.uvs[j * 2 + 1] == list->vertices[j].v;
+        }
+        if (same && list->indexCount > 0) {
+            same = memcmp(&topology.indices[0], list->indices,
+                          list->indexCount * sizeof(uint16_t)) == 0;
+        }
+        if (same) return i;
+    }
+
+    mTopologies.push_back(FlipbookTopology());
+    FlipbookTopology &topology = mTopologies.back();
+    topology.commands.assign(list->commands, list->commands + list->commandCount);
+    topology.indices.assign(list->indices, list->indices + list->indexCount);
+    for (int j = 0; j < list->vertexCount; ++j) {
+        topology.uvs.push_back(list->vertices[j].u);
+        topology.uvs.push_back(list->vertices[j].v);
+    }
+    mByteCount += list->commandCount * sizeof(RenderCommand) +
+                  list->indexCount * sizeof(uint16_t) + list->vertexCount * 2 * sizeof(uint16_t);
+    return (int) mTopologies.size() - 1;
+}
+
+/**
+ * Replace the float positions with int16 steps across the bounds of every frame
+ */
+void VertexFlipbook::quantizePositions() {
+    size_t count = mPositions.size();
+    for (int axis = 0; axis < 2; ++axis) {
+        float min = 0.0f, max = 0.0f;
+        for (size_t i = axis; i < count; i += 2) {
+            if (i == (size_t) axis || mPositions[i] < min) min = mPositions[i];
+            if (i == (size_t) axis || mPositions[i] > max) max = mPositions[i];
+        }
+        mOrigin[axis] = min;
+        mScale[axis] = (max - min) / 65535.0f;
+    }
+
+    mQuantizedPositions.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        int axis = (int) (i & 1);
+        float steps = mScale[axis] > 0.0f ? (mPositions[i] - mOrigin[axis]) / mScale[axis] : 0.0f;
+        int q = (int) (steps + 0.5f);
+        if (q > 65535) q = 65535;
+        mQuantizedPositions[i] = (int16_t) (q - 32768);
+    }
+    std::vector<float>().swap(mPositions);
+}
+
+bool VertexFlipbook::isBaked() const {
+    return !mFrames.empty();
+}
+
+int VertexFlipbook::getFrameCount() const {
+    return (int) mFrames.size();
+}
+
+int VertexFlipbook::getTopologyCount() const {
+    return (int) mTopologies.size();
+}
+
+/**
+ * Bytes kept for frames and topologies, what the budget of bake() is checked against
+ */
+size_t VertexFlipbook::getByteCount() const {
+    return mByteCount;
+}
+
+float VertexFlipbook::getBytesPerSecond() const {
+    return mDuration > 0.0f ? mByteCount / mDuration : (float) mByteCount;
+}
+
+/**
+ * Largest distance between a stored and a built position, half a quantization step
+ */
+float VertexFlipbook::getQuantizationError() const {
+    return mQuantized ? 0.5f * fmaxf(mScale[0], mScale[1]) : 0.0f;
+}
+
+/**
+ * Largest frame, to size the buffers play() writes to once
+ */
+void VertexFlipbook::getMaxCounts(int *vertexCount, int *indexCount, int *commandCount) const {
+    *vertexCount = mMaxVertexCount;
+    *indexCount = mMaxIndexCount;
+    *commandCount = mMaxCommandCount;
+}
+
+/**
+ * Fill the command list with the frame at the given time. Frames showing the same
+ * topology are blended, a change of attachments or draw order snaps to the earlier frame.
+ *
+ * @param time seconds since the start of the animation, wrapped around its duration
+ * @param interpolate blend with the next frame, else show the frame at or before the time
+ * @param list caller-owned buffers, overflow is set if the frame does not fit
+ */
+void VertexFlipbook::play(float time, bool interpolate,
+                          RenderCommandList<PackedVertex> *list) const {
+    list->vertexCount = 0;
+    list->indexCount = 0;
+    list->commandCount = 0;
+    list->overflow = false;
+    append(time, interpolate, list, NULL);
+}
+
+/**
+ * Append the frame at the given time behind what the list already holds, as
+ * RenderCommandBuilder::append does with a posed skeleton: the first command joins the last
+ * one of the list when they share page, blend mode and tint.
+ *
+ * @param time seconds since the start of the animation, wrapped around its duration
+ * @param interpolate blend with the next frame, else show the frame at or before the time
+ * @param list caller-owned buffers, overflow is set if the frame does not fit
+ * @param transform affine a, b, c, d, tx, ty applied to the positions, NULL for none
+ */
+void VertexFlipbook::append(float time, bool interpolate, RenderCommandList<PackedVertex> *list,
+                            const float *transform) const {
+    if (mFrames.empty()) return;
+
+    if (mDuration > 0.0f) {
+        time = fmodf(time, mDuration);
+        if (time < 0.0f) time += mDuration;
+    } else {
+        time = 0.0f;
+    }
+    int frameCount = (int) mFrames.size();
+    int index = (int) (time * mFrameRate);
+    // time * frameRate can round just below a frame the time is exactly at
+    if ((index + 1) / mFrameRate <= time) index++;
+    if (index >= frameCount) index = frameCount - 1;
+    int nextIndex = index + 1 < frameCount ? index + 1 : 0;
+    const FlipbookFrame &frame = mFrames[index];
+    const FlipbookFrame &next = mFrames[nextIndex];
+
+    float alpha = 0.0f;
+    if (interpolate && next.topology == frame.topology && nextIndex != index) {
+        float frameTime = index / mFrameRate;
+        float nextTime = fminf((index + 1) / mFrameRate, mDuration);
+        if (nextTime > frameTime) alpha = (time - frameTime) / (nextTime - frameTime);
+    }
+
+    const FlipbookTopology &topology = mTopologies[frame.topology];
+    int vertexCount = (int) (topology.uvs.size() >> 1);
+    int indexCount = (int) topology.indices.size();
+    int commandCount = (int) topology.commands.size();
+    if (list->vertexCount + vertexCount > list->vertexCapacity ||
+        list->indexCount + indexCount > list->indexCapacity ||
+        list->commandCount + commandCount > list->commandCapacity) {
+        list->overflow = true;
+        return;
+    }
+
+    int vertexStart = list->vertexCount;
+    for (int i = 0; i < commandCount; ++i) {
+        const RenderCommand &command = topology.commands[i];
+        const uint16_t *indices = &topology.indices[command.indexStart];
+        uint16_t *target = list->indices + list->indexCount;
+        RenderCommand *last = list->commandCount > 0 ? &list->commands[list->commandCount - 1]
+                                                     : NULL;
+        if (last && isSameBatch(*last, command) &&
+            last->vertexCount + command.vertexCount <= MAX_COMMAND_VERTEX_COUNT) {
+            // Indices are relative to the first vertex of the command they join
+            uint16_t base = (uint16_t) (vertexStart + command.vertexStart - last->vertexStart);
+            for (int j = 0; j < command.indexCount; ++j) {
+                target[j] = base + indices[j];
+            }
+            last->vertexCount += command.vertexCount;
+            last->indexCount += command.indexCount;
+        } else {
+            RenderCommand *appended = &list->commands[list->commandCount++];
+            *appended = command;
+            appended->vertexStart = vertexStart + command.vertexStart;
+            appended->indexStart = list->indexCount;
+            memcpy(target, indices, command.indexCount * sizeof(uint16_t));
+        }
+        list->indexCount += command.indexCount;
+    }
+
+    if (vertexCount > 0) {
+        const uint32_t *colors = mColors.data() + frame.vertexStart;
+        const uint32_t *nextColors = mColors.data() + next.vertexStart;
+        PackedVertex *vertices = list->vertices + vertexStart;
+        if (mQuantized) {
+            const int16_t *quantized = mQuantizedPositions.data();
+            QuantizedPositions positions(quantized + frame.vertexStart * 2, mOrigin, mScale);
+            QuantizedPositions nextPositions(quantized + next.vertexStart * 2, mOrigin, mScale);
+            writeVertices(positions, nextPositions, colors, nextColors, &topology.uvs[0], alpha,
+                          transform, vertices, vertexCount);
+        } else {
+            FloatPositions positions(mPositions.data() + frame.vertexStart * 2);
+            FloatPositions nextPositions(mPositions.data() + next.vertexStart * 2);
+            writeVertices(positions, nextPositions, colors, nextColors, &topology.uvs[0], alpha,
+                          transform, vertices, vertexCount);
+        }
+    }
+    list->vertexCount += vertexCount;
+}
@@ -52,6 +52,11 @@ void spAnimation_dispose (spAnimation* self) {
 
 void spAnimation_apply (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events,
 		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+	spAnimation_applyWithCursors(self, skeleton, lastTime, time, loop, events, eventsCount, alpha, pose, direction, 0);
+}
+
+void spAnimation_applyWithCursors (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursors) {
 	int i, n = self->timelinesCount;
 
 	if (loop && self->duration) {
@@ -60,21 +65,22 @@ void spAnimation_apply (const spAnimation* self, spSkeleton* skeleton, float las
 	}
 
 	for (i = 0; i < n; ++i)
-		spTimeline_apply(self->timelines[i], skeleton, lastTime, time, events, eventsCount, alpha, pose, direction);
+		spTimeline_applyWithCursor(self->timelines[i], skeleton, lastTime, time, events, eventsCount, alpha, pose, direction,
+			cursors ? cursors + i : 0);
 }
 
 /**/
 
 typedef struct _spTimelineVtable {
 	void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-			int* eventsCount, float alpha, spMixPose pose, spMixDirection direction);
+			int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor);
 	int (*getPropertyId) (const spTimeline* self);
 	void (*dispose) (spTimeline* self);
 } _spTimelineVtable;
 
 void _spTimeline_init (spTimeline* self, spTimelineType type, /**/
 					   void (*dispose) (spTimeline* self), /**/
-					   void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction),
+					   void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor),
 					   int (*getPropertyId) (const spTimeline* self)) {
 	CONST_CAST(spTimelineType, self->type) = type;
 	CONST_CAST(_spTimelineVtable*, self->vtable) = NEW(_spTimelineVtable);
@@ -93,7 +99,12 @@ void spTimeline_dispose (spTimeline* self) {
 
 void spTimeline_apply (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
-	VTABLE(spTimeline, self)->apply(self, skeleton, lastTime, time, firedEvents, eventsCount, alpha, pose, direction);
+	VTABLE(spTimeline, self)->apply(self, skeleton, lastTime, time, firedEvents, eventsCount, alpha, pose, direction, 0);
+}
+
+void spTimeline_applyWithCursor (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor) {
+	VTABLE(spTimeline, self)->apply(self, skeleton, lastTime, time, firedEvents, eventsCount, alpha, pose, direction, cursor);
 }
 
 int spTimeline_getPropertyId (const spTimeline* self) {
@@ -102,28 +113,38 @@ int spTimeline_getPropertyId (const spTimeline* self) {
 
 /**/
 
-static const float CURVE_LINEAR = 0, CURVE_STEPPED = 1, CURVE_BEZIER = 2;
-static const int BEZIER_SIZE = 10 * 2 - 1;
+static const int CURVE_LINEAR = 0, CURVE_STEPPED = -1;
+#define BEZIER_POINTS 9
+static const int BEZIER_SIZE = BEZIER_POINTS * 2;
 
 void _spCurveTimeline_init (spCurveTimeline* self, spTimelineType type, int framesCount, /**/
 		void (*dispose) (spTimeline* self), /**/
-		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction),
+		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor),
 		int (*getPropertyId)(const spTimeline* self)) {
 	_spTimeline_init(SUPER(self), type, dispose, apply, getPropertyId);
-	self->curves = CALLOC(float, (framesCount - 1) * BEZIER_SIZE);
+	self->curvesCount = framesCount - 1;
+	self->curves = CALLOC(int, self->curvesCount);
+	self->bezierCurves = 0;
+	self->bezierCurvesCount = 0;
+	self->bezierCurvesCapacity = 0;
 }
 
 void _spCurveTimeline_deinit (spCurveTimeline* self) {
 	_spTimeline_deinit(SUPER(self));
 	FREE(self->curves);
+	FREE(self->bezierCurves);
+}
+
+int _spCurveTimeline_isStepped (const spCurveTimeline* self, int frameIndex) {
+	return self->curves[frameIndex] == CURVE_STEPPED;
 }
 
 void spCurveTimeline_setLinear (spCurveTimeline* self, int frameIndex) {
-	self->curves[frameIndex * BEZIER_SIZE] = CURVE_LINEAR;
+	self->curves[frameIndex] = CURVE_LINEAR;
 }
 
 void spCurveTimeline_setStepped (spCurveTimeline* self, int frameIndex) {
-	self->curves[frameIndex * BEZIER_SIZE] = CURVE_STEPPED;
+	self->curves[frameIndex] = CURVE_STEPPED;
 }
 
 void spCurveTimeline_setCurve (spCurveTimeline* self, int frameIndex, float cx1, float cy1, float cx2, float cy2) {
@@ -132,13 +153,29 @@ void spCurveTimeline_setCurve (spCurveTimeline* self, int frameIndex, float cx1,
 	float ddfx = tmpx * 2 + dddfx, ddfy = tmpy * 2 + dddfy;
 	float dfx = cx1 * 0.3f + tmpx + dddfx * 0.16666667f, dfy = cy1 * 0.3f + tmpy + dddfy * 0.16666667f;
 	float x = dfx, y = dfy;
+	float* points;
+	int i;
+
+	/* Handles on the diagonal make y equal x all along the curve. */
+	if (cx1 == cy1 && cx2 == cy2) {
+		self->curves[frameIndex] = CURVE_LINEAR;
+		return;
+	}
 
-	int i = frameIndex * BEZIER_SIZE, n = i + BEZIER_SIZE - 1;
-	self->curves[i++] = CURVE_BEZIER;
+	/* A Bezier frame set again keeps its slot. One set linear or stepped in between has lost it and takes a new one, so the
+	 * slots may outnumber the frames. */
+	if (self->curves[frameIndex] <= 0) {
+		if (self->bezierCurvesCount == self->bezierCurvesCapacity) {
+			self->bezierCurvesCapacity = MAX(4, self->bezierCurvesCapacity << 1);
+			self->bezierCurves = REALLOC(self->bezierCurves, float, self->bezierCurvesCapacity * BEZIER_SIZE);
+		}
+		self->curves[frameIndex] = ++self->bezierCurvesCount;
+	}
+	points = self->bezierCurves + (self->curves[frameIndex] - 1) * BEZIER_SIZE;
 
-	for (; i < n; i += 2) {
-		self->curves[i] = x;
-		self->curves[i + 1] = y;
+	for (i = 0; i < BEZIER_SIZE; i += 2) {
+		points[i] = x;
+		points[i + 1] = y;
 		dfx += ddfx;
 		dfy += ddfy;
 		ddfx += dddfx;
@@ -148,31 +185,34 @@ void spCurveTimeline_setCurve (spCurveTimeline* self, int frameIndex, float cx1,
 	}
 }
 
+/* The x of the points only grows, so the segment holding percent is the number of points left of it. Counting them has no
+ * early exit or data dependent branch, unlike scanning for the first point at or past percent, and gives the same segment. */
 float spCurveTimeline_getCurvePercent (const spCurveTimeline* self, int frameIndex, float percent) {
-	float x, y;
-	int i = frameIndex * BEZIER_SIZE, start, n;
-	float type = self->curves[i];
+	const float* points;
+	float prevX, prevY, x, y;
+	int curve = self->curves[frameIndex], segment, i;
 	percent = CLAMP(percent, 0, 1);
-	if (type == CURVE_LINEAR) return percent;
-	if (type == CURVE_STEPPED) return 0;
-	i++;
-	x = 0;
-	for (start = i, n = i + BEZIER_SIZE - 1; i < n; i += 2) {
-		x = self->curves[i];
-		if (x >= percent) {
-			float prevX, prevY;
-			if (i == start) {
-				prevX = 0;
-				prevY = 0;
-			} else {
-				prevX = self->curves[i - 2];
-				prevY = self->curves[i - 1];
-			}
-			return prevY + (self->curves[i + 1] - prevY) * (percent - prevX) / (x - prevX);
-		}
+	if (curve == CURVE_LINEAR) return percent;
+	if (curve == CURVE_STEPPED) return 0;
+	points = self->bezierCurves + (curve - 1) * BEZIER_SIZE;
+	segment = 0;
+	for (i = 0; i < BEZIER_SIZE; i += 2)
+		segment += points[i] < percent;
+	if (segment == 0) {
+		prevX = 0;
+		prevY = 0;
+	} else {
+		prevX = points[segment * 2 - 2];
+		prevY = points[segment * 2 - 1];
+	}
+	if (segment == BEZIER_POINTS) {
+		x = 1; /* Last point is 1,1. */
+		y = 1;
+	} else {
+		x = points[segment * 2];
+		y = points[segment * 2 + 1];
 	}
-	y = self->curves[i - 1];
-	return y + (1 - y) * (percent - x) / (1 - x); /* Last point is 1,1. */
+	return prevY + (y - prevY) * (percent - prevX) / (x - prevX);
 }
 
 /* @param target After the first and before the last entry. */
@@ -196,36 +236,144 @@ int _spCurveTimeline_binarySearch (float *values, int valuesLength, float target
 	return binarySearch(values, valuesLength, target, step);
 }
 
-/* @param target After the first and before the last entry. */
-static int binarySearch1 (float *values, int valuesLength, float target) {
-	int low = 0, current;
-	int high = valuesLength - 2;
-	if (high == 0) return 1;
+/* binarySearch that first tries the frame the cursor found last and the one after it, so time moving forward by less than a
+ * frame needs no search. The result is the same for frame times in ascending order. cursor may be 0.
+ * @param target After the first and before the last entry. */
+static int search (float *values, int valuesLength, float target, int step, spTimelineCursor* cursor) {
+	int low = 0, current, high, frame;
+	if (!cursor) return binarySearch(values, valuesLength, target, step);
+
+	cursor->lookups++;
+	frame = cursor->frame;
+	if (frame > 0 && frame < valuesLength && values[frame - step] <= target) {
+		if (target < values[frame]) return frame;
+		frame += step;
+		if (frame < valuesLength && target < values[frame]) {
+			cursor->frame = frame;
+			return frame;
+		}
+	}
+
+	/* First lookup, a seek, a loop or a jump past the next frame. */
+	cursor->searches++;
+	high = valuesLength / step - 2;
+	if (high == 0) {
+		cursor->frame = step;
+		return step;
+	}
 	current = high >> 1;
 	while (1) {
-		if (values[(current + 1)] <= target)
+		cursor->searchSteps++;
+		if (values[(current + 1) * step] <= target)
 			low = current + 1;
 		else
 			high = current;
-		if (low == high) return low + 1;
+		if (low == high) {
+			cursor->frame = (low + 1) * step;
+			return cursor->frame;
+		}
 		current = (low + high) >> 1;
 	}
 	return 0;
 }
 
+int _spCurveTimeline_search (float *values, int valuesLength, float target, int step, spTimelineCursor* cursor) {
+	return search(values, valuesLength, target, step, cursor);
+}
+
+static int _spAnimation_addStepTime (float* times, int count, int capacity, float time) {
+	if (count < capacity) times[count] = time;
+	return count + 1;
+}
+
+/* Time and values of one key of a timeline with the spBaseTimeline layout, 0 for the other timelines. */
+static int _spBaseTimeline_getEntries (spTimelineType type) {
+	switch (type) {
+	case SP_TIMELINE_ROTATE:
+		return ROTATE_ENTRIES;
+	case SP_TIMELINE_COLOR:
+		return COLOR_ENTRIES;
+	case SP_TIMELINE_TWOCOLOR:
+		return TWOCOLOR_ENTRIES;
+	case SP_TIMELINE_TRANSFORMCONSTRAINT:
+		return TRANSFORMCONSTRAINT_ENTRIES;
+	case SP_TIMELINE_PATHCONSTRAINTPOSITION:
+	case SP_TIMELINE_PATHCONSTRAINTSPACING:
+		return PATHCONSTRAINTPOSITION_ENTRIES;
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE:
+	case SP_TIMELINE_SHEAR:
+	case SP_TIMELINE_IKCONSTRAINT:
+	case SP_TIMELINE_PATHCONSTRAINTMIX:
+		return TRANSLATE_ENTRIES;
+	default: /* Attachment, deform, event and draw order keys are times only. */
+		return 0;
+	}
+}
+
+int _spAnimation_getStepTimes (const spAnimation* self, float* times, int capacity) {
+	int i, ii, entries, count = 0;
+	for (i = 0; i < self->timelinesCount; ++i) {
+		spTimeline* timeline = self->timelines[i];
+		switch (timeline->type) {
+		case SP_TIMELINE_ATTACHMENT: {
+			spAttachmentTimeline* attachmentTimeline = SUB_CAST(spAttachmentTimeline, timeline);
+			for (ii = 0; ii < attachmentTimeline->framesCount; ++ii)
+				count = _spAnimation_addStepTime(times, count, capacity, attachmentTimeline->frames[ii]);
+			continue;
+		}
+		case SP_TIMELINE_DRAWORDER: {
+			spDrawOrderTimeline* drawOrderTimeline = SUB_CAST(spDrawOrderTimeline, timeline);
+			for (ii = 0; ii < drawOrderTimeline->framesCount; ++ii)
+				count = _spAnimation_addStepTime(times, count, capacity, drawOrderTimeline->frames[ii]);
+			continue;
+		}
+		case SP_TIMELINE_DEFORM:
+		case SP_TIMELINE_EVENT:
+			continue;
+		default: {
+			struct spBaseTimeline* baseTimeline = SUB_CAST(struct spBaseTimeline, timeline);
+			const spCompactKeyframes* keyframes = baseTimeline->keyframes;
+			int keysCount;
+			entries = _spBaseTimeline_getEntries(timeline->type);
+			keysCount = baseTimeline->framesCount / entries;
+			for (ii = 1; ii < keysCount; ++ii) {
+				if (!_spCurveTimeline_isStepped(SUPER(baseTimeline), ii - 1)) continue;
+				count = _spAnimation_addStepTime(times, count, capacity,
+					keyframes ? keyframes->times[ii] : baseTimeline->frames[ii * entries]);
+			}
+		}
+		}
+	}
+	return count;
+}
+
 /**/
 
+/* Key times shared by compact keyframes, freed with the last of them. */
+typedef struct {
+	int refCount;
+} _spKeyTimes;
+
+#define KEY_TIMES(TIMES) ((_spKeyTimes*)(TIMES) - 1)
+
+static void _spCompactKeyframes_dispose (spCompactKeyframes* self) {
+	if (--KEY_TIMES(self->times)->refCount == 0) FREE(KEY_TIMES(self->times));
+	FREE(self);
+}
+
 void _spBaseTimeline_dispose (spTimeline* timeline) {
 	struct spBaseTimeline* self = SUB_CAST(struct spBaseTimeline, timeline);
 	_spCurveTimeline_deinit(SUPER(self));
 	FREE(self->frames);
+	if (self->keyframes) _spCompactKeyframes_dispose(self->keyframes);
 	FREE(self);
 }
 
 /* Many timelines have structure identical to struct spBaseTimeline and extend spCurveTimeline. **/
 struct spBaseTimeline* _spBaseTimeline_create (int framesCount, spTimelineType type, int frameSize, /**/
 		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-				int* eventsCount, float alpha, spMixPose pose, spMixDirection direction),
+				int* eventsCount, float alpha, spMixPose pose, spMixDirection direction, spTimelineCursor* cursor),
 		int (*getPropertyId) (const spTimeline* self)) {
 	struct spBaseTimeline* self = NEW(struct spBaseTimeline);
 	_spCurveTimeline_init(SUPER(self), type, framesCount, _spBaseTimeline_dispose, apply, getPropertyId);
@@ -238,16 +386,168 @@ struct spBaseTimeline* _spBaseTimeline_create (int framesCount, spTimelineType t
 
 /**/
 
+float* _spBaseTimeline_getFrames (const struct spBaseTimeline* self, float time, spTimelineCursor** cursor, float* buffer,
+		int* framesCount, int* first) {
+	const spCompactKeyframes* keyframes = self->keyframes;
+	float* times;
+	int valuesCount, key, count, i, ii;
+	if (!keyframes) {
+		*framesCount = self->framesCount;
+		*first = 0;
+		return self->frames;
+	}
+
+	times = keyframes->times;
+	valuesCount = keyframes->valuesCount;
+	if (time < times[0]) {
+		key = 0;
+		count = 1;
+	} else if (time >= times[keyframes->keysCount - 1]) {
+		key = keyframes->keysCount - 1;
+		count = 1;
+	} else {
+		key = search(times, keyframes->keysCount, time, 1, *cursor) - 1;
+		count = 2;
+	}
+	if (keyframes->colors) {
+		const unsigned char* colors = (const unsigned char*)(keyframes + 1) + key * valuesCount;
+		for (i = 0; i < count; ++i, ++buffer) {
+			*buffer = times[key + i];
+			/* Same division as the loaders, so colors read from 8 bit channels come back exactly. */
+			for (ii = 0; ii < valuesCount; ++ii)
+				*++buffer = *colors++ / 255.0f;
+		}
+	} else {
+		const float* offsets = (const float*)(keyframes + 1);
+		const float* scales = offsets + valuesCount;
+		const unsigned short* values = (const unsigned short*)(scales + valuesCount) + key * valuesCount;
+		for (i = 0; i < count; ++i, ++buffer) {
+			*buffer = times[key + i];
+			for (ii = 0; ii < valuesCount; ++ii)
+				*++buffer = offsets[ii] + *values++ * scales[ii];
+		}
+	}
+
+	*framesCount = count * (valuesCount + 1);
+	*first = key;
+	*cursor = 0;
+	return buffer - *framesCount;
+}
+
+/* Replaces the frames of the timeline by compact keyframes using the key times of shared if given, unless that would not make
+ * them smaller. */
+static void _spBaseTimeline_compact (struct spBaseTimeline* self, int entries, float* shared) {
+	int keysCount = self->framesCount / entries, valuesCount = entries - 1, i, ii;
+	int colors = self->super.super.type == SP_TIMELINE_COLOR || self->super.super.type == SP_TIMELINE_TWOCOLOR;
+	size_t size = sizeof(spCompactKeyframes), timesSize = shared ? 0 : sizeof(_spKeyTimes) + keysCount * sizeof(float);
+	spCompactKeyframes* keyframes;
+	float *offsets = 0, *scales = 0;
+	unsigned short* values = 0;
+	unsigned char* colorValues = 0;
+	if (self->keyframes || keysCount == 0) return;
+
+	if (colors)
+		size += keysCount * valuesCount * sizeof(unsigned char);
+	else
+		size += valuesCount * 2 * sizeof(float) + keysCount * valuesCount * sizeof(unsigned short);
+	if (size + timesSize >= self->framesCount * sizeof(float)) return;
+
+	keyframes = (spCompactKeyframes*)MALLOC(char, size);
+	keyframes->keysCount = keysCount;
+	keyframes->valuesCount = valuesCount;
+	keyframes->colors = colors;
+	if (!shared) {
+		_spKeyTimes* keyTimes = (_spKeyTimes*)MALLOC(char, timesSize);
+		keyTimes->refCount = 0;
+		shared = (float*)(keyTimes + 1);
+		for (i = 0; i < keysCount; ++i)
+			shared[i] = self->frames[i * entries];
+	}
+	KEY_TIMES(shared)->refCount++;
+	keyframes->times = shared;
+	if (colors)
+		colorValues = (unsigned char*)(keyframes + 1);
+	else {
+		offsets = (float*)(keyframes + 1);
+		scales = offsets + valuesCount;
+		values = (unsigned short*)(scales + valuesCount);
+	}
+
+	for (ii = 0; ii < valuesCount; ++ii) {
+		float min = self->frames[ii + 1], max = min, scale;
+		int integral = 1;
+		if (colors) {
+			for (i = 0; i < keysCount; ++i) {
+				float value = CLAMP(self->frames[i * entries + ii + 1], 0, 1);
+				colorValues[i * valuesCount + ii] = (unsigned char)(value * 255 + 0.5f);
+			}
+			continue;
+		}
+		for (i = 0; i < keysCount; ++i) {
+			float value = self->frames[i * entries + ii + 1];
+			if (value < min) min = value;
+			if (value > max) max = value;
+			if (value != (float)floor(value)) integral = 0;
+		}
+		/* Integers, such as IK bend directions, keep steps of 1 to stay exact. */
+		scale = integral && max - min <= 65535 ? 1 : (max - min) / 65535;
+		offsets[ii] = min;
+		scales[ii] = scale;
+		for (i = 0; i < keysCount; ++i) {
+			float steps = scale > 0 ? (self->frames[i * entries + ii + 1] - min) / scale + 0.5f : 0;
+			values[i * valuesCount + ii] = (unsigned short)MIN(steps, 65535);
+		}
+	}
+
+	FREE(self->frames);
+	CONST_CAST(float*, self->frames) = 0;
+	self->keyframes = keyframes;
+}
+
+/* Key times of a compacted timeline of the animation before index that match those of the timeline at index, else 0. */
+static float* _spAnimation_findKeyTimes (const spAnimation* self, int index, int entries) {
+	const struct spBaseTimeline* timeline = SUB_CAST(struct spBaseTimeline, self->timelines[index]);
+	int keysCount = timeline->framesCount / entries, i, ii;
+	for (i = 0; i < index; ++i) {
+		const spCompactKeyframes* keyframes;
+		if (!_spBaseTimeline_getEntries(self->timelines[i]->type)) continue;
+		keyframes = SUB_CAST(struct spBaseTimeline, self->timelines[i])->keyframes;
+		if (!keyframes || keyframes->keysCount != keysCount) continue;
+		for (ii = 0; ii < keysCount; ++ii)
+			if (keyframes->times[ii] != timeline->frames[ii * entries]) break;
+		if (ii == keysCount) return keyframes->times;
+	}
+	return 0;
+}
+
+void spAnimation_compactKeyframes (spAnimation* self) {
+	int i, entries;
+	for (i = 0; i < self->timelinesCount; ++i) {
+		struct spBaseTimeline* timeline;
+		entries = _spBaseTimeline_getEntries(self->timelines[i]->type);
+		if (!entries) continue;
+		timeline = SUB_CAST(struct spBaseTimeline, self->timelines[i]);
+		if (!timeline->keyframes) _spBaseTimeline_compact(timeline, entries, _spAnimation_findKeyTimes(self, i, entries));
+	}
+}
+
+/**/
+
 void _spRotateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	spBone *bone;
 	int frame;
 	float prevRotation, frameTime, percent, r;
 
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spRotateTimeline* self = SUB_CAST(spRotateTimeline, timeline);
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	bone = skeleton->bones[self->boneIndex];
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				bone->rotation = bone->data->rotation;
@@ -261,11 +561,11 @@ void _spRotateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton,
 		return;
 	}
 
-	if (time >= self->frames[self->framesCount - ROTATE_ENTRIES]) { /* Time is after last frame. */
+	if (time >= frames[framesCount - ROTATE_ENTRIES]) { /* Time is after last frame. */
 		if (pose == SP_MIX_POSE_SETUP)
-			bone->rotation = bone->data->rotation + self->frames[self->framesCount + ROTATE_PREV_ROTATION] * alpha;
+			bone->rotation = bone->data->rotation + frames[framesCount + ROTATE_PREV_ROTATION] * alpha;
 		else {
-			r = bone->data->rotation + self->frames[self->framesCount + ROTATE_PREV_ROTATION] - bone->rotation;
+			r = bone->data->rotation + frames[framesCount + ROTATE_PREV_ROTATION] - bone->rotation;
 			r -= (16384 - (int)(16384.499999999996 - r / 360)) * 360; /* Wrap within -180 and 180. */
 			bone->rotation += r * alpha;
 		}
@@ -273,12 +573,12 @@ void _spRotateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton,
 	}
 
 	/* Interpolate between the previous frame and the current frame. */
-	frame = binarySearch(self->frames, self->framesCount, time, ROTATE_ENTRIES);
-	prevRotation = self->frames[frame + ROTATE_PREV_ROTATION];
-	frameTime = self->frames[frame];
-	percent = spCurveTimeline_getCurvePercent(SUPER(self), (frame >> 1) - 1, 1 - (time - frameTime) / (self->frames[frame + ROTATE_PREV_TIME] - frameTime));
+	frame = search(frames, framesCount, time, ROTATE_ENTRIES, cursor);
+	prevRotation = frames[frame + ROTATE_PREV_ROTATION];
+	frameTime = frames[frame];
+	percent = spCurveTimeline_getCurvePercent(SUPER(self), first + (frame >> 1) - 1, 1 - (time - frameTime) / (frames[frame + ROTATE_PREV_TIME] - frameTime));
 
-	r = self->frames[frame + ROTATE_ROTATION] - prevRotation;
+	r = frames[frame + ROTATE_ROTATION] - prevRotation;
 	r -= (16384 - (int)(16384.499999999996 - r / 360)) * 360;
 	r = prevRotation + r * percent;
 	if (pose == SP_MIX_POSE_SETUP) {
@@ -315,18 +615,21 @@ static const int TRANSLATE_PREV_TIME = -3, TRANSLATE_PREV_X = -2, TRANSLATE_PREV
 static const int TRANSLATE_X = 1, TRANSLATE_Y = 2;
 
 void _spTranslateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	spBone *bone;
 	int frame;
 	float frameTime, percent;
 	float x, y;
-	float *frames;
-	int framesCount;
 
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spTranslateTimeline* self = SUB_CAST(spTranslateTimeline, timeline);
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	bone = skeleton->bones[self->boneIndex];
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				bone->x = bone->data->x;
@@ -340,18 +643,16 @@ void _spTranslateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleto
 		return;
 	}
 
-	frames = self->frames;
-	framesCount = self->framesCount;
 	if (time >= frames[framesCount - TRANSLATE_ENTRIES]) { /* Time is after last frame. */
 		x = frames[framesCount + TRANSLATE_PREV_X];
 		y = frames[framesCount + TRANSLATE_PREV_Y];
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(frames, framesCount, time, TRANSLATE_ENTRIES);
+		frame = search(frames, framesCount, time, TRANSLATE_ENTRIES, cursor);
 		x = frames[frame + TRANSLATE_PREV_X];
 		y = frames[frame + TRANSLATE_PREV_Y];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / TRANSLATE_ENTRIES - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / TRANSLATE_ENTRIES - 1,
 										1 - (time - frameTime) / (frames[frame + TRANSLATE_PREV_TIME] - frameTime));
 
 		x += (frames[frame + TRANSLATE_X] - x) * percent;
@@ -388,17 +689,20 @@ void spTranslateTimeline_setFrame (spTranslateTimeline* self, int frameIndex, fl
 /**/
 
 void _spScaleTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	spBone *bone;
 	int frame;
 	float frameTime, percent, x, y;
-	float *frames;
-	int framesCount;
 
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spScaleTimeline* self = SUB_CAST(spScaleTimeline, timeline);
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	bone = skeleton->bones[self->boneIndex];
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				bone->scaleX = bone->data->scaleX;
@@ -412,18 +716,16 @@ void _spScaleTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, f
 		return;
 	}
 
-	frames = self->frames;
-	framesCount = self->framesCount;
 	if (time >= frames[framesCount - TRANSLATE_ENTRIES]) { /* Time is after last frame. */
 		x = frames[framesCount + TRANSLATE_PREV_X] * bone->data->scaleX;
 		y = frames[framesCount + TRANSLATE_PREV_Y] * bone->data->scaleY;
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(frames, framesCount, time, TRANSLATE_ENTRIES);
+		frame = search(frames, framesCount, time, TRANSLATE_ENTRIES, cursor);
 		x = frames[frame + TRANSLATE_PREV_X];
 		y = frames[frame + TRANSLATE_PREV_Y];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / TRANSLATE_ENTRIES - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / TRANSLATE_ENTRIES - 1,
 										1 - (time - frameTime) / (frames[frame + TRANSLATE_PREV_TIME] - frameTime));
 
 		x = (x + (frames[frame + TRANSLATE_X] - x) * percent) * bone->data->scaleX;
@@ -473,19 +775,20 @@ void spScaleTimeline_setFrame (spScaleTimeline* self, int frameIndex, float time
 /**/
 
 void _spShearTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-							 int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+							 int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	spBone *bone;
 	int frame;
 	float frameTime, percent, x, y;
-	float *frames;
-	int framesCount;
 
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spShearTimeline* self = SUB_CAST(spShearTimeline, timeline);
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	bone = skeleton->bones[self->boneIndex];
-	frames = self->frames;
-	framesCount = self->framesCount;
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				bone->shearX = bone->data->shearX;
@@ -504,11 +807,11 @@ void _spShearTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, f
 		y = frames[framesCount + TRANSLATE_PREV_Y];
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(frames, framesCount, time, TRANSLATE_ENTRIES);
+		frame = search(frames, framesCount, time, TRANSLATE_ENTRIES, cursor);
 		x = frames[frame + TRANSLATE_PREV_X];
 		y = frames[frame + TRANSLATE_PREV_Y];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / TRANSLATE_ENTRIES - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / TRANSLATE_ENTRIES - 1,
 										1 - (time - frameTime) / (frames[frame + TRANSLATE_PREV_TIME] - frameTime));
 
 		x = x + (frames[frame + TRANSLATE_X] - x) * percent;
@@ -545,17 +848,22 @@ static const int COLOR_PREV_TIME = -5, COLOR_PREV_R = -4, COLOR_PREV_G = -3, COL
 static const int COLOR_R = 1, COLOR_G = 2, COLOR_B = 3, COLOR_A = 4;
 
 void _spColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	spSlot *slot;
 	int frame;
 	float percent, frameTime;
 	float r, g, b, a;
 	spColor* color;
 	spColor* setup;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spColorTimeline* self = (spColorTimeline*)timeline;
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 	slot = skeleton->slots[self->slotIndex];
 
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				spColor_setFromColor(&slot->color, &slot->data->color);
@@ -570,29 +878,29 @@ void _spColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, f
 		return;
 	}
 
-	if (time >= self->frames[self->framesCount - 5]) { /* Time is after last frame */
-		int i = self->framesCount;
-		r = self->frames[i + COLOR_PREV_R];
-		g = self->frames[i + COLOR_PREV_G];
-		b = self->frames[i + COLOR_PREV_B];
-		a = self->frames[i + COLOR_PREV_A];
+	if (time >= frames[framesCount - 5]) { /* Time is after last frame */
+		int i = framesCount;
+		r = frames[i + COLOR_PREV_R];
+		g = frames[i + COLOR_PREV_G];
+		b = frames[i + COLOR_PREV_B];
+		a = frames[i + COLOR_PREV_A];
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(self->frames, self->framesCount, time, COLOR_ENTRIES);
+		frame = search(frames, framesCount, time, COLOR_ENTRIES, cursor);
 
-		r = self->frames[frame + COLOR_PREV_R];
-		g = self->frames[frame + COLOR_PREV_G];
-		b = self->frames[frame + COLOR_PREV_B];
-		a = self->frames[frame + COLOR_PREV_A];
+		r = frames[frame + COLOR_PREV_R];
+		g = frames[frame + COLOR_PREV_G];
+		b = frames[frame + COLOR_PREV_B];
+		a = frames[frame + COLOR_PREV_A];
 
-		frameTime = self->frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / COLOR_ENTRIES - 1,
-			1 - (time - frameTime) / (self->frames[frame + COLOR_PREV_TIME] - frameTime));
+		frameTime = frames[frame];
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / COLOR_ENTRIES - 1,
+			1 - (time - frameTime) / (frames[frame + COLOR_PREV_TIME] - frameTime));
 
-		r += (self->frames[frame + COLOR_R] - r) * percent;
-		g += (self->frames[frame + COLOR_G] - g) * percent;
-		b += (self->frames[frame + COLOR_B] - b) * percent;
-		a += (self->frames[frame + COLOR_A] - a) * percent;
+		r += (frames[frame + COLOR_R] - r) * percent;
+		g += (frames[frame + COLOR_G] - g) * percent;
+		b += (frames[frame + COLOR_B] - b) * percent;
+		a += (frames[frame + COLOR_A] - a) * percent;
 	}
 	if (alpha == 1) {
 		spColor_setFromFloats(&slot->color, r, g, b, a);
@@ -632,7 +940,8 @@ static const int TWOCOLOR_PREV_R2 = -3, TWOCOLOR_PREV_G2 = -2, TWOCOLOR_PREV_B2
 static const int TWOCOLOR_R = 1, TWOCOLOR_G = 2, TWOCOLOR_B = 3, TWOCOLOR_A = 4, TWOCOLOR_R2 = 5, TWOCOLOR_G2 = 6, TWOCOLOR_B2 = 7;
 
 void _spTwoColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-							 int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+							 int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	spSlot *slot;
 	int frame;
 	float percent, frameTime;
@@ -641,10 +950,14 @@ void _spTwoColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton
 	spColor* dark;
 	spColor* setupLight;
 	spColor* setupDark;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spColorTimeline* self = (spColorTimeline*)timeline;
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 	slot = skeleton->slots[self->slotIndex];
 
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				spColor_setFromColor(&slot->color, &slot->data->color);
@@ -663,38 +976,38 @@ void _spTwoColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton
 		return;
 	}
 
-	if (time >= self->frames[self->framesCount - TWOCOLOR_ENTRIES]) { /* Time is after last frame */
-		int i = self->framesCount;
-		r = self->frames[i + TWOCOLOR_PREV_R];
-		g = self->frames[i + TWOCOLOR_PREV_G];
-		b = self->frames[i + TWOCOLOR_PREV_B];
-		a = self->frames[i + TWOCOLOR_PREV_A];
-		r2 = self->frames[i + TWOCOLOR_PREV_R2];
-		g2 = self->frames[i + TWOCOLOR_PREV_G2];
-		b2 = self->frames[i + TWOCOLOR_PREV_B2];
+	if (time >= frames[framesCount - TWOCOLOR_ENTRIES]) { /* Time is after last frame */
+		int i = framesCount;
+		r = frames[i + TWOCOLOR_PREV_R];
+		g = frames[i + TWOCOLOR_PREV_G];
+		b = frames[i + TWOCOLOR_PREV_B];
+		a = frames[i + TWOCOLOR_PREV_A];
+		r2 = frames[i + TWOCOLOR_PREV_R2];
+		g2 = frames[i + TWOCOLOR_PREV_G2];
+		b2 = frames[i + TWOCOLOR_PREV_B2];
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(self->frames, self->framesCount, time, TWOCOLOR_ENTRIES);
+		frame = search(frames, framesCount, time, TWOCOLOR_ENTRIES, cursor);
 
-		r = self->frames[frame + TWOCOLOR_PREV_R];
-		g = self->frames[frame + TWOCOLOR_PREV_G];
-		b = self->frames[frame + TWOCOLOR_PREV_B];
-		a = self->frames[frame + TWOCOLOR_PREV_A];
-		r2 = self->frames[frame + TWOCOLOR_PREV_R2];
-		g2 = self->frames[frame + TWOCOLOR_PREV_G2];
-		b2 = self->frames[frame + TWOCOLOR_PREV_B2];
-
-		frameTime = self->frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / TWOCOLOR_ENTRIES - 1,
-												  1 - (time - frameTime) / (self->frames[frame + TWOCOLOR_PREV_TIME] - frameTime));
+		r = frames[frame + TWOCOLOR_PREV_R];
+		g = frames[frame + TWOCOLOR_PREV_G];
+		b = frames[frame + TWOCOLOR_PREV_B];
+		a = frames[frame + TWOCOLOR_PREV_A];
+		r2 = frames[frame + TWOCOLOR_PREV_R2];
+		g2 = frames[frame + TWOCOLOR_PREV_G2];
+		b2 = frames[frame + TWOCOLOR_PREV_B2];
 
-		r += (self->frames[frame + TWOCOLOR_R] - r) * percent;
-		g += (self->frames[frame + TWOCOLOR_G] - g) * percent;
-		b += (self->frames[frame + TWOCOLOR_B] - b) * percent;
-		a += (self->frames[frame + TWOCOLOR_A] - a) * percent;
-		r2 += (self->frames[frame + TWOCOLOR_R2] - r2) * percent;
-		g2 += (self->frames[frame + TWOCOLOR_G2] - g2) * percent;
-		b2 += (self->frames[frame + TWOCOLOR_B2] - b2) * percent;
+		frameTime = frames[frame];
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / TWOCOLOR_ENTRIES - 1,
+												  1 - (time - frameTime) / (frames[frame + TWOCOLOR_PREV_TIME] - frameTime));
+
+		r += (frames[frame + TWOCOLOR_R] - r) * percent;
+		g += (frames[frame + TWOCOLOR_G] - g) * percent;
+		b += (frames[frame + TWOCOLOR_B] - b) * percent;
+		a += (frames[frame + TWOCOLOR_A] - a) * percent;
+		r2 += (frames[frame + TWOCOLOR_R2] - r2) * percent;
+		g2 += (frames[frame + TWOCOLOR_G2] - g2) * percent;
+		b2 += (frames[frame + TWOCOLOR_B2] - b2) * percent;
 	}
 	if (alpha == 1) {
 		spColor_setFromFloats(&slot->color, r, g, b, a);
@@ -738,7 +1051,8 @@ void spTwoColorTimeline_setFrame (spTwoColorTimeline* self, int frameIndex, floa
 /**/
 
 void _spAttachmentTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	const char* attachmentName;
 	spAttachmentTimeline* self = (spAttachmentTimeline*)timeline;
 	int frameIndex;
@@ -762,7 +1076,7 @@ void _spAttachmentTimeline_apply (const spTimeline* timeline, spSkeleton* skelet
 	if (time >= self->frames[self->framesCount - 1])
 		frameIndex = self->framesCount - 1;
 	else
-		frameIndex = binarySearch1(self->frames, self->framesCount, time) - 1;
+		frameIndex = search(self->frames, self->framesCount, time, 1, cursor) - 1;
 
 	attachmentName = self->attachmentNames[frameIndex];
 	spSlot_setAttachment(skeleton->slots[self->slotIndex],
@@ -815,7 +1129,8 @@ void spAttachmentTimeline_setFrame (spAttachmentTimeline* self, int frameIndex,
 /**/
 
 void _spDeformTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-							  int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+							  int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	int frame, i, vertexCount;
 	float percent, frameTime;
 	const float* prevVertices;
@@ -912,7 +1227,7 @@ void _spDeformTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton,
 	}
 
 	/* Interpolate between the previous frame and the current frame. */
-	frame = binarySearch(frames, framesCount, time, 1);
+	frame = search(frames, framesCount, time, 1, cursor);
 	prevVertices = frameVertices[frame - 1];
 	nextVertices = frameVertices[frame];
 	frameTime = frames[frame];
@@ -997,13 +1312,14 @@ void spDeformTimeline_setFrame (spDeformTimeline* self, int frameIndex, float ti
 
 /** Fires events for frames > lastTime and <= time. */
 void _spEventTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	spEventTimeline* self = (spEventTimeline*)timeline;
 	int frame;
 	if (!firedEvents) return;
 
 	if (lastTime > time) { /* Fire events after last time for looped animations. */
-		_spEventTimeline_apply(timeline, skeleton, lastTime, (float)INT_MAX, firedEvents, eventsCount, alpha, pose, direction);
+		_spEventTimeline_apply(timeline, skeleton, lastTime, (float)INT_MAX, firedEvents, eventsCount, alpha, pose, direction, cursor);
 		lastTime = -1;
 	} else if (lastTime >= self->frames[self->framesCount - 1]) /* Last time is after last frame. */
 	return;
@@ -1013,7 +1329,7 @@ void _spEventTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, f
 		frame = 0;
 	else {
 		float frameTime;
-		frame = binarySearch1(self->frames, self->framesCount, lastTime);
+		frame = search(self->frames, self->framesCount, lastTime, 1, cursor);
 		frameTime = self->frames[frame];
 		while (frame > 0) { /* Fire multiple events with the same frame. */
 			if (self->frames[frame - 1] != frameTime) break;
@@ -1064,7 +1380,8 @@ void spEventTimeline_setFrame (spEventTimeline* self, int frameIndex, spEvent* e
 /**/
 
 void _spDrawOrderTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	int i;
 	int frame;
 	const int* drawOrderToSetupIndex;
@@ -1083,7 +1400,7 @@ void _spDrawOrderTimeline_apply (const spTimeline* timeline, spSkeleton* skeleto
 	if (time >= self->frames[self->framesCount - 1]) /* Time is after last frame. */
 		frame = self->framesCount - 1;
 	else
-		frame = binarySearch1(self->frames, self->framesCount, time) - 1;
+		frame = search(self->frames, self->framesCount, time, 1, cursor) - 1;
 
 	drawOrderToSetupIndex = self->drawOrders[frame];
 	if (!drawOrderToSetupIndex)
@@ -1146,17 +1463,20 @@ static const int IKCONSTRAINT_PREV_TIME = -3, IKCONSTRAINT_PREV_MIX = -2, IKCONS
 static const int IKCONSTRAINT_MIX = 1, IKCONSTRAINT_BEND_DIRECTION = 2;
 
 void _spIkConstraintTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	int frame;
 	float frameTime, percent, mix;
-	float *frames;
-	int framesCount;
 	spIkConstraint* constraint;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spIkConstraintTimeline* self = (spIkConstraintTimeline*)timeline;
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	constraint = skeleton->ikConstraints[self->ikConstraintIndex];
 
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				constraint->mix = constraint->data->mix;
@@ -1170,8 +1490,6 @@ void _spIkConstraintTimeline_apply (const spTimeline* timeline, spSkeleton* skel
 		return;
 	}
 
-	frames = self->frames;
-	framesCount = self->framesCount;
 	if (time >= frames[framesCount - IKCONSTRAINT_ENTRIES]) { /* Time is after last frame. */
 		if (pose == SP_MIX_POSE_SETUP) {
 			constraint->mix = constraint->data->mix + (frames[framesCount + IKCONSTRAINT_PREV_MIX] - constraint->data->mix) * alpha;
@@ -1185,10 +1503,10 @@ void _spIkConstraintTimeline_apply (const spTimeline* timeline, spSkeleton* skel
 	}
 
 	/* Interpolate between the previous frame and the current frame. */
-	frame = binarySearch(self->frames, self->framesCount, time, IKCONSTRAINT_ENTRIES);
-	mix = self->frames[frame + IKCONSTRAINT_PREV_MIX];
-	frameTime = self->frames[frame];
-	percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / IKCONSTRAINT_ENTRIES - 1, 1 - (time - frameTime) / (self->frames[frame + IKCONSTRAINT_PREV_TIME] - frameTime));
+	frame = search(frames, framesCount, time, IKCONSTRAINT_ENTRIES, cursor);
+	mix = frames[frame + IKCONSTRAINT_PREV_MIX];
+	frameTime = frames[frame];
+	percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / IKCONSTRAINT_ENTRIES - 1, 1 - (time - frameTime) / (frames[frame + IKCONSTRAINT_PREV_TIME] - frameTime));
 
 	if (pose == SP_MIX_POSE_SETUP) {
 		constraint->mix = constraint->data->mix + (mix + (frames[frame + IKCONSTRAINT_MIX] - mix) * percent - constraint->data->mix) * alpha;
@@ -1230,16 +1548,19 @@ static const int TRANSFORMCONSTRAINT_SCALE = 3;
 static const int TRANSFORMCONSTRAINT_SHEAR = 4;
 
 void _spTransformConstraintTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-									spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+									spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	int frame;
 	float frameTime, percent, rotate, translate, scale, shear;
 	spTransformConstraint* constraint;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spTransformConstraintTimeline* self = (spTransformConstraintTimeline*)timeline;
-	float *frames;
-	int framesCount;
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	constraint = skeleton->transformConstraints[self->transformConstraintIndex];
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		spTransformConstraintData* data = constraint->data;
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
@@ -1259,8 +1580,6 @@ void _spTransformConstraintTimeline_apply (const spTimeline* timeline, spSkeleto
 		return;
 	}
 
-	frames = self->frames;
-	framesCount = self->framesCount;
 	if (time >= frames[framesCount - TRANSFORMCONSTRAINT_ENTRIES]) { /* Time is after last frame. */
 		int i = framesCount;
 		rotate = frames[i + TRANSFORMCONSTRAINT_PREV_ROTATE];
@@ -1269,13 +1588,13 @@ void _spTransformConstraintTimeline_apply (const spTimeline* timeline, spSkeleto
 		shear = frames[i + TRANSFORMCONSTRAINT_PREV_SHEAR];
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(frames, framesCount, time, TRANSFORMCONSTRAINT_ENTRIES);
+		frame = search(frames, framesCount, time, TRANSFORMCONSTRAINT_ENTRIES, cursor);
 		rotate = frames[frame + TRANSFORMCONSTRAINT_PREV_ROTATE];
 		translate = frames[frame + TRANSFORMCONSTRAINT_PREV_TRANSLATE];
 		scale = frames[frame + TRANSFORMCONSTRAINT_PREV_SCALE];
 		shear = frames[frame + TRANSFORMCONSTRAINT_PREV_SHEAR];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / TRANSFORMCONSTRAINT_ENTRIES - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / TRANSFORMCONSTRAINT_ENTRIES - 1,
 										1 - (time - frameTime) / (frames[frame + TRANSFORMCONSTRAINT_PREV_TIME] - frameTime));
 
 		rotate += (frames[frame + TRANSFORMCONSTRAINT_ROTATE] - rotate) * percent;
@@ -1325,16 +1644,19 @@ static const int PATHCONSTRAINTPOSITION_PREV_VALUE = -1;
 static const int PATHCONSTRAINTPOSITION_VALUE = 1;
 
 void _spPathConstraintPositionTimeline_apply(const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	int frame;
 	float frameTime, percent, position;
 	spPathConstraint* constraint;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spPathConstraintPositionTimeline* self = (spPathConstraintPositionTimeline*)timeline;
-	float* frames;
-	int framesCount;
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	constraint = skeleton->pathConstraints[self->pathConstraintIndex];
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				constraint->position = constraint->data->position;
@@ -1346,16 +1668,14 @@ void _spPathConstraintPositionTimeline_apply(const spTimeline* timeline, spSkele
 		return;
 	}
 
-	frames = self->frames;
-	framesCount = self->framesCount;
 	if (time >= frames[framesCount - PATHCONSTRAINTPOSITION_ENTRIES]) /* Time is after last frame. */
 		position = frames[framesCount + PATHCONSTRAINTPOSITION_PREV_VALUE];
 	else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(frames, framesCount, time, PATHCONSTRAINTPOSITION_ENTRIES);
+		frame = search(frames, framesCount, time, PATHCONSTRAINTPOSITION_ENTRIES, cursor);
 		position = frames[frame + PATHCONSTRAINTPOSITION_PREV_VALUE];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / PATHCONSTRAINTPOSITION_ENTRIES - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / PATHCONSTRAINTPOSITION_ENTRIES - 1,
 										1 - (time - frameTime) / (frames[frame + PATHCONSTRAINTPOSITION_PREV_TIME] - frameTime));
 
 		position += (frames[frame + PATHCONSTRAINTPOSITION_VALUE] - position) * percent;
@@ -1390,16 +1710,19 @@ static const int PATHCONSTRAINTSPACING_PREV_VALUE = -1;
 static const int PATHCONSTRAINTSPACING_VALUE = 1;
 
 void _spPathConstraintSpacingTimeline_apply(const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+		spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	int frame;
 	float frameTime, percent, spacing;
 	spPathConstraint* constraint;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spPathConstraintSpacingTimeline* self = (spPathConstraintSpacingTimeline*)timeline;
-	float* frames;
-	int framesCount;
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	constraint = skeleton->pathConstraints[self->pathConstraintIndex];
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				constraint->spacing = constraint->data->spacing;
@@ -1411,16 +1734,14 @@ void _spPathConstraintSpacingTimeline_apply(const spTimeline* timeline, spSkelet
 		return;
 	}
 
-	frames = self->frames;
-	framesCount = self->framesCount;
 	if (time >= frames[framesCount - PATHCONSTRAINTSPACING_ENTRIES]) /* Time is after last frame. */
 		spacing = frames[framesCount + PATHCONSTRAINTSPACING_PREV_VALUE];
 	else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(frames, framesCount, time, PATHCONSTRAINTSPACING_ENTRIES);
+		frame = search(frames, framesCount, time, PATHCONSTRAINTSPACING_ENTRIES, cursor);
 		spacing = frames[frame + PATHCONSTRAINTSPACING_PREV_VALUE];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / PATHCONSTRAINTSPACING_ENTRIES - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / PATHCONSTRAINTSPACING_ENTRIES - 1,
 										1 - (time - frameTime) / (frames[frame + PATHCONSTRAINTSPACING_PREV_TIME] - frameTime));
 
 		spacing += (frames[frame + PATHCONSTRAINTSPACING_VALUE] - spacing) * percent;
@@ -1459,16 +1780,19 @@ static const int PATHCONSTRAINTMIX_ROTATE = 1;
 static const int PATHCONSTRAINTMIX_TRANSLATE = 2;
 
 void _spPathConstraintMixTimeline_apply(const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-											spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction) {
+											spEvent** firedEvents, int* eventsCount, float alpha, spMixPose pose, spMixDirection direction,
+		spTimelineCursor* cursor) {
 	int frame;
 	float frameTime, percent, rotate, translate;
 	spPathConstraint* constraint;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
+	int framesCount, first;
 	spPathConstraintMixTimeline* self = (spPathConstraintMixTimeline*)timeline;
-	float* frames;
-	int framesCount;
+	float* frames = _spBaseTimeline_getFrames((const struct spBaseTimeline*)timeline, time, &cursor, buffer, &framesCount,
+		&first);
 
 	constraint = skeleton->pathConstraints[self->pathConstraintIndex];
-	if (time < self->frames[0]) {
+	if (time < frames[0]) {
 		switch (pose) {
 			case SP_MIX_POSE_SETUP:
 				constraint->rotateMix = constraint->data->rotateMix;
@@ -1482,18 +1806,16 @@ void _spPathConstraintMixTimeline_apply(const spTimeline* timeline, spSkeleton*
 		return;
 	}
 
-	frames = self->frames;
-	framesCount = self->framesCount;
 	if (time >= frames[framesCount - PATHCONSTRAINTMIX_ENTRIES]) { /* Time is after last frame. */
 		rotate = frames[framesCount + PATHCONSTRAINTMIX_PREV_ROTATE];
 		translate = frames[framesCount + PATHCONSTRAINTMIX_PREV_TRANSLATE];
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = binarySearch(frames, framesCount, time, PATHCONSTRAINTMIX_ENTRIES);
+		frame = search(frames, framesCount, time, PATHCONSTRAINTMIX_ENTRIES, cursor);
 		rotate = frames[frame + PATHCONSTRAINTMIX_PREV_ROTATE];
 		translate = frames[frame + PATHCONSTRAINTMIX_PREV_TRANSLATE];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frame / PATHCONSTRAINTMIX_ENTRIES - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), first + frame / PATHCONSTRAINTMIX_ENTRIES - 1,
 										1 - (time - frameTime) / (frames[frame + PATHCONSTRAINTMIX_PREV_TIME] - frameTime));
 
 		rotate += (frames[frame + PATHCONSTRAINTMIX_ROTATE] - rotate) * percent;
@@ -1527,3 +1849,4 @@ void spPathConstraintMixTimeline_setFrame (spPathConstraintMixTimeline* self, in
 	self->frames[frameIndex + PATHCONSTRAINTMIX_ROTATE] = rotateMix;
 	self->frames[frameIndex + PATHCONSTRAINTMIX_TRANSLATE] = translateMix;
 }
+
@@ -51,7 +51,7 @@ void _spAnimationState_disposeTrackEntry (spTrackEntry* entry);
 void _spAnimationState_disposeTrackEntries (spAnimationState* state, spTrackEntry* entry);
 int /*boolean*/ _spAnimationState_updateMixingFrom (spAnimationState* self, spTrackEntry* entry, float delta);
 float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* entry, spSkeleton* skeleton, spMixPose currentPose);
-void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline* timeline, spSkeleton* skeleton, float time, float alpha, spMixPose pose, float* timelinesRotation, int i, int /*boolean*/ firstFrame);
+void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline* timeline, spSkeleton* skeleton, float time, float alpha, spMixPose pose, float* timelinesRotation, int i, int /*boolean*/ firstFrame, spTimelineCursor* cursor);
 void _spAnimationState_queueEvents (spAnimationState* self, spTrackEntry* entry, float animationTime);
 void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEntry* current, int /*boolean*/ interrupt);
 spTrackEntry* _spAnimationState_expandToIndex (spAnimationState* self, int index);
@@ -184,6 +184,7 @@ void _spAnimationState_disposeTrackEntry (spTrackEntry* entry) {
 	spIntArray_dispose(entry->timelineData);
 	spTrackEntryArray_dispose(entry->timelineDipMix);
 	FREE(entry->timelinesRotation);
+	FREE(entry->timelineCursors);
 	FREE(entry);
 }
 
@@ -341,6 +342,7 @@ int spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 	spTimeline** timelines;
 	int /*boolean*/ firstFrame;
 	float* timelinesRotation;
+	spTimelineCursor* cursors;
 	spTimeline* timeline;
 	int applied = 0;
 	spMixPose currentPose;
@@ -366,9 +368,10 @@ int spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 		animationLast = current->animationLast; animationTime = spTrackEntry_getAnimationTime(current);
 		timelineCount = current->animation->timelinesCount;
 		timelines = current->animation->timelines;
+		cursors = internal->timelineCursorsDisabled ? 0 : current->timelineCursors;
 		if (mix == 1) {
 			for (ii = 0; ii < timelineCount; ii++)
-				spTimeline_apply(timelines[ii], skeleton, animationLast, animationTime, internal->events, &internal->eventsCount, 1, SP_MIX_POSE_SETUP, SP_MIX_DIRECTION_IN);
+				spTimeline_applyWithCursor(timelines[ii], skeleton, animationLast, animationTime, internal->events, &internal->eventsCount, 1, SP_MIX_POSE_SETUP, SP_MIX_DIRECTION_IN, cursors ? cursors + ii : 0);
 		} else {
 			spIntArray* timelineData = current->timelineData;
 
@@ -380,9 +383,9 @@ int spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 				timeline = timelines[ii];
 				pose = timelineData->items[ii] >= FIRST ? SP_MIX_POSE_SETUP : currentPose;
 				if (timeline->type == SP_TIMELINE_ROTATE)
-					_spAnimationState_applyRotateTimeline(self, timeline, skeleton, animationTime, mix, pose, timelinesRotation, ii << 1, firstFrame);
+					_spAnimationState_applyRotateTimeline(self, timeline, skeleton, animationTime, mix, pose, timelinesRotation, ii << 1, firstFrame, cursors ? cursors + ii : 0);
 				else
-					spTimeline_apply(timeline, skeleton, animationLast, animationTime, internal->events, &internal->eventsCount, mix, pose, SP_MIX_DIRECTION_IN);
+					spTimeline_applyWithCursor(timeline, skeleton, animationLast, animationTime, internal->events, &internal->eventsCount, mix, pose, SP_MIX_DIRECTION_IN, cursors ? cursors + ii : 0);
 			}
 		}
 		_spAnimationState_queueEvents(self, current, animationTime);
@@ -412,6 +415,7 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* t
 	float alpha;
 	int /*boolean*/ firstFrame;
 	float* timelinesRotation;
+	spTimelineCursor* cursors;
 	spMixPose pose;
 	int i;
 	spTrackEntry* dipMix;
@@ -435,6 +439,7 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* t
 	timelines = from->animation->timelines;
 	timelineData = from->timelineData;
 	timelineDipMix = from->timelineDipMix;
+	cursors = internal->timelineCursorsDisabled ? 0 : from->timelineCursors;
 
 	firstFrame = from->timelinesRotationCount == 0;
 	if (firstFrame) _spAnimationState_resizeTimelinesRotation(from, timelineCount << 1);
@@ -468,9 +473,9 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* t
 		}
 		from->totalAlpha += alpha;
 		if (timeline->type == SP_TIMELINE_ROTATE)
-			_spAnimationState_applyRotateTimeline(self, timeline, skeleton, animationTime, alpha, pose, timelinesRotation, i << 1, firstFrame);
+			_spAnimationState_applyRotateTimeline(self, timeline, skeleton, animationTime, alpha, pose, timelinesRotation, i << 1, firstFrame, cursors ? cursors + i : 0);
 		else {
-			spTimeline_apply(timeline, skeleton, animationLast, animationTime, events, &internal->eventsCount, alpha, pose, SP_MIX_DIRECTION_OUT);
+			spTimeline_applyWithCursor(timeline, skeleton, animationLast, animationTime, events, &internal->eventsCount, alpha, pose, SP_MIX_DIRECTION_OUT, cursors ? cursors + i : 0);
 		}
 	}
 
@@ -483,9 +488,11 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* t
 	return mix;
 }
 
-void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline* timeline, spSkeleton* skeleton, float time, float alpha, spMixPose pose, float* timelinesRotation, int i, int /*boolean*/ firstFrame) {
+void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline* timeline, spSkeleton* skeleton, float time, float alpha, spMixPose pose, float* timelinesRotation, int i, int /*boolean*/ firstFrame, spTimelineCursor* cursor) {
 	spRotateTimeline *rotateTimeline;
+	float buffer[2 * SP_MAX_TIMELINE_ENTRIES];
 	float *frames;
+	int framesCount, first;
 	spBone* bone;
 	float r1, r2;
 	int frame;
@@ -498,12 +505,12 @@ void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline*
 	if (firstFrame) timelinesRotation[i] = 0;
 
 	if (alpha == 1) {
-		spTimeline_apply(timeline, skeleton, 0, time, 0, 0, 1, pose, SP_MIX_DIRECTION_IN);
+		spTimeline_applyWithCursor(timeline, skeleton, 0, time, 0, 0, 1, pose, SP_MIX_DIRECTION_IN, cursor);
 		return;
 	}
 
 	rotateTimeline = SUB_CAST(spRotateTimeline, timeline);
-	frames = rotateTimeline->frames;
+	frames = _spBaseTimeline_getFrames(rotateTimeline, time, &cursor, buffer, &framesCount, &first);
 	bone = skeleton->bones[rotateTimeline->boneIndex];
 	if (time < frames[0]) {
 		if (pose == SP_MIX_POSE_SETUP) {
@@ -512,14 +519,14 @@ void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline*
 		return; /* Time is before first frame. */
 	}
 
-	if (time >= frames[rotateTimeline->framesCount - ROTATE_ENTRIES]) /* Time is after last frame. */
-		r2 = bone->data->rotation + frames[rotateTimeline->framesCount + ROTATE_PREV_ROTATION];
+	if (time >= frames[framesCount - ROTATE_ENTRIES]) /* Time is after last frame. */
+		r2 = bone->data->rotation + frames[framesCount + ROTATE_PREV_ROTATION];
 	else {
 		/* Interpolate between the previous frame and the current frame. */
-		frame = _spCurveTimeline_binarySearch(frames, rotateTimeline->framesCount, time, ROTATE_ENTRIES);
+		frame = _spCurveTimeline_search(frames, framesCount, time, ROTATE_ENTRIES, cursor);
 		prevRotation = frames[frame + ROTATE_PREV_ROTATION];
 		frameTime = frames[frame];
-		percent = spCurveTimeline_getCurvePercent(SUPER(rotateTimeline), (frame >> 1) - 1,
+		percent = spCurveTimeline_getCurvePercent(SUPER(rotateTimeline), first + (frame >> 1) - 1,
 													   1 - (time - frameTime) / (frames[frame + ROTATE_PREV_TIME] - frameTime));
 
 		r2 = frames[frame + ROTATE_ROTATION] - prevRotation;
@@ -789,6 +796,7 @@ spTrackEntry* _spAnimationState_trackEntry (spAnimationState* self, int trackInd
 
 	entry->timelineData = spIntArray_create(16);
 	entry->timelineDipMix = spTrackEntryArray_create(16);
+	entry->timelineCursors = CALLOC(spTimelineCursor, animation->timelinesCount ? animation->timelinesCount : 1);
 	return entry;
 }
 
@@ -874,6 +882,10 @@ float spTrackEntry_getAnimationTime (spTrackEntry* entry) {
 	return MIN(entry->trackTime + entry->animationStart, entry->animationEnd);
 }
 
+void spAnimationState_setTimelineCursors (spAnimationState* self, int /*boolean*/ enabled) {
+	SUB_CAST(_spAnimationState, self)->timelineCursorsDisabled = !enabled;
+}
+
 int /*boolean*/ _spTrackEntry_hasTimeline(spTrackEntry* self, int id) {
 	spTimeline** timelines = self->animation->timelines;
 	int i, n;
@@ -31,69 +31,70 @@
 #include <spine/AnimationStateData.h>
 #include <spine/extension.h>
 
-typedef struct _ToEntry _ToEntry;
-struct _ToEntry {
-	spAnimation* animation;
+/* One mix duration, in the list of all mixes and in the hash chain of its pair of animations. */
+typedef struct _MixEntry _MixEntry;
+struct _MixEntry {
+	spAnimation* from;
+	spAnimation* to;
 	float duration;
-	_ToEntry* next;
+	_MixEntry* next;
+	_MixEntry* nextInBucket;
 };
 
-_ToEntry* _ToEntry_create (spAnimation* to, float duration) {
-	_ToEntry* self = NEW(_ToEntry);
-	self->animation = to;
-	self->duration = duration;
-	return self;
-}
+typedef struct {
+	spAnimationStateData super;
+	int entriesCount;
+	int bucketsCount; /* A power of two. */
+	_MixEntry** buckets;
+} _spAnimationStateData;
 
-void _ToEntry_dispose (_ToEntry* self) {
-	FREE(self);
+static unsigned int _spAnimationStateData_hash (const spAnimation* from, const spAnimation* to) {
+	unsigned int hash = (unsigned int)((size_t)from >> 4) * 2654435761u;
+	return hash ^ (unsigned int)((size_t)to >> 4) * 40503u;
 }
 
-/**/
-
-typedef struct _FromEntry _FromEntry;
-struct _FromEntry {
-	spAnimation* animation;
-	_ToEntry* toEntries;
-	_FromEntry* next;
-};
+static _MixEntry** _spAnimationStateData_getBucket (const _spAnimationStateData* self, const spAnimation* from, const spAnimation* to) {
+	unsigned int hash = _spAnimationStateData_hash(from, to);
+	return self->buckets + ((hash ^ (hash >> 16)) & (unsigned int)(self->bucketsCount - 1));
+}
 
-_FromEntry* _FromEntry_create (spAnimation* from) {
-	_FromEntry* self = NEW(_FromEntry);
-	self->animation = from;
-	return self;
+static _MixEntry* _spAnimationStateData_find (const _spAnimationStateData* self, const spAnimation* from, const spAnimation* to) {
+	_MixEntry* entry;
+	if (!self->buckets) return 0;
+	for (entry = *_spAnimationStateData_getBucket(self, from, to); entry; entry = entry->nextInBucket)
+		if (entry->from == from && entry->to == to) return entry;
+	return 0;
 }
 
-void _FromEntry_dispose (_FromEntry* self) {
-	FREE(self);
+static void _spAnimationStateData_growBuckets (_spAnimationStateData* self) {
+	_MixEntry* entry;
+	FREE(self->buckets);
+	self->bucketsCount = self->bucketsCount ? self->bucketsCount << 1 : 16;
+	self->buckets = CALLOC(_MixEntry*, self->bucketsCount);
+	for (entry = (_MixEntry*)self->super.entries; entry; entry = entry->next) {
+		_MixEntry** bucket = _spAnimationStateData_getBucket(self, entry->from, entry->to);
+		entry->nextInBucket = *bucket;
+		*bucket = entry;
+	}
 }
 
 /**/
 
 spAnimationStateData* spAnimationStateData_create (spSkeletonData* skeletonData) {
-	spAnimationStateData* self = NEW(spAnimationStateData);
+	spAnimationStateData* self = SUPER(NEW(_spAnimationStateData));
 	CONST_CAST(spSkeletonData*, self->skeletonData) = skeletonData;
 	return self;
 }
 
 void spAnimationStateData_dispose (spAnimationStateData* self) {
-	_ToEntry* toEntry;
-	_ToEntry* nextToEntry;
-	_FromEntry* nextFromEntry;
-
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		toEntry = fromEntry->toEntries;
-		while (toEntry) {
-			nextToEntry = toEntry->next;
-			_ToEntry_dispose(toEntry);
-			toEntry = nextToEntry;
-		}
-		nextFromEntry = fromEntry->next;
-		_FromEntry_dispose(fromEntry);
-		fromEntry = nextFromEntry;
+	_MixEntry* entry = (_MixEntry*)self->entries;
+	while (entry) {
+		_MixEntry* nextEntry = entry->next;
+		FREE(entry);
+		entry = nextEntry;
 	}
 
+	FREE(SUB_CAST(_spAnimationStateData, self)->buckets);
 	FREE(self);
 }
 
@@ -107,45 +108,30 @@ void spAnimationStateData_setMixByName (spAnimationStateData* self, const char*
 }
 
 void spAnimationStateData_setMix (spAnimationStateData* self, spAnimation* from, spAnimation* to, float duration) {
-	/* Find existing FromEntry. */
-	_ToEntry* toEntry;
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		if (fromEntry->animation == from) {
-			/* Find existing ToEntry. */
-			toEntry = fromEntry->toEntries;
-			while (toEntry) {
-				if (toEntry->animation == to) {
-					toEntry->duration = duration;
-					return;
-				}
-				toEntry = toEntry->next;
-			}
-			break; /* Add new ToEntry to the existing FromEntry. */
-		}
-		fromEntry = fromEntry->next;
+	_spAnimationStateData* internal = SUB_CAST(_spAnimationStateData, self);
+	_MixEntry** bucket;
+	_MixEntry* entry = _spAnimationStateData_find(internal, from, to);
+	if (entry) {
+		entry->duration = duration;
+		return;
 	}
-	if (!fromEntry) {
-		fromEntry = _FromEntry_create(from);
-		fromEntry->next = (_FromEntry*)self->entries;
-		CONST_CAST(_FromEntry*, self->entries) = fromEntry;
+	entry = NEW(_MixEntry);
+	entry->from = from;
+	entry->to = to;
+	entry->duration = duration;
+	entry->next = (_MixEntry*)self->entries;
+	CONST_CAST(_MixEntry*, self->entries) = entry;
+	internal->entriesCount++;
+	if (internal->entriesCount > internal->bucketsCount) {
+		_spAnimationStateData_growBuckets(internal);
+	} else {
+		bucket = _spAnimationStateData_getBucket(internal, from, to);
+		entry->nextInBucket = *bucket;
+		*bucket = entry;
 	}
-	toEntry = _ToEntry_create(to, duration);
-	toEntry->next = fromEntry->toEntries;
-	fromEntry->toEntries = toEntry;
 }
 
 float spAnimationStateData_getMix (spAnimationStateData* self, spAnimation* from, spAnimation* to) {
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		if (fromEntry->animation == from) {
-			_ToEntry* toEntry = fromEntry->toEntries;
-			while (toEntry) {
-				if (toEntry->animation == to) return toEntry->duration;
-				toEntry = toEntry->next;
-			}
-		}
-		fromEntry = fromEntry->next;
-	}
-	return self->defaultMix;
+	_MixEntry* entry = _spAnimationStateData_find(SUB_CAST(_spAnimationStateData, self), from, to);
+	return entry ? entry->duration : self->defaultMix;
 }
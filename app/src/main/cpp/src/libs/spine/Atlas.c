@@ -155,6 +155,27 @@ static int toInt(Str* str) {
 	return (int)strtol(str->begin, (char**)&str->end, 10);
 }
 
+typedef struct {
+	spAtlas super;
+	/* The regions in list order, hashed by name for spAtlas_findRegion. */
+	int regionsCount;
+	spAtlasRegion** regions;
+	_spNameTable regionNames;
+} _spAtlas;
+
+static void indexRegions(_spAtlas* self) {
+	spAtlasRegion* region;
+	int i = 0;
+	for (region = self->super.regions; region; region = region->next)
+		++i;
+	self->regionsCount = i;
+	self->regions = MALLOC(spAtlasRegion*, i);
+	for (region = self->super.regions, i = 0; region; region = region->next, ++i) {
+		self->regions[i] = region;
+		_spNameTable_add(&self->regionNames, _spNameTable_hash(region->name), i);
+	}
+}
+
 static spAtlas* abortAtlas(spAtlas* self) {
 	spAtlas_dispose(self);
 	return 0;
@@ -178,7 +199,7 @@ spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* re
 	Str str;
 	Str tuple[4];
 
-	self = NEW(spAtlas);
+	self = SUPER(NEW(_spAtlas));
 	self->rendererObject = rendererObject;
 
 	while (readLine(&begin, end, &str)) {
@@ -301,6 +322,7 @@ spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* re
 		}
 	}
 
+	indexRegions(SUB_CAST(_spAtlas, self));
 	return self;
 }
 
@@ -346,14 +368,16 @@ void spAtlas_dispose(spAtlas* self) {
 		region = nextRegion;
 	}
 
+	FREE(SUB_CAST(_spAtlas, self)->regions);
+	_spNameTable_deinit(&SUB_CAST(_spAtlas, self)->regionNames);
 	FREE(self);
 }
 
 spAtlasRegion* spAtlas_findRegion(const spAtlas* self, const char* name) {
-	spAtlasRegion* region = self->regions;
-	while (region) {
-		if (strcmp(region->name, name) == 0) return region;
-		region = region->next;
-	}
+	const _spAtlas* internal = SUB_CAST(_spAtlas, self);
+	unsigned int hash = _spNameTable_hash(name);
+	int i, cursor = -1;
+	while ((i = _spNameTable_next(&internal->regionNames, hash, &cursor)) != -1)
+		if (strcmp(internal->regions[i]->name, name) == 0) return internal->regions[i];
 	return 0;
 }
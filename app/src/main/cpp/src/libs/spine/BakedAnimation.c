@@ -0,0 +1,391 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/BakedAnimation.h>
+#include <spine/extension.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BONE_FLOATS 6 /* a, b, c, d, worldX, worldY */
+
+typedef struct {
+	spBakedAnimation super;
+	float duration;
+
+	/* The interval from a sample to the next one is split at the first time the pose jumps in it, by a stepped key or an
+	 * attachment or draw order key. Split s adds the pose just before the jump as sample samplesCount + s * 2 and the pose
+	 * at the jump as the sample after it. */
+	int* splits; /* Per sample, the split of the interval to the next sample or -1. */
+	float* splitTimes;
+	int splitsCount;
+
+	float* bones; /* BONE_FLOATS per bone per sample, worldX and worldY without the skeleton position. */
+	spColor* slotColors; /* Per slot per sample. */
+	spColor* slotDarkColors; /* Per slot per sample, 0 when no slot has a dark color. */
+
+	/* Attachments and draw order only change at some samples, each sample keeps the index of its state. */
+	int* attachmentStates;
+	spAttachment** attachments; /* Per slot per state. */
+	int attachmentsCount, attachmentsCapacity;
+	int* drawOrderStates;
+	int* drawOrders; /* Slot indexes per state. */
+	int drawOrdersCount, drawOrdersCapacity;
+
+	int deformTimelinesCount;
+	spTimeline** deformTimelines;
+} _spBakedAnimation;
+
+static float _spBakedAnimation_sampleTime (const _spBakedAnimation* self, int sample) {
+	return MIN(sample / self->super.sampleRate, self->duration);
+}
+
+static int _spBakedAnimation_compareTimes (const void* a, const void* b) {
+	float timeA = *(const float*)a, timeB = *(const float*)b;
+	return timeA < timeB ? -1 : timeA > timeB;
+}
+
+/* Splits every interval at the first step time in it. */
+static void _spBakedAnimation_split (_spBakedAnimation* self, spAnimation* animation) {
+	int i, interval, samplesCount = self->super.samplesCount;
+	int stepsCount = _spAnimation_getStepTimes(animation, 0, 0);
+	float* steps;
+
+	self->splits = MALLOC(int, samplesCount);
+	for (i = 0; i < samplesCount; ++i)
+		self->splits[i] = -1;
+	if (!stepsCount) return;
+
+	steps = MALLOC(float, stepsCount);
+	_spAnimation_getStepTimes(animation, steps, stepsCount);
+	qsort(steps, stepsCount, sizeof(float), _spBakedAnimation_compareTimes);
+	self->splitTimes = MALLOC(float, stepsCount);
+	for (i = 0; i < stepsCount; ++i) {
+		float time = steps[i];
+		if (time <= 0 || time > self->duration) continue;
+		/* The interval with its sample before time and its next sample at or after time. */
+		interval = MIN((int)(time * self->super.sampleRate), samplesCount - 2);
+		while (interval > 0 && _spBakedAnimation_sampleTime(self, interval) >= time) interval--;
+		while (interval < samplesCount - 2 && _spBakedAnimation_sampleTime(self, interval + 1) < time) interval++;
+		if (self->splits[interval] != -1) continue;
+		self->splits[interval] = self->splitsCount;
+		self->splitTimes[self->splitsCount++] = time;
+	}
+	FREE(steps);
+}
+
+/* Returns the index of the state equal to the last one, adding it when it changed. */
+static int _spBakedAnimation_addAttachments (_spBakedAnimation* self, spSkeleton* skeleton) {
+	int i, n = skeleton->slotsCount;
+	spAttachment** state;
+	if (self->attachmentsCount > 0) {
+		state = self->attachments + (self->attachmentsCount - 1) * n;
+		for (i = 0; i < n; ++i)
+			if (state[i] != skeleton->slots[i]->attachment) break;
+		if (i == n) return self->attachmentsCount - 1;
+	}
+	if (self->attachmentsCount == self->attachmentsCapacity) {
+		self->attachmentsCapacity = MAX(8, self->attachmentsCapacity << 1);
+		self->attachments = REALLOC(self->attachments, spAttachment*, self->attachmentsCapacity * n);
+	}
+	state = self->attachments + self->attachmentsCount * n;
+	for (i = 0; i < n; ++i)
+		state[i] = skeleton->slots[i]->attachment;
+	return self->attachmentsCount++;
+}
+
+static int _spBakedAnimation_addDrawOrder (_spBakedAnimation* self, spSkeleton* skeleton) {
+	int i, n = skeleton->slotsCount;
+	int* state;
+	if (self->drawOrdersCount > 0) {
+		state = self->drawOrders + (self->drawOrdersCount - 1) * n;
+		for (i = 0; i < n; ++i)
+			if (state[i] != skeleton->drawOrder[i]->data->index) break;
+		if (i == n) return self->drawOrdersCount - 1;
+	}
+	if (self->drawOrdersCount == self->drawOrdersCapacity) {
+		self->drawOrdersCapacity = MAX(8, self->drawOrdersCapacity << 1);
+		self->drawOrders = REALLOC(self->drawOrders, int, self->drawOrdersCapacity * n);
+	}
+	state = self->drawOrders + self->drawOrdersCount * n;
+	for (i = 0; i < n; ++i)
+		state[i] = skeleton->drawOrder[i]->data->index;
+	return self->drawOrdersCount++;
+}
+
+static void _spBakedAnimation_pose (const _spBakedAnimation* self, spSkeleton* skeleton, float time) {
+	spSkeleton_setToSetupPose(skeleton);
+	spAnimation_apply(self->super.animation, skeleton, time, time, 0, 0, 0, 1, SP_MIX_POSE_SETUP, SP_MIX_DIRECTION_IN);
+	spSkeleton_updateWorldTransform(skeleton);
+}
+
+static void _spBakedAnimation_addSample (_spBakedAnimation* self, spSkeleton* skeleton, int sample, float time) {
+	int i, bonesCount = self->super.bonesCount, slotsCount = self->super.slotsCount;
+	float* bones = self->bones + BONE_FLOATS * bonesCount * sample;
+	spColor* colors = self->slotColors + slotsCount * sample;
+
+	_spBakedAnimation_pose(self, skeleton, time);
+	for (i = 0; i < bonesCount; ++i, bones += BONE_FLOATS) {
+		spBone* bone = skeleton->bones[i];
+		bones[0] = bone->a;
+		bones[1] = bone->b;
+		bones[2] = bone->c;
+		bones[3] = bone->d;
+		bones[4] = bone->worldX;
+		bones[5] = bone->worldY;
+	}
+	for (i = 0; i < slotsCount; ++i) {
+		spSlot* slot = skeleton->slots[i];
+		colors[i] = slot->color;
+		if (self->slotDarkColors) {
+			spColor* darkColor = self->slotDarkColors + slotsCount * sample + i;
+			if (slot->darkColor)
+				*darkColor = *slot->darkColor;
+			else
+				spColor_setFromFloats(darkColor, 0, 0, 0, 0);
+		}
+	}
+	self->attachmentStates[sample] = _spBakedAnimation_addAttachments(self, skeleton);
+	self->drawOrderStates[sample] = _spBakedAnimation_addDrawOrder(self, skeleton);
+}
+
+spBakedAnimation* spBakedAnimation_create (spSkeleton* skeleton, spAnimation* animation, float sampleRate) {
+	_spBakedAnimation* internal = NEW(_spBakedAnimation);
+	spBakedAnimation* self = SUPER(internal);
+	int i, ii, samplesCount, allSamplesCount, bonesCount = skeleton->bonesCount, slotsCount = skeleton->slotsCount;
+	int darkColors = 0;
+	float x = skeleton->x, y = skeleton->y;
+
+	for (i = 0; i < slotsCount; ++i)
+		if (skeleton->slots[i]->darkColor) darkColors = 1;
+	for (i = 0; i < animation->timelinesCount; ++i)
+		if (animation->timelines[i]->type == SP_TIMELINE_DEFORM) internal->deformTimelinesCount++;
+	if (internal->deformTimelinesCount) {
+		internal->deformTimelines = MALLOC(spTimeline*, internal->deformTimelinesCount);
+		for (i = 0, ii = 0; i < animation->timelinesCount; ++i)
+			if (animation->timelines[i]->type == SP_TIMELINE_DEFORM) internal->deformTimelines[ii++] = animation->timelines[i];
+	}
+
+	internal->duration = animation->duration;
+	samplesCount = (int)(animation->duration * sampleRate);
+	if (samplesCount < animation->duration * sampleRate) samplesCount++;
+	samplesCount++;
+	CONST_CAST(spAnimation*, self->animation) = animation;
+	CONST_CAST(float, self->sampleRate) = sampleRate;
+	CONST_CAST(int, self->samplesCount) = samplesCount;
+	CONST_CAST(int, self->bonesCount) = bonesCount;
+	CONST_CAST(int, self->slotsCount) = slotsCount;
+	_spBakedAnimation_split(internal, animation);
+
+	allSamplesCount = samplesCount + internal->splitsCount * 2;
+	internal->bones = MALLOC(float, BONE_FLOATS * bonesCount * allSamplesCount);
+	internal->slotColors = MALLOC(spColor, slotsCount * allSamplesCount);
+	if (darkColors) internal->slotDarkColors = MALLOC(spColor, slotsCount * allSamplesCount);
+	internal->attachmentStates = MALLOC(int, allSamplesCount);
+	internal->drawOrderStates = MALLOC(int, allSamplesCount);
+
+	/* Baked without the skeleton position, which apply adds. */
+	skeleton->x = 0;
+	skeleton->y = 0;
+	for (i = 0; i < samplesCount; ++i) {
+		float sampleTime = _spBakedAnimation_sampleTime(internal, i);
+		_spBakedAnimation_addSample(internal, skeleton, i, sampleTime);
+		if (internal->splits[i] != -1) {
+			int split = internal->splits[i];
+			float time = internal->splitTimes[split];
+			_spBakedAnimation_addSample(internal, skeleton, samplesCount + split * 2, time - (time - sampleTime) * 0.001f);
+			_spBakedAnimation_addSample(internal, skeleton, samplesCount + split * 2 + 1, time);
+		}
+	}
+	skeleton->x = x;
+	skeleton->y = y;
+	spSkeleton_setToSetupPose(skeleton);
+	spSkeleton_updateWorldTransform(skeleton);
+	return self;
+}
+
+void spBakedAnimation_dispose (spBakedAnimation* self) {
+	_spBakedAnimation* internal = SUB_CAST(_spBakedAnimation, self);
+	FREE(internal->splits);
+	FREE(internal->splitTimes);
+	FREE(internal->bones);
+	FREE(internal->slotColors);
+	FREE(internal->slotDarkColors);
+	FREE(internal->attachmentStates);
+	FREE(internal->attachments);
+	FREE(internal->drawOrderStates);
+	FREE(internal->drawOrders);
+	FREE(internal->deformTimelines);
+	FREE(self);
+}
+
+static void _spColor_lerp (spColor* color, const spColor* from, const spColor* to, float alpha) {
+	color->r = from->r + (to->r - from->r) * alpha;
+	color->g = from->g + (to->g - from->g) * alpha;
+	color->b = from->b + (to->b - from->b) * alpha;
+	color->a = from->a + (to->a - from->a) * alpha;
+}
+
+void spBakedAnimation_apply (const spBakedAnimation* self, spSkeleton* skeleton, float time, int /*bool*/ loop) {
+	const _spBakedAnimation* internal = SUB_CAST(_spBakedAnimation, self);
+	int i, sample, from, to, bonesCount = self->bonesCount, slotsCount = self->slotsCount;
+	float alpha, fromTime, toTime;
+	const float *fromBones, *toBones;
+	spAttachment** attachments;
+	int* drawOrder;
+
+	if (loop && internal->duration) time = FMOD(time, internal->duration);
+	time = MAX(0, MIN(time, internal->duration));
+	sample = MIN((int)(time * self->sampleRate), self->samplesCount - 1);
+	/* time * sampleRate may round down at a sample time. */
+	if (sample < self->samplesCount - 1 && _spBakedAnimation_sampleTime(internal, sample + 1) <= time) sample++;
+	from = sample;
+	to = MIN(sample + 1, self->samplesCount - 1);
+	fromTime = _spBakedAnimation_sampleTime(internal, from);
+	toTime = _spBakedAnimation_sampleTime(internal, to);
+	if (internal->splits[sample] != -1) {
+		int split = internal->splits[sample];
+		float splitTime = internal->splitTimes[split];
+		if (time < splitTime) {
+			to = self->samplesCount + split * 2;
+			toTime = splitTime;
+		} else {
+			from = self->samplesCount + split * 2 + 1;
+			fromTime = splitTime;
+		}
+	}
+	alpha = toTime > fromTime ? (time - fromTime) / (toTime - fromTime) : 0;
+
+	fromBones = internal->bones + BONE_FLOATS * bonesCount * from;
+	toBones = internal->bones + BONE_FLOATS * bonesCount * to;
+	for (i = 0; i < bonesCount; ++i, fromBones += BONE_FLOATS, toBones += BONE_FLOATS) {
+		spBone* bone = skeleton->bones[i];
+		CONST_CAST(float, bone->a) = fromBones[0] + (toBones[0] - fromBones[0]) * alpha;
+		CONST_CAST(float, bone->b) = fromBones[1] + (toBones[1] - fromBones[1]) * alpha;
+		CONST_CAST(float, bone->c) = fromBones[2] + (toBones[2] - fromBones[2]) * alpha;
+		CONST_CAST(float, bone->d) = fromBones[3] + (toBones[3] - fromBones[3]) * alpha;
+		CONST_CAST(float, bone->worldX) = fromBones[4] + (toBones[4] - fromBones[4]) * alpha + skeleton->x;
+		CONST_CAST(float, bone->worldY) = fromBones[5] + (toBones[5] - fromBones[5]) * alpha + skeleton->y;
+		bone->appliedValid = 0;
+	}
+
+	attachments = internal->attachments + internal->attachmentStates[from] * slotsCount;
+	for (i = 0; i < slotsCount; ++i) {
+		spSlot* slot = skeleton->slots[i];
+		_spColor_lerp(&slot->color, internal->slotColors + slotsCount * from + i,
+				internal->slotColors + slotsCount * to + i, alpha);
+		if (internal->slotDarkColors && slot->darkColor)
+			_spColor_lerp(slot->darkColor, internal->slotDarkColors + slotsCount * from + i,
+					internal->slotDarkColors + slotsCount * to + i, alpha);
+		spSlot_setAttachment(slot, attachments[i]);
+	}
+	drawOrder = internal->drawOrders + internal->drawOrderStates[from] * slotsCount;
+	for (i = 0; i < slotsCount; ++i)
+		skeleton->drawOrder[i] = skeleton->slots[drawOrder[i]];
+
+	for (i = 0; i < internal->deformTimelinesCount; ++i)
+		spTimeline_apply(internal->deformTimelines[i], skeleton, time, time, 0, 0, 1, SP_MIX_POSE_SETUP, SP_MIX_DIRECTION_IN);
+}
+
+int spBakedAnimation_getByteCount (const spBakedAnimation* self) {
+	const _spBakedAnimation* internal = SUB_CAST(_spBakedAnimation, self);
+	int allSamplesCount = self->samplesCount + internal->splitsCount * 2;
+	return sizeof(_spBakedAnimation)
+		+ sizeof(int) * self->samplesCount
+		+ sizeof(float) * internal->splitsCount
+		+ sizeof(float) * BONE_FLOATS * self->bonesCount * allSamplesCount
+		+ sizeof(spColor) * self->slotsCount * allSamplesCount * (internal->slotDarkColors ? 2 : 1)
+		+ sizeof(int) * allSamplesCount * 2
+		+ sizeof(spAttachment*) * self->slotsCount * internal->attachmentsCapacity
+		+ sizeof(int) * self->slotsCount * internal->drawOrdersCapacity
+		+ sizeof(spTimeline*) * internal->deformTimelinesCount;
+}
+
+float spBakedAnimation_getBytesPerSecond (const spBakedAnimation* self) {
+	const _spBakedAnimation* internal = SUB_CAST(_spBakedAnimation, self);
+	float byteCount = (float)spBakedAnimation_getByteCount(self);
+	return internal->duration > 0 ? byteCount / internal->duration : byteCount;
+}
+
+/* Origin and tip of every bone. */
+static void _spBakedAnimation_bonePoints (const spSkeleton* skeleton, float* points) {
+	int i;
+	for (i = 0; i < skeleton->bonesCount; ++i, points += 4) {
+		const spBone* bone = skeleton->bones[i];
+		float length = MAX(bone->data->length, 1);
+		points[0] = bone->worldX;
+		points[1] = bone->worldY;
+		points[2] = bone->worldX + bone->a * length;
+		points[3] = bone->worldY + bone->c * length;
+	}
+}
+
+float spBakedAnimation_measureError (const spBakedAnimation* self, spSkeleton* skeleton, int probesPerSample,
+		float* colorError) {
+	const _spBakedAnimation* internal = SUB_CAST(_spBakedAnimation, self);
+	int i, ii, probe, slotsCount = self->slotsCount;
+	float* live = MALLOC(float, 4 * self->bonesCount);
+	float* baked = MALLOC(float, 4 * self->bonesCount);
+	spColor* liveColors = MALLOC(spColor, slotsCount);
+	float error = 0, maxColorError = 0;
+
+	for (i = 0; i < self->samplesCount - 1; ++i) {
+		float sampleTime = _spBakedAnimation_sampleTime(internal, i);
+		float interval = _spBakedAnimation_sampleTime(internal, i + 1) - sampleTime;
+		for (probe = 1; probe <= probesPerSample; ++probe) {
+			float time = sampleTime + interval * probe / (probesPerSample + 1);
+			_spBakedAnimation_pose(internal, skeleton, time);
+			_spBakedAnimation_bonePoints(skeleton, live);
+			for (ii = 0; ii < slotsCount; ++ii)
+				liveColors[ii] = skeleton->slots[ii]->color;
+
+			spBakedAnimation_apply(self, skeleton, time, 0);
+			_spBakedAnimation_bonePoints(skeleton, baked);
+			for (ii = 0; ii < 4 * self->bonesCount; ii += 2) {
+				float dx = live[ii] - baked[ii], dy = live[ii + 1] - baked[ii + 1];
+				error = MAX(error, SQRT(dx * dx + dy * dy));
+			}
+			for (ii = 0; ii < slotsCount; ++ii) {
+				const spColor* color = &skeleton->slots[ii]->color;
+				maxColorError = MAX(maxColorError, ABS(liveColors[ii].r - color->r));
+				maxColorError = MAX(maxColorError, ABS(liveColors[ii].g - color->g));
+				maxColorError = MAX(maxColorError, ABS(liveColors[ii].b - color->b));
+				maxColorError = MAX(maxColorError, ABS(liveColors[ii].a - color->a));
+			}
+		}
+	}
+
+	FREE(live);
+	FREE(baked);
+	FREE(liveColors);
+	spSkeleton_setToSetupPose(skeleton);
+	spSkeleton_updateWorldTransform(skeleton);
+	if (colorError) *colorError = maxColorError;
+	return error;
+}
@@ -32,6 +32,7 @@
 #include <spine/extension.h>
 #include <stdio.h>
 static int yDown;
+static int fastMath;
 
 void spBone_setYDown (int value) {
 	yDown = value;
@@ -41,14 +42,26 @@ int spBone_isYDown () {
 	return yDown;
 }
 
-spBone* spBone_create (spBoneData* data, spSkeleton* skeleton, spBone* parent) {
-	spBone* self = NEW(spBone);
+void spBone_setFastMath (int value) {
+	fastMath = value;
+}
+
+int spBone_isFastMath () {
+	return fastMath;
+}
+
+void _spBone_init (spBone* self, spBoneData* data, spSkeleton* skeleton, spBone* parent) {
 	CONST_CAST(spBoneData*, self->data) = data;
 	CONST_CAST(spSkeleton*, self->skeleton) = skeleton;
 	CONST_CAST(spBone*, self->parent) = parent;
 	CONST_CAST(float, self->a) = 1.0f;
 	CONST_CAST(float, self->d) = 1.0f;
 	spBone_setToSetupPose(self);
+}
+
+spBone* spBone_create (spBoneData* data, spSkeleton* skeleton, spBone* parent) {
+	spBone* self = NEW(spBone);
+	_spBone_init(self, data, skeleton, parent);
 	return self;
 }
 
@@ -76,11 +89,13 @@ void spBone_updateWorldTransformWith (spBone* self, float x, float y, float rota
 	self->appliedValid = 1;
 
 	if (!parent) { /* Root bone. */
-		float rotationY = rotation + 90 + shearY;
-		float la = COS_DEG(rotation + shearX) * scaleX;
-		float lb = COS_DEG(rotationY) * scaleY;
-		float lc = SIN_DEG(rotation + shearX) * scaleX;
-		float ld = SIN_DEG(rotationY) * scaleY;
+		float la, lb, lc, ld;
+		_spMath_sinCosDeg(rotation + shearX, &sine, &cosine);
+		la = cosine * scaleX;
+		lc = sine * scaleX;
+		_spMath_sinCosDeg(rotation + 90 + shearY, &sine, &cosine);
+		lb = cosine * scaleY;
+		ld = sine * scaleY;
 		if (self->skeleton->flipX) {
 			x = -x;
 			la = -la;
@@ -110,11 +125,13 @@ void spBone_updateWorldTransformWith (spBone* self, float x, float y, float rota
 
 	switch (self->data->transformMode) {
 		case SP_TRANSFORMMODE_NORMAL: {
-			float rotationY = rotation + 90 + shearY;
-			float la = COS_DEG(rotation + shearX) * scaleX;
-			float lb = COS_DEG(rotationY) * scaleY;
-			float lc = SIN_DEG(rotation + shearX) * scaleX;
-			float ld = SIN_DEG(rotationY) * scaleY;
+			float la, lb, lc, ld;
+			_spMath_sinCosDeg(rotation + shearX, &sine, &cosine);
+			la = cosine * scaleX;
+			lc = sine * scaleX;
+			_spMath_sinCosDeg(rotation + 90 + shearY, &sine, &cosine);
+			lb = cosine * scaleY;
+			ld = sine * scaleY;
 			CONST_CAST(float, self->a) = pa * la + pb * lc;
 			CONST_CAST(float, self->b) = pa * lb + pb * ld;
 			CONST_CAST(float, self->c) = pc * la + pd * lc;
@@ -122,11 +139,12 @@ void spBone_updateWorldTransformWith (spBone* self, float x, float y, float rota
 			return;
 		}
 		case SP_TRANSFORMMODE_ONLYTRANSLATION: {
-			float rotationY = rotation + 90 + shearY;
-			CONST_CAST(float, self->a) = COS_DEG(rotation + shearX) * scaleX;
-			CONST_CAST(float, self->b) = COS_DEG(rotationY) * scaleY;
-			CONST_CAST(float, self->c) = SIN_DEG(rotation + shearX) * scaleX;
-			CONST_CAST(float, self->d) = SIN_DEG(rotationY) * scaleY;
+			_spMath_sinCosDeg(rotation + shearX, &sine, &cosine);
+			CONST_CAST(float, self->a) = cosine * scaleX;
+			CONST_CAST(float, self->c) = sine * scaleX;
+			_spMath_sinCosDeg(rotation + 90 + shearY, &sine, &cosine);
+			CONST_CAST(float, self->b) = cosine * scaleY;
+			CONST_CAST(float, self->d) = sine * scaleY;
 			break;
 		}
 		case SP_TRANSFORMMODE_NOROTATIONORREFLECTION: {
@@ -144,10 +162,12 @@ void spBone_updateWorldTransformWith (spBone* self, float x, float y, float rota
 			}
 			rx = rotation + shearX - prx;
 			ry = rotation + shearY - prx + 90;
-			la = COS_DEG(rx) * scaleX;
-			lb = COS_DEG(ry) * scaleY;
-			lc = SIN_DEG(rx) * scaleX;
-			ld = SIN_DEG(ry) * scaleY;
+			_spMath_sinCosDeg(rx, &sine, &cosine);
+			la = cosine * scaleX;
+			lc = sine * scaleX;
+			_spMath_sinCosDeg(ry, &sine, &cosine);
+			lb = cosine * scaleY;
+			ld = sine * scaleY;
 			CONST_CAST(float, self->a) = pa * la - pb * lc;
 			CONST_CAST(float, self->b) = pa * lb - pb * ld;
 			CONST_CAST(float, self->c) = pc * la + pd * lc;
@@ -158,7 +178,7 @@ void spBone_updateWorldTransformWith (spBone* self, float x, float y, float rota
 		case SP_TRANSFORMMODE_NOSCALEORREFLECTION: {
 			float za, zc, s;
 			float r, zb, zd, la, lb, lc, ld;
-			cosine = COS_DEG(rotation); sine = SIN_DEG(rotation);
+			_spMath_sinCosDeg(rotation, &sine, &cosine);
 			za = pa * cosine + pb * sine;
 			zc = pc * cosine + pd * sine;
 			s = SQRT(za * za + zc * zc);
@@ -167,12 +187,15 @@ void spBone_updateWorldTransformWith (spBone* self, float x, float y, float rota
 			zc *= s;
 			s = SQRT(za * za + zc * zc);
 			r = PI / 2 + atan2(zc, za);
-			zb = COS(r) * s;
-			zd = SIN(r) * s;
-			la = COS_DEG(shearX) * scaleX;
-			lb = COS_DEG(90 + shearY) * scaleY;
-			lc = SIN_DEG(shearX) * scaleX;
-			ld = SIN_DEG(90 + shearY) * scaleY;
+			_spMath_sinCos(r, &sine, &cosine);
+			zb = cosine * s;
+			zd = sine * s;
+			_spMath_sinCosDeg(shearX, &sine, &cosine);
+			la = cosine * scaleX;
+			lc = sine * scaleX;
+			_spMath_sinCosDeg(90 + shearY, &sine, &cosine);
+			lb = cosine * scaleY;
+			ld = sine * scaleY;
 			if (self->data->transformMode != SP_TRANSFORMMODE_NOSCALEORREFLECTION ? pa * pd - pb * pc < 0 : self->skeleton->flipX != self->skeleton->flipY) {
 				zb = -zb;
 				zd = -zd;
@@ -281,21 +304,20 @@ void spBone_localToWorld (spBone* self, float localX, float localY, float* world
 
 float spBone_worldToLocalRotation (spBone* self, float worldRotation) {
 	float sine, cosine;
-	sine = SIN_DEG(worldRotation);
-	cosine = COS_DEG(worldRotation);
+	_spMath_sinCosDeg(worldRotation, &sine, &cosine);
 	return ATAN2(self->a * sine - self->c * cosine, self->d * cosine - self->b * sine) * RAD_DEG;
 }
 
 float spBone_localToWorldRotation (spBone* self, float localRotation) {
 	float sine, cosine;
-	sine = SIN_DEG(localRotation);
-	cosine = COS_DEG(localRotation);
+	_spMath_sinCosDeg(localRotation, &sine, &cosine);
 	return ATAN2(cosine * self->c + sine * self->d, cosine * self->a + sine * self->b) * RAD_DEG;
 }
 
 void spBone_rotateWorld (spBone* self, float degrees) {
 	float a = self->a, b = self->b, c = self->c, d = self->d;
-	float cosine = COS_DEG(degrees), sine = SIN_DEG(degrees);
+	float cosine, sine;
+	_spMath_sinCosDeg(degrees, &sine, &cosine);
 	CONST_CAST(float, self->a) = cosine * a - sine * c;
 	CONST_CAST(float, self->b) = cosine * b - sine * d;
 	CONST_CAST(float, self->c) = sine * a + cosine * c;
@@ -33,20 +33,23 @@
 #include <spine/extension.h>
 #include <float.h>
 
-spIkConstraint *spIkConstraint_create(spIkConstraintData *data, const spSkeleton *skeleton) {
+void _spIkConstraint_init(spIkConstraint *self, spIkConstraintData *data, const spSkeleton *skeleton, spBone **bones) {
 	int i;
 
-	spIkConstraint *self = NEW(spIkConstraint);
 	CONST_CAST(spIkConstraintData*, self->data) = data;
 	self->bendDirection = data->bendDirection;
 	self->mix = data->mix;
 
 	self->bonesCount = self->data->bonesCount;
-	self->bones = MALLOC(spBone*, self->bonesCount);
+	self->bones = bones;
 	for (i = 0; i < self->bonesCount; ++i)
-		self->bones[i] = spSkeleton_findBone(skeleton, self->data->bones[i]->name);
-	self->target = spSkeleton_findBone(skeleton, self->data->target->name);
+		self->bones[i] = skeleton->bones[self->data->bones[i]->index];
+	self->target = skeleton->bones[self->data->target->index];
+}
 
+spIkConstraint *spIkConstraint_create(spIkConstraintData *data, const spSkeleton *skeleton) {
+	spIkConstraint *self = NEW(spIkConstraint);
+	_spIkConstraint_init(self, data, skeleton, MALLOC(spBone*, data->bonesCount));
 	return self;
 }
 
@@ -66,14 +69,19 @@ void spIkConstraint_apply(spIkConstraint *self) {
 	}
 }
 
-void spIkConstraint_apply1 (spBone* bone, float targetX, float targetY, float alpha) {
+/* Target position in the parent space of bone, relative to bone. */
+static void _spIkConstraint_target1 (spBone* bone, float targetX, float targetY, float* tx, float* ty) {
 	spBone* p = bone->parent;
-	float id, x, y, tx, ty, rotationIK;
+	float id, x, y;
 	if (!bone->appliedValid) spBone_updateAppliedTransform(bone);
 	id = 1 / (p->a * p->d - p->b * p->c);
 	x = targetX - p->worldX, y = targetY - p->worldY;
-	tx = (x * p->d - y * p->b) * id - bone->ax; ty = (y * p->a - x * p->c) * id - bone->ay;
-	rotationIK = ATAN2(ty, tx) * RAD_DEG - bone->ashearX - bone->arotation;
+	*tx = (x * p->d - y * p->b) * id - bone->ax; *ty = (y * p->a - x * p->c) * id - bone->ay;
+}
+
+/* @param angle ATAN2 of the target returned by _spIkConstraint_target1. */
+static void _spIkConstraint_rotate1 (spBone* bone, float angle, float alpha) {
+	float rotationIK = angle * RAD_DEG - bone->ashearX - bone->arotation;
 	if (bone->ascaleX < 0) rotationIK += 180;
 	if (rotationIK > 180) rotationIK -= 360;
 	else if (rotationIK < -180) rotationIK += 360;
@@ -81,17 +89,25 @@ void spIkConstraint_apply1 (spBone* bone, float targetX, float targetY, float al
 		bone->ascaleY, bone->ashearX, bone->ashearY);
 }
 
-void spIkConstraint_apply2 (spBone* parent, spBone* child, float targetX, float targetY, int bendDir, float alpha) {
+void spIkConstraint_apply1 (spBone* bone, float targetX, float targetY, float alpha) {
+	float tx, ty;
+	_spIkConstraint_target1(bone, targetX, targetY, &tx, &ty);
+	_spIkConstraint_rotate1(bone, ATAN2(ty, tx), alpha);
+}
+
+/* Two bone chain of spIkConstraint_apply2, positions in the space of the parent's parent. */
+typedef struct {
+	float px, py, psx, psy, cx, cy, tx, ty, l1, l2;
+	int o1, o2, s2, u;
+} _spIkChain;
+
+static void _spIkChain_init (_spIkChain* self, spBone* parent, spBone* child, float targetX, float targetY) {
 	float px, py, psx, psy;
 	float cx, cy, csx, cwx, cwy;
 	int o1, o2, s2, u;
 	spBone* pp = parent->parent;
-	float tx, ty, dx, dy, l1, l2, a1, a2, r;
+	float tx, ty, dx, dy, r;
 	float id, x, y;
-	if (alpha == 0) {
-		spBone_updateWorldTransform(child);
-		return;
-	}
 	if (!parent->appliedValid) spBone_updateAppliedTransform(parent);
 	if (!child->appliedValid) spBone_updateAppliedTransform(child);
 	px = parent->ax; py = parent->ay; psx = parent->ascaleX; psy = parent->ascaleY; csx = child->ascaleX;
@@ -133,76 +149,190 @@ void spIkConstraint_apply2 (spBone* parent, spBone* child, float targetX, float
 	y = cwy - pp->worldY;
 	dx = (x * pp->d - y * pp->b) * id - px;
 	dy = (y * pp->a - x * pp->c) * id - py;
-	l1 = SQRT(dx * dx + dy * dy);
-	l2 = child->data->length * csx;
-	if (u) {
-		float cosine, a, b;
-		l2 *= psx;
-		cosine = (tx * tx + ty * ty - l1 * l1 - l2 * l2) / (2 * l1 * l2);
-		if (cosine < -1) cosine = -1;
-		else if (cosine > 1) cosine = 1;
+	self->l1 = SQRT(dx * dx + dy * dy);
+	self->l2 = child->data->length * csx;
+	self->px = px; self->py = py; self->psx = psx; self->psy = psy;
+	self->cx = cx; self->cy = cy; self->tx = tx; self->ty = ty;
+	self->o1 = o1; self->o2 = o2; self->s2 = s2; self->u = u;
+}
+
+/* Cosine of the child angle of a uniformly scaled chain, l2 scaled by the parent. */
+static float _spIkChain_cosine (const _spIkChain* self, float l2) {
+	float tx = self->tx, ty = self->ty, l1 = self->l1;
+	float cosine = (tx * tx + ty * ty - l1 * l1 - l2 * l2) / (2 * l1 * l2);
+	if (cosine < -1) cosine = -1;
+	else if (cosine > 1) cosine = 1;
+	return cosine;
+}
+
+static void _spIkChain_solveNonUniform (const _spIkChain* self, int bendDir, float* parentAngle, float* childAngle) {
+	float tx = self->tx, ty = self->ty, l1 = self->l1, l2 = self->l2, psx = self->psx, psy = self->psy;
+	float a = psx * l2, b = psy * l2;
+	float aa = a * a, bb = b * b, ll = l1 * l1, dd = tx * tx + ty * ty, ta = ATAN2(ty, tx);
+	float c0 = bb * ll + aa * dd - aa * bb, c1 = -2 * bb * l1, c2 = bb - aa;
+	float d = c1 * c1 - 4 * c2 * c0;
+	float x, y, r;
+	if (d >= 0) {
+		float q = SQRT(d), r0, r1;
+		if (c1 < 0) q = -q;
+		q = -(c1 + q) / 2;
+		r0 = q / c2; r1 = c0 / q;
+		r = ABS(r0) < ABS(r1) ? r0 : r1;
+		if (r * r <= dd) {
+			y = SQRT(dd - r * r) * bendDir;
+			*parentAngle = ta - ATAN2(y, r);
+			*childAngle = ATAN2(y / psy, (r - l1) / psx);
+			return;
+		}
+	}
+	{
+		float minAngle = PI, minX = l1 - a, minDist = minX * minX, minY = 0;
+		float maxAngle = 0, maxX = l1 + a, maxDist = maxX * maxX, maxY = 0;
+		c0 = -a * l1 / (aa - bb);
+		if (c0 >= -1 && c0 <= 1) {
+			c0 = ACOS(c0);
+			x = a * COS(c0) + l1;
+			y = b * SIN(c0);
+			d = x * x + y * y;
+			if (d < minDist) {
+				minAngle = c0;
+				minDist = d;
+				minX = x;
+				minY = y;
+			}
+			if (d > maxDist) {
+				maxAngle = c0;
+				maxDist = d;
+				maxX = x;
+				maxY = y;
+			}
+		}
+		if (dd <= (minDist + maxDist) / 2) {
+			*parentAngle = ta - ATAN2(minY * bendDir, minX);
+			*childAngle = minAngle * bendDir;
+		} else {
+			*parentAngle = ta - ATAN2(maxY * bendDir, maxX);
+			*childAngle = maxAngle * bendDir;
+		}
+	}
+}
+
+/* Rotates both bones by the solved angles in radians. @param os ATAN2 of the child position. */
+static void _spIkChain_rotate (const _spIkChain* self, spBone* parent, spBone* child, float a1, float a2, float os,
+	float alpha) {
+	os *= self->s2;
+	a1 = (a1 - os) * RAD_DEG + self->o1 - parent->arotation;
+	if (a1 > 180) a1 -= 360;
+	else if (a1 < -180) a1 += 360;
+	spBone_updateWorldTransformWith(parent, self->px, self->py, parent->rotation + a1 * alpha, parent->ascaleX, parent->ascaleY,
+		0, 0);
+	a2 = ((a2 + os) * RAD_DEG - child->ashearX) * self->s2 + self->o2 - child->arotation;
+	if (a2 > 180) a2 -= 360;
+	else if (a2 < -180) a2 += 360;
+	spBone_updateWorldTransformWith(child, self->cx, self->cy, child->arotation + a2 * alpha, child->ascaleX, child->ascaleY,
+		child->ashearX, child->ashearY);
+}
+
+void spIkConstraint_apply2 (spBone* parent, spBone* child, float targetX, float targetY, int bendDir, float alpha) {
+	_spIkChain chain;
+	float a1, a2;
+	if (alpha == 0) {
+		spBone_updateWorldTransform(child);
+		return;
+	}
+	_spIkChain_init(&chain, parent, child, targetX, targetY);
+	if (chain.u) {
+		float tx = chain.tx, ty = chain.ty, l2 = chain.l2 * chain.psx;
+		float cosine = _spIkChain_cosine(&chain, l2), a, b;
 		a2 = ACOS(cosine) * bendDir;
-		a = l1 + l2 * cosine;
+		a = chain.l1 + l2 * cosine;
 		b = l2 * SIN(a2);
 		a1 = ATAN2(ty * a - tx * b, tx * a + ty * b);
-	} else {
-		float a = psx * l2, b = psy * l2;
-		float aa = a * a, bb = b * b, ll = l1 * l1, dd = tx * tx + ty * ty, ta = ATAN2(ty, tx);
-		float c0 = bb * ll + aa * dd - aa * bb, c1 = -2 * bb * l1, c2 = bb - aa;
-		float d = c1 * c1 - 4 * c2 * c0;
-		if (d >= 0) {
-			float q = SQRT(d), r0, r1;
-			if (c1 < 0) q = -q;
-			q = -(c1 + q) / 2;
-			r0 = q / c2; r1 = c0 / q;
-			r = ABS(r0) < ABS(r1) ? r0 : r1;
-			if (r * r <= dd) {
-				y = SQRT(dd - r * r) * bendDir;
-				a1 = ta - ATAN2(y, r);
-				a2 = ATAN2(y / psy, (r - l1) / psx);
-				goto outer;
-			}
+	} else
+		_spIkChain_solveNonUniform(&chain, bendDir, &a1, &a2);
+	_spIkChain_rotate(&chain, parent, child, a1, a2, ATAN2(chain.cy, chain.cx), alpha);
+}
+
+/* Scratch arrays of _spIkConstraint_applyBatch. */
+#define SP_IK_BATCH_FLOATS 10
+
+/* Two bone constraints whose angles are solved with the array functions: uniformly scaled and with a mix. */
+static int /*bool*/ _spIkConstraint_isBatched2 (const spIkConstraint* self, const _spIkChain* chain) {
+	return self->bonesCount == 2 && self->mix != 0 && chain->u;
+}
+
+size_t _spIkConstraint_getBatchScratchSize (int count) {
+	return (sizeof(_spIkChain) + sizeof(float) * SP_IK_BATCH_FLOATS) * count;
+}
+
+void _spIkConstraint_applyBatch (spIkConstraint** constraints, int count, void* scratch) {
+	_spIkChain* chains = (_spIkChain*)scratch;
+	float* y = (float*)(chains + count); /* 2 * count atan2 inputs and angles. */
+	float* x = y + count * 2;
+	float* angles = x + count * 2;
+	float* childAngles = angles + count * 2;
+	float* sines = childAngles + count;
+	float* cosines = sines + count;
+	int i, n, lane;
+
+	/* One bone: the angle of the target in the parent space. */
+	for (i = 0, n = 0; i < count; ++i) {
+		spIkConstraint* constraint = constraints[i];
+		if (constraint->bonesCount != 1) continue;
+		_spIkConstraint_target1(constraint->bones[0], constraint->target->worldX, constraint->target->worldY, x + n, y + n);
+		++n;
+	}
+	_spMath_atan2Array(y, x, angles, n);
+	for (i = 0, lane = 0; i < count; ++i) {
+		spIkConstraint* constraint = constraints[i];
+		if (constraint->bonesCount == 1) _spIkConstraint_rotate1(constraint->bones[0], angles[lane++], constraint->mix);
+	}
+
+	/* Two bones: acos of the cosine law, then the parent angle and the child position angle. The others are solved here. */
+	for (i = 0, n = 0; i < count; ++i) {
+		spIkConstraint* constraint = constraints[i];
+		_spIkChain* chain = chains + i;
+		chain->u = 0;
+		if (constraint->bonesCount != 2) continue;
+		if (constraint->mix == 0) {
+			spIkConstraint_apply(constraint);
+			continue;
 		}
-		{
-			float minAngle = PI, minX = l1 - a, minDist = minX * minX, minY = 0;
-			float maxAngle = 0, maxX = l1 + a, maxDist = maxX * maxX, maxY = 0;
-			c0 = -a * l1 / (aa - bb);
-			if (c0 >= -1 && c0 <= 1) {
-				c0 = ACOS(c0);
-				x = a * COS(c0) + l1;
-				y = b * SIN(c0);
-				d = x * x + y * y;
-				if (d < minDist) {
-					minAngle = c0;
-					minDist = d;
-					minX = x;
-					minY = y;
-				}
-				if (d > maxDist) {
-					maxAngle = c0;
-					maxDist = d;
-					maxX = x;
-					maxY = y;
-				}
-			}
-			if (dd <= (minDist + maxDist) / 2) {
-				a1 = ta - ATAN2(minY * bendDir, minX);
-				a2 = minAngle * bendDir;
-			} else {
-				a1 = ta - ATAN2(maxY * bendDir, maxX);
-				a2 = maxAngle * bendDir;
-			}
+		_spIkChain_init(chain, constraint->bones[0], constraint->bones[1], constraint->target->worldX, constraint->target->worldY);
+		if (!chain->u) {
+			float a1, a2;
+			_spIkChain_solveNonUniform(chain, constraint->bendDirection, &a1, &a2);
+			_spIkChain_rotate(chain, constraint->bones[0], constraint->bones[1], a1, a2, ATAN2(chain->cy, chain->cx),
+				constraint->mix);
+			continue;
 		}
+		chain->l2 *= chain->psx;
+		cosines[n++] = _spIkChain_cosine(chain, chain->l2);
+	}
+	if (n == 0) return;
+	_spMath_acosArray(cosines, childAngles, n);
+	for (i = 0, lane = 0; i < count; ++i)
+		if (_spIkConstraint_isBatched2(constraints[i], chains + i)) childAngles[lane++] *= constraints[i]->bendDirection;
+	/* The cosines are still needed, the sine pass writes its cosines over the atan2 angles. */
+	_spMath_sinCosArray(childAngles, sines, angles, n);
+	for (i = 0, lane = 0; i < count; ++i) {
+		const _spIkChain* chain = chains + i;
+		float tx = chain->tx, ty = chain->ty, l2 = chain->l2, a, b;
+		if (!_spIkConstraint_isBatched2(constraints[i], chain)) continue;
+		a = chain->l1 + l2 * cosines[lane];
+		b = l2 * sines[lane];
+		y[lane] = ty * a - tx * b;
+		x[lane] = tx * a + ty * b;
+		y[n + lane] = chain->cy;
+		x[n + lane] = chain->cx;
+		++lane;
 	}
-	outer: {
-		float os = ATAN2(cy, cx) * s2;
-		a1 = (a1 - os) * RAD_DEG + o1 - parent->arotation;
-		if (a1 > 180) a1 -= 360;
-		else if (a1 < -180) a1 += 360;
-		spBone_updateWorldTransformWith(parent, px, py, parent->rotation + a1 * alpha, parent->ascaleX, parent->ascaleY, 0, 0);
-		a2 = ((a2 + os) * RAD_DEG - child->ashearX) * s2 + o2 - child->arotation;
-		if (a2 > 180) a2 -= 360;
-		else if (a2 < -180) a2 += 360;
-		spBone_updateWorldTransformWith(child, cx, cy, child->arotation + a2 * alpha, child->ascaleX, child->ascaleY, child->ashearX, child->ashearY);
+	_spMath_atan2Array(y, x, angles, n * 2);
+	for (i = 0, lane = 0; i < count; ++i) {
+		spIkConstraint* constraint = constraints[i];
+		if (!_spIkConstraint_isBatched2(constraint, chains + i)) continue;
+		_spIkChain_rotate(chains + i, constraint->bones[0], constraint->bones[1], angles[lane], childAngles[lane],
+			angles[n + lane], constraint->mix);
+		++lane;
 	}
 }
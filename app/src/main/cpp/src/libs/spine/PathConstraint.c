@@ -36,15 +36,14 @@
 #define PATHCONSTRAINT_BEFORE -2
 #define PATHCONSTRAINT_AFTER -3
 
-spPathConstraint* spPathConstraint_create (spPathConstraintData* data, const spSkeleton* skeleton) {
+void _spPathConstraint_init (spPathConstraint* self, spPathConstraintData* data, const spSkeleton* skeleton, spBone** bones) {
 	int i;
-	spPathConstraint *self = NEW(spPathConstraint);
 	CONST_CAST(spPathConstraintData*, self->data) = data;
 	self->bonesCount = data->bonesCount;
-	CONST_CAST(spBone**, self->bones) = MALLOC(spBone*, self->bonesCount);
+	CONST_CAST(spBone**, self->bones) = bones;
 	for (i = 0; i < self->bonesCount; ++i)
-		self->bones[i] = spSkeleton_findBone(skeleton, self->data->bones[i]->name);
-	self->target = spSkeleton_findSlot(skeleton, self->data->target->name);
+		self->bones[i] = skeleton->bones[self->data->bones[i]->index];
+	self->target = skeleton->slots[self->data->target->index];
 	self->position = data->position;
 	self->spacing = data->spacing;
 	self->rotateMix = data->rotateMix;
@@ -59,19 +58,145 @@ spPathConstraint* spPathConstraint_create (spPathConstraintData* data, const spS
 	self->curves = 0;
 	self->lengthsCount = 0;
 	self->lengths = 0;
+	self->segments = 0;
+	self->placement = 0;
+	self->arenaCapacity = 0;
+	self->arena = 0;
+	self->cachedPath = 0;
+	self->cachedWorld = 0;
+}
+
+void _spPathConstraint_deinit (spPathConstraint* self) {
+	FREE(self->arena);
+}
+
+spPathConstraint* spPathConstraint_create (spPathConstraintData* data, const spSkeleton* skeleton) {
+	spPathConstraint *self = NEW(spPathConstraint);
+	_spPathConstraint_init(self, data, skeleton, MALLOC(spBone*, data->bonesCount));
 	return self;
 }
 
 void spPathConstraint_dispose (spPathConstraint* self) {
 	FREE(self->bones);
-	FREE(self->spaces);
-	if (self->positions) FREE(self->positions);
-	if (self->world) FREE(self->world);
-	if (self->curves) FREE(self->curves);
-	if (self->lengths) FREE(self->lengths);
+	_spPathConstraint_deinit(self);
 	FREE(self);
 }
 
+/* World vertices and curves of the path used by spPathConstraint_computeWorldPositions. */
+static void _spPathConstraint_getPathCounts (const spPathAttachment* path, int* worldCount, int* curvesCount) {
+	int verticesLength = path->super.worldVerticesLength;
+	if (!path->constantSpeed) {
+		*worldCount = 8;
+		*curvesCount = 0;
+	} else if (path->closed) {
+		*worldCount = verticesLength + 2;
+		*curvesCount = verticesLength / 6;
+	} else {
+		*worldCount = verticesLength - 4;
+		*curvesCount = verticesLength / 6 - 1;
+	}
+}
+
+/* Carves the arrays from the arena for the counts of the bones and the path. spaces and lengths keep their values, the
+ * arc-length cache is dropped when the layout changes. */
+static void _spPathConstraint_layout (spPathConstraint* self, int spacesCount, int lengthsCount, const spPathAttachment* path) {
+	int worldCount, curvesCount, positionsCount = spacesCount * 3 + 2, size;
+	float* arena;
+	_spPathConstraint_getPathCounts(path, &worldCount, &curvesCount);
+	if (self->arena && spacesCount == self->spacesCount && lengthsCount == self->lengthsCount && worldCount == self->worldCount
+		&& curvesCount == self->curvesCount) return;
+
+	size = spacesCount + lengthsCount + positionsCount + spacesCount * 8 + worldCount * 2 + curvesCount * 11;
+	if (size > self->arenaCapacity) {
+		arena = MALLOC(float, size);
+		if (self->arena) {
+			memcpy(arena, self->arena, sizeof(float) * MIN(self->spacesCount + self->lengthsCount, spacesCount + lengthsCount));
+			FREE(self->arena);
+		}
+		self->arena = arena;
+		self->arenaCapacity = size;
+	}
+	arena = self->arena;
+	self->spaces = arena; arena += spacesCount;
+	self->lengths = lengthsCount ? arena : 0; arena += lengthsCount;
+	self->positions = arena; arena += positionsCount;
+	self->placement = arena; arena += spacesCount * 8;
+	self->world = arena; arena += worldCount;
+	self->cachedWorld = arena; arena += worldCount;
+	self->curves = arena; arena += curvesCount;
+	self->segments = arena;
+	self->spacesCount = spacesCount;
+	self->lengthsCount = lengthsCount;
+	self->positionsCount = positionsCount;
+	self->worldCount = worldCount;
+	self->curvesCount = curvesCount;
+	self->cachedPath = 0;
+}
+
+/* The bone placement of spPathConstraint_apply when no bone moves the next one, which the tip of a chain does: the
+ * translation and scale of every bone, then the atan2 and sincos of all bones over arrays. */
+static void _spPathConstraint_placeBones (spPathConstraint* self, const float* positions, int/*bool*/ tangents,
+	int/*bool*/ scale, float offsetRotation) {
+	int i, p, boneCount = self->bonesCount;
+	float rotateMix = self->rotateMix, translateMix = self->translateMix;
+	float* y = self->placement; /* 2 * boneCount atan2 inputs and angles. */
+	float* x = y + boneCount * 2;
+	float* angles = x + boneCount * 2;
+	float* sines = angles + boneCount * 2;
+	float* cosines = sines + boneCount;
+	float boneX = positions[0], boneY = positions[1];
+
+	for (i = 0, p = 3; i < boneCount; i++, p += 3) {
+		spBone* bone = self->bones[i];
+		float px = positions[p], py = positions[p + 1], dx = px - boneX, dy = py - boneY;
+		CONST_CAST(float, bone->worldX) += (boneX - bone->worldX) * translateMix;
+		CONST_CAST(float, bone->worldY) += (boneY - bone->worldY) * translateMix;
+		if (scale) {
+			float length = self->lengths[i];
+			if (length != 0) {
+				float s = (SQRT(dx * dx + dy * dy) / length - 1) * rotateMix + 1;
+				CONST_CAST(float, bone->a) *= s;
+				CONST_CAST(float, bone->c) *= s;
+			}
+		}
+		boneX = px;
+		boneY = py;
+		y[i * 2] = dy;
+		x[i * 2] = dx;
+		y[i * 2 + 1] = bone->c;
+		x[i * 2 + 1] = bone->a;
+	}
+	_spMath_atan2Array(y, x, angles, boneCount * 2);
+
+	for (i = 0, p = 3; i < boneCount; i++, p += 3) {
+		float r;
+		if (tangents)
+			r = positions[p - 1];
+		else if (self->spaces[i + 1] == 0)
+			r = positions[p + 2];
+		else
+			r = angles[i * 2];
+		r -= angles[i * 2 + 1] - offsetRotation * DEG_RAD;
+		r += offsetRotation;
+		if (r > PI)
+			r -= PI2;
+		else if (r < -PI)
+			r += PI2;
+		y[i] = r * rotateMix;
+	}
+	_spMath_sinCosArray(y, sines, cosines, boneCount);
+
+	for (i = 0; i < boneCount; i++) {
+		spBone* bone = self->bones[i];
+		float a = bone->a, b = bone->b, c = bone->c, d = bone->d, sine = sines[i], cosine = cosines[i];
+		CONST_CAST(float, bone->a) = cosine * a - sine * c;
+		CONST_CAST(float, bone->b) = cosine * b - sine * d;
+		CONST_CAST(float, bone->c) = sine * a + cosine * c;
+		CONST_CAST(float, bone->d) = sine * b + cosine * d;
+		CONST_CAST(int, bone->appliedValid) = -1;
+	}
+}
+
 void spPathConstraint_apply (spPathConstraint* self) {
 	int i, p, n;
 	float length, setupLength, x, y, dx, dy, s;
@@ -94,24 +219,13 @@ void spPathConstraint_apply (spPathConstraint* self) {
 	if (!translate && !rotate) return;
 	if ((attachment == 0) || (attachment->super.super.type != SP_ATTACHMENT_PATH)) return;
 
-	if (self->spacesCount != spacesCount) {
-		if (self->spaces) FREE(self->spaces);
-		self->spaces = MALLOC(float, spacesCount);
-		self->spacesCount = spacesCount;
-	}
+	_spPathConstraint_layout(self, spacesCount, scale ? boneCount : 0, attachment);
 	spaces = self->spaces;
 	spaces[0] = 0;
 	lengths = 0;
 	spacing = self->spacing;
 	if (scale || lengthSpacing) {
-		if (scale) {
-			if (self->lengthsCount != boneCount) {
-				if (self->lengths) FREE(self->lengths);
-				self->lengths = MALLOC(float, boneCount);
-				self->lengthsCount = boneCount;
-			}
-			lengths = self->lengths;
-		}
+		if (scale) lengths = self->lengths;
 		for (i = 0, n = spacesCount - 1; i < n;) {
 			spBone* bone = bones[i];
 			setupLength = bone->data->length;
@@ -138,6 +252,10 @@ void spPathConstraint_apply (spPathConstraint* self) {
 		pa = self->target->bone;
 		offsetRotation *= pa->a * pa->d - pa->b * pa->c > 0 ? DEG_RAD : -DEG_RAD;
 	}
+	if (rotate && !tip) {
+		_spPathConstraint_placeBones(self, positions, tangents, scale, offsetRotation);
+		return;
+	}
 	for (i = 0, p = 3; i < boneCount; i++, p += 3) {
 		spBone* bone = bones[i];
 		CONST_CAST(float, bone->worldX) += (boneX - bone->worldX) * translateMix;
@@ -163,8 +281,7 @@ void spPathConstraint_apply (spPathConstraint* self) {
 				r = ATAN2(dy, dx);
 			r -= ATAN2(c, a) - offsetRotation * DEG_RAD;
 			if (tip) {
-				cosine = COS(r);
-				sine = SIN(r);
+				_spMath_sinCos(r, &sine, &cosine);
 				length = bone->data->length;
 				boneX += (length * (cosine * a - sine * c) - dx) * rotateMix;
 				boneY += (length * (sine * a + cosine * c) - dy) * rotateMix;
@@ -175,8 +292,7 @@ void spPathConstraint_apply (spPathConstraint* self) {
 			else if (r < -PI)
 				r += PI2;
 			r *= rotateMix;
-			cosine = COS(r);
-			sine = SIN(r);
+			_spMath_sinCos(r, &sine, &cosine);
 			CONST_CAST(float, bone->a) = cosine * a - sine * c;
 			CONST_CAST(float, bone->b) = cosine * b - sine * d;
 			CONST_CAST(float, bone->c) = sine * a + cosine * c;
@@ -222,17 +338,13 @@ static void _addCurvePosition (float p, float x1, float y1, float cx1, float cy1
 
 float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAttachment* path, int spacesCount, int/*bool*/ tangents, int/*bool*/percentPosition, int/**/percentSpacing) {
 	int i, o, w, curve, segment, /*bool*/closed, verticesLength, curveCount, prevCurve;
-	float* out, *curves, *segments;
+	float* out, *curves, *segments = 0;
 	float tmpx, tmpy, dddfx, dddfy, ddfx, ddfy, dfx, dfy, pathLength, curveLength, p;
-	float x1, y1, cx1, cy1, cx2, cy2, x2, y2;
+	float x1 = 0, y1 = 0, cx1 = 0, cy1 = 0, cx2 = 0, cy2 = 0, x2 = 0, y2 = 0;
 	spSlot* target = self->target;
 	float position = self->position;
 	float* spaces = self->spaces, *world = 0;
-	if (self->positionsCount != spacesCount * 3 + 2) {
-		if (self->positions) FREE(self->positions);
-		self->positions = MALLOC(float, spacesCount * 3 + 2);
-		self->positionsCount = spacesCount * 3 + 2;
-	}
+	_spPathConstraint_layout(self, spacesCount, self->lengthsCount, path);
 	out = self->positions;
 	closed = path->closed;
 	verticesLength = path->super.worldVerticesLength, curveCount = verticesLength / 6, prevCurve = PATHCONSTRAINT_NONE;
@@ -246,11 +358,6 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 			for (i = 0; i < spacesCount; i++)
 				spaces[i] *= pathLength;
 		}
-		if (self->worldCount != 8) {
-			if (self->world) FREE(self->world);
-			self->world = MALLOC(float, 8);
-			self->worldCount = 8;
-		}
 		world = self->world;
 		for (i = 0, o = 0, curve = 0; i < spacesCount; i++, o += 3) {
 			float space = spaces[i];
@@ -306,11 +413,6 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 	/* World vertices. */
 	if (closed) {
 		verticesLength += 2;
-		if (self->worldCount != verticesLength) {
-			if (self->world) FREE(self->world);
-			self->world = MALLOC(float, verticesLength);
-			self->worldCount = verticesLength;
-		}
 		world = self->world;
 		spVertexAttachment_computeWorldVertices(SUPER(path), target, 2, verticesLength - 4, world, 0, 2);
 		spVertexAttachment_computeWorldVertices(SUPER(path), target, 0, 2, world, verticesLength - 4, 2);
@@ -319,62 +421,58 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 	} else {
 		curveCount--;
 		verticesLength -= 4;
-		if (self->worldCount != verticesLength) {
-			if (self->world) FREE(self->world);
-			self->world = MALLOC(float, verticesLength);
-			self->worldCount = verticesLength;
-		}
 		world = self->world;
 		spVertexAttachment_computeWorldVertices(SUPER(path), target, 2, verticesLength, world, 0, 2);
 	}
 
-	/* Curve lengths. */
-	if (self->curvesCount != curveCount) {
-		if (self->curves) FREE(self->curves);
-		self->curves = MALLOC(float, curveCount);
-		self->curvesCount = curveCount;
-	}
+	/* Curve lengths, kept while the world vertices are the same. */
 	curves = self->curves;
-	pathLength = 0;
-	x1 = world[0], y1 = world[1], cx1 = 0, cy1 = 0, cx2 = 0, cy2 = 0, x2 = 0, y2 = 0;
-	for (i = 0, w = 2; i < curveCount; i++, w += 6) {
-		cx1 = world[w];
-		cy1 = world[w + 1];
-		cx2 = world[w + 2];
-		cy2 = world[w + 3];
-		x2 = world[w + 4];
-		y2 = world[w + 5];
-		tmpx = (x1 - cx1 * 2 + cx2) * 0.1875f;
-		tmpy = (y1 - cy1 * 2 + cy2) * 0.1875f;
-		dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.09375f;
-		dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.09375f;
-		ddfx = tmpx * 2 + dddfx;
-		ddfy = tmpy * 2 + dddfy;
-		dfx = (cx1 - x1) * 0.75f + tmpx + dddfx * 0.16666667f;
-		dfy = (cy1 - y1) * 0.75f + tmpy + dddfy * 0.16666667f;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		dfx += ddfx;
-		dfy += ddfy;
-		ddfx += dddfx;
-		ddfy += dddfy;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		dfx += ddfx;
-		dfy += ddfy;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		dfx += ddfx + dddfx;
-		dfy += ddfy + dddfy;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		curves[i] = pathLength;
-		x1 = x2;
-		y1 = y2;
+	if (self->cachedPath != path || memcmp(world, self->cachedWorld, sizeof(float) * verticesLength) != 0) {
+		pathLength = 0;
+		x1 = world[0], y1 = world[1], cx1 = 0, cy1 = 0, cx2 = 0, cy2 = 0, x2 = 0, y2 = 0;
+		for (i = 0, w = 2; i < curveCount; i++, w += 6) {
+			cx1 = world[w];
+			cy1 = world[w + 1];
+			cx2 = world[w + 2];
+			cy2 = world[w + 3];
+			x2 = world[w + 4];
+			y2 = world[w + 5];
+			tmpx = (x1 - cx1 * 2 + cx2) * 0.1875f;
+			tmpy = (y1 - cy1 * 2 + cy2) * 0.1875f;
+			dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.09375f;
+			dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.09375f;
+			ddfx = tmpx * 2 + dddfx;
+			ddfy = tmpy * 2 + dddfy;
+			dfx = (cx1 - x1) * 0.75f + tmpx + dddfx * 0.16666667f;
+			dfy = (cy1 - y1) * 0.75f + tmpy + dddfy * 0.16666667f;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			dfx += ddfx;
+			dfy += ddfy;
+			ddfx += dddfx;
+			ddfy += dddfy;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			dfx += ddfx;
+			dfy += ddfy;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			dfx += ddfx + dddfx;
+			dfy += ddfy + dddfy;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			curves[i] = pathLength;
+			x1 = x2;
+			y1 = y2;
+		}
+		memcpy(self->cachedWorld, world, sizeof(float) * verticesLength);
+		self->cachedPath = path;
+		for (i = 0; i < curveCount; i++)
+			self->segments[i * 10] = -1;
 	}
+	pathLength = curveCount > 0 ? curves[curveCount - 1] : 0;
 	if (percentPosition) position *= pathLength;
 	if (percentSpacing) {
 		for (i = 0; i < spacesCount; i++)
 			spaces[i] *= pathLength;
 	}
 
-	segments = self->segments;
 	curveLength = 0;
 	for (i = 0, o = 0, curve = 0, segment = 0; i < spacesCount; i++, o += 3) {
 		float space = spaces[i];
@@ -406,7 +504,7 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 			break;
 		}
 
-		/* Curve segment lengths. */
+		/* Curve segment lengths, computed once per curve while the world vertices are the same. */
 		if (curve != prevCurve) {
 			int ii;
 			prevCurve = curve;
@@ -419,32 +517,36 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 			cy2 = world[ii + 5];
 			x2 = world[ii + 6];
 			y2 = world[ii + 7];
-			tmpx = (x1 - cx1 * 2 + cx2) * 0.03f;
-			tmpy = (y1 - cy1 * 2 + cy2) * 0.03f;
-			dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.006f;
-			dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.006f;
-			ddfx = tmpx * 2 + dddfx;
-			ddfy = tmpy * 2 + dddfy;
-			dfx = (cx1 - x1) * 0.3f + tmpx + dddfx * 0.16666667f;
-			dfy = (cy1 - y1) * 0.3f + tmpy + dddfy * 0.16666667f;
-			curveLength = SQRT(dfx * dfx + dfy * dfy);
-			segments[0] = curveLength;
-			for (ii = 1; ii < 8; ii++) {
+			segments = self->segments + curve * 10;
+			if (segments[0] < 0) {
+				tmpx = (x1 - cx1 * 2 + cx2) * 0.03f;
+				tmpy = (y1 - cy1 * 2 + cy2) * 0.03f;
+				dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.006f;
+				dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.006f;
+				ddfx = tmpx * 2 + dddfx;
+				ddfy = tmpy * 2 + dddfy;
+				dfx = (cx1 - x1) * 0.3f + tmpx + dddfx * 0.16666667f;
+				dfy = (cy1 - y1) * 0.3f + tmpy + dddfy * 0.16666667f;
+				curveLength = SQRT(dfx * dfx + dfy * dfy);
+				segments[0] = curveLength;
+				for (ii = 1; ii < 8; ii++) {
+					dfx += ddfx;
+					dfy += ddfy;
+					ddfx += dddfx;
+					ddfy += dddfy;
+					curveLength += SQRT(dfx * dfx + dfy * dfy);
+					segments[ii] = curveLength;
+				}
 				dfx += ddfx;
 				dfy += ddfy;
-				ddfx += dddfx;
-				ddfy += dddfy;
 				curveLength += SQRT(dfx * dfx + dfy * dfy);
-				segments[ii] = curveLength;
+				segments[8] = curveLength;
+				dfx += ddfx + dddfx;
+				dfy += ddfy + dddfy;
+				curveLength += SQRT(dfx * dfx + dfy * dfy);
+				segments[9] = curveLength;
 			}
-			dfx += ddfx;
-			dfy += ddfy;
-			curveLength += SQRT(dfx * dfx + dfy * dfy);
-			segments[8] = curveLength;
-			dfx += ddfx + dddfx;
-			dfy += ddfy + dddfy;
-			curveLength += SQRT(dfx * dfx + dfy * dfy);
-			segments[9] = curveLength;
+			curveLength = segments[9];
 			segment = 0;
 		}
 
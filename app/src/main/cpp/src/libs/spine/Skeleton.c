@@ -42,6 +42,76 @@ typedef struct {
 	void* object;
 } _spUpdate;
 
+#define SP_DIRTY_BONE 1 /* Recomputed by its own update this frame. */
+#define SP_DIRTY_CONSTRAINT 2 /* Written by a constraint this frame. */
+#define SP_DIRTY_RESET 4 /* Applied values reset from the local ones this frame. */
+
+/* Full updates run without diffing after an update that recomputed more than half of the bones, see
+ * _spBoneDirtyState_end. */
+#define SP_DIRTY_FULL_UPDATES 15
+
+/* Final pose of the last update for spSkeleton_setIncrementalUpdate, indexed by bone index. */
+typedef struct {
+	int bonesCount;
+	float* lastLocal; /* x, y, rotation, scaleX, scaleY, shearX, shearY of each bone. */
+	float* lastWorld; /* a, b, c, d, worldX, worldY of each bone. */
+	char* forced; /* Bones of path constraints, recomputed every update. */
+	char* reset; /* Bones of the update cache reset list. */
+	char* updated; /* SP_DIRTY_* flags of this update. */
+	char* worldChanged; /* Bones whose world transform differs from lastWorld, their children must be recomputed. */
+	int lastMixesCount;
+	float* lastMixes; /* Mixes of the IK and transform constraints, 4 per update cache entry. */
+	int /*boolean*/ valid; /* The next update is a full one until this is set. */
+	int /*boolean*/ full;
+	float lastX, lastY;
+	int lastFlipX, lastFlipY, lastYDown;
+	int updatedCount;
+	int fullUpdatesLeft; /* Full updates to run before diffing again, the last one invalidates the state. */
+} _spBoneDirtyState;
+
+#define SP_UPDATE_CACHE_MEMOS 8
+
+/* Update cache built for one key, see _spSkeleton_getUpdateCacheKey. */
+typedef struct {
+	void** key;
+	int updateCacheCount;
+	_spUpdate* updateCache;
+	int updateCacheResetCount;
+	spBone** updateCacheReset;
+} _spUpdateCacheMemo;
+
+/* Update cache split for spSkeleton_setThreadPool. The prefix holds the updates of the trunk bones, the unconstrained
+ * branching bones near the root that every limb reads. The other updates are split into groups that share no bone, each
+ * keeping the update cache order, so the groups can run on any thread once the prefix is done. */
+typedef struct {
+	int prefixCount;
+	int* prefix; /* Update cache indexes of the trunk bones. */
+	int groupsCount;
+	int* groupStarts; /* groupsCount + 1 offsets into entries. */
+	int* entries; /* Update cache indexes of each group. */
+} _spUpdateGraph;
+
+/* Update cache in dependency level order for spSkeleton_setBatchedConstraints. An update runs one level after the last
+ * update writing a bone it reads or writes, and after the last update reading a bone it writes, so the updates of a level
+ * are independent. Each level runs its bones and other updates first, then its IK constraints and its absolute world
+ * transform constraints as one batch each when there are two or more. Path constraints run alone in their level. */
+typedef struct {
+	int /*boolean*/ batch;
+	_spUpdateType type;
+	int start, count; /* Into updates, or into ikConstraints or transformConstraints for a batch. */
+} _spConstraintStep;
+
+typedef struct {
+	int stepsCount;
+	_spConstraintStep* steps;
+	_spUpdate* updates;
+	spIkConstraint** ikConstraints;
+	spTransformConstraint** transformConstraints;
+	int batchesCount;
+	size_t scratchSize;
+	void* scratch;
+} _spConstraintBatches;
+
 typedef struct {
 	spSkeleton super;
 
@@ -52,36 +122,721 @@ typedef struct {
 	int updateCacheResetCount;
 	int updateCacheResetCapacity;
 	spBone** updateCacheReset;
+
+	unsigned char* updateCacheBones; /* Bitset of the bones with an update in the update cache. */
+	int constraintsCount;
+	_spUpdate* constraintsByOrder; /* Constraint sorted for each order, 0 object for an unused order. */
+	int updateCacheKeyCount;
+	void** updateCacheKey;
+	int updateCacheMemosCount;
+	int updateCacheMemosNext; /* Memo replaced once all SP_UPDATE_CACHE_MEMOS are used. */
+	_spUpdateCacheMemo updateCacheMemos[SP_UPDATE_CACHE_MEMOS];
+
+
+	int /*boolean*/ incrementalUpdate;
+	_spBoneDirtyState dirtyState;
+
+	spThreadPool* threadPool;
+	_spUpdateGraph updateGraph;
+
+	int /*boolean*/ batchedConstraints;
+	_spConstraintBatches constraintBatches;
 } _spSkeleton;
 
-spSkeleton* spSkeleton_create (spSkeletonData* data) {
+static void _spBoneDirtyState_dispose (_spBoneDirtyState* self) {
+	FREE(self->lastLocal);
+	FREE(self->lastWorld);
+	FREE(self->forced);
+	FREE(self->reset);
+	FREE(self->updated);
+	FREE(self->worldChanged);
+	FREE(self->lastMixes);
+	memset(self, 0, sizeof(_spBoneDirtyState));
+}
+
+static void _spBoneDirtyState_mark (char* flags, spBone** bones, int bonesCount) {
 	int i;
-	int* childrenCounts;
+	for (i = 0; i < bonesCount; ++i)
+		flags[bones[i]->data->index] = 1;
+}
+
+/* Sizes the state for the skeleton and its update cache. The next update is a full one. */
+static void _spBoneDirtyState_build (_spBoneDirtyState* self, const spSkeleton* skeleton, int updateCacheCount,
+	spBone** updateCacheReset, int updateCacheResetCount) {
+	int i, n = skeleton->bonesCount;
+	if (n != self->bonesCount || !self->forced) {
+		_spBoneDirtyState_dispose(self);
+		self->bonesCount = n;
+		self->lastLocal = MALLOC(float, n * 7);
+		self->lastWorld = MALLOC(float, n * 6);
+		self->forced = MALLOC(char, n);
+		self->reset = MALLOC(char, n);
+		self->updated = CALLOC(char, n);
+		self->worldChanged = CALLOC(char, n);
+	}
+	if (updateCacheCount > self->lastMixesCount) {
+		FREE(self->lastMixes);
+		self->lastMixesCount = updateCacheCount;
+		self->lastMixes = MALLOC(float, updateCacheCount * 4);
+	}
+	memset(self->forced, 0, n);
+	memset(self->reset, 0, n);
+	for (i = 0; i < skeleton->pathConstraintsCount; ++i)
+		_spBoneDirtyState_mark(self->forced, skeleton->pathConstraints[i]->bones, skeleton->pathConstraints[i]->bonesCount);
+	_spBoneDirtyState_mark(self->reset, updateCacheReset, updateCacheResetCount);
+	self->valid = 0;
+	self->fullUpdatesLeft = 0;
+}
+
+static void _spBoneDirtyState_begin (_spBoneDirtyState* self, const spSkeleton* skeleton) {
+	self->full = !self->valid || skeleton->x != self->lastX || skeleton->y != self->lastY || skeleton->flipX != self->lastFlipX
+		|| skeleton->flipY != self->lastFlipY || spBone_isYDown() != self->lastYDown;
+	self->updatedCount = 0;
+}
+
+/* A bone is recomputed when its local values or its parent's world transform changed, when a constraint wrote it earlier in
+ * this update or when a path constraint uses it. */
+static int /*boolean*/ _spBoneDirtyState_needsUpdate (const _spBoneDirtyState* self, const spBone* bone) {
+	int index = bone->data->index;
+	const float* last = self->lastLocal + index * 7;
+	if (self->full || self->forced[index] || (self->updated[index] & SP_DIRTY_CONSTRAINT)) return 1;
+	if (bone->parent && self->worldChanged[bone->parent->data->index]) return 1;
+	return bone->x != last[0] || bone->y != last[1] || bone->rotation != last[2] || bone->scaleX != last[3]
+		|| bone->scaleY != last[4] || bone->shearX != last[5] || bone->shearY != last[6];
+}
+
+/* Records a bone whose world transform was just written by its own update or by a constraint. */
+static void _spBoneDirtyState_setUpdated (_spBoneDirtyState* self, const spBone* bone, int flag) {
+	int index = bone->data->index;
+	const float* last = self->lastWorld + index * 6;
+	self->updated[index] |= flag;
+	self->worldChanged[index] = self->full || bone->a != last[0] || bone->b != last[1] || bone->c != last[2]
+		|| bone->d != last[3] || bone->worldX != last[4] || bone->worldY != last[5];
+}
+
+static void _spBoneDirtyState_setLocal (_spBoneDirtyState* self, const spBone* bone) {
+	float* last = self->lastLocal + bone->data->index * 7;
+	last[0] = bone->x;
+	last[1] = bone->y;
+	last[2] = bone->rotation;
+	last[3] = bone->scaleX;
+	last[4] = bone->scaleY;
+	last[5] = bone->shearX;
+	last[6] = bone->shearY;
+	++self->updatedCount;
+}
+
+static void _spBoneDirtyState_updateBone (_spBoneDirtyState* self, spBone* bone) {
+	_spBoneDirtyState_setLocal(self, bone);
+	spBone_updateWorldTransform(bone);
+	_spBoneDirtyState_setUpdated(self, bone, SP_DIRTY_BONE);
+}
+
+/* An IK or transform constraint is skipped when its target, its mixes and its bones are unchanged: the bones still hold its
+ * result of the last update. */
+static int /*boolean*/ _spBoneDirtyState_needsConstraint (_spBoneDirtyState* self, int updateIndex, const spBone* target,
+	spBone** bones, int bonesCount, const float* mixes) {
+	int i, changed = self->full || self->worldChanged[target->data->index];
+	float* lastMixes = self->lastMixes + updateIndex * 4;
+	for (i = 0; i < 4; ++i) {
+		if (lastMixes[i] != mixes[i]) changed = 1;
+		lastMixes[i] = mixes[i];
+	}
+	for (i = 0; i < bonesCount && !changed; ++i) {
+		spBone* bone = bones[i];
+		if (self->updated[bone->data->index] & SP_DIRTY_BONE) return 1;
+		if (_spBoneDirtyState_needsUpdate(self, bone)) return 1;
+	}
+	return changed;
+}
+
+/* Brings a constrained bone to the state the full update gives it before the constraint, parents first. */
+static void _spBoneDirtyState_restore (_spBoneDirtyState* self, spBone** bones, int bonesCount, spBone* bone) {
+	int i, index = bone->data->index;
+	if (self->updated[index] & (SP_DIRTY_BONE | SP_DIRTY_RESET)) return;
+	for (i = 0; i < bonesCount; ++i)
+		if (bones[i] == bone->parent) _spBoneDirtyState_restore(self, bones, bonesCount, bone->parent);
+	if (self->reset[index]) {
+		bone->ax = bone->x;
+		bone->ay = bone->y;
+		bone->arotation = bone->rotation;
+		bone->ascaleX = bone->scaleX;
+		bone->ascaleY = bone->scaleY;
+		bone->ashearX = bone->shearX;
+		bone->ashearY = bone->shearY;
+		bone->appliedValid = 1;
+		_spBoneDirtyState_setLocal(self, bone);
+		self->updated[index] |= SP_DIRTY_RESET;
+	} else
+		_spBoneDirtyState_updateBone(self, bone);
+}
+
+static void _spBoneDirtyState_beforeConstraint (_spBoneDirtyState* self, spBone** bones, int bonesCount) {
+	int i;
+	for (i = 0; i < bonesCount; ++i)
+		_spBoneDirtyState_restore(self, bones, bonesCount, bones[i]);
+}
+
+static void _spBoneDirtyState_afterConstraint (_spBoneDirtyState* self, spBone** bones, int bonesCount) {
+	int i;
+	for (i = 0; i < bonesCount; ++i)
+		_spBoneDirtyState_setUpdated(self, bones[i], SP_DIRTY_CONSTRAINT);
+}
+
+/* Keeps the final world transform of every written bone for the next update. Diffing every bone costs about a quarter of a
+ * full update, so when more than half of the bones were recomputed the next updates are full ones without diffing. */
+static void _spBoneDirtyState_end (_spBoneDirtyState* self, const spSkeleton* skeleton) {
+	int i;
+	for (i = 0; i < skeleton->bonesCount; ++i) {
+		spBone* bone;
+		float* last;
+		if (!self->updated[i]) continue;
+		bone = skeleton->bones[i];
+		last = self->lastWorld + i * 6;
+		last[0] = bone->a;
+		last[1] = bone->b;
+		last[2] = bone->c;
+		last[3] = bone->d;
+		last[4] = bone->worldX;
+		last[5] = bone->worldY;
+		self->updated[i] = 0;
+		self->worldChanged[i] = 0;
+	}
+	self->valid = 1;
+	self->lastX = skeleton->x;
+	self->lastY = skeleton->y;
+	self->lastFlipX = skeleton->flipX;
+	self->lastFlipY = skeleton->flipY;
+	self->lastYDown = spBone_isYDown();
+	if (!self->full && self->updatedCount * 2 > self->bonesCount) self->fullUpdatesLeft = SP_DIRTY_FULL_UPDATES;
+}
+
+static void _spUpdateGraph_dispose (_spUpdateGraph* self) {
+	FREE(self->prefix);
+	FREE(self->groupStarts);
+	FREE(self->entries);
+	memset(self, 0, sizeof(_spUpdateGraph));
+}
+
+static int _spUpdateGraph_find (int* sets, int index) {
+	while (sets[index] != index) {
+		sets[index] = sets[sets[index]];
+		index = sets[index];
+	}
+	return index;
+}
+
+/* Joins the sets of two bones, trunk bones are only read once the prefix is done and join nothing. */
+static void _spUpdateGraph_union (int* sets, const char* trunk, const spBone* a, const spBone* b) {
+	int i = a->data->index, j = b->data->index;
+	if (trunk[i] || trunk[j]) return;
+	i = _spUpdateGraph_find(sets, i);
+	j = _spUpdateGraph_find(sets, j);
+	if (i != j) sets[i > j ? i : j] = i < j ? i : j;
+}
+
+static void _spUpdateGraph_unionBones (int* sets, const char* trunk, const spBone* a, spBone** bones, int bonesCount) {
+	int i;
+	for (i = 0; i < bonesCount; ++i)
+		_spUpdateGraph_union(sets, trunk, a, bones[i]);
+}
+
+/* Joins the bones a path attachment is computed from, like _sortPathConstraintAttachmentBones. */
+static void _spUpdateGraph_unionPath (int* sets, const char* trunk, spBone** bones, spAttachment* attachment, spBone* slotBone) {
+	spVertexAttachment* path = (spVertexAttachment*)attachment;
+	int i = 0, n;
+	if (!attachment || attachment->type != SP_ATTACHMENT_PATH || !path->bones) return;
+	while (i < path->bonesCount) {
+		int boneCount = path->bones[i++];
+		for (n = i + boneCount; i < n; i++)
+			_spUpdateGraph_union(sets, trunk, slotBone, bones[path->bones[i]]);
+	}
+}
+
+static void _spUpdateGraph_unionPathSkin (int* sets, const char* trunk, spBone** bones, const spSkin* skin, int slotIndex,
+	spBone* slotBone) {
+	const _Entry* entry = SUB_CAST(_spSkin, skin)->entries;
+	for (; entry; entry = entry->next)
+		if (entry->slotIndex == slotIndex) _spUpdateGraph_unionPath(sets, trunk, bones, entry->attachment, slotBone);
+}
+
+/* Marks the single child chain from bone to the first branching bone as trunk when no constrained bone is on the way. */
+static void _spUpdateGraph_markTrunk (char* trunk, const char* constrained, spBone* bone) {
+	spBone* end = bone;
+	spBone* chain;
+	int i;
+	while (end->childrenCount == 1 && !constrained[end->data->index]) end = end->children[0];
+	if (end->childrenCount < 2 || constrained[end->data->index]) return;
+	for (chain = end; chain != bone->parent; chain = chain->parent)
+		trunk[chain->data->index] = 1;
+	for (i = 0; i < end->childrenCount; ++i)
+		_spUpdateGraph_markTrunk(trunk, constrained, end->children[i]);
+}
 
-	_spSkeleton* internal = NEW(_spSkeleton);
+static spBone* _spUpdateGraph_getBone (const _spUpdate* update) {
+	switch (update->type) {
+	case SP_UPDATE_BONE:
+		return (spBone*)update->object;
+	case SP_UPDATE_IK_CONSTRAINT:
+		return ((spIkConstraint*)update->object)->bones[0];
+	case SP_UPDATE_TRANSFORM_CONSTRAINT:
+		return ((spTransformConstraint*)update->object)->bones[0];
+	default:
+		return ((spPathConstraint*)update->object)->bones[0];
+	}
+}
+
+static void _spUpdateGraph_build (_spUpdateGraph* self, const spSkeleton* skeleton, const _spUpdate* updateCache,
+	int updateCacheCount) {
+	int i, j, n = skeleton->bonesCount;
+	spBone** bones = skeleton->bones;
+	char* constrained = CALLOC(char, n);
+	char* trunk = CALLOC(char, n);
+	int* sets = MALLOC(int, n);
+	int* groups = MALLOC(int, n); /* Group of each set root, -1 before its first update. */
+	int* entryGroups = MALLOC(int, updateCacheCount);
+
+	_spUpdateGraph_dispose(self);
+	self->prefix = MALLOC(int, updateCacheCount);
+	self->entries = MALLOC(int, updateCacheCount);
+	self->groupStarts = MALLOC(int, n + 1);
+
+	for (i = 0; i < skeleton->ikConstraintsCount; ++i)
+		_spBoneDirtyState_mark(constrained, skeleton->ikConstraints[i]->bones, skeleton->ikConstraints[i]->bonesCount);
+	for (i = 0; i < skeleton->transformConstraintsCount; ++i) {
+		spTransformConstraint* constraint = skeleton->transformConstraints[i];
+		_spBoneDirtyState_mark(constrained, constraint->bones, constraint->bonesCount);
+	}
+	for (i = 0; i < skeleton->pathConstraintsCount; ++i)
+		_spBoneDirtyState_mark(constrained, skeleton->pathConstraints[i]->bones, skeleton->pathConstraints[i]->bonesCount);
+	if (skeleton->root) _spUpdateGraph_markTrunk(trunk, constrained, skeleton->root);
+
+	for (i = 0; i < n; ++i) {
+		sets[i] = i;
+		groups[i] = -1;
+	}
+	for (i = 0; i < n; ++i)
+		if (bones[i]->parent) _spUpdateGraph_union(sets, trunk, bones[i], bones[i]->parent);
+	for (i = 0; i < skeleton->ikConstraintsCount; ++i) {
+		spIkConstraint* constraint = skeleton->ikConstraints[i];
+		_spUpdateGraph_unionBones(sets, trunk, constraint->target, constraint->bones, constraint->bonesCount);
+	}
+	for (i = 0; i < skeleton->transformConstraintsCount; ++i) {
+		spTransformConstraint* constraint = skeleton->transformConstraints[i];
+		_spUpdateGraph_unionBones(sets, trunk, constraint->target, constraint->bones, constraint->bonesCount);
+	}
+	for (i = 0; i < skeleton->pathConstraintsCount; ++i) {
+		spPathConstraint* constraint = skeleton->pathConstraints[i];
+		spSlot* slot = constraint->target;
+		spBone* slotBone = slot->bone;
+		_spUpdateGraph_unionBones(sets, trunk, slotBone, constraint->bones, constraint->bonesCount);
+		/* The attachment of the slot may change without an update cache rebuild, join the path attachments of every skin. */
+		if (skeleton->skin) _spUpdateGraph_unionPathSkin(sets, trunk, bones, skeleton->skin, slot->data->index, slotBone);
+		if (skeleton->data->defaultSkin)
+			_spUpdateGraph_unionPathSkin(sets, trunk, bones, skeleton->data->defaultSkin, slot->data->index, slotBone);
+		for (j = 0; j < skeleton->data->skinsCount; ++j)
+			_spUpdateGraph_unionPathSkin(sets, trunk, bones, skeleton->data->skins[j], slot->data->index, slotBone);
+		_spUpdateGraph_unionPath(sets, trunk, bones, slot->attachment, slotBone);
+	}
+
+	/* Groups are numbered by their first update, then filled in update cache order. */
+	for (i = 0; i < updateCacheCount; ++i) {
+		const _spUpdate* update = updateCache + i;
+		spBone* bone = _spUpdateGraph_getBone(update);
+		int set;
+		if (update->type == SP_UPDATE_BONE && trunk[bone->data->index]) {
+			self->prefix[self->prefixCount++] = i;
+			entryGroups[i] = -1;
+			continue;
+		}
+		set = _spUpdateGraph_find(sets, bone->data->index);
+		if (groups[set] == -1) groups[set] = self->groupsCount++;
+		entryGroups[i] = groups[set];
+	}
+	memset(self->groupStarts, 0, sizeof(int) * (self->groupsCount + 1));
+	for (i = 0; i < updateCacheCount; ++i)
+		if (entryGroups[i] != -1) ++self->groupStarts[entryGroups[i] + 1];
+	for (i = 0; i < self->groupsCount; ++i)
+		self->groupStarts[i + 1] += self->groupStarts[i];
+	memcpy(groups, self->groupStarts, sizeof(int) * self->groupsCount);
+	for (i = 0; i < updateCacheCount; ++i)
+		if (entryGroups[i] != -1) self->entries[groups[entryGroups[i]]++] = i;
+
+	FREE(entryGroups);
+	FREE(groups);
+	FREE(sets);
+	FREE(trunk);
+	FREE(constrained);
+}
+
+static void _spConstraintBatches_dispose (_spConstraintBatches* self) {
+	FREE(self->steps);
+	FREE(self->updates);
+	FREE(self->ikConstraints);
+	FREE(self->transformConstraints);
+	FREE(self->scratch);
+	memset(self, 0, sizeof(_spConstraintBatches));
+}
+
+/* Raises level past the last write of bone and, for a write, past its last read. */
+static int _spConstraintBatches_after (const int* lastWrite, const int* lastRead, const spBone* bone, int write, int level) {
+	int index = bone->data->index;
+	if (lastWrite[index] >= level) level = lastWrite[index] + 1;
+	if (write && lastRead[index] >= level) level = lastRead[index] + 1;
+	return level;
+}
+
+static void _spConstraintBatches_record (int* lastWrite, int* lastRead, const spBone* bone, int write, int level) {
+	int index = bone->data->index;
+	if (write)
+		lastWrite[index] = level;
+	else if (lastRead[index] < level)
+		lastRead[index] = level;
+}
+
+/* First level of an update from level on, or records level as the last access of its bones when record is set. */
+static int _spConstraintBatches_visit (int* lastWrite, int* lastRead, const _spUpdate* update, int level, int record) {
+	int i;
+	switch (update->type) {
+	case SP_UPDATE_BONE: {
+		spBone* bone = (spBone*)update->object;
+		if (record) {
+			if (bone->parent) _spConstraintBatches_record(lastWrite, lastRead, bone->parent, 0, level);
+			_spConstraintBatches_record(lastWrite, lastRead, bone, 1, level);
+			break;
+		}
+		if (bone->parent) level = _spConstraintBatches_after(lastWrite, lastRead, bone->parent, 0, level);
+		level = _spConstraintBatches_after(lastWrite, lastRead, bone, 1, level);
+		break;
+	}
+	case SP_UPDATE_IK_CONSTRAINT: {
+		spIkConstraint* constraint = (spIkConstraint*)update->object;
+		spBone* parent = constraint->bones[0]->parent;
+		if (record) {
+			_spConstraintBatches_record(lastWrite, lastRead, constraint->target, 0, level);
+			if (parent) _spConstraintBatches_record(lastWrite, lastRead, parent, 0, level);
+			for (i = 0; i < constraint->bonesCount; ++i)
+				_spConstraintBatches_record(lastWrite, lastRead, constraint->bones[i], 1, level);
+			break;
+		}
+		level = _spConstraintBatches_after(lastWrite, lastRead, constraint->target, 0, level);
+		if (parent) level = _spConstraintBatches_after(lastWrite, lastRead, parent, 0, level);
+		for (i = 0; i < constraint->bonesCount; ++i)
+			level = _spConstraintBatches_after(lastWrite, lastRead, constraint->bones[i], 1, level);
+		break;
+	}
+	case SP_UPDATE_TRANSFORM_CONSTRAINT: {
+		/* Local modes update the applied values of the target. */
+		spTransformConstraint* constraint = (spTransformConstraint*)update->object;
+		int writeTarget = constraint->data->local;
+		if (record) {
+			_spConstraintBatches_record(lastWrite, lastRead, constraint->target, writeTarget, level);
+			for (i = 0; i < constraint->bonesCount; ++i)
+				if (constraint->bones[i]->parent)
+					_spConstraintBatches_record(lastWrite, lastRead, constraint->bones[i]->parent, 0, level);
+			for (i = 0; i < constraint->bonesCount; ++i)
+				_spConstraintBatches_record(lastWrite, lastRead, constraint->bones[i], 1, level);
+			break;
+		}
+		level = _spConstraintBatches_after(lastWrite, lastRead, constraint->target, writeTarget, level);
+		for (i = 0; i < constraint->bonesCount; ++i) {
+			spBone* bone = constraint->bones[i];
+			if (bone->parent) level = _spConstraintBatches_after(lastWrite, lastRead, bone->parent, 0, level);
+			level = _spConstraintBatches_after(lastWrite, lastRead, bone, 1, level);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	return level;
+}
+
+static int /*boolean*/ _spConstraintBatches_isBatchable (const _spUpdate* update) {
+	return update->type == SP_UPDATE_IK_CONSTRAINT || (update->type == SP_UPDATE_TRANSFORM_CONSTRAINT
+		&& !((spTransformConstraint*)update->object)->data->local && !((spTransformConstraint*)update->object)->data->relative);
+}
+
+/* Appends one update, joining the previous step when it runs single updates too. */
+static void _spConstraintBatches_addUpdate (_spConstraintBatches* self, const _spUpdate* update, int* updatesCount) {
+	_spConstraintStep* step = self->stepsCount ? self->steps + self->stepsCount - 1 : 0;
+	if (!step || step->batch) {
+		step = self->steps + self->stepsCount++;
+		step->batch = 0;
+		step->type = update->type;
+		step->start = *updatesCount;
+		step->count = 0;
+	}
+	self->updates[(*updatesCount)++] = *update;
+	++step->count;
+}
+
+/* Adds the batchable updates of type at positions [start, end) of order as one batch, a lone one as a single update. */
+static void _spConstraintBatches_addBatch (_spConstraintBatches* self, const _spUpdate* updateCache, const int* order,
+	int start, int end, _spUpdateType type, int* updatesCount, int* batchedCount) {
+	_spConstraintStep* step;
+	const _spUpdate* last = 0;
+	int i, count = 0, bonesCount = 0;
+	size_t scratchSize;
+	for (i = start; i < end; ++i) {
+		const _spUpdate* update = updateCache + order[i];
+		if (update->type != type || !_spConstraintBatches_isBatchable(update)) continue;
+		last = update;
+		++count;
+	}
+	if (count < 2) {
+		if (last) _spConstraintBatches_addUpdate(self, last, updatesCount);
+		return;
+	}
+	step = self->steps + self->stepsCount++;
+	step->batch = 1;
+	step->type = type;
+	step->start = *batchedCount;
+	step->count = count;
+	for (i = start; i < end; ++i) {
+		const _spUpdate* update = updateCache + order[i];
+		if (update->type != type || !_spConstraintBatches_isBatchable(update)) continue;
+		if (type == SP_UPDATE_IK_CONSTRAINT)
+			self->ikConstraints[*batchedCount] = (spIkConstraint*)update->object;
+		else {
+			self->transformConstraints[*batchedCount] = (spTransformConstraint*)update->object;
+			bonesCount += self->transformConstraints[*batchedCount]->bonesCount;
+		}
+		++*batchedCount;
+	}
+	++self->batchesCount;
+	scratchSize = type == SP_UPDATE_IK_CONSTRAINT ? _spIkConstraint_getBatchScratchSize(count)
+		: _spTransformConstraint_getBatchScratchSize(bonesCount);
+	if (scratchSize > self->scratchSize) self->scratchSize = scratchSize;
+}
+
+static void _spConstraintBatches_build (_spConstraintBatches* self, const spSkeleton* skeleton, const _spUpdate* updateCache,
+	int updateCacheCount) {
+	int i, level, barrier = 0, maxLevel = 0, updatesCount = 0, batchedCount = 0;
+	int* lastWrite = CALLOC(int, skeleton->bonesCount);
+	int* lastRead = CALLOC(int, skeleton->bonesCount);
+	int* levels = MALLOC(int, updateCacheCount);
+	int* levelStarts = CALLOC(int, updateCacheCount + 2);
+	int* order = MALLOC(int, updateCacheCount);
+
+	_spConstraintBatches_dispose(self);
+	self->steps = MALLOC(_spConstraintStep, updateCacheCount);
+	self->updates = MALLOC(_spUpdate, updateCacheCount);
+	self->ikConstraints = MALLOC(spIkConstraint*, updateCacheCount);
+	self->transformConstraints = MALLOC(spTransformConstraint*, updateCacheCount);
+
+	for (i = 0; i < updateCacheCount; ++i) {
+		const _spUpdate* update = updateCache + i;
+		if (update->type == SP_UPDATE_PATH_CONSTRAINT) {
+			/* The bones of the path attachment are not tracked, the path constraint waits for every update before it and
+			 * every update after it waits for it. */
+			level = barrier = maxLevel + 1;
+		} else {
+			level = _spConstraintBatches_visit(lastWrite, lastRead, update, barrier + 1, 0);
+			_spConstraintBatches_visit(lastWrite, lastRead, update, level, 1);
+		}
+		levels[i] = level;
+		if (level > maxLevel) maxLevel = level;
+		++levelStarts[level + 1];
+	}
+	for (level = 1; level <= maxLevel; ++level)
+		levelStarts[level + 1] += levelStarts[level];
+	for (i = 0; i < updateCacheCount; ++i)
+		order[levelStarts[levels[i]]++] = i;
+
+	for (level = 1, i = 0; level <= maxLevel; ++level) {
+		int start = i, end = levelStarts[level];
+		for (i = start; i < end; ++i)
+			if (!_spConstraintBatches_isBatchable(updateCache + order[i]))
+				_spConstraintBatches_addUpdate(self, updateCache + order[i], &updatesCount);
+		_spConstraintBatches_addBatch(self, updateCache, order, start, end, SP_UPDATE_IK_CONSTRAINT, &updatesCount,
+			&batchedCount);
+		_spConstraintBatches_addBatch(self, updateCache, order, start, end, SP_UPDATE_TRANSFORM_CONSTRAINT, &updatesCount,
+			&batchedCount);
+		i = end;
+	}
+	if (self->scratchSize) self->scratch = MALLOC(char, self->scratchSize);
+
+	FREE(order);
+	FREE(levelStarts);
+	FREE(levels);
+	FREE(lastRead);
+	FREE(lastWrite);
+}
+
+#define BITSET_SIZE(COUNT) (((COUNT) + 7) >> 3)
+#define BITSET_GET(BITS, INDEX) ((BITS)[(INDEX) >> 3] & (1 << ((INDEX) & 7)))
+#define BITSET_SET(BITS, INDEX) ((BITS)[(INDEX) >> 3] |= (unsigned char)(1 << ((INDEX) & 7)))
+
+/* The first constraint of each order wins, IK before transform before path like the scan it replaces. Orders outside
+ * [0, constraintsCount) are never sorted. */
+static void _spSkeleton_buildConstraintsByOrder (_spSkeleton* internal) {
+	int i;
 	spSkeleton* self = SUPER(internal);
+	internal->constraintsCount = self->ikConstraintsCount + self->transformConstraintsCount + self->pathConstraintsCount;
+	for (i = self->pathConstraintsCount - 1; i >= 0; --i) {
+		int order = self->pathConstraints[i]->data->order;
+		if (order < 0 || order >= internal->constraintsCount) continue;
+		internal->constraintsByOrder[order].type = SP_UPDATE_PATH_CONSTRAINT;
+		internal->constraintsByOrder[order].object = self->pathConstraints[i];
+	}
+	for (i = self->transformConstraintsCount - 1; i >= 0; --i) {
+		int order = self->transformConstraints[i]->data->order;
+		if (order < 0 || order >= internal->constraintsCount) continue;
+		internal->constraintsByOrder[order].type = SP_UPDATE_TRANSFORM_CONSTRAINT;
+		internal->constraintsByOrder[order].object = self->transformConstraints[i];
+	}
+	for (i = self->ikConstraintsCount - 1; i >= 0; --i) {
+		int order = self->ikConstraints[i]->data->order;
+		if (order < 0 || order >= internal->constraintsCount) continue;
+		internal->constraintsByOrder[order].type = SP_UPDATE_IK_CONSTRAINT;
+		internal->constraintsByOrder[order].object = self->ikConstraints[i];
+	}
+}
+
+/* Everything the update cache depends on besides the fixed bones: the target and bones of each constraint, which can be
+ * changed, then with path constraints what path attachments are looked up through. Adding an attachment to a skin replaces
+ * the head of its entries, so the memo of the old entries is not used. */
+static int _addConstraintToKey (void** key, int n, void* target, spBone** bones, int bonesCount) {
+	key[n++] = target;
+	memcpy(key + n, bones, sizeof(spBone*) * bonesCount);
+	return n + bonesCount;
+}
+
+static void _spSkeleton_getUpdateCacheKey (_spSkeleton* internal) {
+	int i, n = 0;
+	spSkeleton* self = SUPER(internal);
+	void** key = internal->updateCacheKey;
+	for (i = 0; i < self->ikConstraintsCount; ++i)
+		n = _addConstraintToKey(key, n, self->ikConstraints[i]->target, self->ikConstraints[i]->bones, self->ikConstraints[i]->bonesCount);
+	for (i = 0; i < self->transformConstraintsCount; ++i)
+		n = _addConstraintToKey(key, n, self->transformConstraints[i]->target, self->transformConstraints[i]->bones, self->transformConstraints[i]->bonesCount);
+	for (i = 0; i < self->pathConstraintsCount; ++i)
+		n = _addConstraintToKey(key, n, self->pathConstraints[i]->target, self->pathConstraints[i]->bones, self->pathConstraints[i]->bonesCount);
+	if (!self->pathConstraintsCount) return;
+	key[n++] = self->skin;
+	key[n++] = self->skin ? SUB_CAST(_spSkin, self->skin)->entries : 0;
+	key[n++] = self->data->defaultSkin ? SUB_CAST(_spSkin, self->data->defaultSkin)->entries : 0;
+	for (i = 0; i < self->data->skinsCount; ++i)
+		key[n++] = SUB_CAST(_spSkin, self->data->skins[i])->entries;
+	for (i = 0; i < self->pathConstraintsCount; ++i)
+		key[n++] = self->pathConstraints[i]->target->attachment;
+}
+
+static void _spUpdateCacheMemo_dispose (_spUpdateCacheMemo* self) {
+	FREE(self->key);
+	FREE(self->updateCache);
+	FREE(self->updateCacheReset);
+	memset(self, 0, sizeof(_spUpdateCacheMemo));
+}
+
+static _spUpdateCacheMemo* _spSkeleton_findUpdateCacheMemo (_spSkeleton* internal) {
+	int i;
+	for (i = 0; i < internal->updateCacheMemosCount; ++i) {
+		_spUpdateCacheMemo* memo = internal->updateCacheMemos + i;
+		if (!memcmp(memo->key, internal->updateCacheKey, sizeof(void*) * internal->updateCacheKeyCount)) return memo;
+	}
+	return 0;
+}
+
+static void _spSkeleton_addUpdateCacheMemo (_spSkeleton* internal) {
+	_spUpdateCacheMemo* memo;
+	if (internal->updateCacheMemosCount < SP_UPDATE_CACHE_MEMOS)
+		memo = internal->updateCacheMemos + internal->updateCacheMemosCount++;
+	else {
+		memo = internal->updateCacheMemos + internal->updateCacheMemosNext;
+		internal->updateCacheMemosNext = (internal->updateCacheMemosNext + 1) % SP_UPDATE_CACHE_MEMOS;
+		_spUpdateCacheMemo_dispose(memo);
+	}
+	memo->key = MALLOC(void*, internal->updateCacheKeyCount + 1);
+	memcpy(memo->key, internal->updateCacheKey, sizeof(void*) * internal->updateCacheKeyCount);
+	memo->updateCacheCount = internal->updateCacheCount;
+	memo->updateCache = MALLOC(_spUpdate, internal->updateCacheCount + 1);
+	memcpy(memo->updateCache, internal->updateCache, sizeof(_spUpdate) * internal->updateCacheCount);
+	memo->updateCacheResetCount = internal->updateCacheResetCount;
+	memo->updateCacheReset = MALLOC(spBone*, internal->updateCacheResetCount + 1);
+	memcpy(memo->updateCacheReset, internal->updateCacheReset, sizeof(spBone*) * internal->updateCacheResetCount);
+}
+
+/* Reserves bytes at the end of the block, 16 byte aligned. */
+static size_t _spSkeleton_reserve (size_t* blockSize, size_t bytes) {
+	size_t offset = *blockSize;
+	*blockSize += (bytes + 15) & ~(size_t)15;
+	return offset;
+}
+
+#define BLOCK_AT(TYPE, OFFSET) ((TYPE*)(block + (OFFSET)))
+
+/* Everything is carved out of one zeroed block: the skeleton, then the bone, slot and constraint structs read every update
+ * next to each other in bone and slot order (the setup draw order), then the pointer arrays and the rarely used rest. Only
+ * the update cache, which can grow, and what the objects allocate later live outside of it. */
+spSkeleton* spSkeleton_create (spSkeletonData* data) {
+	int i, childrenCount = 0, constrainedCount = 0, darkColorsCount = 0, constraintsCount, keyCount;
+	size_t blockSize = 0;
+	size_t bonesOffset, slotsOffset, ikOffset, transformOffset, pathOffset;
+	size_t boneArrayOffset, slotArrayOffset, drawOrderOffset, ikArrayOffset, transformArrayOffset, pathArrayOffset;
+	size_t childrenOffset, constrainedOffset, darkColorsOffset, bitsetOffset, orderOffset, keyOffset;
+	char* block;
+	spBone** children;
+	spBone** constrained;
+	spColor* darkColors;
+	_spSkeleton* internal;
+	spSkeleton* self;
+
+	for (i = 0; i < data->bonesCount; ++i)
+		if (data->bones[i]->parent) ++childrenCount;
+	for (i = 0; i < data->slotsCount; ++i)
+		if (data->slots[i]->darkColor) ++darkColorsCount;
+	for (i = 0; i < data->ikConstraintsCount; ++i)
+		constrainedCount += data->ikConstraints[i]->bonesCount;
+	for (i = 0; i < data->transformConstraintsCount; ++i)
+		constrainedCount += data->transformConstraints[i]->bonesCount;
+	for (i = 0; i < data->pathConstraintsCount; ++i)
+		constrainedCount += data->pathConstraints[i]->bonesCount;
+	constraintsCount = data->ikConstraintsCount + data->transformConstraintsCount + data->pathConstraintsCount;
+
+	_spSkeleton_reserve(&blockSize, sizeof(_spSkeleton));
+	bonesOffset = _spSkeleton_reserve(&blockSize, sizeof(spBone) * data->bonesCount);
+	slotsOffset = _spSkeleton_reserve(&blockSize, sizeof(_spSlot) * data->slotsCount);
+	ikOffset = _spSkeleton_reserve(&blockSize, sizeof(spIkConstraint) * data->ikConstraintsCount);
+	transformOffset = _spSkeleton_reserve(&blockSize, sizeof(spTransformConstraint) * data->transformConstraintsCount);
+	pathOffset = _spSkeleton_reserve(&blockSize, sizeof(spPathConstraint) * data->pathConstraintsCount);
+	boneArrayOffset = _spSkeleton_reserve(&blockSize, sizeof(spBone*) * data->bonesCount);
+	slotArrayOffset = _spSkeleton_reserve(&blockSize, sizeof(spSlot*) * data->slotsCount);
+	drawOrderOffset = _spSkeleton_reserve(&blockSize, sizeof(spSlot*) * data->slotsCount);
+	ikArrayOffset = _spSkeleton_reserve(&blockSize, sizeof(spIkConstraint*) * data->ikConstraintsCount);
+	transformArrayOffset = _spSkeleton_reserve(&blockSize, sizeof(spTransformConstraint*) * data->transformConstraintsCount);
+	pathArrayOffset = _spSkeleton_reserve(&blockSize, sizeof(spPathConstraint*) * data->pathConstraintsCount);
+	childrenOffset = _spSkeleton_reserve(&blockSize, sizeof(spBone*) * childrenCount);
+	constrainedOffset = _spSkeleton_reserve(&blockSize, sizeof(spBone*) * constrainedCount);
+	darkColorsOffset = _spSkeleton_reserve(&blockSize, sizeof(spColor) * darkColorsCount);
+	bitsetOffset = _spSkeleton_reserve(&blockSize, BITSET_SIZE(data->bonesCount));
+	orderOffset = _spSkeleton_reserve(&blockSize, sizeof(_spUpdate) * constraintsCount);
+	keyCount = constraintsCount + constrainedCount;
+	if (data->pathConstraintsCount) keyCount += 3 + data->skinsCount + data->pathConstraintsCount;
+	keyOffset = _spSkeleton_reserve(&blockSize, sizeof(void*) * keyCount);
+
+	block = CALLOC(char, blockSize);
+	internal = BLOCK_AT(_spSkeleton, 0);
+	self = SUPER(internal);
 	CONST_CAST(spSkeletonData*, self->data) = data;
 
 	self->bonesCount = self->data->bonesCount;
-	self->bones = MALLOC(spBone*, self->bonesCount);
-	childrenCounts = CALLOC(int, self->bonesCount);
-
+	self->bones = BLOCK_AT(spBone*, boneArrayOffset);
 	for (i = 0; i < self->bonesCount; ++i) {
 		spBoneData* boneData = self->data->bones[i];
-		spBone* newBone;
-		if (!boneData->parent)
-			newBone = spBone_create(boneData, self, 0);
-		else {
-			spBone* parent = self->bones[boneData->parent->index];
-			newBone = spBone_create(boneData, self, parent);
-			++childrenCounts[boneData->parent->index];
-		}
-		self->bones[i] = newBone;
+		spBone* bone = BLOCK_AT(spBone, bonesOffset) + i;
+		spBone* parent = boneData->parent ? self->bones[boneData->parent->index] : 0;
+		_spBone_init(bone, boneData, self, parent);
+		if (parent) ++parent->childrenCount;
+		self->bones[i] = bone;
 	}
+	children = BLOCK_AT(spBone*, childrenOffset);
 	for (i = 0; i < self->bonesCount; ++i) {
-		spBoneData* boneData = self->data->bones[i];
 		spBone* bone = self->bones[i];
-		CONST_CAST(spBone**, bone->children) = MALLOC(spBone*, childrenCounts[boneData->index]);
+		CONST_CAST(spBone**, bone->children) = children;
+		children += bone->childrenCount;
+		bone->childrenCount = 0;
 	}
 	for (i = 0; i < self->bonesCount; ++i) {
 		spBone* bone = self->bones[i];
@@ -92,36 +847,57 @@ spSkeleton* spSkeleton_create (spSkeletonData* data) {
 	CONST_CAST(spBone*, self->root) = (self->bonesCount > 0 ? self->bones[0] : NULL);
 
 	self->slotsCount = data->slotsCount;
-	self->slots = MALLOC(spSlot*, self->slotsCount);
+	self->slots = BLOCK_AT(spSlot*, slotArrayOffset);
+	darkColors = BLOCK_AT(spColor, darkColorsOffset);
 	for (i = 0; i < self->slotsCount; ++i) {
 		spSlotData *slotData = data->slots[i];
+		_spSlot* internalSlot = BLOCK_AT(_spSlot, slotsOffset) + i;
+		spSlot* slot = SUPER(internalSlot);
 		spBone* bone = self->bones[slotData->boneData->index];
-		self->slots[i] = spSlot_create(slotData, bone);
+		_spSlot_init(slot, slotData, bone, slotData->darkColor ? darkColors++ : 0);
+		self->slots[i] = slot;
 	}
 
-	self->drawOrder = MALLOC(spSlot*, self->slotsCount);
+	self->drawOrder = BLOCK_AT(spSlot*, drawOrderOffset);
 	memcpy(self->drawOrder, self->slots, sizeof(spSlot*) * self->slotsCount);
 
+	constrained = BLOCK_AT(spBone*, constrainedOffset);
 	self->ikConstraintsCount = data->ikConstraintsCount;
-	self->ikConstraints = MALLOC(spIkConstraint*, self->ikConstraintsCount);
-	for (i = 0; i < self->data->ikConstraintsCount; ++i)
-		self->ikConstraints[i] = spIkConstraint_create(self->data->ikConstraints[i], self);
+	self->ikConstraints = BLOCK_AT(spIkConstraint*, ikArrayOffset);
+	for (i = 0; i < self->data->ikConstraintsCount; ++i) {
+		spIkConstraint* constraint = BLOCK_AT(spIkConstraint, ikOffset) + i;
+		_spIkConstraint_init(constraint, self->data->ikConstraints[i], self, constrained);
+		constrained += constraint->bonesCount;
+		self->ikConstraints[i] = constraint;
+	}
 
 	self->transformConstraintsCount = data->transformConstraintsCount;
-	self->transformConstraints = MALLOC(spTransformConstraint*, self->transformConstraintsCount);
-	for (i = 0; i < self->data->transformConstraintsCount; ++i)
-		self->transformConstraints[i] = spTransformConstraint_create(self->data->transformConstraints[i], self);
+	self->transformConstraints = BLOCK_AT(spTransformConstraint*, transformArrayOffset);
+	for (i = 0; i < self->data->transformConstraintsCount; ++i) {
+		spTransformConstraint* constraint = BLOCK_AT(spTransformConstraint, transformOffset) + i;
+		_spTransformConstraint_init(constraint, self->data->transformConstraints[i], self, constrained);
+		constrained += constraint->bonesCount;
+		self->transformConstraints[i] = constraint;
+	}
 
 	self->pathConstraintsCount = data->pathConstraintsCount;
-	self->pathConstraints = MALLOC(spPathConstraint*, self->pathConstraintsCount);
-	for (i = 0; i < self->data->pathConstraintsCount; i++)
-		self->pathConstraints[i] = spPathConstraint_create(self->data->pathConstraints[i], self);
+	self->pathConstraints = BLOCK_AT(spPathConstraint*, pathArrayOffset);
+	for (i = 0; i < self->data->pathConstraintsCount; i++) {
+		spPathConstraint* constraint = BLOCK_AT(spPathConstraint, pathOffset) + i;
+		_spPathConstraint_init(constraint, self->data->pathConstraints[i], self, constrained);
+		constrained += constraint->bonesCount;
+		self->pathConstraints[i] = constraint;
+	}
 
 	spColor_setFromFloats(&self->color, 1, 1, 1, 1);
 
-	spSkeleton_updateCache(self);
+	internal->updateCacheBones = BLOCK_AT(unsigned char, bitsetOffset);
+	internal->constraintsByOrder = BLOCK_AT(_spUpdate, orderOffset);
+	_spSkeleton_buildConstraintsByOrder(internal);
+	internal->updateCacheKeyCount = keyCount;
+	internal->updateCacheKey = BLOCK_AT(void*, keyOffset);
 
-	FREE(childrenCounts);
+	spSkeleton_updateCache(self);
 
 	return self;
 }
@@ -132,29 +908,19 @@ void spSkeleton_dispose (spSkeleton* self) {
 
 	FREE(internal->updateCache);
 	FREE(internal->updateCacheReset);
-
-	for (i = 0; i < self->bonesCount; ++i)
-		spBone_dispose(self->bones[i]);
-	FREE(self->bones);
+	for (i = 0; i < internal->updateCacheMemosCount; ++i)
+		_spUpdateCacheMemo_dispose(internal->updateCacheMemos + i);
+	_spBoneDirtyState_dispose(&internal->dirtyState);
+	_spUpdateGraph_dispose(&internal->updateGraph);
+	_spConstraintBatches_dispose(&internal->constraintBatches);
 
 	for (i = 0; i < self->slotsCount; ++i)
-		spSlot_dispose(self->slots[i]);
-	FREE(self->slots);
-
-	for (i = 0; i < self->ikConstraintsCount; ++i)
-		spIkConstraint_dispose(self->ikConstraints[i]);
-	FREE(self->ikConstraints);
-
-	for (i = 0; i < self->transformConstraintsCount; ++i)
-		spTransformConstraint_dispose(self->transformConstraints[i]);
-	FREE(self->transformConstraints);
-
+		_spSlot_deinit(self->slots[i]);
 	for (i = 0; i < self->pathConstraintsCount; i++)
-		spPathConstraint_dispose(self->pathConstraints[i]);
-	FREE(self->pathConstraints);
+		_spPathConstraint_deinit(self->pathConstraints[i]);
 
-	FREE(self->drawOrder);
-	FREE(self);
+	/* The skeleton is the start of the block. */
+	FREE(internal);
 }
 
 static void _addToUpdateCache(_spSkeleton* const internal, _spUpdateType type, void *object) {
@@ -164,6 +930,7 @@ static void _addToUpdateCache(_spSkeleton* const internal, _spUpdateType type, v
 		internal->updateCache = (_spUpdate*)realloc(internal->updateCache, sizeof(_spUpdate) * internal->updateCacheCapacity);
 	}
 	update = internal->updateCache + internal->updateCacheCount;
+	if (type == SP_UPDATE_BONE) BITSET_SET(internal->updateCacheBones, ((spBone*)object)->data->index);
 	update->type = type;
 	update->object = object;
 	++internal->updateCacheCount;
@@ -223,8 +990,6 @@ static void _sortReset(spBone** bones, int bonesCount) {
 }
 
 static void _sortIkConstraint (_spSkeleton* const internal, spIkConstraint* constraint) {
-	int /*bool*/ contains = 0;
-	int i;
 	spBone* target = constraint->target;
 	spBone** constrained;
 	spBone* parent;
@@ -236,15 +1001,7 @@ static void _sortIkConstraint (_spSkeleton* const internal, spIkConstraint* cons
 
 	if (constraint->bonesCount > 1) {
 		spBone* child = constrained[constraint->bonesCount - 1];
-		contains = 0;
-		for (i = 0; i < internal->updateCacheCount; i++) {
-			_spUpdate update = internal->updateCache[i];
-			if (update.object == child) {
-				contains = -1;
-				break;
-			}
-		}
-		if (!contains)
+		if (!BITSET_GET(internal->updateCacheBones, child->data->index))
 			_addToUpdateCacheReset(internal, child);
 	}
 
@@ -288,7 +1045,6 @@ static void _sortTransformConstraint(_spSkeleton* const internal, spTransformCon
 	int i, boneCount;
 	spBone** constrained;
 	spBone* child;
-	int /*boolean*/ contains = 0;
 	_sortBone(internal, constraint->target);
 
 	constrained = constraint->bones;
@@ -297,15 +1053,7 @@ static void _sortTransformConstraint(_spSkeleton* const internal, spTransformCon
 		for (i = 0; i < boneCount; i++) {
 			child = constrained[i];
 			_sortBone(internal, child);
-			contains = 0;
-			for (i = 0; i < internal->updateCacheCount; i++) {
-				_spUpdate update = internal->updateCache[i];
-				if (update.object == child) {
-					contains = -1;
-					break;
-				}
-			}
-			if (!contains) _addToUpdateCacheReset(internal, child);
+			if (!BITSET_GET(internal->updateCacheBones, child->data->index)) _addToUpdateCacheReset(internal, child);
 		}
 	} else {
 		for (i = 0; i < boneCount; i++)
@@ -321,74 +1069,259 @@ static void _sortTransformConstraint(_spSkeleton* const internal, spTransformCon
 }
 
 void spSkeleton_updateCache (spSkeleton* self) {
-	int i, ii;
+	int i;
 	spBone** bones;
-	spIkConstraint** ikConstraints;
-	spPathConstraint** pathConstraints;
-	spTransformConstraint** transformConstraints;
-	int ikCount, transformCount, pathCount, constraintCount;
+	_spUpdateCacheMemo* memo;
 	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
 
 	internal->updateCacheCapacity = self->bonesCount + self->ikConstraintsCount + self->transformConstraintsCount + self->pathConstraintsCount;
+	internal->updateCacheResetCapacity = self->bonesCount;
+
+	_spSkeleton_getUpdateCacheKey(internal);
+	memo = _spSkeleton_findUpdateCacheMemo(internal);
+	if (memo) {
+		if (memo->updateCacheCount > internal->updateCacheCapacity) internal->updateCacheCapacity = memo->updateCacheCount;
+		if (memo->updateCacheResetCount > internal->updateCacheResetCapacity)
+			internal->updateCacheResetCapacity = memo->updateCacheResetCount;
+	}
+
 	FREE(internal->updateCache);
 	internal->updateCache = MALLOC(_spUpdate, internal->updateCacheCapacity);
-	internal->updateCacheCount = 0;
-
-	internal->updateCacheResetCapacity = self->bonesCount;
 	FREE(internal->updateCacheReset);
 	internal->updateCacheReset = MALLOC(spBone*, internal->updateCacheResetCapacity);
-	internal->updateCacheResetCount = 0;
 
-	bones = self->bones;
-	for (i = 0; i < self->bonesCount; ++i)
-		bones[i]->sorted = 0;
-
-	/* IK first, lowest hierarchy depth first. */
-	ikConstraints = self->ikConstraints;
-	transformConstraints = self->transformConstraints;
-	pathConstraints = self->pathConstraints;
-	ikCount = self->ikConstraintsCount; transformCount = self->transformConstraintsCount; pathCount = self->pathConstraintsCount;
-	constraintCount = ikCount + transformCount + pathCount;
-
-	i = 0;
-	outer:
-	for (; i < constraintCount; i++) {
-		for (ii = 0; ii < ikCount; ii++) {
-			spIkConstraint* ikConstraint = ikConstraints[ii];
-			if (ikConstraint->data->order == i) {
-				_sortIkConstraint(internal, ikConstraint);
-				i++;
-				goto outer;
+	if (memo) {
+		internal->updateCacheCount = memo->updateCacheCount;
+		memcpy(internal->updateCache, memo->updateCache, sizeof(_spUpdate) * memo->updateCacheCount);
+		internal->updateCacheResetCount = memo->updateCacheResetCount;
+		memcpy(internal->updateCacheReset, memo->updateCacheReset, sizeof(spBone*) * memo->updateCacheResetCount);
+	} else {
+		internal->updateCacheCount = 0;
+		internal->updateCacheResetCount = 0;
+		memset(internal->updateCacheBones, 0, BITSET_SIZE(self->bonesCount));
+
+		bones = self->bones;
+		for (i = 0; i < self->bonesCount; ++i)
+			bones[i]->sorted = 0;
+
+		/* IK first, lowest hierarchy depth first. */
+		for (i = 0; i < internal->constraintsCount; i++) {
+			_spUpdate* constraint = internal->constraintsByOrder + i;
+			if (!constraint->object) continue;
+			switch (constraint->type) {
+			case SP_UPDATE_IK_CONSTRAINT:
+				_sortIkConstraint(internal, (spIkConstraint*)constraint->object);
+				break;
+			case SP_UPDATE_TRANSFORM_CONSTRAINT:
+				_sortTransformConstraint(internal, (spTransformConstraint*)constraint->object);
+				break;
+			case SP_UPDATE_PATH_CONSTRAINT:
+				_sortPathConstraint(internal, (spPathConstraint*)constraint->object);
+				break;
+			default:
+				break;
 			}
 		}
 
-		for (ii = 0; ii < transformCount; ii++) {
-			spTransformConstraint* transformConstraint = transformConstraints[ii];
-			if (transformConstraint->data->order == i) {
-				_sortTransformConstraint(internal, transformConstraint);
-				i++;
-				goto outer;
-			}
-		}
+		for (i = 0; i < self->bonesCount; ++i)
+			_sortBone(internal, self->bones[i]);
+		_spSkeleton_addUpdateCacheMemo(internal);
+	}
 
-		for (ii = 0; ii < pathCount; ii++) {
-			spPathConstraint* pathConstraint = pathConstraints[ii];
-			if (pathConstraint->data->order == i) {
-				_sortPathConstraint(internal, pathConstraint);
-				i++;
-				goto outer;
-			}
+	if (internal->incrementalUpdate)
+		_spBoneDirtyState_build(&internal->dirtyState, self, internal->updateCacheCount, internal->updateCacheReset,
+			internal->updateCacheResetCount);
+	if (internal->threadPool) _spUpdateGraph_build(&internal->updateGraph, self, internal->updateCache, internal->updateCacheCount);
+	if (internal->batchedConstraints)
+		_spConstraintBatches_build(&internal->constraintBatches, self, internal->updateCache, internal->updateCacheCount);
+}
+
+/* Incremental update, a thread pool and batched constraints each replace the serial update, at most one of them is set. */
+int/*bool*/ spSkeleton_setIncrementalUpdate (spSkeleton* self, int/*bool*/ enabled) {
+	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	if (enabled && (internal->threadPool || internal->batchedConstraints)) return 0;
+	internal->incrementalUpdate = enabled;
+	if (enabled)
+		_spBoneDirtyState_build(&internal->dirtyState, self, internal->updateCacheCount, internal->updateCacheReset,
+			internal->updateCacheResetCount);
+	else
+		_spBoneDirtyState_dispose(&internal->dirtyState);
+	return 1;
+}
+
+void _spSkeleton_invalidateIncrementalUpdate (spSkeleton* self) {
+	SUB_CAST(_spSkeleton, self)->dirtyState.valid = 0;
+}
+
+int/*bool*/ spSkeleton_hasIncrementalUpdate (const spSkeleton* self) {
+	return SUB_CAST(_spSkeleton, self)->incrementalUpdate;
+}
+
+int spSkeleton_getUpdatedBonesCount (const spSkeleton* self) {
+	const _spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	return internal->incrementalUpdate ? internal->dirtyState.updatedCount : 0;
+}
+
+int/*bool*/ spSkeleton_setThreadPool (spSkeleton* self, spThreadPool* threadPool) {
+	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	if (threadPool && (internal->incrementalUpdate || internal->batchedConstraints)) return 0;
+	internal->threadPool = threadPool;
+	if (threadPool)
+		_spUpdateGraph_build(&internal->updateGraph, self, internal->updateCache, internal->updateCacheCount);
+	else
+		_spUpdateGraph_dispose(&internal->updateGraph);
+	return 1;
+}
+
+spThreadPool* spSkeleton_getThreadPool (const spSkeleton* self) {
+	return SUB_CAST(_spSkeleton, self)->threadPool;
+}
+
+int spSkeleton_getUpdateGroupsCount (const spSkeleton* self) {
+	const _spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	return internal->threadPool ? internal->updateGraph.groupsCount : 0;
+}
+
+int/*bool*/ spSkeleton_setBatchedConstraints (spSkeleton* self, int/*bool*/ enabled) {
+	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	if (enabled && (internal->incrementalUpdate || internal->threadPool)) return 0;
+	internal->batchedConstraints = enabled;
+	if (enabled)
+		_spConstraintBatches_build(&internal->constraintBatches, self, internal->updateCache, internal->updateCacheCount);
+	else
+		_spConstraintBatches_dispose(&internal->constraintBatches);
+	return 1;
+}
+
+int/*bool*/ spSkeleton_hasBatchedConstraints (const spSkeleton* self) {
+	return SUB_CAST(_spSkeleton, self)->batchedConstraints;
+}
+
+int spSkeleton_getConstraintBatchesCount (const spSkeleton* self) {
+	const _spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	return internal->batchedConstraints ? internal->constraintBatches.batchesCount : 0;
+}
+
+static void _spSkeleton_runUpdate (const _spUpdate* update) {
+	switch (update->type) {
+	case SP_UPDATE_BONE:
+		spBone_updateWorldTransform((spBone*)update->object);
+		break;
+	case SP_UPDATE_IK_CONSTRAINT:
+		spIkConstraint_apply((spIkConstraint*)update->object);
+		break;
+	case SP_UPDATE_TRANSFORM_CONSTRAINT:
+		spTransformConstraint_apply((spTransformConstraint*)update->object);
+		break;
+	case SP_UPDATE_PATH_CONSTRAINT:
+		spPathConstraint_apply((spPathConstraint*)update->object);
+		break;
+	}
+}
+
+static void _spSkeleton_runUpdateGroup (void* context, int index) {
+	const _spSkeleton* internal = (const _spSkeleton*)context;
+	const _spUpdateGraph* graph = &internal->updateGraph;
+	int i;
+	for (i = graph->groupStarts[index]; i < graph->groupStarts[index + 1]; ++i)
+		_spSkeleton_runUpdate(internal->updateCache + graph->entries[i]);
+}
+
+/* spSkeleton_updateWorldTransform with the update graph, each update sees the same bones as in the serial order. */
+static void _spSkeleton_updateWorldTransformParallel (_spSkeleton* internal) {
+	_spUpdateGraph* graph = &internal->updateGraph;
+	int i;
+	for (i = 0; i < graph->prefixCount; ++i)
+		spBone_updateWorldTransform((spBone*)internal->updateCache[graph->prefix[i]].object);
+	spThreadPool_run(internal->threadPool, graph->groupsCount, _spSkeleton_runUpdateGroup, internal);
+}
+
+static void _spSkeleton_updateWorldTransformBatched (_spSkeleton* internal) {
+	_spConstraintBatches* batches = &internal->constraintBatches;
+	int i, j;
+	for (i = 0; i < batches->stepsCount; ++i) {
+		const _spConstraintStep* step = batches->steps + i;
+		if (!step->batch) {
+			for (j = step->start; j < step->start + step->count; ++j)
+				_spSkeleton_runUpdate(batches->updates + j);
+		} else if (step->type == SP_UPDATE_IK_CONSTRAINT)
+			_spIkConstraint_applyBatch(batches->ikConstraints + step->start, step->count, batches->scratch);
+		else
+			_spTransformConstraint_applyBatch(batches->transformConstraints + step->start, step->count, batches->scratch);
+	}
+}
+
+/* spSkeleton_updateWorldTransform with a dirty state, see _spBoneDirtyState_needsUpdate and
+ * _spBoneDirtyState_needsConstraint. The reset of applied values is done by the constraints that run. */
+static void _spSkeleton_updateWorldTransformIncremental (_spSkeleton* internal) {
+	int i;
+	spSkeleton* self = SUPER(internal);
+	_spBoneDirtyState* dirtyState = &internal->dirtyState;
+	_spBoneDirtyState_begin(dirtyState, self);
+
+	for (i = 0; i < internal->updateCacheCount; ++i) {
+		_spUpdate* update = internal->updateCache + i;
+		switch (update->type) {
+		case SP_UPDATE_BONE: {
+			spBone* bone = (spBone*)update->object;
+			if (_spBoneDirtyState_needsUpdate(dirtyState, bone)) _spBoneDirtyState_updateBone(dirtyState, bone);
+			break;
+		}
+		case SP_UPDATE_IK_CONSTRAINT: {
+			spIkConstraint* constraint = (spIkConstraint*)update->object;
+			float mixes[4];
+			mixes[0] = constraint->mix;
+			mixes[1] = (float)constraint->bendDirection;
+			mixes[2] = mixes[3] = 0;
+			if (!_spBoneDirtyState_needsConstraint(dirtyState, i, constraint->target, constraint->bones, constraint->bonesCount,
+				mixes)) break;
+			_spBoneDirtyState_beforeConstraint(dirtyState, constraint->bones, constraint->bonesCount);
+			spIkConstraint_apply(constraint);
+			_spBoneDirtyState_afterConstraint(dirtyState, constraint->bones, constraint->bonesCount);
+			break;
+		}
+		case SP_UPDATE_TRANSFORM_CONSTRAINT: {
+			spTransformConstraint* constraint = (spTransformConstraint*)update->object;
+			float mixes[4];
+			mixes[0] = constraint->rotateMix;
+			mixes[1] = constraint->translateMix;
+			mixes[2] = constraint->scaleMix;
+			mixes[3] = constraint->shearMix;
+			if (!_spBoneDirtyState_needsConstraint(dirtyState, i, constraint->target, constraint->bones, constraint->bonesCount,
+				mixes)) break;
+			_spBoneDirtyState_beforeConstraint(dirtyState, constraint->bones, constraint->bonesCount);
+			spTransformConstraint_apply(constraint);
+			_spBoneDirtyState_afterConstraint(dirtyState, constraint->bones, constraint->bonesCount);
+			break;
+		}
+		case SP_UPDATE_PATH_CONSTRAINT: {
+			/* Path constraints also depend on the path attachment and its bones, they always run. */
+			spPathConstraint* constraint = (spPathConstraint*)update->object;
+			_spBoneDirtyState_beforeConstraint(dirtyState, constraint->bones, constraint->bonesCount);
+			spPathConstraint_apply(constraint);
+			_spBoneDirtyState_afterConstraint(dirtyState, constraint->bones, constraint->bonesCount);
+			break;
+		}
 		}
 	}
 
-	for (i = 0; i < self->bonesCount; ++i)
-		_sortBone(internal, self->bones[i]);
+	_spBoneDirtyState_end(dirtyState, self);
 }
 
 void spSkeleton_updateWorldTransform (const spSkeleton* self) {
 	int i;
 	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
 	spBone** updateCacheReset = internal->updateCacheReset;
+	if (internal->incrementalUpdate) {
+		_spBoneDirtyState* dirtyState = &internal->dirtyState;
+		if (!dirtyState->fullUpdatesLeft) {
+			_spSkeleton_updateWorldTransformIncremental(internal);
+			return;
+		}
+		/* The next incremental update is a full one keeping the pose to diff against. */
+		if (!--dirtyState->fullUpdatesLeft) dirtyState->valid = 0;
+		dirtyState->updatedCount = self->bonesCount;
+	}
 	for (i = 0; i < internal->updateCacheResetCount; i++) {
 		spBone* bone = updateCacheReset[i];
 		CONST_CAST(float, bone->ax) = bone->x;
@@ -401,23 +1334,17 @@ void spSkeleton_updateWorldTransform (const spSkeleton* self) {
 		CONST_CAST(int, bone->appliedValid) = 1;
 	}
 
-	for (i = 0; i < internal->updateCacheCount; ++i) {
-		_spUpdate* update = internal->updateCache + i;
-		switch (update->type) {
-		case SP_UPDATE_BONE:
-			spBone_updateWorldTransform((spBone*)update->object);
-			break;
-		case SP_UPDATE_IK_CONSTRAINT:
-			spIkConstraint_apply((spIkConstraint*)update->object);
-			break;
-		case SP_UPDATE_TRANSFORM_CONSTRAINT:
-			spTransformConstraint_apply((spTransformConstraint*)update->object);
-			break;
-		case SP_UPDATE_PATH_CONSTRAINT:
-			spPathConstraint_apply((spPathConstraint*)update->object);
-			break;
-		}
+	if (internal->threadPool && internal->updateGraph.groupsCount > 1) {
+		_spSkeleton_updateWorldTransformParallel(internal);
+		return;
+	}
+	if (internal->batchedConstraints) {
+		_spSkeleton_updateWorldTransformBatched(internal);
+		return;
 	}
+
+	for (i = 0; i < internal->updateCacheCount; ++i)
+		_spSkeleton_runUpdate(internal->updateCache + i);
 }
 
 void spSkeleton_setToSetupPose (const spSkeleton* self) {
@@ -463,31 +1390,23 @@ void spSkeleton_setSlotsToSetupPose (const spSkeleton* self) {
 }
 
 spBone* spSkeleton_findBone (const spSkeleton* self, const char* boneName) {
-	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->data->bones[i]->name, boneName) == 0) return self->bones[i];
-	return 0;
+	int i = spSkeleton_findBoneIndex(self, boneName);
+	return i == -1 ? 0 : self->bones[i];
 }
 
 int spSkeleton_findBoneIndex (const spSkeleton* self, const char* boneName) {
-	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->data->bones[i]->name, boneName) == 0) return i;
-	return -1;
+	int i = spSkeletonData_findBoneIndex(self->data, boneName);
+	return i < self->bonesCount ? i : -1;
 }
 
 spSlot* spSkeleton_findSlot (const spSkeleton* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->data->slots[i]->name, slotName) == 0) return self->slots[i];
-	return 0;
+	int i = spSkeleton_findSlotIndex(self, slotName);
+	return i == -1 ? 0 : self->slots[i];
 }
 
 int spSkeleton_findSlotIndex (const spSkeleton* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->data->slots[i]->name, slotName) == 0) return i;
-	return -1;
+	int i = spSkeletonData_findSlotIndex(self->data, slotName);
+	return i < self->slotsCount ? i : -1;
 }
 
 int spSkeleton_setSkinByName (spSkeleton* self, const char* skinName) {
@@ -540,42 +1459,31 @@ spAttachment* spSkeleton_getAttachmentForSlotIndex (const spSkeleton* self, int
 }
 
 int spSkeleton_setAttachment (spSkeleton* self, const char* slotName, const char* attachmentName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i) {
-		spSlot *slot = self->slots[i];
-		if (strcmp(slot->data->name, slotName) == 0) {
-			if (!attachmentName)
-				spSlot_setAttachment(slot, 0);
-			else {
-				spAttachment* attachment = spSkeleton_getAttachmentForSlotIndex(self, i, attachmentName);
-				if (!attachment) return 0;
-				spSlot_setAttachment(slot, attachment);
-			}
-			return 1;
-		}
+	int i = spSkeleton_findSlotIndex(self, slotName);
+	if (i == -1) return 0;
+	if (!attachmentName)
+		spSlot_setAttachment(self->slots[i], 0);
+	else {
+		spAttachment* attachment = spSkeleton_getAttachmentForSlotIndex(self, i, attachmentName);
+		if (!attachment) return 0;
+		spSlot_setAttachment(self->slots[i], attachment);
 	}
-	return 0;
+	return 1;
 }
 
 spIkConstraint* spSkeleton_findIkConstraint (const spSkeleton* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->ikConstraintsCount; ++i)
-		if (strcmp(self->ikConstraints[i]->data->name, constraintName) == 0) return self->ikConstraints[i];
-	return 0;
+	int i = _spSkeletonData_findIkConstraintIndex(self->data, constraintName);
+	return i == -1 || i >= self->ikConstraintsCount ? 0 : self->ikConstraints[i];
 }
 
 spTransformConstraint* spSkeleton_findTransformConstraint (const spSkeleton* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->transformConstraintsCount; ++i)
-		if (strcmp(self->transformConstraints[i]->data->name, constraintName) == 0) return self->transformConstraints[i];
-	return 0;
+	int i = _spSkeletonData_findTransformConstraintIndex(self->data, constraintName);
+	return i == -1 || i >= self->transformConstraintsCount ? 0 : self->transformConstraints[i];
 }
 
 spPathConstraint* spSkeleton_findPathConstraint (const spSkeleton* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->pathConstraintsCount; ++i)
-		if (strcmp(self->pathConstraints[i]->data->name, constraintName) == 0) return self->pathConstraints[i];
-	return 0;
+	int i = _spSkeletonData_findPathConstraintIndex(self->data, constraintName);
+	return i == -1 || i >= self->pathConstraintsCount ? 0 : self->pathConstraints[i];
 }
 
 void spSkeleton_update (spSkeleton* self, float deltaTime) {
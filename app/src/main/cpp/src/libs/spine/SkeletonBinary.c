@@ -603,6 +603,7 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 	animation->duration = duration;
 	animation->timelinesCount = kv_size(timelines);
 	animation->timelines = kv_array(timelines);
+	if (self->compactKeyframes) spAnimation_compactKeyframes(animation);
 	return animation;
 }
 
@@ -1091,5 +1092,6 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	}
 
 	FREE(input);
+	_spSkeletonData_indexNames(skeletonData);
 	return skeletonData;
 }
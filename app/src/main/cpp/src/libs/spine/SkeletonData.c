@@ -32,11 +32,93 @@
 #include <string.h>
 #include <spine/extension.h>
 
+typedef struct {
+	spSkeletonData super;
+	_spNameTable bones;
+	_spNameTable slots;
+	_spNameTable skins;
+	_spNameTable events;
+	_spNameTable animations;
+	_spNameTable ikConstraints;
+	_spNameTable transformConstraints;
+	_spNameTable pathConstraints;
+} _spSkeletonData;
+
+typedef const char* (*_spSkeletonData_getName) (const spSkeletonData* self, int index);
+
+static const char* _spSkeletonData_getBoneName (const spSkeletonData* self, int index) {
+	return self->bones[index]->name;
+}
+
+static const char* _spSkeletonData_getSlotName (const spSkeletonData* self, int index) {
+	return self->slots[index]->name;
+}
+
+static const char* _spSkeletonData_getSkinName (const spSkeletonData* self, int index) {
+	return self->skins[index]->name;
+}
+
+static const char* _spSkeletonData_getEventName (const spSkeletonData* self, int index) {
+	return self->events[index]->name;
+}
+
+static const char* _spSkeletonData_getAnimationName (const spSkeletonData* self, int index) {
+	return self->animations[index]->name;
+}
+
+static const char* _spSkeletonData_getIkConstraintName (const spSkeletonData* self, int index) {
+	return self->ikConstraints[index]->name;
+}
+
+static const char* _spSkeletonData_getTransformConstraintName (const spSkeletonData* self, int index) {
+	return self->transformConstraints[index]->name;
+}
+
+static const char* _spSkeletonData_getPathConstraintName (const spSkeletonData* self, int index) {
+	return self->pathConstraints[index]->name;
+}
+
+/* Hashes the items appended since the last call. An array that shrank is hashed again from the start. */
+static void _spSkeletonData_indexArray (const spSkeletonData* self, _spNameTable* names, int count, _spSkeletonData_getName getName) {
+	int i;
+	if (names->count > count) _spNameTable_clear(names);
+	for (i = names->count; i < count; ++i)
+		_spNameTable_add(names, _spNameTable_hash(getName(self, i)), i);
+}
+
+/* Returns the first index with the name, like a scan of the array, or -1. */
+static int _spSkeletonData_findIndex (const spSkeletonData* self, _spNameTable* names, int count, _spSkeletonData_getName getName,
+	const char* name) {
+	unsigned int hash;
+	int i, cursor = -1;
+	if (names->count != count) _spSkeletonData_indexArray(self, names, count, getName);
+	hash = _spNameTable_hash(name);
+	while ((i = _spNameTable_next(names, hash, &cursor)) != -1)
+		if (strcmp(getName(self, i), name) == 0) return i;
+	return -1;
+}
+
+void _spSkeletonData_indexNames (spSkeletonData* self) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	_spSkeletonData_indexArray(self, &internal->bones, self->bonesCount, _spSkeletonData_getBoneName);
+	_spSkeletonData_indexArray(self, &internal->slots, self->slotsCount, _spSkeletonData_getSlotName);
+	_spSkeletonData_indexArray(self, &internal->skins, self->skinsCount, _spSkeletonData_getSkinName);
+	_spSkeletonData_indexArray(self, &internal->events, self->eventsCount, _spSkeletonData_getEventName);
+	_spSkeletonData_indexArray(self, &internal->animations, self->animationsCount, _spSkeletonData_getAnimationName);
+	_spSkeletonData_indexArray(self, &internal->ikConstraints, self->ikConstraintsCount, _spSkeletonData_getIkConstraintName);
+	_spSkeletonData_indexArray(self, &internal->transformConstraints, self->transformConstraintsCount,
+		_spSkeletonData_getTransformConstraintName);
+	_spSkeletonData_indexArray(self, &internal->pathConstraints, self->pathConstraintsCount, _spSkeletonData_getPathConstraintName);
+}
+
+/**/
+
 spSkeletonData* spSkeletonData_create () {
-	return NEW(spSkeletonData);
+	return SUPER(NEW(_spSkeletonData));
 }
 
 void spSkeletonData_dispose (spSkeletonData* self) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
 	int i;
 	for (i = 0; i < self->bonesCount; ++i)
 		spBoneData_dispose(self->bones[i]);
@@ -73,75 +155,86 @@ void spSkeletonData_dispose (spSkeletonData* self) {
 	FREE(self->hash);
 	FREE(self->version);
 
+	_spNameTable_deinit(&internal->bones);
+	_spNameTable_deinit(&internal->slots);
+	_spNameTable_deinit(&internal->skins);
+	_spNameTable_deinit(&internal->events);
+	_spNameTable_deinit(&internal->animations);
+	_spNameTable_deinit(&internal->ikConstraints);
+	_spNameTable_deinit(&internal->transformConstraints);
+	_spNameTable_deinit(&internal->pathConstraints);
+
 	FREE(self);
 }
 
 spBoneData* spSkeletonData_findBone (const spSkeletonData* self, const char* boneName) {
-	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->bones[i]->name, boneName) == 0) return self->bones[i];
-	return 0;
+	int i = spSkeletonData_findBoneIndex(self, boneName);
+	return i == -1 ? 0 : self->bones[i];
 }
 
 int spSkeletonData_findBoneIndex (const spSkeletonData* self, const char* boneName) {
-	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->bones[i]->name, boneName) == 0) return i;
-	return -1;
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	return _spSkeletonData_findIndex(self, &internal->bones, self->bonesCount, _spSkeletonData_getBoneName, boneName);
 }
 
 spSlotData* spSkeletonData_findSlot (const spSkeletonData* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->slots[i]->name, slotName) == 0) return self->slots[i];
-	return 0;
+	int i = spSkeletonData_findSlotIndex(self, slotName);
+	return i == -1 ? 0 : self->slots[i];
 }
 
 int spSkeletonData_findSlotIndex (const spSkeletonData* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->slots[i]->name, slotName) == 0) return i;
-	return -1;
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	return _spSkeletonData_findIndex(self, &internal->slots, self->slotsCount, _spSkeletonData_getSlotName, slotName);
 }
 
 spSkin* spSkeletonData_findSkin (const spSkeletonData* self, const char* skinName) {
-	int i;
-	for (i = 0; i < self->skinsCount; ++i)
-		if (strcmp(self->skins[i]->name, skinName) == 0) return self->skins[i];
-	return 0;
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	int i = _spSkeletonData_findIndex(self, &internal->skins, self->skinsCount, _spSkeletonData_getSkinName, skinName);
+	return i == -1 ? 0 : self->skins[i];
 }
 
 spEventData* spSkeletonData_findEvent (const spSkeletonData* self, const char* eventName) {
-	int i;
-	for (i = 0; i < self->eventsCount; ++i)
-		if (strcmp(self->events[i]->name, eventName) == 0) return self->events[i];
-	return 0;
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	int i = _spSkeletonData_findIndex(self, &internal->events, self->eventsCount, _spSkeletonData_getEventName, eventName);
+	return i == -1 ? 0 : self->events[i];
 }
 
 spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const char* animationName) {
-	int i;
-	for (i = 0; i < self->animationsCount; ++i)
-		if (strcmp(self->animations[i]->name, animationName) == 0) return self->animations[i];
-	return 0;
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	int i = _spSkeletonData_findIndex(self, &internal->animations, self->animationsCount,
+		_spSkeletonData_getAnimationName, animationName);
+	return i == -1 ? 0 : self->animations[i];
+}
+
+int _spSkeletonData_findIkConstraintIndex (const spSkeletonData* self, const char* constraintName) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	return _spSkeletonData_findIndex(self, &internal->ikConstraints, self->ikConstraintsCount,
+		_spSkeletonData_getIkConstraintName, constraintName);
 }
 
 spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->ikConstraintsCount; ++i)
-		if (strcmp(self->ikConstraints[i]->name, constraintName) == 0) return self->ikConstraints[i];
-	return 0;
+	int i = _spSkeletonData_findIkConstraintIndex(self, constraintName);
+	return i == -1 ? 0 : self->ikConstraints[i];
+}
+
+int _spSkeletonData_findTransformConstraintIndex (const spSkeletonData* self, const char* constraintName) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	return _spSkeletonData_findIndex(self, &internal->transformConstraints, self->transformConstraintsCount,
+		_spSkeletonData_getTransformConstraintName, constraintName);
 }
 
 spTransformConstraintData* spSkeletonData_findTransformConstraint (const spSkeletonData* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->transformConstraintsCount; ++i)
-		if (strcmp(self->transformConstraints[i]->name, constraintName) == 0) return self->transformConstraints[i];
-	return 0;
+	int i = _spSkeletonData_findTransformConstraintIndex(self, constraintName);
+	return i == -1 ? 0 : self->transformConstraints[i];
+}
+
+int _spSkeletonData_findPathConstraintIndex (const spSkeletonData* self, const char* constraintName) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	return _spSkeletonData_findIndex(self, &internal->pathConstraints, self->pathConstraintsCount,
+		_spSkeletonData_getPathConstraintName, constraintName);
 }
 
 spPathConstraintData* spSkeletonData_findPathConstraint (const spSkeletonData* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->pathConstraintsCount; ++i)
-		if (strcmp(self->pathConstraints[i]->name, constraintName) == 0) return self->pathConstraints[i];
-	return 0;
+	int i = _spSkeletonData_findPathConstraintIndex(self, constraintName);
+	return i == -1 ? 0 : self->pathConstraints[i];
 }
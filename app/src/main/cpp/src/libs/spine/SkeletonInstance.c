@@ -0,0 +1,301 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonInstance.h>
+#include <spine/extension.h>
+#include <string.h>
+
+#define BONE_FLOATS 13 /* x, y, rotation, scaleX, scaleY, shearX, shearY, a, b, c, d, worldX, worldY */
+#define CONSTRAINT_FLOATS 4
+
+typedef struct {
+	int count, capacity;
+	float* vertices;
+} _spInstanceDeform;
+
+typedef struct {
+	spSkeletonTemplate super;
+	spSkeletonInstance* loaded;
+} _spSkeletonTemplate;
+
+struct spSkeletonInstance {
+	spSkeletonTemplate* skeletonTemplate;
+	spSkin* skin;
+	spColor color;
+	float time;
+	int flipX, flipY;
+	float x, y;
+
+	float* bones; /* BONE_FLOATS per bone. */
+	float* constraints; /* CONSTRAINT_FLOATS per IK, transform and path constraint, in that order. */
+	spColor* slotColors;
+	spColor* slotDarkColors; /* 0 when no slot has a dark color. */
+	spAttachment** attachments;
+	float* attachmentTimes;
+	int* drawOrder; /* Slot indexes. */
+	_spInstanceDeform* deforms;
+	int byteCount;
+};
+
+spSkeletonTemplate* spSkeletonTemplate_create (spSkeletonData* data) {
+	_spSkeletonTemplate* internal = NEW(_spSkeletonTemplate);
+	spSkeletonTemplate* self = SUPER(internal);
+	CONST_CAST(spSkeletonData*, self->data) = data;
+	CONST_CAST(spSkeleton*, self->skeleton) = spSkeleton_create(data);
+	return self;
+}
+
+void spSkeletonTemplate_dispose (spSkeletonTemplate* self) {
+	spSkeleton_dispose(self->skeleton);
+	FREE(self);
+}
+
+static int _spSkeletonInstance_hasDarkColors (const spSkeletonData* data) {
+	int i;
+	for (i = 0; i < data->slotsCount; ++i)
+		if (data->slots[i]->darkColor) return 1;
+	return 0;
+}
+
+spSkeletonInstance* spSkeletonInstance_create (spSkeletonTemplate* skeletonTemplate) {
+	spSkeletonInstance* self;
+	const spSkeleton* skeleton = skeletonTemplate->skeleton;
+	int constraintsCount = skeleton->ikConstraintsCount + skeleton->transformConstraintsCount + skeleton->pathConstraintsCount;
+	int slotsCount = skeleton->slotsCount;
+	int darkColors = _spSkeletonInstance_hasDarkColors(skeleton->data);
+	/* Largest alignment first so every array stays aligned. */
+	int byteCount = sizeof(spSkeletonInstance)
+		+ sizeof(spAttachment*) * slotsCount
+		+ sizeof(_spInstanceDeform) * slotsCount
+		+ sizeof(float) * (BONE_FLOATS * skeleton->bonesCount + CONSTRAINT_FLOATS * constraintsCount)
+		+ sizeof(spColor) * slotsCount * (darkColors ? 2 : 1)
+		+ sizeof(float) * slotsCount
+		+ sizeof(int) * slotsCount;
+	char* block = CALLOC(char, byteCount);
+
+	self = (spSkeletonInstance*)block;
+	block += sizeof(spSkeletonInstance);
+	self->skeletonTemplate = skeletonTemplate;
+	self->attachments = (spAttachment**)block;
+	block += sizeof(spAttachment*) * slotsCount;
+	self->deforms = (_spInstanceDeform*)block;
+	block += sizeof(_spInstanceDeform) * slotsCount;
+	self->bones = (float*)block;
+	block += sizeof(float) * BONE_FLOATS * skeleton->bonesCount;
+	self->constraints = (float*)block;
+	block += sizeof(float) * CONSTRAINT_FLOATS * constraintsCount;
+	self->slotColors = (spColor*)block;
+	block += sizeof(spColor) * slotsCount;
+	if (darkColors) {
+		self->slotDarkColors = (spColor*)block;
+		block += sizeof(spColor) * slotsCount;
+	}
+	self->attachmentTimes = (float*)block;
+	block += sizeof(float) * slotsCount;
+	self->drawOrder = (int*)block;
+	self->byteCount = byteCount;
+
+	/* The setup pose, like a new skeleton. */
+	spColor_setFromFloats(&self->color, 1, 1, 1, 1);
+	spSkeletonInstance_load(self);
+	spSkeleton_setToSetupPose(skeleton);
+	spSkeleton_updateWorldTransform(skeleton);
+	spSkeletonInstance_store(self);
+	return self;
+}
+
+void spSkeletonInstance_dispose (spSkeletonInstance* self) {
+	int i;
+	_spSkeletonTemplate* internal = SUB_CAST(_spSkeletonTemplate, self->skeletonTemplate);
+	if (internal->loaded == self) internal->loaded = 0;
+	for (i = 0; i < self->skeletonTemplate->skeleton->slotsCount; ++i)
+		FREE(self->deforms[i].vertices);
+	FREE(self);
+}
+
+spSkeletonTemplate* spSkeletonInstance_getTemplate (const spSkeletonInstance* self) {
+	return self->skeletonTemplate;
+}
+
+static void _spSkeletonInstance_copyVertices (float** vertices, int* capacity, const float* from, int count) {
+	if (*capacity < count) {
+		FREE(*vertices);
+		*vertices = MALLOC(float, count);
+		*capacity = count;
+	}
+	memcpy(*vertices, from, sizeof(float) * count);
+}
+
+spSkeleton* spSkeletonInstance_load (spSkeletonInstance* self) {
+	int i;
+	const float* values;
+	_spSkeletonTemplate* internal = SUB_CAST(_spSkeletonTemplate, self->skeletonTemplate);
+	spSkeleton* skeleton = self->skeletonTemplate->skeleton;
+	if (internal->loaded == self) return skeleton;
+	internal->loaded = self;
+	/* The last incremental update was of another instance. */
+	_spSkeleton_invalidateIncrementalUpdate(skeleton);
+
+	if (skeleton->skin != self->skin) {
+		CONST_CAST(spSkin*, skeleton->skin) = self->skin;
+		/* Path constraints depend on the skin, the update cache of a known skin is a copy. */
+		if (skeleton->pathConstraintsCount) spSkeleton_updateCache(skeleton);
+	}
+	skeleton->color = self->color;
+	skeleton->time = self->time;
+	skeleton->flipX = self->flipX;
+	skeleton->flipY = self->flipY;
+	skeleton->x = self->x;
+	skeleton->y = self->y;
+
+	for (i = 0, values = self->bones; i < skeleton->bonesCount; ++i, values += BONE_FLOATS) {
+		spBone* bone = skeleton->bones[i];
+		bone->x = values[0];
+		bone->y = values[1];
+		bone->rotation = values[2];
+		bone->scaleX = values[3];
+		bone->scaleY = values[4];
+		bone->shearX = values[5];
+		bone->shearY = values[6];
+		CONST_CAST(float, bone->a) = values[7];
+		CONST_CAST(float, bone->b) = values[8];
+		CONST_CAST(float, bone->c) = values[9];
+		CONST_CAST(float, bone->d) = values[10];
+		CONST_CAST(float, bone->worldX) = values[11];
+		CONST_CAST(float, bone->worldY) = values[12];
+	}
+
+	values = self->constraints;
+	for (i = 0; i < skeleton->ikConstraintsCount; ++i, values += CONSTRAINT_FLOATS) {
+		skeleton->ikConstraints[i]->mix = values[0];
+		skeleton->ikConstraints[i]->bendDirection = (int)values[1];
+	}
+	for (i = 0; i < skeleton->transformConstraintsCount; ++i, values += CONSTRAINT_FLOATS) {
+		spTransformConstraint* constraint = skeleton->transformConstraints[i];
+		constraint->rotateMix = values[0];
+		constraint->translateMix = values[1];
+		constraint->scaleMix = values[2];
+		constraint->shearMix = values[3];
+	}
+	for (i = 0; i < skeleton->pathConstraintsCount; ++i, values += CONSTRAINT_FLOATS) {
+		spPathConstraint* constraint = skeleton->pathConstraints[i];
+		constraint->position = values[0];
+		constraint->spacing = values[1];
+		constraint->rotateMix = values[2];
+		constraint->translateMix = values[3];
+	}
+
+	for (i = 0; i < skeleton->slotsCount; ++i) {
+		spSlot* slot = skeleton->slots[i];
+		_spInstanceDeform* deform = self->deforms + i;
+		slot->color = self->slotColors[i];
+		if (slot->darkColor) *slot->darkColor = self->slotDarkColors[i];
+		CONST_CAST(spAttachment*, slot->attachment) = self->attachments[i];
+		SUB_CAST(_spSlot, slot)->attachmentTime = self->attachmentTimes[i];
+		if (deform->count)
+			_spSkeletonInstance_copyVertices(&slot->attachmentVertices, &slot->attachmentVerticesCapacity, deform->vertices,
+				deform->count);
+		slot->attachmentVerticesCount = deform->count;
+		skeleton->drawOrder[i] = skeleton->slots[self->drawOrder[i]];
+	}
+	return skeleton;
+}
+
+void spSkeletonInstance_store (spSkeletonInstance* self) {
+	int i;
+	float* values;
+	const spSkeleton* skeleton = self->skeletonTemplate->skeleton;
+
+	self->skin = skeleton->skin;
+	self->color = skeleton->color;
+	self->time = skeleton->time;
+	self->flipX = skeleton->flipX;
+	self->flipY = skeleton->flipY;
+	self->x = skeleton->x;
+	self->y = skeleton->y;
+
+	for (i = 0, values = self->bones; i < skeleton->bonesCount; ++i, values += BONE_FLOATS) {
+		const spBone* bone = skeleton->bones[i];
+		values[0] = bone->x;
+		values[1] = bone->y;
+		values[2] = bone->rotation;
+		values[3] = bone->scaleX;
+		values[4] = bone->scaleY;
+		values[5] = bone->shearX;
+		values[6] = bone->shearY;
+		values[7] = bone->a;
+		values[8] = bone->b;
+		values[9] = bone->c;
+		values[10] = bone->d;
+		values[11] = bone->worldX;
+		values[12] = bone->worldY;
+	}
+
+	values = self->constraints;
+	for (i = 0; i < skeleton->ikConstraintsCount; ++i, values += CONSTRAINT_FLOATS) {
+		values[0] = skeleton->ikConstraints[i]->mix;
+		values[1] = (float)skeleton->ikConstraints[i]->bendDirection;
+	}
+	for (i = 0; i < skeleton->transformConstraintsCount; ++i, values += CONSTRAINT_FLOATS) {
+		const spTransformConstraint* constraint = skeleton->transformConstraints[i];
+		values[0] = constraint->rotateMix;
+		values[1] = constraint->translateMix;
+		values[2] = constraint->scaleMix;
+		values[3] = constraint->shearMix;
+	}
+	for (i = 0; i < skeleton->pathConstraintsCount; ++i, values += CONSTRAINT_FLOATS) {
+		const spPathConstraint* constraint = skeleton->pathConstraints[i];
+		values[0] = constraint->position;
+		values[1] = constraint->spacing;
+		values[2] = constraint->rotateMix;
+		values[3] = constraint->translateMix;
+	}
+
+	for (i = 0; i < skeleton->slotsCount; ++i) {
+		const spSlot* slot = skeleton->slots[i];
+		_spInstanceDeform* deform = self->deforms + i;
+		self->slotColors[i] = slot->color;
+		if (slot->darkColor) self->slotDarkColors[i] = *slot->darkColor;
+		self->attachments[i] = slot->attachment;
+		self->attachmentTimes[i] = SUB_CAST(_spSlot, slot)->attachmentTime;
+		if (slot->attachmentVerticesCount) {
+			self->byteCount -= sizeof(float) * deform->capacity;
+			_spSkeletonInstance_copyVertices(&deform->vertices, &deform->capacity, slot->attachmentVertices,
+				slot->attachmentVerticesCount);
+			self->byteCount += sizeof(float) * deform->capacity;
+		}
+		deform->count = slot->attachmentVerticesCount;
+		self->drawOrder[i] = skeleton->drawOrder[i]->data->index;
+	}
+}
+
+int spSkeletonInstance_getByteCount (const spSkeletonInstance* self) {
+	return self->byteCount;
+}
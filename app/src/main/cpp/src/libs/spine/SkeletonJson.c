@@ -508,6 +508,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		animation->duration = MAX(animation->duration, timeline->frames[events->size - 1]);
 	}
 
+	if (self->compactKeyframes) spAnimation_compactKeyframes(animation);
 	return animation;
 }
 
@@ -1115,5 +1116,6 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 	}
 
 	Json_dispose(root);
+	_spSkeletonData_indexNames(skeletonData);
 	return skeletonData;
 }
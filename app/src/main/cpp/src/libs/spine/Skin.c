@@ -47,6 +47,29 @@ void _Entry_dispose (_Entry* self) {
 
 /**/
 
+static unsigned int _spSkin_hash (int slotIndex, const char* name) {
+	return _spNameTable_hash(name) ^ (unsigned int)slotIndex * 2654435761u;
+}
+
+static _Entry** _spSkin_getBucket (const _spSkin* self, unsigned int hash) {
+	return self->buckets + ((hash ^ (hash >> 16)) & (unsigned int)(self->bucketsCount - 1));
+}
+
+/* Doubles the buckets. Every entry goes to the end of its new chain, so the chains stay newest first. */
+static void _spSkin_growBuckets (_spSkin* self) {
+	_Entry* entry;
+	FREE(self->buckets);
+	self->bucketsCount = self->bucketsCount ? self->bucketsCount << 1 : 16;
+	self->buckets = CALLOC(_Entry*, self->bucketsCount);
+	for (entry = self->entries; entry; entry = entry->next) {
+		_Entry** link = _spSkin_getBucket(self, entry->hash);
+		while (*link)
+			link = &(*link)->nextInBucket;
+		entry->nextInBucket = 0;
+		*link = entry;
+	}
+}
+
 spSkin* spSkin_create (const char* name) {
 	spSkin* self = SUPER(NEW(_spSkin));
 	MALLOC_STR(self->name, name);
@@ -61,22 +84,36 @@ void spSkin_dispose (spSkin* self) {
 		entry = nextEntry;
 	}
 
+	FREE(SUB_CAST(_spSkin, self)->buckets);
 	FREE(self->name);
 	FREE(self);
 }
 
 void spSkin_addAttachment (spSkin* self, int slotIndex, const char* name, spAttachment* attachment) {
+	_spSkin* internal = SUB_CAST(_spSkin, self);
 	_Entry* newEntry = _Entry_create(slotIndex, name, attachment);
-	newEntry->next = SUB_CAST(_spSkin, self)->entries;
-	SUB_CAST(_spSkin, self)->entries = newEntry;
+	_Entry** bucket;
+	newEntry->hash = _spSkin_hash(slotIndex, name);
+	newEntry->next = internal->entries;
+	internal->entries = newEntry;
+	internal->entriesCount++;
+	if (internal->entriesCount > internal->bucketsCount) {
+		_spSkin_growBuckets(internal);
+	} else {
+		bucket = _spSkin_getBucket(internal, newEntry->hash);
+		newEntry->nextInBucket = *bucket;
+		*bucket = newEntry;
+	}
 }
 
 spAttachment* spSkin_getAttachment (const spSkin* self, int slotIndex, const char* name) {
-	const _Entry* entry = SUB_CAST(_spSkin, self)->entries;
-	while (entry) {
-		if (entry->slotIndex == slotIndex && strcmp(entry->name, name) == 0) return entry->attachment;
-		entry = entry->next;
-	}
+	const _spSkin* internal = SUB_CAST(_spSkin, self);
+	unsigned int hash;
+	const _Entry* entry;
+	if (!internal->buckets) return 0;
+	hash = _spSkin_hash(slotIndex, name);
+	for (entry = *_spSkin_getBucket(internal, hash); entry; entry = entry->nextInBucket)
+		if (entry->hash == hash && entry->slotIndex == slotIndex && strcmp(entry->name, name) == 0) return entry->attachment;
 	return 0;
 }
 
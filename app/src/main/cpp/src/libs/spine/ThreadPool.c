@@ -0,0 +1,207 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/ThreadPool.h>
+#include <spine/extension.h>
+#include <pthread.h>
+
+typedef struct {
+	pthread_mutex_t mutex;
+	int* tasks;
+	int head, tail; /* The owner takes from head, thieves from tail. */
+} _spTaskDeque;
+
+typedef struct {
+	spThreadPool* pool;
+	int index;
+	pthread_t thread;
+} _spWorker;
+
+struct spThreadPool {
+	int threadsCount;
+	_spTaskDeque* deques; /* One per thread, the calling thread uses deques[0]. */
+	_spWorker* workers; /* threadsCount - 1 pool threads. */
+	int tasksCapacity;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t started;
+	pthread_cond_t finished;
+	int generation;
+	int working; /* Pool threads still busy with the current generation. */
+	int /*boolean*/ quit;
+
+	spThreadPoolTask task;
+	void* context;
+};
+
+static int /*boolean*/ _spTaskDeque_pop (_spTaskDeque* self, int* index) {
+	int found;
+	pthread_mutex_lock(&self->mutex);
+	found = self->head < self->tail;
+	if (found) *index = self->tasks[self->head++];
+	pthread_mutex_unlock(&self->mutex);
+	return found;
+}
+
+static int /*boolean*/ _spTaskDeque_steal (_spTaskDeque* self, int* index) {
+	int found;
+	pthread_mutex_lock(&self->mutex);
+	found = self->head < self->tail;
+	if (found) *index = self->tasks[--self->tail];
+	pthread_mutex_unlock(&self->mutex);
+	return found;
+}
+
+/* Runs tasks until every deque is empty. */
+static void _spThreadPool_work (spThreadPool* self, int threadIndex) {
+	int index = 0, i;
+	for (;;) {
+		if (_spTaskDeque_pop(self->deques + threadIndex, &index)) {
+			self->task(self->context, index);
+			continue;
+		}
+		for (i = 1; i < self->threadsCount; ++i)
+			if (_spTaskDeque_steal(self->deques + (threadIndex + i) % self->threadsCount, &index)) break;
+		if (i == self->threadsCount) return;
+		self->task(self->context, index);
+	}
+}
+
+static void* _spWorker_run (void* argument) {
+	_spWorker* worker = (_spWorker*)argument;
+	spThreadPool* self = worker->pool;
+	int generation = 0;
+	for (;;) {
+		pthread_mutex_lock(&self->mutex);
+		while (self->generation == generation && !self->quit)
+			pthread_cond_wait(&self->started, &self->mutex);
+		if (self->quit) {
+			pthread_mutex_unlock(&self->mutex);
+			return 0;
+		}
+		generation = self->generation;
+		pthread_mutex_unlock(&self->mutex);
+
+		_spThreadPool_work(self, worker->index);
+
+		pthread_mutex_lock(&self->mutex);
+		if (--self->working == 0) pthread_cond_signal(&self->finished);
+		pthread_mutex_unlock(&self->mutex);
+	}
+}
+
+spThreadPool* spThreadPool_create (int threadsCount) {
+	int i;
+	spThreadPool* self = NEW(spThreadPool);
+	if (threadsCount < 1) threadsCount = 1;
+	self->threadsCount = threadsCount;
+	self->deques = CALLOC(_spTaskDeque, threadsCount);
+	for (i = 0; i < threadsCount; ++i)
+		pthread_mutex_init(&self->deques[i].mutex, 0);
+	pthread_mutex_init(&self->mutex, 0);
+	pthread_cond_init(&self->started, 0);
+	pthread_cond_init(&self->finished, 0);
+
+	self->workers = CALLOC(_spWorker, threadsCount - 1);
+	for (i = 1; i < threadsCount; ++i) {
+		_spWorker* worker = self->workers + i - 1;
+		worker->pool = self;
+		worker->index = i;
+		pthread_create(&worker->thread, 0, _spWorker_run, worker);
+	}
+	return self;
+}
+
+void spThreadPool_dispose (spThreadPool* self) {
+	int i;
+	pthread_mutex_lock(&self->mutex);
+	self->quit = 1;
+	pthread_cond_broadcast(&self->started);
+	pthread_mutex_unlock(&self->mutex);
+	for (i = 1; i < self->threadsCount; ++i)
+		pthread_join(self->workers[i - 1].thread, 0);
+
+	for (i = 0; i < self->threadsCount; ++i) {
+		pthread_mutex_destroy(&self->deques[i].mutex);
+		FREE(self->deques[i].tasks);
+	}
+	pthread_cond_destroy(&self->finished);
+	pthread_cond_destroy(&self->started);
+	pthread_mutex_destroy(&self->mutex);
+	FREE(self->workers);
+	FREE(self->deques);
+	FREE(self);
+}
+
+int spThreadPool_getThreadsCount (const spThreadPool* self) {
+	return self->threadsCount;
+}
+
+void spThreadPool_run (spThreadPool* self, int tasksCount, spThreadPoolTask task, void* context) {
+	int i, t;
+	if (self->threadsCount == 1 || tasksCount < 2) {
+		for (i = 0; i < tasksCount; ++i)
+			task(context, i);
+		return;
+	}
+
+	if (tasksCount > self->tasksCapacity) {
+		self->tasksCapacity = tasksCount;
+		for (t = 0; t < self->threadsCount; ++t) {
+			FREE(self->deques[t].tasks);
+			self->deques[t].tasks = MALLOC(int, tasksCount);
+		}
+	}
+	/* Contiguous blocks keep neighbouring tasks on one thread, stealing evens out the rest. */
+	for (t = 0; t < self->threadsCount; ++t) {
+		_spTaskDeque* deque = self->deques + t;
+		int start = (int)((long)tasksCount * t / self->threadsCount);
+		int end = (int)((long)tasksCount * (t + 1) / self->threadsCount);
+		deque->head = 0;
+		deque->tail = end - start;
+		for (i = start; i < end; ++i)
+			deque->tasks[i - start] = i;
+	}
+
+	pthread_mutex_lock(&self->mutex);
+	self->task = task;
+	self->context = context;
+	self->working = self->threadsCount - 1;
+	++self->generation;
+	pthread_cond_broadcast(&self->started);
+	pthread_mutex_unlock(&self->mutex);
+
+	_spThreadPool_work(self, 0);
+
+	pthread_mutex_lock(&self->mutex);
+	while (self->working > 0)
+		pthread_cond_wait(&self->finished, &self->mutex);
+	pthread_mutex_unlock(&self->mutex);
+}
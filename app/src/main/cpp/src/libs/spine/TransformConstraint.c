@@ -32,19 +32,24 @@
 #include <spine/Skeleton.h>
 #include <spine/extension.h>
 
-spTransformConstraint* spTransformConstraint_create (spTransformConstraintData* data, const spSkeleton* skeleton) {
+void _spTransformConstraint_init (spTransformConstraint* self, spTransformConstraintData* data, const spSkeleton* skeleton,
+	spBone** bones) {
 	int i;
-	spTransformConstraint* self = NEW(spTransformConstraint);
 	CONST_CAST(spTransformConstraintData*, self->data) = data;
 	self->rotateMix = data->rotateMix;
 	self->translateMix = data->translateMix;
 	self->scaleMix = data->scaleMix;
 	self->shearMix = data->shearMix;
 	self->bonesCount = data->bonesCount;
-	CONST_CAST(spBone**, self->bones) = MALLOC(spBone*, self->bonesCount);
+	CONST_CAST(spBone**, self->bones) = bones;
 	for (i = 0; i < self->bonesCount; ++i)
-		self->bones[i] = spSkeleton_findBone(skeleton, self->data->bones[i]->name);
-	self->target = spSkeleton_findBone(skeleton, self->data->target->name);
+		self->bones[i] = skeleton->bones[self->data->bones[i]->index];
+	self->target = skeleton->bones[self->data->target->index];
+}
+
+spTransformConstraint* spTransformConstraint_create (spTransformConstraintData* data, const spSkeleton* skeleton) {
+	spTransformConstraint* self = NEW(spTransformConstraint);
+	_spTransformConstraint_init(self, data, skeleton, MALLOC(spBone*, data->bonesCount));
 	return self;
 }
 
@@ -53,6 +58,33 @@ void spTransformConstraint_dispose (spTransformConstraint* self) {
 	FREE(self);
 }
 
+/* Translate and scale mixes of _spTransformConstraint_applyAbsoluteWorld, after the rotate mix. */
+static void _spTransformConstraint_translateAndScaleWorld (spTransformConstraint* self, spBone* bone) {
+	float translateMix = self->translateMix, scaleMix = self->scaleMix;
+	spBone* target = self->target;
+	float ta = target->a, tb = target->b, tc = target->c, td = target->d;
+	float x, y, s, ts;
+
+	if (translateMix != 0) {
+		spBone_localToWorld(target, self->data->offsetX, self->data->offsetY, &x, &y);
+		CONST_CAST(float, bone->worldX) += (x - bone->worldX) * translateMix;
+		CONST_CAST(float, bone->worldY) += (y - bone->worldY) * translateMix;
+	}
+
+	if (scaleMix > 0) {
+		s = SQRT(bone->a * bone->a + bone->c * bone->c);
+		ts = SQRT(ta * ta + tc * tc);
+		if (s > 0.00001f) s = (s + (ts - s + self->data->offsetScaleX) * scaleMix) / s;
+		CONST_CAST(float, bone->a) *= s;
+		CONST_CAST(float, bone->c) *= s;
+		s = SQRT(bone->b * bone->b + bone->d * bone->d);
+		ts = SQRT(tb * tb + td * td);
+		if (s > 0.00001f) s = (s + (ts - s + self->data->offsetScaleY) * scaleMix) / s;
+		CONST_CAST(float, bone->b) *= s;
+		CONST_CAST(float, bone->d) *= s;
+	}
+}
+
 void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 	float rotateMix = self->rotateMix, translateMix = self->translateMix, scaleMix = self->scaleMix, shearMix = self->shearMix;
 	spBone* target = self->target;
@@ -61,7 +93,7 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 	float offsetRotation = self->data->offsetRotation * degRadReflect, offsetShearY = self->data->offsetShearY * degRadReflect;
 	int /*bool*/ modified;
 	int i;
-	float a, b, c, d, r, cosine, sine, x, y, s, ts, by;
+	float a, b, c, d, r, cosine, sine, s, by;
 	for (i = 0; i < self->bonesCount; ++i) {
 		spBone* bone = self->bones[i];
 		modified = 0;
@@ -72,8 +104,7 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 			if (r > PI) r -= PI2;
 			else if (r < -PI) r += PI2;
 			r *= rotateMix;
-			cosine = COS(r);
-			sine = SIN(r);
+			_spMath_sinCos(r, &sine, &cosine);
 			CONST_CAST(float, bone->a) = cosine * a - sine * c;
 			CONST_CAST(float, bone->b) = cosine * b - sine * d;
 			CONST_CAST(float, bone->c) = sine * a + cosine * c;
@@ -81,24 +112,8 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 			modified = 1;
 		}
 
-		if (translateMix != 0) {
-			spBone_localToWorld(target, self->data->offsetX, self->data->offsetY, &x, &y);
-			CONST_CAST(float, bone->worldX) += (x - bone->worldX) * translateMix;
-			CONST_CAST(float, bone->worldY) += (y - bone->worldY) * translateMix;
-			modified = 1;
-		}
-
-		if (scaleMix > 0) {
-			s = SQRT(bone->a * bone->a + bone->c * bone->c);
-			ts = SQRT(ta * ta + tc * tc);
-			if (s > 0.00001f) s = (s + (ts - s + self->data->offsetScaleX) * scaleMix) / s;
-			CONST_CAST(float, bone->a) *= s;
-			CONST_CAST(float, bone->c) *= s;
-			s = SQRT(bone->b * bone->b + bone->d * bone->d);
-			ts = SQRT(tb * tb + td * td);
-			if (s > 0.00001f) s = (s + (ts - s + self->data->offsetScaleY) * scaleMix) / s;
-			CONST_CAST(float, bone->b) *= s;
-			CONST_CAST(float, bone->d) *= s;
+		if (translateMix != 0 || scaleMix > 0) {
+			_spTransformConstraint_translateAndScaleWorld(self, bone);
 			modified = 1;
 		}
 
@@ -110,8 +125,9 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 			if (r > PI) r -= PI2;
 			else if (r < -PI) r += PI2;
 			r = by + (r + offsetShearY) * shearMix;
-			CONST_CAST(float, bone->b) = COS(r) * s;
-			CONST_CAST(float, bone->d) = SIN(r) * s;
+			_spMath_sinCos(r, &sine, &cosine);
+			CONST_CAST(float, bone->b) = cosine * s;
+			CONST_CAST(float, bone->d) = sine * s;
 			modified = 1;
 		}
 
@@ -138,8 +154,7 @@ void _spTransformConstraint_applyRelativeWorld (spTransformConstraint* self) {
 			if (r > PI) r -= PI2;
 			else if (r < -PI) r += PI2;
 			r *= rotateMix;
-			cosine = COS(r);
-			sine = SIN(r);
+			_spMath_sinCos(r, &sine, &cosine);
 			CONST_CAST(float, bone->a) = cosine * a - sine * c;
 			CONST_CAST(float, bone->b) = cosine * b - sine * d;
 			CONST_CAST(float, bone->c) = sine * a + cosine * c;
@@ -171,8 +186,9 @@ void _spTransformConstraint_applyRelativeWorld (spTransformConstraint* self) {
 			b = bone->b, d = bone->d;
 			r = ATAN2(d, b) + (r - PI / 2 + offsetShearY) * shearMix;
 			s = SQRT(b * b + d * d);
-			CONST_CAST(float, bone->b) = COS(r) * s;
-			CONST_CAST(float, bone->d) = SIN(r) * s;
+			_spMath_sinCos(r, &sine, &cosine);
+			CONST_CAST(float, bone->b) = cosine * s;
+			CONST_CAST(float, bone->d) = sine * s;
 			modified = 1;
 		}
 
@@ -271,3 +287,119 @@ void spTransformConstraint_apply (spTransformConstraint* self) {
 			_spTransformConstraint_applyAbsoluteWorld(self);
 	}
 }
+
+/* Scratch floats per bone of _spTransformConstraint_applyBatch. */
+#define SP_TRANSFORM_BATCH_FLOATS 14
+
+static float _spTransformConstraint_getDegRadReflect (const spTransformConstraint* self) {
+	const spBone* target = self->target;
+	return target->a * target->d - target->b * target->c > 0 ? DEG_RAD : -DEG_RAD;
+}
+
+size_t _spTransformConstraint_getBatchScratchSize (int bonesCount) {
+	return sizeof(float) * SP_TRANSFORM_BATCH_FLOATS * bonesCount;
+}
+
+/* _spTransformConstraint_applyAbsoluteWorld of every bone of the constraints at once: the atan2 of the rotate mix, then
+ * the translate and scale mixes, then the atan2 of the shear mix. */
+void _spTransformConstraint_applyBatch (spTransformConstraint** constraints, int count, void* scratch) {
+	int i, j, n, bonesCount = 0;
+	float *y, *x, *angles, *sines, *cosines;
+	for (i = 0; i < count; ++i)
+		bonesCount += constraints[i]->bonesCount;
+	y = (float*)scratch; /* 4 * bonesCount atan2 inputs and angles. */
+	x = y + bonesCount * 4;
+	angles = x + bonesCount * 4;
+	sines = angles + bonesCount * 4;
+	cosines = sines + bonesCount;
+
+	/* Rotate: angle of the target against the angle of each bone. */
+	for (i = 0, n = 0; i < count; ++i) {
+		spTransformConstraint* constraint = constraints[i];
+		spBone* target = constraint->target;
+		if (constraint->rotateMix == 0) continue;
+		for (j = 0; j < constraint->bonesCount; ++j, ++n) {
+			spBone* bone = constraint->bones[j];
+			y[n * 2] = target->c;
+			x[n * 2] = target->a;
+			y[n * 2 + 1] = bone->c;
+			x[n * 2 + 1] = bone->a;
+		}
+	}
+	_spMath_atan2Array(y, x, angles, n * 2);
+	for (i = 0, n = 0; i < count; ++i) {
+		spTransformConstraint* constraint = constraints[i];
+		float offsetRotation;
+		if (constraint->rotateMix == 0) continue;
+		offsetRotation = constraint->data->offsetRotation * _spTransformConstraint_getDegRadReflect(constraint);
+		for (j = 0; j < constraint->bonesCount; ++j, ++n) {
+			float r = angles[n * 2] - angles[n * 2 + 1] + offsetRotation;
+			if (r > PI) r -= PI2;
+			else if (r < -PI) r += PI2;
+			y[n] = r * constraint->rotateMix;
+		}
+	}
+	_spMath_sinCosArray(y, sines, cosines, n);
+
+	/* Translate and scale, then the shear angles of the rotated and scaled bones. */
+	for (i = 0, n = 0; i < count; ++i) {
+		spTransformConstraint* constraint = constraints[i];
+		int rotate = constraint->rotateMix != 0;
+		for (j = 0; j < constraint->bonesCount; ++j) {
+			spBone* bone = constraint->bones[j];
+			if (rotate) {
+				float a = bone->a, b = bone->b, c = bone->c, d = bone->d, sine = sines[n], cosine = cosines[n];
+				CONST_CAST(float, bone->a) = cosine * a - sine * c;
+				CONST_CAST(float, bone->b) = cosine * b - sine * d;
+				CONST_CAST(float, bone->c) = sine * a + cosine * c;
+				CONST_CAST(float, bone->d) = sine * b + cosine * d;
+				++n;
+			}
+			_spTransformConstraint_translateAndScaleWorld(constraint, bone);
+			if (rotate || constraint->translateMix != 0 || constraint->scaleMix > 0 || constraint->shearMix > 0)
+				CONST_CAST(int, bone->appliedValid) = 0;
+		}
+	}
+	for (i = 0, n = 0; i < count; ++i) {
+		spTransformConstraint* constraint = constraints[i];
+		spBone* target = constraint->target;
+		if (constraint->shearMix <= 0) continue;
+		for (j = 0; j < constraint->bonesCount; ++j, ++n) {
+			spBone* bone = constraint->bones[j];
+			y[n * 4] = bone->d;
+			x[n * 4] = bone->b;
+			y[n * 4 + 1] = target->d;
+			x[n * 4 + 1] = target->b;
+			y[n * 4 + 2] = target->c;
+			x[n * 4 + 2] = target->a;
+			y[n * 4 + 3] = bone->c;
+			x[n * 4 + 3] = bone->a;
+		}
+	}
+	if (n == 0) return;
+	_spMath_atan2Array(y, x, angles, n * 4);
+	for (i = 0, n = 0; i < count; ++i) {
+		spTransformConstraint* constraint = constraints[i];
+		float offsetShearY;
+		if (constraint->shearMix <= 0) continue;
+		offsetShearY = constraint->data->offsetShearY * _spTransformConstraint_getDegRadReflect(constraint);
+		for (j = 0; j < constraint->bonesCount; ++j, ++n) {
+			float* angle = angles + n * 4;
+			float by = angle[0], r = angle[1] - angle[2] - (by - angle[3]);
+			if (r > PI) r -= PI2;
+			else if (r < -PI) r += PI2;
+			y[n] = by + (r + offsetShearY) * constraint->shearMix;
+		}
+	}
+	_spMath_sinCosArray(y, sines, cosines, n);
+	for (i = 0, n = 0; i < count; ++i) {
+		spTransformConstraint* constraint = constraints[i];
+		if (constraint->shearMix <= 0) continue;
+		for (j = 0; j < constraint->bonesCount; ++j, ++n) {
+			spBone* bone = constraint->bones[j];
+			float b = bone->b, d = bone->d, s = SQRT(b * b + d * d);
+			CONST_CAST(float, bone->b) = cosines[n] * s;
+			CONST_CAST(float, bone->d) = sines[n] * s;
+		}
+	}
+}
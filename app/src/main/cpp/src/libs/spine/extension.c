@@ -31,6 +31,34 @@
 #include <spine/extension.h>
 #include <stdio.h>
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SP_MATH_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SP_MATH_SSE2 1
+#endif
+
+/* Single precision minimax coefficients of sin and cos on [-PI / 4, PI / 4]. */
+#define SIN_C1 -1.6666654611e-1f
+#define SIN_C2 8.3321608736e-3f
+#define SIN_C3 -1.9515295891e-4f
+#define COS_C1 4.166664568298827e-2f
+#define COS_C2 -1.388731625493765e-3f
+#define COS_C3 2.443315711809948e-5f
+
+/* Single precision minimax coefficients of atan on [-tan(PI / 8), tan(PI / 8)] and asin on [-0.5, 0.5]. */
+#define ATAN_C1 -3.33329491539e-1f
+#define ATAN_C2 1.99777106478e-1f
+#define ATAN_C3 -1.38776856032e-1f
+#define ATAN_C4 8.05374449538e-2f
+#define TAN_PI_8 0.414213562373f
+#define ASIN_C1 1.6666752422e-1f
+#define ASIN_C2 7.4953002686e-2f
+#define ASIN_C3 4.5470025998e-2f
+#define ASIN_C4 2.4181311049e-2f
+#define ASIN_C5 4.2163199048e-2f
+
 float _spInternalRandom () {
 	return rand() / (float)RAND_MAX;
 }
@@ -99,6 +127,81 @@ char* _spReadFile (const char* path, int* length) {
 	return data;
 }
 
+static int _spNameTable_position (const _spNameTable* self, unsigned int hash) {
+	return (int)((hash ^ (hash >> 16)) & (unsigned int)self->mask);
+}
+
+static void _spNameTable_insert (_spNameTable* self, unsigned int hash, int index) {
+	int i = _spNameTable_position(self, hash);
+	while (self->slots[i].index != -1)
+		i = (i + 1) & self->mask;
+	self->slots[i].hash = hash;
+	self->slots[i].index = index;
+}
+
+unsigned int _spNameTable_hash (const char* name) {
+	unsigned int hash = 2166136261u;
+	while (*name) {
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void _spNameTable_add (_spNameTable* self, unsigned int hash, int index) {
+	if (!self->slots || (self->count + 1) * 2 > self->mask + 1) {
+		_spNameTableSlot* oldSlots = self->slots;
+		int oldCapacity = oldSlots ? self->mask + 1 : 0;
+		int capacity = oldCapacity ? oldCapacity << 1 : 16;
+		int i, start = 0;
+		self->slots = MALLOC(_spNameTableSlot, capacity);
+		self->mask = capacity - 1;
+		for (i = 0; i < capacity; ++i)
+			self->slots[i].index = -1;
+		if (oldSlots) {
+			/* Walk the old slots from a free one so every run of equal hashes is reinserted in probe order, which keeps the
+			 * order they were added in. */
+			while (oldSlots[start].index != -1)
+				++start;
+			for (i = 1; i <= oldCapacity; ++i) {
+				_spNameTableSlot* slot = oldSlots + ((start + i) & (oldCapacity - 1));
+				if (slot->index != -1) _spNameTable_insert(self, slot->hash, slot->index);
+			}
+			FREE(oldSlots);
+		}
+	}
+	_spNameTable_insert(self, hash, index);
+	self->count++;
+}
+
+int _spNameTable_next (const _spNameTable* self, unsigned int hash, int* cursor) {
+	int i;
+	if (!self->slots) return -1;
+	i = *cursor == -1 ? _spNameTable_position(self, hash) : (*cursor + 1) & self->mask;
+	for (; self->slots[i].index != -1; i = (i + 1) & self->mask) {
+		if (self->slots[i].hash == hash) {
+			*cursor = i;
+			return self->slots[i].index;
+		}
+	}
+	return -1;
+}
+
+void _spNameTable_clear (_spNameTable* self) {
+	int i;
+	if (!self->slots) return;
+	for (i = 0; i <= self->mask; ++i)
+		self->slots[i].index = -1;
+	self->count = 0;
+}
+
+void _spNameTable_deinit (_spNameTable* self) {
+	FREE(self->slots);
+	self->slots = 0;
+	self->count = 0;
+	self->mask = 0;
+}
+
 float _spMath_random(float min, float max) {
 	return min + (max - min) * _spRandom();
 }
@@ -126,3 +229,237 @@ float _spMath_pow2_apply(float a) {
 float _spMath_pow2out_apply(float a) {
 	return POW(a - 1, 2) * -1 + 1;
 }
+
+void _spMath_sinCosDeg(float degrees, float* sine, float* cosine) {
+	if (spBone_isFastMath()) {
+		_spMath_fastSinCosDeg(degrees, sine, cosine);
+		return;
+	}
+	*sine = SIN_DEG(degrees);
+	*cosine = COS_DEG(degrees);
+}
+
+void _spMath_sinCos(float radians, float* sine, float* cosine) {
+	if (spBone_isFastMath()) {
+		_spMath_fastSinCosDeg(radians * RAD_DEG, sine, cosine);
+		return;
+	}
+	*sine = SIN(radians);
+	*cosine = COS(radians);
+}
+
+void _spMath_fastSinCosDeg(float degrees, float* sine, float* cosine) {
+	/* Nearest quadrant, rounded half away from zero like the vector version. */
+	float y = degrees * (1.0f / 90);
+	int quadrant = (int)(y + (y < 0 ? -0.5f : 0.5f));
+	float r = (degrees - (float)quadrant * 90) * DEG_RAD;
+	float z = r * r;
+	float s = r + r * z * (SIN_C1 + z * (SIN_C2 + z * SIN_C3));
+	float c = 1 - 0.5f * z + z * z * (COS_C1 + z * (COS_C2 + z * COS_C3));
+	switch (quadrant & 3) {
+	case 0:
+		*sine = s;
+		*cosine = c;
+		break;
+	case 1:
+		*sine = c;
+		*cosine = -s;
+		break;
+	case 2:
+		*sine = -s;
+		*cosine = -c;
+		break;
+	default:
+		*sine = -c;
+		*cosine = s;
+	}
+}
+
+void _spMath_fastSinCosDegArray(const float* degrees, float* sines, float* cosines, int count) {
+	int i = 0;
+#if defined(SP_MATH_NEON)
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t angle = vld1q_f32(degrees + i);
+		float32x4_t y = vmulq_f32(angle, vdupq_n_f32(1.0f / 90));
+		uint32x4_t half = vorrq_u32(vandq_u32(vreinterpretq_u32_f32(y), vdupq_n_u32(0x80000000u)),
+			vreinterpretq_u32_f32(vdupq_n_f32(0.5f)));
+		int32x4_t quadrant = vcvtq_s32_f32(vaddq_f32(y, vreinterpretq_f32_u32(half)));
+		float32x4_t r = vmulq_f32(vsubq_f32(angle, vmulq_f32(vcvtq_f32_s32(quadrant), vdupq_n_f32(90))), vdupq_n_f32(DEG_RAD));
+		float32x4_t z = vmulq_f32(r, r);
+		float32x4_t s = vaddq_f32(vdupq_n_f32(SIN_C2), vmulq_f32(z, vdupq_n_f32(SIN_C3)));
+		float32x4_t c = vaddq_f32(vdupq_n_f32(COS_C2), vmulq_f32(z, vdupq_n_f32(COS_C3)));
+		uint32x4_t swap, sineSign, cosineSign;
+		float32x4_t sine, cosine;
+		s = vaddq_f32(r, vmulq_f32(vmulq_f32(r, z), vaddq_f32(vdupq_n_f32(SIN_C1), vmulq_f32(z, s))));
+		c = vaddq_f32(vsubq_f32(vdupq_n_f32(1), vmulq_f32(vdupq_n_f32(0.5f), z)),
+			vmulq_f32(vmulq_f32(z, z), vaddq_f32(vdupq_n_f32(COS_C1), vmulq_f32(z, c))));
+		swap = vceqq_s32(vandq_s32(quadrant, vdupq_n_s32(1)), vdupq_n_s32(1));
+		sineSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(quadrant, vdupq_n_s32(2))), 30);
+		cosineSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(vaddq_s32(quadrant, vdupq_n_s32(1)), vdupq_n_s32(2))), 30);
+		sine = vbslq_f32(swap, c, s);
+		cosine = vbslq_f32(swap, s, c);
+		vst1q_f32(sines + i, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sine), sineSign)));
+		vst1q_f32(cosines + i, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cosine), cosineSign)));
+	}
+#elif defined(SP_MATH_SSE2)
+	for (; i + 4 <= count; i += 4) {
+		__m128 angle = _mm_loadu_ps(degrees + i);
+		__m128 y = _mm_mul_ps(angle, _mm_set1_ps(1.0f / 90));
+		__m128 half = _mm_or_ps(_mm_and_ps(y, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000u))), _mm_set1_ps(0.5f));
+		__m128i quadrant = _mm_cvttps_epi32(_mm_add_ps(y, half));
+		__m128 r = _mm_mul_ps(_mm_sub_ps(angle, _mm_mul_ps(_mm_cvtepi32_ps(quadrant), _mm_set1_ps(90))), _mm_set1_ps(DEG_RAD));
+		__m128 z = _mm_mul_ps(r, r);
+		__m128 s = _mm_add_ps(_mm_set1_ps(SIN_C2), _mm_mul_ps(z, _mm_set1_ps(SIN_C3)));
+		__m128 c = _mm_add_ps(_mm_set1_ps(COS_C2), _mm_mul_ps(z, _mm_set1_ps(COS_C3)));
+		__m128 swap, sine, cosine;
+		__m128i sineSign, cosineSign;
+		s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), _mm_add_ps(_mm_set1_ps(SIN_C1), _mm_mul_ps(z, s))));
+		c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1), _mm_mul_ps(_mm_set1_ps(0.5f), z)),
+			_mm_mul_ps(_mm_mul_ps(z, z), _mm_add_ps(_mm_set1_ps(COS_C1), _mm_mul_ps(z, c))));
+		swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		sineSign = _mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30);
+		cosineSign = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30);
+		sine = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+		cosine = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+		_mm_storeu_ps(sines + i, _mm_xor_ps(sine, _mm_castsi128_ps(sineSign)));
+		_mm_storeu_ps(cosines + i, _mm_xor_ps(cosine, _mm_castsi128_ps(cosineSign)));
+	}
+#endif
+	for (; i < count; i++) {
+		float sine, cosine;
+		_spMath_fastSinCosDeg(degrees[i], &sine, &cosine);
+		sines[i] = sine;
+		cosines[i] = cosine;
+	}
+}
+
+/* atan2 from atan of the smaller over the larger absolute value, reduced around PI / 4 above tan(PI / 8), then placed in its
+ * octant. Both zero gives 0 with the sign of y and PI with the sign of y for negative x, like libm. */
+static int /*bool*/ _spMath_signBit (float value) {
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits >> 31;
+}
+
+static float _spMath_fastAtan2 (float y, float x) {
+	float ax = x < 0 ? -x : x, ay = y < 0 ? -y : y;
+	float mn = ax < ay ? ax : ay, mx = ax < ay ? ay : ax;
+	float num = mn, den = mx, base = 0, t, z, r;
+	if (mn > mx * TAN_PI_8) {
+		num = mn - mx;
+		den = mn + mx;
+		base = PI / 4;
+	}
+	t = den > 0 ? num / den : 0;
+	z = t * t;
+	r = base + t + t * z * (ATAN_C1 + z * (ATAN_C2 + z * (ATAN_C3 + z * ATAN_C4)));
+	if (ay > ax) r = PI / 2 - r;
+	if (_spMath_signBit(x)) r = PI - r;
+	return _spMath_signBit(y) ? -r : r;
+}
+
+void _spMath_atan2Array(const float* y, const float* x, float* angles, int count) {
+	int i = 0;
+	if (!spBone_isFastMath()) {
+		for (; i < count; i++)
+			angles[i] = ATAN2(y[i], x[i]);
+		return;
+	}
+#if defined(SP_MATH_NEON)
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t vy = vld1q_f32(y + i), vx = vld1q_f32(x + i);
+		float32x4_t ax = vabsq_f32(vx), ay = vabsq_f32(vy);
+		float32x4_t mn = vminq_f32(ax, ay), mx = vmaxq_f32(ax, ay);
+		uint32x4_t reduce = vcgtq_f32(mn, vmulq_f32(mx, vdupq_n_f32(TAN_PI_8)));
+		float32x4_t num = vbslq_f32(reduce, vsubq_f32(mn, mx), mn);
+		float32x4_t den = vbslq_f32(reduce, vaddq_f32(mn, mx), mx);
+		uint32x4_t zero = vceqq_f32(den, vdupq_n_f32(0));
+		float32x4_t t, z, r;
+		uint32x4_t sign = vdupq_n_u32(0x80000000u);
+		den = vbslq_f32(zero, vdupq_n_f32(1), den);
+#if defined(__aarch64__)
+		t = vdivq_f32(num, den);
+#else
+		{
+			float32x4_t inverse = vrecpeq_f32(den);
+			inverse = vmulq_f32(vrecpsq_f32(den, inverse), inverse);
+			inverse = vmulq_f32(vrecpsq_f32(den, inverse), inverse);
+			t = vmulq_f32(num, inverse);
+		}
+#endif
+		t = vbslq_f32(zero, vdupq_n_f32(0), t);
+		z = vmulq_f32(t, t);
+		r = vaddq_f32(vdupq_n_f32(ATAN_C3), vmulq_f32(z, vdupq_n_f32(ATAN_C4)));
+		r = vaddq_f32(vdupq_n_f32(ATAN_C2), vmulq_f32(z, r));
+		r = vaddq_f32(vdupq_n_f32(ATAN_C1), vmulq_f32(z, r));
+		r = vaddq_f32(vaddq_f32(vbslq_f32(reduce, vdupq_n_f32(PI / 4), vdupq_n_f32(0)), t), vmulq_f32(vmulq_f32(t, z), r));
+		r = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(vdupq_n_f32(PI / 2), r), r);
+		r = vbslq_f32(vtstq_u32(vreinterpretq_u32_f32(vx), sign), vsubq_f32(vdupq_n_f32(PI), r), r);
+		r = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(r), vandq_u32(vreinterpretq_u32_f32(vy), sign)));
+		vst1q_f32(angles + i, r);
+	}
+#elif defined(SP_MATH_SSE2)
+	for (; i + 4 <= count; i += 4) {
+		__m128 vy = _mm_loadu_ps(y + i), vx = _mm_loadu_ps(x + i);
+		__m128 sign = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000u));
+		__m128 ax = _mm_andnot_ps(sign, vx), ay = _mm_andnot_ps(sign, vy);
+		__m128 mn = _mm_min_ps(ax, ay), mx = _mm_max_ps(ax, ay);
+		__m128 reduce = _mm_cmpgt_ps(mn, _mm_mul_ps(mx, _mm_set1_ps(TAN_PI_8)));
+		__m128 num = _mm_or_ps(_mm_and_ps(reduce, _mm_sub_ps(mn, mx)), _mm_andnot_ps(reduce, mn));
+		__m128 den = _mm_or_ps(_mm_and_ps(reduce, _mm_add_ps(mn, mx)), _mm_andnot_ps(reduce, mx));
+		__m128 nonZero = _mm_cmpgt_ps(den, _mm_setzero_ps());
+		__m128 t, z, r, negativeX, steep;
+		t = _mm_and_ps(nonZero, _mm_div_ps(num, _mm_or_ps(_mm_and_ps(nonZero, den), _mm_andnot_ps(nonZero, _mm_set1_ps(1)))));
+		z = _mm_mul_ps(t, t);
+		r = _mm_add_ps(_mm_set1_ps(ATAN_C3), _mm_mul_ps(z, _mm_set1_ps(ATAN_C4)));
+		r = _mm_add_ps(_mm_set1_ps(ATAN_C2), _mm_mul_ps(z, r));
+		r = _mm_add_ps(_mm_set1_ps(ATAN_C1), _mm_mul_ps(z, r));
+		r = _mm_add_ps(_mm_add_ps(_mm_and_ps(reduce, _mm_set1_ps(PI / 4)), t), _mm_mul_ps(_mm_mul_ps(t, z), r));
+		steep = _mm_cmpgt_ps(ay, ax);
+		r = _mm_or_ps(_mm_and_ps(steep, _mm_sub_ps(_mm_set1_ps(PI / 2), r)), _mm_andnot_ps(steep, r));
+		negativeX = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(vx), 31));
+		r = _mm_or_ps(_mm_and_ps(negativeX, _mm_sub_ps(_mm_set1_ps(PI), r)), _mm_andnot_ps(negativeX, r));
+		_mm_storeu_ps(angles + i, _mm_or_ps(r, _mm_and_ps(vy, sign)));
+	}
+#endif
+	for (; i < count; i++)
+		angles[i] = _spMath_fastAtan2(y[i], x[i]);
+}
+
+void _spMath_acosArray(const float* x, float* angles, int count) {
+	int i;
+	if (!spBone_isFastMath()) {
+		for (i = 0; i < count; i++)
+			angles[i] = ACOS(x[i]);
+		return;
+	}
+	/* acos from asin, of sqrt((1 - |x|) / 2) above 0.5. */
+	for (i = 0; i < count; i++) {
+		float a = x[i] < 0 ? -x[i] : x[i], s, z;
+		if (a > 1) a = 1;
+		if (a > 0.5f) {
+			z = 0.5f * (1 - a);
+			s = SQRT(z);
+			s = 2 * (s + s * z * (ASIN_C1 + z * (ASIN_C2 + z * (ASIN_C3 + z * (ASIN_C4 + z * ASIN_C5)))));
+			angles[i] = x[i] < 0 ? PI - s : s;
+		} else {
+			z = x[i] * x[i];
+			angles[i] = PI / 2 - (x[i] + x[i] * z * (ASIN_C1 + z * (ASIN_C2 + z * (ASIN_C3 + z * (ASIN_C4 + z * ASIN_C5)))));
+		}
+	}
+}
+
+void _spMath_sinCosArray(const float* radians, float* sines, float* cosines, int count) {
+	int i;
+	if (!spBone_isFastMath()) {
+		for (i = 0; i < count; i++) {
+			float r = radians[i];
+			sines[i] = SIN(r);
+			cosines[i] = COS(r);
+		}
+		return;
+	}
+	for (i = 0; i < count; i++)
+		cosines[i] = radians[i] * RAD_DEG;
+	_spMath_fastSinCosDegArray(cosines, sines, cosines, count);
+}
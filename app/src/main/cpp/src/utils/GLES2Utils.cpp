@@ -65,19 +65,35 @@ GLuint loadShader(GLenum shaderType, const char *src) {
     return shaderHandle;
 }
 
+/**
+ * Multiply the color channels of RGBA8 pixels by their alpha
+ */
+static void premultiplyPixels(unsigned char *pixels, int pixelCount) {
+    for (int i = 0; i < pixelCount; ++i, pixels += 4) {
+        unsigned int a = pixels[3];
+        pixels[0] = (unsigned char) ((pixels[0] * a + 127) / 255);
+        pixels[1] = (unsigned char) ((pixels[1] * a + 127) / 255);
+        pixels[2] = (unsigned char) ((pixels[2] * a + 127) / 255);
+    }
+}
+
 /**
  * Load a image texture
  *
  * @param imagePath image file path
+ * @param premultiplyAlpha multiply the color channels by alpha before upload
+ * @param outWidth if not NULL, receives the image width
+ * @param outHeight if not NULL, receives the image height
  * @return texture handle
  */
-GLuint loadTexture(const char *imagePath) {
+GLuint loadTexture(const char *imagePath, bool premultiplyAlpha, int *outWidth,
+                   int *outHeight) {
     GLuint textureHandle = 0;
     glGenTextures(1, &textureHandle);
     checkGlError("glGenTextures - Gen a new texture");
 
     if (textureHandle != 0) {
-        glBindTexture(GL_TEXTURE_2D, textureHandle);
+        cachedBindTexture(GL_TEXTURE_2D, textureHandle);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -87,6 +103,9 @@ GLuint loadTexture(const char *imagePath) {
         int width, height, nrchanel;
         unsigned char *image = stbi_load(imagePath, &width, &height, &nrchanel, STBI_rgb_alpha);
         if (image) {
+            if (premultiplyAlpha) premultiplyPixels(image, width * height);
+            if (outWidth) *outWidth = width;
+            if (outHeight) *outHeight = height;
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
             LOGD("stbi_load image SUCCESSFUL.....");
         } else {
@@ -117,7 +136,7 @@ GLuint loadTextureColor(GLubyte rgba[]) {
     checkGlError("glGenTextures - Gen solid color texture");
 
     if (textureHandle[0] != 0) {
-        glBindTexture(GL_TEXTURE_2D, textureHandle[0]);
+        cachedBindTexture(GL_TEXTURE_2D, textureHandle[0]);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -178,4 +197,180 @@ GLuint createProgram(const char *vertexShaderCode, const char *fragShaderCode) {
 
     LOGD("Linking program: SUCCESSFUL...................");
     return program;
-}
\ No newline at end of file
+}
+/*
+ * ----------------------------------------------------------------------------------
+ * GL state cache - START
+ * Mirrors the state set through the cached* functions and drops calls that would not change
+ * anything. Values are unknown after resetGLStateCache(), so the next call always goes to GL.
+ * ----------------------------------------------------------------------------------
+ */
+
+#define GL_STATE_UNKNOWN 0xFFFFFFFFu
+
+struct VertexAttribState {
+    GLuint enabled; // GL_TRUE, GL_FALSE or GL_STATE_UNKNOWN
+    GLuint buffer;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLsizei stride;
+    const void *pointer;
+};
+
+static struct {
+    GLuint program;
+    GLuint arrayBuffer;
+    GLuint elementArrayBuffer;
+    GLenum activeTexture;
+    GLuint textures[GL_STATE_MAX_TEXTURE_UNITS];
+    VertexAttribState attribs[GL_STATE_MAX_VERTEX_ATTRIBS];
+    GLenum blend[4];
+} glState;
+
+static GLStateCounters glStateCounters = {0, 0};
+
+/**
+ * Forget everything the cache knows, e.g. for a new EGL context or after deleting objects
+ */
+void resetGLStateCache() {
+    glState.program = GL_STATE_UNKNOWN;
+    glState.arrayBuffer = GL_STATE_UNKNOWN;
+    glState.elementArrayBuffer = GL_STATE_UNKNOWN;
+    glState.activeTexture = GL_STATE_UNKNOWN;
+    for (int i = 0; i < GL_STATE_MAX_TEXTURE_UNITS; ++i) {
+        glState.textures[i] = GL_STATE_UNKNOWN;
+    }
+    for (int i = 0; i < GL_STATE_MAX_VERTEX_ATTRIBS; ++i) {
+        glState.attribs[i].enabled = GL_STATE_UNKNOWN;
+        glState.attribs[i].buffer = GL_STATE_UNKNOWN;
+    }
+    for (int i = 0; i < 4; ++i) {
+        glState.blend[i] = GL_STATE_UNKNOWN;
+    }
+}
+
+/**
+ * Start a new counting period, usually once per frame
+ */
+void resetGLStateCounters() {
+    glStateCounters.issued = 0;
+    glStateCounters.skipped = 0;
+}
+
+GLStateCounters getGLStateCounters() {
+    return glStateCounters;
+}
+
+/**
+ * Count a state call filtered outside of the cache, e.g. a uniform the caller tracks itself
+ */
+void countGLStateCall(bool issued) {
+    if (issued) glStateCounters.issued++;
+    else glStateCounters.skipped++;
+}
+
+/**
+ * Update a cached value
+ *
+ * @return true if the value changed and the call has to be issued
+ */
+static inline bool updateState(GLuint *cached, GLuint value) {
+    bool changed = *cached != value;
+    *cached = value;
+    countGLStateCall(changed);
+    return changed;
+}
+
+void cachedUseProgram(GLuint program) {
+    if (updateState(&glState.program, program)) glUseProgram(program);
+}
+
+void cachedBindBuffer(GLenum target, GLuint buffer) {
+    GLuint *cached = target == GL_ARRAY_BUFFER ? &glState.arrayBuffer
+                                               : &glState.elementArrayBuffer;
+    if (updateState(cached, buffer)) glBindBuffer(target, buffer);
+}
+
+void cachedActiveTexture(GLenum unit) {
+    if (updateState(&glState.activeTexture, unit)) glActiveTexture(unit);
+}
+
+/**
+ * Bind a texture to the active unit, only GL_TEXTURE_2D on the first units is cached
+ */
+void cachedBindTexture(GLenum target, GLuint texture) {
+    GLuint unit = glState.activeTexture - GL_TEXTURE0;
+    if (target != GL_TEXTURE_2D || unit >= GL_STATE_MAX_TEXTURE_UNITS) {
+        countGLStateCall(true);
+        glBindTexture(target, texture);
+        return;
+    }
+    if (updateState(&glState.textures[unit], texture)) glBindTexture(target, texture);
+}
+
+void cachedEnableVertexAttribArray(GLuint index) {
+    if (index >= GL_STATE_MAX_VERTEX_ATTRIBS) {
+        countGLStateCall(true);
+        glEnableVertexAttribArray(index);
+        return;
+    }
+    if (updateState(&glState.attribs[index].enabled, GL_TRUE)) glEnableVertexAttribArray(index);
+}
+
+void cachedDisableVertexAttribArray(GLuint index) {
+    if (index >= GL_STATE_MAX_VERTEX_ATTRIBS) {
+        countGLStateCall(true);
+        glDisableVertexAttribArray(index);
+        return;
+    }
+    if (updateState(&glState.attribs[index].enabled, GL_FALSE)) glDisableVertexAttribArray(index);
+}
+
+/**
+ * Set an attribute pointer, the cache remembers which GL_ARRAY_BUFFER it was taken from
+ */
+void cachedVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                               GLsizei stride, const void *pointer) {
+    if (index < GL_STATE_MAX_VERTEX_ATTRIBS && glState.arrayBuffer != GL_STATE_UNKNOWN) {
+        VertexAttribState *attrib = &glState.attribs[index];
+        if (attrib->buffer == glState.arrayBuffer && attrib->size == size &&
+            attrib->type == type && attrib->normalized == normalized &&
+            attrib->stride == stride && attrib->pointer == pointer) {
+            countGLStateCall(false);
+            return;
+        }
+        attrib->buffer = glState.arrayBuffer;
+        attrib->size = size;
+        attrib->type = type;
+        attrib->normalized = normalized;
+        attrib->stride = stride;
+        attrib->pointer = pointer;
+    }
+    countGLStateCall(true);
+    glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+void cachedBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+    if (glState.blend[0] == srcRGB && glState.blend[1] == dstRGB &&
+        glState.blend[2] == srcAlpha && glState.blend[3] == dstAlpha) {
+        countGLStateCall(false);
+        return;
+    }
+    glState.blend[0] = srcRGB;
+    glState.blend[1] = dstRGB;
+    glState.blend[2] = srcAlpha;
+    glState.blend[3] = dstAlpha;
+    countGLStateCall(true);
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+void cachedBlendFunc(GLenum src, GLenum dst) {
+    cachedBlendFuncSeparate(src, dst, src, dst);
+}
+
+/*
+ * ----------------------------------------------------------------------------------
+ * GL state cache - END
+ * ----------------------------------------------------------------------------------
+ */
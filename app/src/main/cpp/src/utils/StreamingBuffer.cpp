@@ -0,0 +1,103 @@
+#include <utils/StreamingBuffer.h>
+#include <utils/GLES2Utils.h>
+#include <android/log.h>
+
+#define LOG_TAG "StreamingBuffer"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+/**
+ * No GL calls here, the buffers are created by create() once a context is current
+ *
+ * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+ * @param capacity size in bytes of every buffer of the ring
+ */
+StreamingBuffer::StreamingBuffer(GLenum target, GLsizeiptr capacity) {
+    mTarget = target;
+    mCapacity = capacity;
+    mOffset = 0;
+    mCurrent = 0;
+    for (int i = 0; i < STREAMING_BUFFER_RING_SIZE; ++i) {
+        mBuffers[i] = 0;
+    }
+}
+
+StreamingBuffer::~StreamingBuffer() {
+
+}
+
+/**
+ * Generate the buffers of the ring and allocate their storage
+ */
+void StreamingBuffer::create() {
+    if (mBuffers[0] == 0) glGenBuffers(STREAMING_BUFFER_RING_SIZE, mBuffers);
+    allocate(mCapacity);
+}
+
+/**
+ * Delete the buffers, the current EGL context must be the one they were created in
+ */
+void StreamingBuffer::destroy() {
+    if (mBuffers[0] == 0) return;
+
+    glDeleteBuffers(STREAMING_BUFFER_RING_SIZE, mBuffers);
+    resetGLStateCache();
+    for (int i = 0; i < STREAMING_BUFFER_RING_SIZE; ++i) {
+        mBuffers[i] = 0;
+    }
+}
+
+/**
+ * (Re)allocate the storage of every buffer of the ring and restart at the first one
+ *
+ * @param capacity size in bytes of every buffer
+ */
+void StreamingBuffer::allocate(GLsizeiptr capacity) {
+    mCapacity = capacity;
+    for (int i = 0; i < STREAMING_BUFFER_RING_SIZE; ++i) {
+        cachedBindBuffer(mTarget, mBuffers[i]);
+        glBufferData(mTarget, mCapacity, NULL, GL_STREAM_DRAW);
+        checkGlError("glBufferData - allocate streaming buffer");
+    }
+    mCurrent = 0;
+    mOffset = 0;
+    cachedBindBuffer(mTarget, mBuffers[mCurrent]);
+}
+
+/**
+ * Copy data behind the previous append, moving to (and orphaning) the next buffer of the
+ * ring when it does not fit. The buffer holding the data stays bound to the target.
+ *
+ * @param data bytes to upload
+ * @param size number of bytes
+ * @return byte offset of the data inside getBuffer()
+ */
+GLintptr StreamingBuffer::append(const void *data, GLsizeiptr size) {
+    if (size > mCapacity) {
+        GLsizeiptr capacity = mCapacity;
+        while (capacity < size) capacity *= 2;
+        LOGD("Grow streaming buffer from %ld to %ld bytes", (long) mCapacity, (long) capacity);
+        allocate(capacity);
+    } else if (mOffset + size > mCapacity) {
+        mCurrent = (mCurrent + 1) % STREAMING_BUFFER_RING_SIZE;
+        mOffset = 0;
+        cachedBindBuffer(mTarget, mBuffers[mCurrent]);
+        // Orphan: the GPU keeps the old storage while we write into a fresh one
+        glBufferData(mTarget, mCapacity, NULL, GL_STREAM_DRAW);
+    } else {
+        cachedBindBuffer(mTarget, mBuffers[mCurrent]);
+    }
+
+    GLintptr offset = mOffset;
+    glBufferSubData(mTarget, offset, size, data);
+    checkGlError("glBufferSubData - streaming buffer");
+
+    mOffset += (size + STREAMING_BUFFER_ALIGNMENT - 1) & ~(STREAMING_BUFFER_ALIGNMENT - 1);
+    return offset;
+}
+
+/**
+ * Buffer that received the last append
+ */
+GLuint StreamingBuffer::getBuffer() {
+    return mBuffers[mCurrent];
+}
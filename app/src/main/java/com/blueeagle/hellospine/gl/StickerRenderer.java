@@ -34,6 +34,52 @@ public class StickerRenderer implements GLSurfaceView.Renderer {
         destroySticker();
     }
 
+    /**
+     * Add a sticker to the scene, must run on the GL thread (GLSurfaceView#queueEvent)
+     *
+     * @param atlasPath    atlas file
+     * @param skeletonPath skeleton file, .json or .skel
+     * @param animation    animation to loop, may be null
+     * @return sticker id, 0 if the files could not be loaded
+     */
+    public int addStickerToScene(String atlasPath, String skeletonPath, String animation) {
+        return addSticker(atlasPath, skeletonPath, animation);
+    }
+
+    /**
+     * Remove a sticker from the scene, must run on the GL thread
+     */
+    public boolean removeStickerFromScene(int id) {
+        return removeSticker(id);
+    }
+
+    /**
+     * Place a sticker in scene coordinates, must run on the GL thread
+     */
+    public boolean moveSticker(int id, float x, float y, float angle, float scale) {
+        return setStickerTransform(id, x, y, angle, scale);
+    }
+
+    /**
+     * Play the animation of a sticker from baked samples, must run on the GL thread
+     *
+     * @param sampleRate samples per second, 0 to evaluate the animation live again
+     */
+    public boolean bakeSticker(int id, float sampleRate) {
+        return setStickerBakedPlayback(id, sampleRate);
+    }
+
+    /**
+     * Play the animation of a sticker from baked vertices, must run on the GL thread
+     *
+     * @param frameRate frames per second, 0 to evaluate the animation live again
+     * @param quantized store positions as 16 bit integers instead of floats
+     * @return false if the frames did not fit the budget, the sticker keeps evaluating live
+     */
+    public boolean flipbookSticker(int id, float frameRate, boolean quantized) {
+        return setStickerFlipbookPlayback(id, frameRate, quantized);
+    }
+
     /*
      * ----------------------------------------------------------------------
      * Native method declaration
@@ -46,4 +92,16 @@ public class StickerRenderer implements GLSurfaceView.Renderer {
     private native void onStickerDrawFrame();
 
     private native void destroySticker();
+
+    private native int addSticker(String atlasPath, String skeletonPath, String animation);
+
+    private native boolean removeSticker(int id);
+
+    private native boolean setStickerTransform(int id, float x, float y, float angle,
+                                               float scale);
+
+    private native boolean setStickerBakedPlayback(int id, float sampleRate);
+
+    private native boolean setStickerFlipbookPlayback(int id, float frameRate,
+                                                      boolean quantized);
 }